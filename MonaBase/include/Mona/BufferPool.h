@@ -19,6 +19,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Allocator.h"
 #include "Mona/Timer.h"
+#include "Mona/Recycler.h"
 #include <mutex>
 
 namespace Mona {
@@ -35,7 +36,7 @@ struct BufferPool : Allocator, virtual Object {
 	void   deallocate(UInt8* buffer, UInt32 size) const;
 
 private:
-	mutable std::multimap<UInt32,UInt8*>	_buffers;
+	mutable std::multimap<UInt32, UInt8*, std::less<UInt32>, Recycler<std::pair<const UInt32, UInt8*>>>	_buffers; // recycled nodes to not allocate on deallocate
 	mutable std::mutex						_mutex;
 	const Timer&							_timer;
 	Timer::OnTimer							_onTimer;
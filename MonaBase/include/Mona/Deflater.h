@@ -0,0 +1,66 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Buffer.h"
+#include "Mona/Exceptions.h"
+#include <zlib.h>
+
+//
+// Automatically link zlib library.
+//
+#if defined(_MSC_VER)
+#if defined(_DEBUG)
+#pragma comment(lib, "zlibd.lib")
+#else
+#pragma comment(lib, "zlib.lib")
+#endif
+#endif
+
+namespace Mona {
+
+/*!
+	Streaming zlib compressor, a stream can be written in several calls and once ended the deflater is reset (and not reallocated) to compress the next one,
+	so keep a Deflater by connection rather than by message.
+	FORMAT_GZIP and FORMAT_ZLIB are respectively the "gzip" and "deflate" HTTP content-codings (RFC 7230 4.2) */
+struct Deflater : virtual Object {
+	enum Format {
+		FORMAT_RAW = -MAX_WBITS,
+		FORMAT_ZLIB = MAX_WBITS,
+		FORMAT_GZIP = MAX_WBITS + 16
+	};
+	Deflater(Format format = FORMAT_GZIP, Int8 level = Z_DEFAULT_COMPRESSION);
+	~Deflater();
+
+	const Format	format;
+	const Int8		level;
+
+	/*!
+	Compress 'data' and append it to 'buffer', 'end' finishes the stream (beware, if it fails the deflater is reset and the current stream lost) */
+	bool deflate(Exception& ex, const void* data, UInt32 size, Buffer& buffer, bool end = true);
+	/*!
+	Abort the current stream */
+	void reset();
+
+private:
+	z_stream	_stream;
+	bool		_initialized;
+};
+
+
+} // namespace Mona
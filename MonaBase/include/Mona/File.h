@@ -42,10 +42,19 @@ struct File : virtual NullableObject {
 		MODE_WRITE,
 		MODE_APPEND
 	};
+	enum {
+		DIRECT_ALIGNMENT = 4096 // memory, size and position alignment of a direct writing
+	};
 	File(const Path& path, Mode mode);
 	~File();
 
 	const Mode  mode;
+	/*!
+	Writing options to set before the first writing (Linux only):
+	- preallocation reserves disk space by chunks ahead of writing to limit fragmentation (fallocate), 0 disables
+	- direct writes without system cache when memory, size and position are aligned on DIRECT_ALIGNMENT (O_DIRECT) */
+	UInt32		preallocation;
+	bool		direct;
 
 	explicit operator bool() const { return _handle != -1; }
 	operator const Path&() const { return _path; }
@@ -60,7 +69,7 @@ struct File : virtual NullableObject {
 
 	bool		exists(bool refresh = false) const { return _path.exists(refresh); }
 	UInt64		size(bool refresh = false) const;
-	Int64		lastModified(bool refresh = false) const { return _path.size(refresh); }
+	Int64		lastModified(bool refresh = false) const { return _path.lastModified(refresh); }
 	UInt8		device() const { return _path.device(); }
 
 	bool		loaded() const { return _handle != -1; }
@@ -77,12 +86,21 @@ struct File : virtual NullableObject {
 	/*!
 	If writing error => Ex::System::File || Ex::Intern */
 	bool				write(Exception& ex, const void* data, UInt32 size);
+	/*!
+	Flush written data to the disk (fdatasync)
+	If error => Ex::System::File || Ex::Intern */
+	bool				sync(Exception& ex);
 
 	void				reset();
 
 private:
+	void				prepareWrite(const void* data, UInt32 size);
+
 	Path			_path;
 	long			_handle;
+	UInt64			_position; // writing position
+	UInt64			_reserved; // preallocation end
+	bool			_direct;
 
 	//// Used by IOFile /////////////////////
 	shared<Decoder>				pDecoder;
@@ -30,9 +30,7 @@ struct Handler : virtual Object {
 	template<typename RunnerType>
 	void queue(const shared<RunnerType>& pRunner) const {
 		FATAL_CHECK(pRunner);
-		std::lock_guard<std::mutex> lock(_mutex);
-		_runners.emplace_back(pRunner);
-		_signal.set();
+		push(pRunner);
 	}
 
 	template<typename ResultType, typename BaseType, typename ...Args>
@@ -44,7 +42,7 @@ struct Handler : virtual Object {
 			Event<void(BaseType&)>	_onResult;
 			ResultType				_result;
 		};
-		queue(std::make_shared<Result>(onResult, std::forward<Args>(args)...));
+		queue(Runner::Make<Result>(onResult, std::forward<Args>(args)...));
 	}
 	template<typename ResultType, typename ...Args>
 	void queue(const Event<void(ResultType&)>& onResult, Args&&... args) const {
@@ -55,11 +53,20 @@ struct Handler : virtual Object {
 
 	UInt32 flush(UInt32 count = 0);
 
+	~Handler();
+
 private:
+	void push(const shared<Runner>& pRunner) const;
+
+	struct Job {
+		Job(const shared<Runner>& pRunner, Int64 time) : pRunner(pRunner), time(time) {}
+		shared<Runner>	pRunner;
+		Int64			time; // queueing time to measure latency
+	};
 
-	mutable std::mutex					_mutex;
-	mutable std::deque<shared<Runner>>	_runners;
-	Signal&								_signal;
+	mutable std::mutex							_mutex;
+	mutable std::deque<Job, Recycler<Job>>		_runners;
+	Signal&										_signal;
 };
 
 
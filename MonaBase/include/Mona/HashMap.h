@@ -0,0 +1,185 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <vector>
+
+namespace Mona {
+
+/*!
+	Hash table with open addressing (linear probing, backward shift deletion) on one contiguous array,
+	every slot keeps the hash of its key to compare it before key and to grow without rehashing.
+	Interface is a subset of std::unordered_map, /!\ any insertion or deletion invalidates iterators */
+template<typename KeyType, typename ValueType, typename HashType = std::hash<KeyType>, typename EqualType = std::equal_to<KeyType>>
+struct HashMap : virtual Object {
+	typedef std::pair<KeyType, ValueType> value_type;
+private:
+	struct Slot {
+		Slot() : hash(0) {}
+		UInt32		hash; // 0 = empty
+		value_type	entry;
+	};
+	template<typename EntryType, typename SlotType>
+	struct Iterator {
+		typedef std::forward_iterator_tag	iterator_category;
+		typedef EntryType					value_type;
+		typedef std::ptrdiff_t				difference_type;
+		typedef EntryType*					pointer;
+		typedef EntryType&					reference;
+
+		Iterator(SlotType* pSlot = NULL, SlotType* pEnd = NULL) : _pSlot(pSlot), _pEnd(pEnd) { skip(); }
+		template<typename OtherEntryType, typename OtherSlotType>
+		Iterator(const Iterator<OtherEntryType, OtherSlotType>& other) : _pSlot(other._pSlot), _pEnd(other._pEnd) {}
+
+		EntryType&	operator*() const { return _pSlot->entry; }
+		EntryType*	operator->() const { return &_pSlot->entry; }
+		Iterator&	operator++() { ++_pSlot; skip(); return *this; }
+		Iterator	operator++(int) { Iterator it(*this); ++*this; return it; }
+		bool		operator==(const Iterator& other) const { return _pSlot == other._pSlot; }
+		bool		operator!=(const Iterator& other) const { return _pSlot != other._pSlot; }
+	private:
+		void skip() { while (_pSlot != _pEnd && !_pSlot->hash) ++_pSlot; }
+		SlotType* _pSlot;
+		SlotType* _pEnd;
+		template<typename, typename> friend struct Iterator;
+		friend struct HashMap;
+	};
+public:
+	typedef Iterator<value_type, Slot>				iterator;
+	typedef Iterator<const value_type, const Slot>	const_iterator;
+
+	HashMap(UInt32 capacity = 0) : _size(0), _mask(0) { if (capacity) reserve(capacity); }
+
+	UInt32			size() const { return _size; }
+	bool			empty() const { return !_size; }
+
+	iterator		begin() { return iterator(_slots.data(), _slots.data() + _slots.size()); }
+	iterator		end() { return iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size()); }
+	const_iterator	begin() const { return const_iterator(_slots.data(), _slots.data() + _slots.size()); }
+	const_iterator	end() const { return const_iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size()); }
+
+	iterator find(const KeyType& key) {
+		Slot* pSlot(lookup(key, Hash(key)));
+		return pSlot->hash ? iterator(pSlot, _slots.data() + _slots.size()) : end();
+	}
+	const_iterator find(const KeyType& key) const { return const_iterator(const_cast<HashMap*>(this)->find(key)); }
+	UInt32 count(const KeyType& key) const { return find(key) == end() ? 0 : 1; }
+
+	template<typename ...Args>
+	std::pair<iterator, bool> emplace(const KeyType& key, Args&&... args) {
+		if ((_size + 1) > (_slots.size() - (_slots.size() >> 2))) // load factor 3/4
+			reserve(_size + 1);
+		UInt32 hash(Hash(key));
+		Slot* pSlot(lookup(key, hash));
+		if (pSlot->hash)
+			return std::make_pair(iterator(pSlot, _slots.data() + _slots.size()), false);
+		pSlot->hash = hash;
+		pSlot->entry.first = key;
+		pSlot->entry.second = ValueType(std::forward<Args>(args)...);
+		++_size;
+		return std::make_pair(iterator(pSlot, _slots.data() + _slots.size()), true);
+	}
+
+	UInt32 erase(const KeyType& key) {
+		if (!_size)
+			return 0;
+		Slot* pSlot(lookup(key, Hash(key)));
+		if (!pSlot->hash)
+			return 0;
+		remove(UInt32(pSlot - _slots.data()));
+		return 1;
+	}
+	void erase(const iterator& it) { remove(UInt32(it._pSlot - _slots.data())); }
+
+	void clear() {
+		for (Slot& slot : _slots) {
+			if (!slot.hash)
+				continue;
+			slot.hash = 0;
+			slot.entry = value_type();
+		}
+		_size = 0;
+	}
+
+	/*!
+	Allocate enough slots to contain 'size' entries without growing */
+	void reserve(UInt32 size) {
+		UInt32 capacity(16);
+		while ((capacity - (capacity >> 2)) < size)
+			capacity <<= 1;
+		if (capacity <= _slots.size())
+			return;
+		std::vector<Slot> slots(capacity);
+		_slots.swap(slots);
+		_mask = capacity - 1;
+		for (Slot& slot : slots) {
+			if (!slot.hash)
+				continue;
+			Slot* pSlot(&_slots[slot.hash & _mask]);
+			while (pSlot->hash)
+				pSlot = next(pSlot);
+			pSlot->hash = slot.hash;
+			pSlot->entry = std::move(slot.entry);
+		}
+	}
+
+private:
+	static UInt32 Hash(const KeyType& key) {
+		std::size_t value(HashType()(key));
+		// fold and mix to spread sequential values, never 0 (empty)
+		UInt32 hash(UInt32((value ^ (UInt64(value) >> 32)) * 0x9E3779B1u));
+		return hash ? hash : 1;
+	}
+
+	Slot* next(Slot* pSlot) { return ++pSlot == (_slots.data() + _slots.size()) ? _slots.data() : pSlot; }
+
+	/*!
+	Returns the slot of key, or the empty slot where insert it */
+	Slot* lookup(const KeyType& key, UInt32 hash) {
+		if (_slots.empty())
+			reserve(1);
+		Slot* pSlot(&_slots[hash & _mask]);
+		while (pSlot->hash && (pSlot->hash != hash || !EqualType()(pSlot->entry.first, key)))
+			pSlot = next(pSlot);
+		return pSlot;
+	}
+
+	void remove(UInt32 index) {
+		// backward shift deletion, no tombstone: until the end of the cluster move back in the hole
+		// every entry whose ideal slot is not between the hole and itself
+		for (UInt32 next = (index + 1) & _mask; _slots[next].hash; next = (next + 1) & _mask) {
+			if (((next - _slots[next].hash) & _mask) < ((next - index) & _mask))
+				continue;
+			_slots[index].hash = _slots[next].hash;
+			_slots[index].entry = std::move(_slots[next].entry);
+			index = next;
+		}
+		_slots[index].hash = 0;
+		_slots[index].entry = value_type();
+		--_size;
+	}
+
+	std::vector<Slot>	_slots;
+	UInt32				_size;
+	UInt32				_mask;
+};
+
+
+} // namespace Mona
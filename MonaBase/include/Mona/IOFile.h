@@ -57,15 +57,25 @@ struct IOFile : virtual Object {
 	void read(const shared<File>& pFile, UInt32 size=0xFFFF);
 	void write(const shared<File>& pFile, const Packet& packet);
 	/*!
+	Flush data written before to the disk (fdatasync) */
+	void sync(const shared<File>& pFile);
+	/*!
 	Close */
 	void close(shared<File>& pFile);
 
 	void join();
+
+	/*!
+	I/O engine of devices (disks) used from now, io_uring on Linux (batched submissions) if available, otherwise or disabled one thread by device (default) */
+	static bool GetURing() { return _URing; }
+	static void SetURing(bool enabled) { _URing = enabled; }
 private:
 	struct Action;
 	struct OpenFile;
 	
 	void dispatch(File& file, const shared<Action>& pAction);
+
+	static std::atomic<bool> _URing;
 };
 
 
@@ -53,6 +53,11 @@ struct IOSocket : private Thread, virtual Object {
 	Unsubscribe pSocket and reset shared<Socket> to avoid to resubscribe the same socket which could crash decoder assignation */
 	void					unsubscribe(shared<Socket>& pSocket);
 
+	/*!
+	Stop to read pSocket until resume (backpressure), meanwhile received data wait in the system buffer */
+	void					pause(const shared<Socket>& pSocket);
+	void					resume(const shared<Socket>& pSocket);
+
 private:
 
 	bool					subscribe(Exception& ex, const shared<Socket>& pSocket,
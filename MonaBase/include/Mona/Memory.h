@@ -0,0 +1,77 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Metrics.h"
+#include <atomic>
+
+namespace Mona {
+
+/*!
+	Server-wide memory accountant fed by Buffer allocations and Socket sending queues.
+	Low and high watermarks (0 = unlimited) give a pressure level to the backpressure mechanisms:
+	above low => drop non-key frames, above high => pause publication ingest and evict the biggest queues */
+struct Memory : virtual Static {
+	enum Pressure {
+		PRESSURE_NONE = 0,
+		PRESSURE_LOW,
+		PRESSURE_HIGH
+	};
+
+	/*!
+	Sending queue accounting of a group of sockets (a protocol for example), see Socket::setAccount */
+	struct Account : virtual Object {
+		Account(const char* name);
+		const char* const name;
+		UInt64	queueing() const { return _queueing; }
+	private:
+		std::atomic<UInt64>	_queueing;
+		Metrics::Gauge		_gauge;
+		friend struct Memory;
+	};
+
+	/*!
+	Bytes allocated by living Buffers */
+	static UInt64	Buffered() { return _Buffered; }
+	/*!
+	Bytes waiting in socket sending queues (referencing mostly buffered memory) */
+	static UInt64	Queueing() { return _Queueing; }
+
+	static UInt64	Low() { return _Low; }
+	static UInt64	High() { return _High; }
+	static void		SetWatermarks(UInt64 low, UInt64 high);
+
+	static Pressure	GetPressure();
+
+private:
+	static void Allocate(UInt32 size) { _Buffered += size; }
+	static void Deallocate(UInt32 size) { _Buffered -= size; }
+	static void Queue(Account* pAccount, UInt64 size);
+	static void Unqueue(Account* pAccount, UInt64 size);
+
+	static std::atomic<UInt64>	_Buffered;
+	static std::atomic<UInt64>	_Queueing;
+	static std::atomic<UInt64>	_Low;
+	static std::atomic<UInt64>	_High;
+
+	friend struct Buffer;
+	friend struct Socket;
+};
+
+
+} // namespace Mona
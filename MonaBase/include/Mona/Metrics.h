@@ -0,0 +1,135 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <atomic>
+#include <functional>
+
+namespace Mona {
+
+/*!
+	Metrics registry with counters, gauges and histograms.
+	Recording is lock-free and sharded by thread, so threads do not contend; shards are summed on reading.
+	Metrics register themselves on construction and unregister on destruction. Write serializes every metric
+	in the Prometheus text exposition format.
+	static Metrics::Counter Sent("mona_sent_bytes_total", "Bytes sent"); Sent += size; */
+struct Metrics : virtual Static {
+	enum { SHARDS = 16 };
+
+	struct Metric : virtual Object {
+		const char* const	type; // counter, gauge or histogram
+		const char* const	name;
+		const char* const	help;
+		const std::string	labels; // key1="value1",key2="value2"
+
+		virtual ~Metric();
+		/*!
+		Write samples in Prometheus text format */
+		virtual void write(std::string& buffer) const = 0;
+	protected:
+		Metric(const char* type, const char* name, const char* help, std::string&& labels);
+	};
+
+	struct Counter : Metric, virtual Object {
+		Counter(const char* name, const char* help, std::string&& labels = "") : Metric("counter", name, help, std::move(labels)) {}
+
+		Counter& operator+=(UInt64 value) { _shards[Shard()].value.fetch_add(value, std::memory_order_relaxed); return *this; }
+		Counter& operator++() { return operator+=(1); }
+		UInt64	 value() const;
+	private:
+		void write(std::string& buffer) const;
+
+		struct alignas(64) Cell { Cell() : value(0) {} std::atomic<UInt64> value; };
+		Cell _shards[SHARDS];
+	};
+
+	/*!
+	Gauge set by the code, or computed on reading when built with a getter */
+	struct Gauge : Metric, virtual Object {
+		Gauge(const char* name, const char* help, std::string&& labels = "", std::function<Int64()>&& get = nullptr) : Metric("gauge", name, help, std::move(labels)), _get(std::move(get)), _value(0) {}
+
+		Gauge& operator+=(Int64 value) { _value.fetch_add(value, std::memory_order_relaxed); return *this; }
+		Gauge& operator-=(Int64 value) { _value.fetch_sub(value, std::memory_order_relaxed); return *this; }
+		Gauge& operator++() { return operator+=(1); }
+		Gauge& operator--() { return operator-=(1); }
+		Gauge& operator=(Int64 value) { _value = value; return *this; }
+		Int64  value() const { return _get ? _get() : _value.load(); }
+	private:
+		void write(std::string& buffer) const;
+
+		std::function<Int64()>	_get;
+		std::atomic<Int64>		_value;
+	};
+
+	/*!
+	HDR-style histogram: 4 linear sub-buckets by power of 2 (precision of 25%), written with power of 2 upper bounds,
+	sharded by default, sharded=false for a metric recorded always by the same thread (saves memory) */
+	struct Histogram : Metric, virtual Object {
+		enum { BUCKETS = 253, MAX_POWER = 32 }; // exposition from le=1 to le=2^MAX_POWER
+
+		Histogram(const char* name, const char* help, std::string&& labels = "", bool sharded = true);
+		~Histogram();
+
+		void	record(UInt64 value);
+		UInt64	count() const;
+		UInt64	sum() const;
+		/*!
+		Upper bound of the bucket which contains the 'quantile' (0 to 1) */
+		UInt64	quantile(double quantile) const;
+
+		static UInt16 Index(UInt64 value);
+		static UInt64 UpperBound(UInt16 index);
+	private:
+		void	write(std::string& buffer) const;
+		void	buckets(UInt64 (&counts)[BUCKETS]) const;
+
+		struct Shard {
+			Shard() : sum(0) { for (auto& count : counts) count = 0; }
+			std::atomic<UInt64> counts[BUCKETS];
+			std::atomic<UInt64> sum;
+		};
+		Shard*	_shards;
+		UInt8	_count;
+	};
+
+	/*!
+	Bytes and packets of a group of sockets (a protocol for example), see Socket::setTraffic */
+	struct Traffic : virtual Object {
+		Traffic(const std::string& labels);
+		Counter sent;
+		Counter sentPackets;
+		Counter received;
+		Counter receivedPackets;
+	};
+
+	/*!
+	Monotonic time in microseconds, to measure latencies and durations */
+	static Int64		Now();
+	/*!
+	Format a label, value is escaped */
+	static std::string	Label(const char* key, const std::string& value);
+	/*!
+	Write all registered metrics in Prometheus text exposition format (version 0.0.4) */
+	static std::string&	Write(std::string& buffer);
+
+private:
+	static UInt8 Shard();
+};
+
+
+} // namespace Mona
@@ -216,6 +216,12 @@ struct Net : virtual Object {
 		virtual double	sendLostRate() const { return 0; }
 
 		virtual UInt64	queueing() const = 0;
+
+		/*!
+		Congestion control state, 0 when unmanaged by the protocol */
+		virtual UInt32	congestionWindow() const { return 0; }
+		virtual UInt64	pacingRate() const { return 0; }
+		virtual UInt32	inflight() const { return 0; }
 	};
 
 private:
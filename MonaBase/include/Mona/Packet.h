@@ -37,7 +37,9 @@ Example:
 	// Here Packet wraps a unbuffered area of data
 	packets.push(std::move(unbuffered));
 	// Here Packet wraps a already buffered area of data, after this call pBuffer is empty (became immutable), and no copying data will occur anymore
-	packets.push(std::move(buffered)); */
+	packets.push(std::move(buffered));
+A copy references the buffer of the original packet without touching to its reference counter, a packet bufferized or capturing a buffer
+holds it inline (no allocation), and small data are bufferized in one recycled memory block shared with their reference counter (see Recycler) */
 struct Packet: Binary, virtual Object {
 	/*!
 	Build an empty Packet */
@@ -84,7 +86,7 @@ struct Packet: Binary, virtual Object {
 	explicit Packet(shared<BinaryType>& pBuffer, const UInt8* data, UInt32 size) : _reference(true) { set<BinaryType>(pBuffer, data, size); }
 	/*!
 	Release the referenced area of data */
-	virtual ~Packet() { if (!_reference) delete _ppBuffer; }
+	virtual ~Packet() {}
 	/*!
 	Allow to compare data packet*/
 	bool operator == (const Packet& packet) const { return _size == packet._size && memcmp(_data, packet._data, _size)==0; }
@@ -197,7 +199,7 @@ struct Packet: Binary, virtual Object {
 	static const Packet& Null() { static Packet Null(nullptr); return Null; }
 
 private:
-	Packet(std::nullptr_t) : _ppBuffer(new shared<const Binary>()), _data(NULL), _size(0), _reference(false) {}
+	Packet(std::nullptr_t) : _ppBuffer(&_pBuffer), _data(NULL), _size(0), _reference(false) {}
 
 	Packet& setArea(const UInt8* data, UInt32 size);
 
@@ -207,17 +209,16 @@ private:
 	Packet& setIntern(const shared<BinaryType>& pBuffer) {
 		if (!pBuffer || !pBuffer->data()) // if size==0 the normal behavior is required to get the same data address
 			return set(NULL, 0);
-		if (!_reference)
-			delete _ppBuffer;
-		else
-			_reference = false;
-		_ppBuffer = new shared<const Binary>(pBuffer);
+		_reference = false;
+		_pBuffer = pBuffer;
+		_ppBuffer = &_pBuffer;
 		_data = pBuffer->data();
 		_size = pBuffer->size();
 		return *this;
 	}
 
-	mutable const shared<const Binary>*	_ppBuffer;
+	mutable const shared<const Binary>*	_ppBuffer; // _pBuffer or the buffer referenced
+	mutable shared<const Binary>		_pBuffer; // if !_reference
 	mutable const UInt8*				_data;
 	mutable bool						_reference;
 	UInt32								_size;
@@ -18,15 +18,112 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Event.h"
+#include <atomic>
+#include <cmath>
+#include <type_traits>
+#include <vector>
 
 namespace Mona {
 
+/*!
+	Case-insensitive string parameters, stored in a vector sorted by lowercase key (interned to be shared between instances),
+	a number or boolean readen is parsed once and cached until the value changes.
+	/!\ any insertion or deletion invalidates iterators, but not references to values */
 struct Parameters : virtual Object {
 
 	typedef Event<void(const std::string& key, const std::string* pValue)> ON(Change);
 	typedef Event<void()>												   ON(Clear);
 
-	typedef std::map<std::string, std::string, String::IComparator>::const_iterator const_iterator;
+	struct Entry {
+		Entry(const std::string& key, const char* lowerKey, UInt32 size);
+
+		const std::string	first; // key
+		std::string			second; // value
+
+		const char*			key() const { return _key; } // lowercase
+
+	private:
+		template<typename NumberType>
+		bool toNumber(NumberType& value) const {
+			UInt8 cache(_cache.load(std::memory_order_acquire));
+			UInt64 integer;
+			double decimal;
+			if (cache & CACHE_NUMBER) {
+				integer = _integer.load(std::memory_order_relaxed);
+				decimal = _decimal.load(std::memory_order_relaxed);
+			} else {
+				// parse in locals, publish values before flags (concurrent const readers)
+				cache = parseNumber(integer, decimal);
+				_integer.store(integer, std::memory_order_relaxed);
+				_decimal.store(decimal, std::memory_order_relaxed);
+				_cache.fetch_or(cache, std::memory_order_release);
+			}
+			if (!(cache & CACHE_IS_NUMBER))
+				return false;
+			// same checks than String::ToNumber<NumberType>
+			bool negative((cache & CACHE_IS_INTEGER) ? (cache & CACHE_IS_NEGATIVE)!=0 : std::signbit(decimal));
+			if (negative && !std::numeric_limits<NumberType>::is_signed)
+				return false;
+			if (cache & CACHE_IS_INTEGER) {
+				// exact, without floating conversion (UInt64 > 2^53)
+				if (std::is_integral<NumberType>::value && integer > UInt64(std::numeric_limits<NumberType>::max()))
+					return false;
+				value = negative ? NumberType(0) - (NumberType)integer : (NumberType)integer;
+				return true;
+			}
+			if (negative)
+				decimal = -decimal;
+			if (std::is_integral<NumberType>::value && std::numeric_limits<NumberType>::digits > std::numeric_limits<double>::digits) {
+				// max is not exact in double (64 bits integer), compare with max+1
+				if (decimal >= std::ldexp(1.0, std::numeric_limits<NumberType>::digits))
+					return false;
+			} else if (decimal > std::numeric_limits<NumberType>::max())
+				return false;
+			value = negative ? NumberType(0) - (NumberType)decimal : (NumberType)decimal;
+			return true;
+		}
+		UInt8 parseNumber(UInt64& integer, double& decimal) const;
+		bool toBoolean() const;
+		void assigned() { _cache = 0; }
+
+		enum {
+			CACHE_NUMBER = 1,
+			CACHE_IS_NUMBER = 2,
+			CACHE_BOOLEAN = 4,
+			CACHE_IS_TRUE = 8,
+			CACHE_IS_INTEGER = 16,
+			CACHE_IS_NEGATIVE = 32
+		};
+		const char*					_key; // lowercase
+		std::string					_ownKey; // if not interned
+		mutable std::atomic<UInt8>	_cache;
+		mutable std::atomic<UInt64>	_integer; // absolute value if CACHE_IS_INTEGER
+		mutable std::atomic<double>	_decimal;
+		friend struct Parameters;
+	};
+
+	struct const_iterator {
+		typedef std::bidirectional_iterator_tag	iterator_category;
+		typedef const Entry						value_type;
+		typedef std::ptrdiff_t					difference_type;
+		typedef const Entry*					pointer;
+		typedef const Entry&					reference;
+
+		const_iterator() {}
+
+		const Entry&	operator*() const { return **_it; }
+		const Entry*	operator->() const { return _it->get(); }
+		const_iterator&	operator++() { ++_it; return *this; }
+		const_iterator	operator++(int) { const_iterator it(*this); ++_it; return it; }
+		const_iterator&	operator--() { --_it; return *this; }
+		const_iterator	operator--(int) { const_iterator it(*this); --_it; return it; }
+		bool			operator==(const const_iterator& other) const { return _it == other._it; }
+		bool			operator!=(const const_iterator& other) const { return _it != other._it; }
+	private:
+		const_iterator(std::vector<unique<Entry>>::const_iterator it) : _it(it) {}
+		std::vector<unique<Entry>>::const_iterator _it;
+		friend struct Parameters;
+	};
 
 private:
 	struct ForEach {
@@ -44,11 +141,11 @@ public:
 	Parameters(Parameters&& other) { operator=(std::move(other));  }
 	Parameters& operator=(Parameters&& other);
 
-	const_iterator	begin() const { return _pMap ? _pMap->begin() : Null().begin(); }
-	const_iterator	end() const { return _pMap ? _pMap->end() : Null().end(); }
-	ForEach			from(const std::string& prefix) { return _pMap ? ForEach(_pMap->lower_bound(prefix), _pMap->end()) : ForEach(); }
+	const_iterator	begin() const { return _entries.begin(); }
+	const_iterator	end() const { return _entries.end(); }
+	ForEach			from(const std::string& prefix) { return ForEach(lowerBound(prefix), end()); }
 	ForEach			band(const std::string& prefix);
-	UInt32			count() const { return _pMap ? _pMap->size() : 0; }
+	UInt32			count() const { return _entries.size(); }
 	
 	Parameters&		clear();
 
@@ -62,7 +159,13 @@ public:
 	/*!
 	Return false if key doesn't exist or if it's not a numeric type, otherwise return true and assign numeric 'value' */
 	template<typename NumberType>
-	bool getNumber(const std::string& key, NumberType& value) const { const char* temp = getParameter(key); return temp && String::ToNumber<NumberType>(temp, value); }
+	bool getNumber(const std::string& key, NumberType& value) const {
+		const Entry* pEntry(find(key));
+		if (pEntry)
+			return pEntry->toNumber(value);
+		const char* temp = onParamUnfound(key);
+		return temp && String::ToNumber<NumberType>(temp, value);
+	}
 	/*!
 	A short version of getNumber with template default argument to get value by returned result */
 	template<typename NumberType = double, int defaultValue = 0>
@@ -93,7 +196,7 @@ public:
 		return setParameter(item.first, std::move(item.second));
 	}
 
-	static const Parameters& Null() { static Parameters Null(nullptr); return Null; }
+	static const Parameters& Null() { static Parameters Null; return Null; }
 
 protected:
 	virtual void onParamChange(const std::string& key, const std::string* pValue) { onChange(key, pValue); }
@@ -102,23 +205,22 @@ protected:
 private:
 	virtual const char* onParamUnfound(const std::string& key) const { return NULL; }
 
-	Parameters(std::nullptr_t) : _pMap(new std::map<std::string, std::string, String::IComparator>()) {} // Null()
-
 	const char* getParameter(const std::string& key) const;
 
 	template<typename ...Args>
 	const std::string& setParameter(const std::string& key, Args&& ...args) {
-		if (!_pMap)
-			_pMap.reset(new std::map<std::string, std::string, String::IComparator>());
-		const auto& it = _pMap->emplace(key, std::string()).first;
-		it->second.assign(std::forward<Args>(args)...);
-		onParamChange(it->first, &it->second);
-		return it->second;
+		Entry& entry(this->entry(key));
+		entry.second.assign(std::forward<Args>(args)...);
+		entry.assigned();
+		onParamChange(entry.first, &entry.second);
+		return entry.second;
 	}
 
-	// shared because a lot more faster than using st::map move constructor!
-	// Also build _pMap just if required, and then not erase it but clear it (more faster that reset the shared)
-	shared<std::map<std::string, std::string, String::IComparator>>	_pMap;
+	std::vector<unique<Entry>>::const_iterator	lowerBound(const std::string& key) const;
+	const Entry*								find(const std::string& key) const;
+	Entry&										entry(const std::string& key); // find or insert
+
+	std::vector<unique<Entry>>	_entries;
 };
 
 
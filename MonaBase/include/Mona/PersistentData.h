@@ -20,15 +20,22 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Thread.h"
 #include "Mona/Exceptions.h"
 #include "Mona/Packet.h"
+#include "Mona/File.h"
 #include <functional>
 #include <deque>
+#include <map>
 
 namespace Mona {
 
-
+/*!
+	Persistent key-value store, entries are appended by a writing thread to log segment files (rootDir/<number>.log)
+	as CRC-checked records, and indexed in memory by path.
+	Writings are gathered and synced to the disk by batch (once the queue of entries empty) and segments are compacted
+	when their obsolete records exceed the live ones.
+	load replays the segments sequentially, and imports once the old format (one MD5-named file by entry in a directory tree) */
 class PersistentData : private Thread, public virtual Object {
 public:
-	PersistentData(const char* name = "PersistentData") : _disableTransaction(false), Thread(name) {}
+	PersistentData(const char* name = "PersistentData") : _disableTransaction(false), Thread(name), _segment(0), _size(0), _live(0), _dirty(false) {}
 
 	typedef std::function<void(const std::string& path, const UInt8* value, UInt32 size)> ForEach;
 
@@ -67,14 +74,41 @@ private:
 	}
 
 
+	struct Record {
+		Record(UInt32 segment, UInt32 offset, UInt32 size) : segment(segment), offset(offset), size(size) {}
+		UInt32 segment;
+		UInt32 offset;
+		UInt32 size;
+	};
+
 	bool run(Exception& ex, const volatile bool& stopping);
 	void processEntry(Exception& ex, Entry& entry);
+	/*!
+	Write the record of path in the current segment, an empty packet is a removing */
+	bool write(Exception& ex, const std::string& path, const Packet& packet);
+	bool writeBuffer(Exception& ex);
+	/*!
+	Sync the batch written and compact segments if need */
+	bool commit(Exception& ex);
+	bool compact(Exception& ex);
+	bool replay(Exception& ex, UInt32 segment, shared<Buffer>& pBuffer);
 	bool loadDirectory(Exception& ex, const std::string& directory, const std::string& path, const ForEach& forEach);
+	std::string& segmentPath(UInt32 segment, std::string& path) const { return String::Assign(path, _rootPath, segment, ".log"); }
 
 	std::string							_rootPath;
 	std::mutex							_mutex;
 	std::deque<shared<Entry>>	_entries;
 	bool								_disableTransaction;
+
+	// accessed by load and the writing thread
+	std::map<std::string, Record>		_index;
+	std::map<UInt32, UInt32>			_segments; // segment => size
+	unique<File>						_pSegment;
+	Buffer								_buffer; // records to write in the current segment
+	UInt32								_segment; // current segment
+	UInt64								_size; // segments size
+	UInt64								_live; // live records size
+	bool								_dirty;
 };
 
 } // namespace Mona
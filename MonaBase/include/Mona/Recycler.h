@@ -0,0 +1,57 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+
+namespace Mona {
+
+/*!
+	Free lists by thread of small memory blocks (<= MAX_SIZE), without lock: a thread which releases more than it allocates (consumer)
+	gives its surplus to a global list where a producer thread takes it back, so a producer/consumer flow stops to allocate once warm */
+struct Recycling : virtual Static {
+	enum { MAX_SIZE = 1024 };
+
+	static void*	Allocate(std::size_t size);
+	static void		Deallocate(void* pBlock, std::size_t size);
+	/*!
+	Count of blocks allocated from the system since the start, doesn't change in steady state */
+	static UInt64	Allocations();
+};
+
+/*!
+	STL allocator on Recycling, with std::allocate_shared object and reference counter share one recycled block:
+	shared<Type> pObject(std::allocate_shared<Type>(Recycler<Type>(), args...)) */
+template<typename Type>
+struct Recycler {
+	typedef Type value_type;
+
+	Recycler() {}
+	template<typename OtherType>
+	Recycler(const Recycler<OtherType>&) {}
+
+	Type*	allocate(std::size_t count) { return (Type*)Recycling::Allocate(count * sizeof(Type)); }
+	void	deallocate(Type* pObject, std::size_t count) { Recycling::Deallocate(pObject, count * sizeof(Type)); }
+
+	template<typename OtherType>
+	bool operator==(const Recycler<OtherType>&) const { return true; }
+	template<typename OtherType>
+	bool operator!=(const Recycler<OtherType>&) const { return false; }
+};
+
+
+} // namespace Mona
@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Exceptions.h"
+#include "Mona/Recycler.h"
 
 namespace Mona {
 
@@ -30,6 +31,11 @@ struct Runner : virtual Object {
 	// If ex is raised, an error is displayed if the operation has returned false
 	// otherwise a warning is displayed
 	virtual bool run(Exception& ex) = 0;
+
+	/*!
+	Build a runner in a recycled memory block shared with its reference counter, no allocation in steady state */
+	template<typename RunnerType, typename ...Args>
+	static shared<RunnerType> Make(Args&&... args) { return std::allocate_shared<RunnerType>(Recycler<RunnerType>(), std::forward<Args>(args)...); }
 };
 
 
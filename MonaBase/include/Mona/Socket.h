@@ -21,6 +21,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/ByteRate.h"
 #include "Mona/Packet.h"
 #include "Mona/Handler.h"
+#include "Mona/Memory.h"
+#include "Mona/Metrics.h"
 #include <deque>
 
 namespace Mona {
@@ -73,6 +75,12 @@ struct Socket : virtual Object, Net::Stats {
 
 	virtual UInt32		available() const;
 	virtual UInt64		queueing() const { return _queueing; }
+	/*!
+	Account sending queue of this socket in pAccount (in addition to the server-wide Memory accounting) */
+	void				setAccount(const shared<Memory::Account>& pAccount);
+	/*!
+	Count bytes and packets of this socket in pTraffic (in addition to the server-wide Metrics counting) */
+	void				setTraffic(const shared<Metrics::Traffic>& pTraffic) { std::atomic_store(&_pTraffic, pTraffic); }
 
 	operator NET_SOCKET() const { return _sockfd; }
 	
@@ -100,6 +108,10 @@ struct Socket : virtual Object, Net::Stats {
 	bool setBroadcast(Exception& ex, bool value) { return setOption(ex, SOL_SOCKET, SO_BROADCAST, value ? 1 : 0); }
 	bool getBroadcast(Exception& ex, bool& value) const { return getOption(ex, SOL_SOCKET, SO_BROADCAST, value); }
 
+	/*!
+	Kernel pacing in bytes/second (Linux, effective on UDP with fq qdisc), fails if unsupported */
+	bool setMaxPacingRate(Exception& ex, UInt32 rate);
+
 	bool setLinger(Exception& ex, bool on, int seconds);
 	bool getLinger(Exception& ex, bool& on, int& seconds) const;
 	
@@ -130,6 +142,9 @@ struct Socket : virtual Object, Net::Stats {
 	Returns size of data sent immediatly (or -1 if error, for TCP socket a SHUTDOWN_SEND is done, so socket will be disconnected) */
 	int			 write(Exception& ex, const Packet& packet, int flags = 0) { return write(ex, packet, SocketAddress::Wildcard(), flags); }
 	int			 write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags = 0);
+	/*!
+	Vectored version of write, packets are sent to peer in one system call (gather writing), what can't be sent is queued */
+	int			 write(Exception& ex, const Packet* packets, UInt32 count, int flags = 0);
 
 	virtual bool flush(Exception& ex);
 
@@ -144,10 +159,14 @@ protected:
 	Socket(NET_SOCKET sockfd, const sockaddr& addr);
 	virtual Socket* newSocket(Exception& ex, NET_SOCKET sockfd, const sockaddr& addr) { return new Socket(sockfd, (sockaddr&)addr); }
 	virtual int		receive(Exception& ex, void* buffer, UInt32 size, int flags, SocketAddress* pAddress);
+	/*!
+	Send to peer in one system call (sendmsg/WSASend) a maximum of SENDVECTOR_MAX packets, returns bytes sent */
+	virtual int		sendVector(Exception& ex, const Packet* packets, UInt32 count, int flags);
+	enum { SENDVECTOR_MAX = 16 };
 
 
-	void send(UInt32 count) { _sendTime = Time::Now(); _sendByteRate += count; }
-	void receive(UInt32 count) { _recvTime = Time::Now(); _recvByteRate += count; }
+	void send(UInt32 count, UInt32 packets = 1);
+	void receive(UInt32 count);
 
 private:
 	void init();
@@ -193,6 +212,8 @@ private:
 	mutable std::mutex			_mutexSending;
 	std::deque<Sending>			_sendings;
 	std::atomic<UInt64>			_queueing;
+	shared<Memory::Account>		_pAccount;
+	shared<Metrics::Traffic>	_pTraffic;
 
 	SocketAddress				_peerAddress;
 	mutable SocketAddress		_address;
@@ -216,6 +237,7 @@ private:
 	UInt16						_threadReceive;
 	std::atomic<UInt32>			_receiving;
 	std::atomic<UInt8>			_reading;
+	std::atomic<UInt8>			_paused; // 1 - paused, 2 - paused and reception held
 	const Handler*				_pHandler;
 	bool						_listening; // no need to protect this variable because listen() have to be called before IOSocket subscription!
 
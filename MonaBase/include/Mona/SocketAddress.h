@@ -102,6 +102,10 @@ struct SocketAddress : private IPAddress, virtual NullableObject {
 	
 	explicit operator bool() const { return port() || !isWildcard(); }
 
+	/*!
+	Hash to key unordered containers by address */
+	struct Hash { std::size_t operator()(const SocketAddress& address) const; };
+
 	// Returns a wildcard IPv4 or IPv6 address (0.0.0.0)
 	static const SocketAddress& Wildcard(IPAddress::Family family = IPAddress::IPv4);
 
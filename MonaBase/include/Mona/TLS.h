@@ -55,6 +55,7 @@ struct TLS : virtual Object {
 		bool flush(Exception& ex);
 	private:
 		int			  receive(Exception& ex, void* buffer, UInt32 size, int flags, SocketAddress* pAddress);
+		int			  sendVector(Exception& ex, const Packet* packets, UInt32 count, int flags);
 		Mona::Socket* newSocket(Exception& ex, NET_SOCKET sockfd, const sockaddr& addr);
 
 
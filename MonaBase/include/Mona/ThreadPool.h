@@ -22,20 +22,57 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 namespace Mona {
 
+/*!
+	Pool of threads where a runner queued with a track always runs on the same thread (ordered with the other runners of the track),
+	and an untracked runner runs on the next thread, or with work-stealing on any idle thread */
 struct ThreadPool : virtual Object {
+	/*!
+	Statistics of a thread queue to diagnose hotspots, latency is the time waited by a runner in queue */
+	struct Stats {
+		Stats() : runners(0), stolen(0), depth(0), maxDepth(0), latency(0), maxLatency(0) {}
+		UInt64	runners; // dequeued
+		UInt64	stolen; // dequeued by an other thread
+		UInt32	depth; // currently queued
+		UInt32	maxDepth;
+		UInt64	latency; // average in microseconds
+		UInt64	maxLatency; // in microseconds
+	};
+
 	/*!
 	If threads==0 use ProcessorCount*2 because gives the better result */
-	ThreadPool(UInt16 threads = 0) : _current(0), _threads(threads ? threads : Thread::ProcessorCount()*2) { _size = UInt16(_threads.size()); }
+	ThreadPool(UInt16 threads = 0);
+	~ThreadPool() { join(); }
 
 	UInt16	threads() const { return _size; }
 
-	void	join() { for (Thread& thread : _threads) thread.stop(); }
+	void	join();
 
+	/*!
+	Work-stealing for untracked runners: a runner queued from a thread of the pool stays on this thread (cache locality),
+	and idle threads steal the runners waiting behind a busy one, tracked runners are never stolen */
+	bool			stealing() const { return _stealing; }
+	ThreadPool&		setStealing(bool value) { _stealing = value; return *this; }
+	/*!
+	Pin the thread i on the CPU cpus[i%cpus.size()] (empty to unpin), applied on thread start so call it before to queue or after a join.
+	With pinning a thread steals in priority the runners of threads on the same NUMA node */
+	ThreadPool&		setAffinity(const std::vector<UInt16>& cpus);
+	/*!
+	Parse a CPU list as "0-3,8,10-11" */
+	bool			setAffinity(Exception& ex, const char* cpus);
+	/*!
+	Stats of the thread queue 'index' (< threads()), 'reset' restarts max and average computations */
+	Stats&			stats(UInt16 index, Stats& stats, bool reset = false) const;
 
 	template<typename RunnerType>
 	bool  queue(Exception& ex, const shared<RunnerType>& pRunner) const {
 		FATAL_CHECK(pRunner);
-		return _threads[_current++%_size].queue(ex, pRunner);
+		if (_stealing) {
+			// stay on the current thread of the pool to keep cache locality, idle threads will steal if need
+			Thread* pThread(Thread::Current(*this));
+			if (pThread)
+				return pThread->queue(ex, pRunner, true);
+		}
+		return _threads[_current++%_size]->queue(ex, pRunner, _stealing);
 	}
 
 	template<typename RunnerType>
@@ -44,21 +81,62 @@ struct ThreadPool : virtual Object {
 		Thread* pThread;
 		if (track > _size) {
 			ex.set<Ex::Intern>("Thread track out of ThreadPool bounds");
-			pThread = &_threads[_current++%_size];
+			pThread = _threads[_current++%_size].get();
 		} else if (!track) {
-			pThread = &_threads[track = (_current++%_size)];
+			pThread = _threads[track = (_current++%_size)].get();
 			++track;
 		} else
-			pThread = &_threads[track - 1];
+			pThread = _threads[track - 1].get();
 		return pThread->queue(ex, pRunner);
 	}
 
 private:
-	struct Thread : virtual Object, ThreadQueue { Thread() : ThreadQueue("ThreadPool") {} };
-
-	mutable std::vector<Thread>	_threads;
+	/*!
+	ThreadQueue to stay compatible with ThreadQueue::Current() callers which requeue on the current thread (as a tracked runner) */
+	struct Thread : ThreadQueue, virtual Object {
+		Thread(const ThreadPool& pool, UInt16 index);
+		~Thread() { stop(); }
+
+		static Thread* Current(const ThreadPool& pool) { return (_PCurrent && &_PCurrent->_pool == &pool) ? _PCurrent : NULL; }
+
+		const UInt16	index;
+		Int32			cpu; // -1 if not pinned
+		Int32			node; // NUMA node of cpu, -1 if unknown
+
+		bool	queue(Exception& ex, const shared<Runner>& pRunner, bool stealable = false);
+		bool	busy() const { return _busy; }
+		/*!
+		Wake up to steal, start the thread if need */
+		bool	wake(Exception& ex);
+		Stats&	stats(Stats& stats, bool reset);
+	private:
+		struct Job {
+			Job() : time(0) {}
+			Job(const shared<Runner>& pRunner, Int64 time) : pRunner(pRunner), time(time) {}
+			shared<Runner>	pRunner;
+			Int64			time;
+		};
+		bool	push(Exception& ex, const shared<Runner>& pRunner) { return queue(ex, pRunner); }
+		bool	run(Exception& ex, const volatile bool& stopping);
+		bool	pop(Job& job, bool stealer = false);
+		bool	steal(Job& job);
+
+		const ThreadPool&	_pool;
+		std::deque<Job, Recycler<Job>>	_runners; // tracked
+		std::deque<Job, Recycler<Job>>	_stealables;
+		std::atomic<bool>	_busy;
+		Stats				_stats;
+		UInt64				_latencies;
+		UInt64				_count;
+		std::mutex			_mutex;
+
+		static thread_local Thread* _PCurrent;
+	};
+
+	std::vector<unique<Thread>>	_threads;
 	mutable std::atomic<UInt16>	_current;
 	UInt16						_size;
+	std::atomic<bool>			_stealing;
 };
 
 
@@ -30,21 +30,17 @@ struct ThreadQueue : Thread, virtual Object {
 	static ThreadQueue*	Current() { return _PCurrent; }
 
 	template<typename RunnerType>
-	bool queue(Exception& ex, const shared<RunnerType>& pRunner) {
-		std::lock_guard<std::mutex> lock(_mutex);
-		if (!start(ex))
-			return false;
-		_runners.emplace_back(pRunner);
-		wakeUp.set();
-		return true;
-	}
+	bool queue(Exception& ex, const shared<RunnerType>& pRunner) { return push(ex, pRunner); }
 
+protected:
+	virtual bool push(Exception& ex, const shared<Runner>& pRunner);
+
+	static thread_local ThreadQueue*	_PCurrent;
 private:
 	bool run(Exception& ex, const volatile bool& stopping);
 
-	std::deque<shared<Runner>>			_runners;
+	std::deque<shared<Runner>, Recycler<shared<Runner>>>	_runners;
 	std::mutex							_mutex;
-	static thread_local ThreadQueue*	_PCurrent;
 };
 
 
@@ -0,0 +1,74 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Thread.h"
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+namespace Mona {
+
+/*!
+	Stall detector of an event loop thread: the watched thread marks its tasks (Handler runners, Timer callbacks)
+	with Watchdog::Task, a task longer than threshold is logged with its name while running and on its end.
+	With sampling, the stack of the stalled thread is logged too (requires backtrace support, glibc or macOS) */
+struct Watchdog : private Thread, virtual Object {
+	/*!
+	Mark a task of the calling thread, without effect if the thread is not watched or already in a task */
+	struct Task : virtual Object {
+		Task(const char* name) : _pWatchdog(_PCurrent) { if (_pWatchdog) begin(name, NULL); }
+		Task(const std::type_info& type) : _pWatchdog(_PCurrent) { if (_pWatchdog) begin(NULL, &type); }
+		~Task() { if (_pWatchdog) end(); }
+	private:
+		void begin(const char* name, const std::type_info* pType);
+		void end();
+
+		Watchdog*	_pWatchdog;
+	};
+
+	Watchdog();
+	~Watchdog() { stop(); }
+
+	/*!
+	Watch the calling thread, threshold in ms */
+	bool start(Exception& ex, UInt32 threshold, bool sampling = false);
+	void stop();
+
+private:
+	bool run(Exception& ex, const volatile bool& stopping);
+	void sample();
+	std::string& name(std::string& buffer) const;
+
+	static thread_local Watchdog* _PCurrent;
+
+	std::atomic<Int64>					_time; // beginning of the running task in microseconds, 0 if idle
+	std::atomic<UInt32>					_task; // count of tasks to report a stall just one time
+	std::atomic<const char*>			_name;
+	std::atomic<const std::type_info*>	_pType;
+
+	UInt32								_threshold;
+	bool								_sampling;
+	std::string							_thread; // name of the watched thread
+#if !defined(_WIN32)
+	pthread_t							_watched;
+#endif
+};
+
+
+} // namespace Mona
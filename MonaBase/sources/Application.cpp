@@ -21,6 +21,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
     #include <signal.h>
 #endif
 #include "Mona/Util.h"
+#include "Mona/IOFile.h"
 #include "Mona/Logs.h"
 
 using namespace std;
@@ -109,6 +110,10 @@ bool Application::init(int argc, const char* argv[]) {
 		Net::SetSendBufferSize(value);
 	setNumber("net.recvBufferSize", Net::GetRecvBufferSize());
 	setNumber("net.sendBufferSize", Net::GetSendBufferSize());
+	bool uring;
+	if (getBoolean("file.uring", uring))
+		IOFile::SetURing(uring);
+	setBoolean("file.uring", IOFile::GetURing());
 
 	// 4 - init logs
 	string logDir(_file.parent());
@@ -16,6 +16,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Buffer.h"
 #include "Mona/Exceptions.h"
+#include "Mona/Memory.h"
 
 using namespace std;
 
@@ -31,6 +32,7 @@ Buffer::Buffer(UInt32 size, const void* data) : _offset(0), _size(size), _capaci
 		return;
 	}
 	_data = _buffer = _Allocator.load()->allocate(_capacity);
+	Memory::Allocate(_capacity);
 	if (data)
 		memcpy(_data,data,size);
 }
@@ -38,8 +40,10 @@ Buffer::Buffer(UInt32 size, const void* data) : _offset(0), _size(size), _capaci
 Buffer::Buffer(void* buffer, UInt32 size) : _offset(0), _data(BIN buffer), _size(size),_capacity(size),_buffer(NULL) {}
 
 Buffer::~Buffer() {
-	if (_buffer && (_capacity+=_offset))
+	if (_buffer && (_capacity+=_offset)) {
 		_Allocator.load()->deallocate(_buffer, _capacity);
+		Memory::Deallocate(_capacity);
+	}
 }
 
 Buffer& Buffer::append(const void* data, UInt32 size) {
@@ -108,6 +112,7 @@ Buffer& Buffer::resize(UInt32 size, bool preserveData) {
 
 	// allocate
 	_data = _Allocator.load()->allocate(_capacity);
+	Memory::Allocate(_capacity);
 
 	 // copy data
 	if (preserveData)
@@ -115,8 +120,10 @@ Buffer& Buffer::resize(UInt32 size, bool preserveData) {
 
 
 	// deallocate if was allocated
-	if (oldCapacity)
+	if (oldCapacity) {
 		_Allocator.load()->deallocate(_buffer, oldCapacity);
+		Memory::Deallocate(oldCapacity);
+	}
 
 	_size = size;
 	_buffer=_data;
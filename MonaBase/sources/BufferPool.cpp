@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/BufferPool.h"
+#include "Mona/Metrics.h"
 
 
 using namespace std;
@@ -22,6 +23,9 @@ using namespace std;
 
 namespace Mona {
 
+static Metrics::Counter _Hits("mona_bufferpool_hits_total", "Buffer allocations served by the pool");
+static Metrics::Counter _Misses("mona_bufferpool_misses_total", "Buffer allocations missing the pool");
+static Metrics::Gauge	_Available("mona_bufferpool_available", "Buffers available in the pool");
 
 BufferPool::BufferPool(const Timer&	timer) : _timer(timer), _minCount(0), _maxSize(0),
 	_onTimer([this](UInt32)->UInt32 {
@@ -31,6 +35,7 @@ BufferPool::BufferPool(const Timer&	timer) : _timer(timer), _minCount(0), _maxSi
 			_minCount = 100;
 		++_minCount;
 
+		_Available -= _buffers.size();
 		// remove useless bigger buffer!
 		while (--_minCount) {
 			auto it(_buffers.end());
@@ -47,6 +52,7 @@ BufferPool::BufferPool(const Timer&	timer) : _timer(timer), _minCount(0), _maxSi
 		}
 		
 		_minCount = _buffers.size();
+		_Available += _minCount;
 		_maxSize = 0;
 		return 10000;
 	}) {
@@ -63,6 +69,7 @@ void BufferPool::clear() {
 	lock_guard<mutex> lock(_mutex);
 	for(const auto& it : _buffers)
 		delete [] it.second;
+	_Available -= _buffers.size();
 	_buffers.clear();
 }
 
@@ -75,17 +82,22 @@ UInt8* BufferPool::allocate(UInt32& size) const {
 
 	if (_buffers.empty()) {
 		_minCount = 0;
+		++_Misses;
 		return new UInt8[size]();
 	}
 	// at less one available here
 	auto itBigger(_buffers.end());
 	--itBigger;
-	if (size > itBigger->first)
+	if (size > itBigger->first) {
+		++_Misses;
 		return new UInt8[size]();
+	}
 
 	size = itBigger->first;
 	UInt8* buffer(itBigger->second);
 	_buffers.erase(itBigger);
+	++_Hits;
+	--_Available;
 	if (_buffers.size() < _minCount)
 		_minCount = _buffers.size();
 	return buffer;
@@ -94,6 +106,7 @@ UInt8* BufferPool::allocate(UInt32& size) const {
 void BufferPool::deallocate(UInt8* buffer, UInt32 size) const {
 	lock_guard<mutex> lock(_mutex);
 	_buffers.emplace(size,buffer);
+	++_Available;
 }
 
 
@@ -0,0 +1,72 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Deflater.h"
+
+using namespace std;
+
+namespace Mona {
+
+
+Deflater::Deflater(Format format, Int8 level) : format(format), level(level), _initialized(false) {
+	memset(&_stream, 0, sizeof(_stream));
+}
+
+Deflater::~Deflater() {
+	if (_initialized)
+		deflateEnd(&_stream);
+}
+
+void Deflater::reset() {
+	if (_initialized)
+		deflateReset(&_stream);
+}
+
+bool Deflater::deflate(Exception& ex, const void* data, UInt32 size, Buffer& buffer, bool end) {
+	if (!_initialized) {
+		int result = deflateInit2(&_stream, level, Z_DEFLATED, format, 8, Z_DEFAULT_STRATEGY);
+		if (result != Z_OK) {
+			ex.set<Ex::Intern>("Deflater initialization, ", zError(result));
+			return false;
+		}
+		_initialized = true;
+	}
+	_stream.next_in = (Bytef*)data;
+	_stream.avail_in = size;
+	UInt32 offset(buffer.size());
+	do {
+		// deflateBound allows usually to compress in one pass
+		UInt32 available(UInt32(deflateBound(&_stream, _stream.avail_in)));
+		buffer.resize(offset + available);
+		_stream.next_out = buffer.data() + offset;
+		_stream.avail_out = available;
+		int result = ::deflate(&_stream, end ? Z_FINISH : Z_NO_FLUSH);
+		offset += available - _stream.avail_out;
+		if (result == Z_STREAM_ERROR) {
+			ex.set<Ex::Intern>("Deflate, ", _stream.msg ? _stream.msg : zError(result));
+			deflateReset(&_stream);
+			buffer.resize(offset);
+			return false;
+		}
+	} while (!_stream.avail_out);
+	buffer.resize(offset);
+	if (end)
+		deflateReset(&_stream); // keep allocations for the next stream
+	return true;
+}
+
+
+} // namespace Mona
@@ -43,7 +43,8 @@ using namespace std;
 
 namespace Mona {
 
-File::File(const Path& path, Mode mode) : _path(path), mode(mode), _decodingTrack(0), _pDevice(NULL), _queueing(0), _loading(0), _loadingTrack(0), _handle(-1) {
+File::File(const Path& path, Mode mode) : _path(path), mode(mode), _decodingTrack(0), _pDevice(NULL), _queueing(0), _loading(0), _loadingTrack(0), _handle(-1),
+	preallocation(0), direct(false), _position(0), _reserved(0), _direct(false) {
 }
 
 File::~File() {
@@ -53,6 +54,8 @@ File::~File() {
 #if defined(_WIN32)
 	CloseHandle((HANDLE)_handle);
 #else
+	if (_reserved > _position)
+		ftruncate(_handle, _position); // release preallocated space beyond the end
 	::close(_handle);
 #endif
 }
@@ -120,6 +123,8 @@ bool File::load(Exception& ex) {
 		struct stat status;
 		::fstat(_handle, &status);
 		_path._pImpl->setAttributes(status.st_mode&S_IFDIR ? 0 : (UInt64)status.st_size, status.st_mtime * 1000ll, UInt8(major(status.st_dev)));
+		if (mode == MODE_APPEND)
+			_reserved = _position = status.st_size;
 		return true;
 	}
 #endif
@@ -199,6 +204,7 @@ bool File::write(Exception& ex, const void* data, UInt32 size) {
 		ex.set<Ex::Intern>("Impossible to write ", _path, " opened in reading mode");
 		return false;
 	}
+	prepareWrite(data, size);
 #if defined(_WIN32)
 	DWORD written;
 	if (!WriteFile((HANDLE)_handle, data, size, &written, NULL))
@@ -214,7 +220,47 @@ bool File::write(Exception& ex, const void* data, UInt32 size) {
 		ex.set<Ex::System::File>("No more disk space to write ", _path, " (size=", size, ")");
 		return false;
 	}
+	_position += size;
 	return true;
 }
 
+void File::prepareWrite(const void* data, UInt32 size) {
+#if defined(__linux__)
+	if (direct) {
+		bool aligned(!((UInt64(data) | size | _position) & (DIRECT_ALIGNMENT - 1)));
+		if (aligned != _direct) {
+			int flags(fcntl(_handle, F_GETFL));
+			if (flags != -1 && fcntl(_handle, F_SETFL, aligned ? (flags | O_DIRECT) : (flags & ~O_DIRECT)) == 0)
+				_direct = aligned;
+			else if (!_direct)
+				direct = false; // unsupported by the file system
+		}
+	}
+	if (preallocation && (_position + size) > _reserved) {
+		UInt64 reserved(_position + size + preallocation);
+		if (fallocate(_handle, FALLOC_FL_KEEP_SIZE, _reserved, reserved - _reserved) == 0)
+			_reserved = reserved;
+		else
+			preallocation = 0; // unsupported by the file system
+	}
+#endif
+}
+
+bool File::sync(Exception& ex) {
+	if (!load(ex))
+		return false;
+#if defined(_WIN32)
+	if (FlushFileBuffers((HANDLE)_handle))
+		return true;
+#elif defined(__APPLE__) || defined(_BSD)
+	if (fsync(_handle) == 0)
+		return true;
+#else
+	if (fdatasync(_handle) == 0)
+		return true;
+#endif
+	ex.set<Ex::System::File>("Impossible to sync ", _path);
+	return false;
+}
+
 } // namespace Mona
@@ -16,6 +16,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 
 #include "Mona/Handler.h"
+#include "Mona/Metrics.h"
+#include "Mona/Watchdog.h"
 #include "Mona/Logs.h"
 
 
@@ -23,6 +25,24 @@ using namespace std;
 
 namespace Mona {
 
+static Metrics::Counter		_Runners("mona_handler_runners_total", "Runners executed by the main thread");
+static Metrics::Gauge		_Depth("mona_handler_depth", "Runners waiting execution by the main thread");
+static Metrics::Histogram	_Latency("mona_handler_latency_microseconds", "Time waited by runners before main thread execution", "", false);
+
+Handler::~Handler() {
+	lock_guard<mutex> lock(_mutex);
+	_Depth -= _runners.size();
+}
+
+void Handler::push(const shared<Runner>& pRunner) const {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_runners.emplace_back(pRunner, Metrics::Now());
+	}
+	++_Depth;
+	_signal.set();
+}
+
 void Handler::queue(const Event<void()>& onResult) const {
 	struct Result : Runner, virtual Object {
 		Result(const Event<void()>& onResult) : _onResult(onResult), Runner(typeof(onResult).c_str()) {}
@@ -30,7 +50,7 @@ void Handler::queue(const Event<void()>& onResult) const {
 	private:
 		Event<void()>	_onResult;
 	};
-	queue(make_shared<Result>(onResult));
+	queue(Runner::Make<Result>(onResult));
 }
 
 UInt32 Handler::flush(UInt32 count) {
@@ -42,11 +62,16 @@ UInt32 Handler::flush(UInt32 count) {
 			lock_guard<mutex> lock(_mutex);
 			if (_runners.empty() || (!all && count--))
 				break;
-			pRunner = move(_runners.front());
+			Job& job(_runners.front());
+			_Latency.record(Metrics::Now() - job.time);
+			pRunner = move(job.pRunner);
 			_runners.pop_front();
 		}
+		--_Depth;
+		++_Runners;
 		Exception ex;
 		Thread::ChangeName newName(pRunner->name);
+		Watchdog::Task task(pRunner->name);
 		AUTO_ERROR(pRunner->run(ex), newName);
 		++done;
 	}
@@ -15,16 +15,361 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/IOFile.h"
+#include "Mona/Logs.h"
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+#define MONA_URING 1
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <unordered_map>
+#endif
+#endif
+#endif
 
 using namespace std;
 
 namespace Mona {
 
-struct IODevice : virtual Object, ThreadQueue { IODevice() : ThreadQueue("IODevice") {} };
+std::atomic<bool> IOFile::_URing(false);
+
+/*!
+Reading or writing operation of a device */
+struct IOAction : Runner, virtual Object {
+	IOAction(const char* name) : Runner(name) {}
+
+	struct Operation {
+		enum Type {
+			TYPE_READ,
+			TYPE_WRITE,
+			TYPE_SYNC
+		};
+		Type	type;
+		int		handle;
+		UInt8*	data;
+		UInt32	size;
+	};
+
+	virtual shared<File> file() = 0;
+	/*!
+	Asynchronous engine, assigns the file operation to do (returns false on error),
+	then the action is completed with the operation result (transfered size or -errno) */
+	virtual bool	prepare(Exception& ex, File& file, Operation& operation) { ex.set<Ex::Intern>(name, " is not a file operation"); return false; }
+	virtual void	complete(Exception& ex, const shared<File>& pFile, int result) = 0;
+};
+
+#if defined(MONA_URING)
+/*!
+io_uring engine of a device, operations are submitted by batch with the same system call which waits completions,
+one operation by file at a time to keep File::read/write behavior (current file position) */
+struct IORing : Thread, virtual Object {
+	enum { ENTRIES = 256 };
+
+	IORing();
+	~IORing();
+
+	bool init(Exception& ex);
+
+	bool queue(Exception& ex, const shared<IOAction>& pAction) {
+		bool signal;
+		{
+			lock_guard<mutex> lock(_mutex);
+			if (!start(ex))
+				return false;
+			signal = _actions.empty(); // else already signaled
+			_actions.emplace_back(pAction);
+		}
+		if (signal)
+			eventfd_write(_event, 1);
+		return true;
+	}
+	void stop() {
+		_ending = true;
+		eventfd_write(_event, 1);
+		Thread::stop();
+		_ending = false;
+	}
+
+private:
+	struct Slot {
+		shared<IOAction>	pAction;
+		shared<File>		pFile;
+	};
+	bool run(Exception& ex, const volatile bool& stopping);
+	/*!
+	Submit the first action of the file which prepares successfully its operation, returns false if none */
+	bool submit(const shared<File>& pFile, deque<shared<IOAction>>& actions);
+	io_uring_sqe& newSQE();
+	UInt8* map(Exception& ex, UInt32 size, UInt64 offset);
+
+	int				_fd;
+	int				_event;
+	eventfd_t		_eventValue;
+	bool			_eventArmed;
+	volatile bool	_ending;
+
+	UInt8*			_maps[3];
+	UInt32			_sizes[3];
+	UInt32*			_sqTail;
+	UInt32*			_sqMask;
+	UInt32*			_sqArray;
+	io_uring_sqe*	_sqes;
+	UInt32*			_cqHead;
+	UInt32*			_cqTail;
+	UInt32*			_cqMask;
+	io_uring_cqe*	_cqes;
+
+	UInt32											_submitting;
+	Slot											_slots[ENTRIES];
+	vector<UInt32>									_free; // free slots
+	unordered_map<File*, deque<shared<IOAction>>>	_files; // files in operation with their waiting actions
+
+	deque<shared<IOAction>>	_actions;
+	mutex					_mutex;
+};
+
+IORing::IORing() : Thread("IORing"), _fd(-1), _event(-1), _eventArmed(false), _ending(false), _submitting(0), _maps(), _sizes() {
+	_free.reserve(ENTRIES - 1);
+	for (UInt32 i = 1; i < ENTRIES; ++i) // one entry reserved to the event reading
+		_free.emplace_back(ENTRIES - i);
+}
+
+IORing::~IORing() {
+	if (_event >= 0) {
+		stop();
+		::close(_event);
+	}
+	for (UInt8 i = 0; i < 3; ++i) {
+		if (_maps[i])
+			munmap(_maps[i], _sizes[i]);
+	}
+	if (_fd >= 0)
+		::close(_fd);
+}
+
+UInt8* IORing::map(Exception& ex, UInt32 size, UInt64 offset) {
+	void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, offset);
+	if (data != MAP_FAILED)
+		return (UInt8*)data;
+	ex.set<Ex::System::Memory>("io_uring mapping, ", strerror(errno));
+	return NULL;
+}
+
+bool IORing::init(Exception& ex) {
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	_fd = syscall(__NR_io_uring_setup, ENTRIES, &params);
+	if (_fd < 0) {
+		ex.set<Ex::Unsupported>("io_uring unavailable, ", strerror(errno));
+		return false;
+	}
+	if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+		ex.set<Ex::Unsupported>("io_uring without current file position support (Linux < 5.6)");
+		return false;
+	}
+	_sizes[0] = params.sq_off.array + params.sq_entries * sizeof(UInt32);
+	_sizes[1] = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		// submission and completion rings in the same mapping
+		if (_sizes[1] > _sizes[0])
+			_sizes[0] = _sizes[1];
+		if (!(_maps[0] = map(ex, _sizes[0], IORING_OFF_SQ_RING)))
+			return false;
+		_sizes[1] = 0;
+	} else if (!(_maps[0] = map(ex, _sizes[0], IORING_OFF_SQ_RING)) || !(_maps[1] = map(ex, _sizes[1], IORING_OFF_CQ_RING)))
+		return false;
+	_sizes[2] = params.sq_entries * sizeof(io_uring_sqe);
+	if (!(_maps[2] = map(ex, _sizes[2], IORING_OFF_SQES)))
+		return false;
+	UInt8* pCQ = _maps[1] ? _maps[1] : _maps[0];
+	_sqTail = (UInt32*)(_maps[0] + params.sq_off.tail);
+	_sqMask = (UInt32*)(_maps[0] + params.sq_off.ring_mask);
+	_sqArray = (UInt32*)(_maps[0] + params.sq_off.array);
+	_sqes = (io_uring_sqe*)_maps[2];
+	_cqHead = (UInt32*)(pCQ + params.cq_off.head);
+	_cqTail = (UInt32*)(pCQ + params.cq_off.tail);
+	_cqMask = (UInt32*)(pCQ + params.cq_off.ring_mask);
+	_cqes = (io_uring_cqe*)(pCQ + params.cq_off.cqes);
+	// eventfd always in reading to wake up the ring on new action
+	if ((_event = eventfd(0, EFD_CLOEXEC)) >= 0)
+		return true;
+	ex.set<Ex::System>("io_uring event, ", strerror(errno));
+	return false;
+}
+
+io_uring_sqe& IORing::newSQE() {
+	// sq_entries >= ENTRIES, and at most ENTRIES operations in progress
+	UInt32 tail(*_sqTail);
+	UInt32 index(tail & *_sqMask);
+	io_uring_sqe& sqe(_sqes[index]);
+	memset(&sqe, 0, sizeof(sqe));
+	_sqArray[index] = index;
+	__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+	++_submitting;
+	return sqe;
+}
+
+bool IORing::submit(const shared<File>& pFile, deque<shared<IOAction>>& actions) {
+	while (!actions.empty()) {
+		shared<IOAction> pAction(move(actions.front()));
+		actions.pop_front();
+		Exception ex;
+		IOAction::Operation operation;
+		if (!pAction->prepare(ex, *pFile, operation)) {
+			pAction->complete(ex, pFile, 0);
+			continue;
+		}
+		UInt32 index(_free.back());
+		_free.pop_back();
+		io_uring_sqe& sqe(newSQE());
+		sqe.fd = operation.handle;
+		sqe.user_data = index;
+		if (operation.type == IOAction::Operation::TYPE_SYNC) {
+			sqe.opcode = IORING_OP_FSYNC;
+			sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+		} else {
+			sqe.opcode = operation.type == IOAction::Operation::TYPE_WRITE ? IORING_OP_WRITE : IORING_OP_READ;
+			sqe.off = UInt64(-1); // current position (or end in append mode)
+			sqe.addr = UInt64(operation.data);
+			sqe.len = operation.size;
+		}
+		_slots[index].pAction = move(pAction);
+		_slots[index].pFile = pFile;
+		return true;
+	}
+	return false;
+}
+
+bool IORing::run(Exception& ex, const volatile bool& stopping) {
+	deque<shared<IOAction>> actions; // waiting a free operation
+	for (;;) {
+		if (!_eventArmed) {
+			io_uring_sqe& sqe(newSQE());
+			sqe.opcode = IORING_OP_READ;
+			sqe.fd = _event;
+			sqe.addr = UInt64(&_eventValue);
+			sqe.len = sizeof(_eventValue);
+			sqe.user_data = ENTRIES;
+			_eventArmed = true;
+		}
+		{
+			lock_guard<mutex> lock(_mutex);
+			if (_actions.empty()) {
+				if ((stopping || _ending) && actions.empty() && _files.empty()) {
+					Thread::stop(); // to set _stop immediatly!
+					return true;
+				}
+			} else {
+				if (actions.empty())
+					actions.swap(_actions);
+				else {
+					move(_actions.begin(), _actions.end(), back_inserter(actions));
+					_actions.clear();
+				}
+			}
+		}
+		while (!actions.empty() && !_free.empty()) {
+			shared<File> pFile(actions.front()->file());
+			if (pFile) {
+				auto result = _files.emplace(piecewise_construct, forward_as_tuple(pFile.get()), forward_as_tuple());
+				result.first->second.emplace_back(move(actions.front()));
+				if (result.second && !submit(pFile, result.first->second)) // else waits the end of the current file operation
+					_files.erase(result.first);
+			}
+			actions.pop_front();
+		}
+
+		int result = syscall(__NR_io_uring_enter, _fd, _submitting, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (result >= 0)
+			_submitting -= result;
+		else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+			ex.set<Ex::System>("io_uring, ", strerror(errno));
+			return false;
+		}
+
+		UInt32 head(*_cqHead);
+		while (head != __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE)) {
+			const io_uring_cqe& cqe(_cqes[head & *_cqMask]);
+			UInt32 index(UInt32(cqe.user_data));
+			result = cqe.res;
+			__atomic_store_n(_cqHead, ++head, __ATOMIC_RELEASE);
+			if (index == ENTRIES) {
+				_eventArmed = false;
+				continue;
+			}
+			Slot& slot(_slots[index]);
+			shared<IOAction> pAction(move(slot.pAction));
+			shared<File> pFile(move(slot.pFile));
+			_free.emplace_back(index);
+			Exception ex;
+			pAction->complete(ex, pFile, result);
+			// next operation of this file
+			auto it = _files.find(pFile.get());
+			if (!submit(pFile, it->second))
+				_files.erase(it);
+		}
+	}
+	return true;
+}
+#endif
+
+struct IODevice : virtual Object, ThreadQueue {
+	IODevice(bool uring) : ThreadQueue("IODevice") {
+		if (!uring)
+			return;
+#if defined(MONA_URING)
+		_pRing.reset(new IORing());
+		Exception ex;
+		if (_pRing->init(ex))
+			return;
+		WARN(ex, ", thread engine used");
+		_pRing.reset();
+#else
+		WARN("io_uring unavailable on this system, thread engine used");
+#endif
+	}
+
+	template<typename ActionType>
+	bool queue(Exception& ex, const shared<ActionType>& pAction) {
+#if defined(MONA_URING)
+		if (_pRing)
+			return _pRing->queue(ex, pAction);
+#endif
+		return ThreadQueue::queue(ex, pAction);
+	}
+
+	bool running() const {
+#if defined(MONA_URING)
+		if (_pRing)
+			return _pRing->running();
+#endif
+		return ThreadQueue::running();
+	}
+	void stop() {
+#if defined(MONA_URING)
+		if (_pRing)
+			_pRing->stop();
+#endif
+		ThreadQueue::stop();
+	}
+
+private:
+#if defined(MONA_URING)
+	unique<IORing> _pRing;
+#endif
+};
 static struct IODevices : virtual Object {
 	IODevice& operator[](UInt8 device) {
+		bool uring(IOFile::GetURing());
+		UInt16 key(uring ? (0x100 | device) : device);
 		lock_guard<mutex> lock(_mutex);
-		return _devices[device];
+		auto it = _devices.lower_bound(key);
+		if (it == _devices.end() || it->first != key)
+			it = _devices.emplace_hint(it, piecewise_construct, forward_as_tuple(key), forward_as_tuple(uring));
+		return it->second;
 	}
 	UInt32 join() {
 		UInt32 count(0);
@@ -37,14 +382,13 @@ static struct IODevices : virtual Object {
 		return count;
 	}
 private:
-	map<UInt8, IODevice> _devices;
-	mutex			     _mutex;
+	map<UInt16, IODevice> _devices;
+	mutex			      _mutex;
 } _IODevices;
 
-struct IOFile::Action : Runner, virtual NullableObject {
-	Action(const char* name, const Handler& handler, const shared<File>& pFile) : loading(false), handler(handler), _weakFile(pFile), Runner(name) {}
+struct IOFile::Action : IOAction, virtual NullableObject {
+	Action(const char* name, const Handler& handler, const shared<File>& pFile) : handler(handler), _weakFile(pFile), IOAction(name) {}
 
-	bool loading;
 	shared<File> file() { return _weakFile.lock(); }
 	virtual operator bool() const { return false; }
 
@@ -71,6 +415,11 @@ struct IOFile::Action : Runner, virtual NullableObject {
 		handle<ErrorHandle>(ex);
 	}
 
+	void complete(Exception& ex, const shared<File>& pFile, int result) {
+		if (ex || !run(ex, pFile, result))
+			onError(ex);
+	}
+
 protected:
 	template<typename HandleType, typename ...Args>
 	void handle(Args&&... args) {
@@ -85,11 +434,10 @@ private:
 			return true;
 		if(!run(ex, pFile))
 			onError(ex);
-		if (loading)
-			--pFile->_loading;
 		return true;
 	}
 	virtual bool run(Exception& ex, const shared<File>& pFile) { return true; }
+	virtual bool run(Exception& ex, const shared<File>& pFile, int result) { return true; }
 
 	weak<File>	_weakFile;
 };
@@ -135,7 +483,6 @@ void IOFile::dispatch(File& file, const shared<Action>& pAction) {
 			shared<Action> _pAction;
 		};
 		++file._loading;
-		pAction->loading = true;
 		if (threadPool.queue(ex, make_shared<Dispatch>(pAction), file._loadingTrack))
 			return;
 		--file._loading;
@@ -201,11 +548,29 @@ void IOFile::read(const shared<File>& pFile, UInt32 size) {
 			shared<Buffer>	_pBuffer;
 			bool   _end;
 		};
+		bool prepare(Exception& ex, File& file, Operation& operation) {
+			if (file.mode) {
+				ex.set<Ex::Intern>("Impossible to read ", file.path(), " opened in writing mode");
+				return false;
+			}
+			_pBuffer.reset(new Buffer(_size));
+			operation.type = Operation::TYPE_READ;
+			operation.handle = int(file._handle);
+			operation.data = _pBuffer->data();
+			operation.size = _size;
+			return true;
+		}
 		bool run(Exception& ex, const shared<File>& pFile) {
-			shared<Buffer>	pBuffer(new Buffer(_size));
-			int size = pFile->read(ex, pBuffer->data(), pBuffer->size());
-			if (size < 0)
+			_pBuffer.reset(new Buffer(_size));
+			int size = pFile->read(ex, _pBuffer->data(), _size);
+			return size >= 0 && run(ex, pFile, size);
+		}
+		bool run(Exception& ex, const shared<File>& pFile, int size) {
+			if (size < 0) {
+				ex.set<Ex::System::File>("Impossible to read ", pFile->path(), " (size=", _size, "), ", strerror(-size));
 				return false;
+			}
+			shared<Buffer> pBuffer(move(_pBuffer));
 			pBuffer->resize(size);
 			bool end = UInt32(size) < _size;
 			if (pFile->pDecoder) {
@@ -235,6 +600,7 @@ void IOFile::read(const shared<File>& pFile, UInt32 size) {
 			return true;
 		}
 		UInt32				_size;
+		shared<Buffer>		_pBuffer;
 		const ThreadPool&	_threadPool;
 	};
 	if(size) // useless if 0 => to allows to garantee a right value to end param too!
@@ -253,6 +619,18 @@ void IOFile::write(const shared<File>& pFile, const Packet& packet) {
 		private:
 			void handle(File& file) { file.onFlush(); }
 		};
+		bool prepare(Exception& ex, File& file, Operation& operation) {
+			if (!file.mode) {
+				ex.set<Ex::Intern>("Impossible to write ", file.path(), " opened in reading mode");
+				return false;
+			}
+			file.prepareWrite(_packet.data(), _packet.size());
+			operation.type = Operation::TYPE_WRITE;
+			operation.handle = int(file._handle);
+			operation.data = BIN _packet.data();
+			operation.size = _packet.size();
+			return true;
+		}
 		bool run(Exception& ex, const shared<File>& pFile) {
 			_flushing = _flushing && (pFile->_queueing -= _packet.size())<= 0xFFFF;
 			if (!pFile->write(ex, _packet.data(), _packet.size()))
@@ -261,6 +639,21 @@ void IOFile::write(const shared<File>& pFile, const Packet& packet) {
 				handle<Handle>();
 			return true;
 		}
+		bool run(Exception& ex, const shared<File>& pFile, int written) {
+			_flushing = _flushing && (pFile->_queueing -= _packet.size()) <= 0xFFFF;
+			if (written < 0) {
+				ex.set<Ex::System::File>("Impossible to write ", pFile->path(), " (size=", _packet.size(), "), ", strerror(-written));
+				return false;
+			}
+			if (UInt32(written) < _packet.size()) {
+				ex.set<Ex::System::File>("No more disk space to write ", pFile->path(), " (size=", _packet.size(), ")");
+				return false;
+			}
+			pFile->_position += written;
+			if (_flushing)
+				handle<Handle>();
+			return true;
+		}
 		Packet		 _packet;
 		shared<File> _pFile; // maintain alive, Write operation must be reliable!
 		bool		 _flushing;
@@ -269,5 +662,27 @@ void IOFile::write(const shared<File>& pFile, const Packet& packet) {
 		dispatch(*pFile, make_shared<WriteFile>(handler, pFile, packet));
 }
 
+void IOFile::sync(const shared<File>& pFile) {
+	struct SyncFile : Action {
+		SyncFile(const Handler& handler, const shared<File>& pFile) : _pFile(pFile), Action("SyncFile", handler, pFile) {}
+		operator bool() const { return true; }
+	private:
+		bool prepare(Exception& ex, File& file, Operation& operation) {
+			operation.type = Operation::TYPE_SYNC;
+			operation.handle = int(file._handle);
+			return true;
+		}
+		bool run(Exception& ex, const shared<File>& pFile) { return pFile->sync(ex); }
+		bool run(Exception& ex, const shared<File>& pFile, int result) {
+			if (result >= 0)
+				return true;
+			ex.set<Ex::System::File>("Impossible to sync ", pFile->path(), ", ", strerror(-result));
+			return false;
+		}
+		shared<File> _pFile; // maintain alive, as writing operation
+	};
+	dispatch(*pFile, make_shared<SyncFile>(handler, pFile));
+}
+
 
 } // namespace Mona
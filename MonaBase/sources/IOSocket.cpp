@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/IOSocket.h"
+#include "Mona/Metrics.h"
 #if defined(_BSD)
     #include <sys/types.h>
     #include <sys/event.h>
@@ -36,6 +37,9 @@ using namespace std;
 
 namespace Mona {
 
+static Metrics::Counter _Polls("mona_iosocket_polls_total", "Wake-ups of socket polling threads");
+static Metrics::Counter _Events("mona_iosocket_events_total", "Socket events dispatched by polling threads");
+
 struct IOSocket::Action : Runner, virtual Object {
 	template<typename ActionType>
 	static void Run(const ThreadPool& threadPool, const shared<ActionType>& pAction) {
@@ -77,7 +81,7 @@ protected:
 
 	template<typename HandleType, typename ...Args>
 	void handle(const shared<Socket>& pSocket, Args&&... args) {
-		_handler.queue(make_shared<HandleType>(name, pSocket, _ex, std::forward<Args>(args)...));
+		_handler.queue(Runner::Make<HandleType>(name, pSocket, _ex, std::forward<Args>(args)...));
 		_ex = NULL;
 	}
 
@@ -263,6 +267,20 @@ void IOSocket::unsubscribe(shared<Socket>& pSocket) {
 }
 
 
+void IOSocket::pause(const shared<Socket>& pSocket) {
+	UInt8 running(0);
+	pSocket->_paused.compare_exchange_strong(running, 1);
+}
+
+void IOSocket::resume(const shared<Socket>& pSocket) {
+	if (pSocket->_paused.exchange(0) < 2)
+		return;
+	// reception held => rearm
+	--pSocket->_reading;
+	read(pSocket, 0);
+}
+
+
 struct IOSocket::Send : IOSocket::Action {
 	Send(int error, const shared<Socket>& pSocket) : Action("SocketSend", error, pSocket) {}
 
@@ -293,7 +311,7 @@ void IOSocket::write(const shared<Socket>& pSocket, int error) {
 	if (pSocket->_firstWritable)
 		pSocket->_firstWritable = false;
 #endif
-	Action::Run(threadPool, make_shared<Send>(error, pSocket));
+	Action::Run(threadPool, Runner::Make<Send>(error, pSocket));
 }
 
 void IOSocket::read(const shared<Socket>& pSocket, int error) {
@@ -325,7 +343,7 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 					if (receiving < Socket::BACKLOG_MAX) {
 						// REARM
 						Exception ex;
-						if (!_pThread->queue(ex, make_shared<Accept>(0, pSocket)))
+						if (!_pThread->queue(ex, Runner::Make<Accept>(0, pSocket)))
 							pSocket->onError(ex);
 					} else
 						--pSocket->_reading;
@@ -347,7 +365,7 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 			}
 		};
 
-		return Action::Run(threadPool, make_shared<Accept>(error, pSocket), pSocket->_threadReceive);
+		return Action::Run(threadPool, Runner::Make<Accept>(error, pSocket), pSocket->_threadReceive);
 	}
 
 
@@ -374,7 +392,7 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 				if(receiving < pSocket->recvBufferSize()) {
 					// REARM
 					Exception ex;
-					if (!_pThread->queue(ex, make_shared<Receive>(0, pSocket)))
+					if (!_pThread->queue(ex, Runner::Make<Receive>(0, pSocket)))
 						pSocket->onError(ex);
 				} else
 					--pSocket->_reading;
@@ -384,15 +402,30 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 			ThreadQueue*		_pThread;
 		};
 
+		/*!
+		Returns true if reception is held by a pause, resume will rearm it */
+		static bool Hold(const shared<Socket>& pSocket) {
+			if (!pSocket->_paused)
+				return false;
+			++pSocket->_reading;
+			UInt8 paused(1);
+			if (pSocket->_paused.compare_exchange_strong(paused, 2))
+				return true;
+			--pSocket->_reading; // resumed meanwhile
+			return false;
+		}
+
 		bool process(Exception& ex, const shared<Socket>& pSocket) {
 			if (!pSocket->_reading--) // me and something else! useless!
 				return true;
 			UInt32 available = pSocket->available();
 			bool stop(false);
 			while (!stop) {
+				if (Hold(pSocket))
+					return true;
 				if (!available) // always get something (maybe a new reception has been gotten since the last pSocket->available() call)
 					available = 2048; // in UDP allows to avoid a NET_EMSGSIZE error (where packet is lost!), and 2048 to be greater than max possible MTU (~1500 bytes)
-				shared<Buffer>	pBuffer(new Buffer(available));
+				shared<Buffer>	pBuffer(allocate_shared<Buffer>(Recycler<Buffer>(), available));
 				SocketAddress	address;
 				bool queueing(pSocket->queueing() ? true : false);
 				int received = pSocket->receive(ex, pBuffer->data(), available, 0, &address);
@@ -434,7 +467,7 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 		}
 	};
 
-	Action::Run(threadPool, make_shared<Receive>(error, pSocket), pSocket->_threadReceive);
+	Action::Run(threadPool, Runner::Make<Receive>(error, pSocket), pSocket->_threadReceive);
 }
 
 void IOSocket::close(const shared<Socket>& pSocket, int error) {
@@ -458,7 +491,7 @@ void IOSocket::close(const shared<Socket>& pSocket, int error) {
 			return true;
 		}
 	};
-	Action::Run(threadPool, make_shared<Close>(error, pSocket), pSocket->_threadReceive);
+	Action::Run(threadPool, Runner::Make<Close>(error, pSocket), pSocket->_threadReceive);
 }
 
 
@@ -556,6 +589,8 @@ bool IOSocket::run(Exception& ex, const volatile bool& stopping) {
 		if (!pSocket)
 			continue; // socket error
 
+		++_Polls;
+		++_Events;
 		UInt32 event(WSAGETSELECTEVENT(msg.lParam));
 		// Map to display event string when need
 		/*static map<UInt32, const char*> events({
@@ -600,6 +635,8 @@ bool IOSocket::run(Exception& ex, const volatile bool& stopping) {
 				continue;
 			break;
 		}
+		++_Polls;
+		_Events += result;
 
 		// for each ready socket
 		for(i=0;i<result;++i) {
@@ -637,7 +674,7 @@ bool IOSocket::run(Exception& ex, const volatile bool& stopping) {
 			else if (event.filter==EVFILT_WRITE)
 				write(pSocket, error);
 			else if (event.flags&EV_ERROR) // on few unix system we can get an error without anything else
-				Action::Run(threadPool, make_shared<Action>("SocketError", error, pSocket), pSocket->_threadReceive);
+				Action::Run(threadPool, Runner::Make<Action>("SocketError", error, pSocket), pSocket->_threadReceive);
 
 #else
 			epoll_event& event(events[i]);
@@ -678,7 +715,7 @@ bool IOSocket::run(Exception& ex, const volatile bool& stopping) {
 			} else if (event.events&EPOLLOUT)
 				write(pSocket, error);
 			else if (event.events&EPOLLERR) // on few unix system we can get an error without anything else
-				Action::Run(threadPool, make_shared<Action>("SocketError", error, pSocket), pSocket->_threadReceive);
+				Action::Run(threadPool, Runner::Make<Action>("SocketError", error, pSocket), pSocket->_threadReceive);
 #endif
 		}
 
@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/String.h"
 #include "Mona/DNS.h"
 #include "Mona/Util.h"
+#include "Mona/Recycler.h"
 #if defined(_WIN32)
 #include <Iphlpapi.h>
 #elif !defined(__ANDROID__)
@@ -584,7 +585,7 @@ IPAddress::IPAddress(const IPAddress& other, UInt16 port) : _pIPAddress(other._p
 IPAddress::IPAddress(const in_addr& addr) : _pIPAddress(new IPv4Impl(addr)) {}
 IPAddress::IPAddress(const in6_addr& addr, UInt32 scope) : _pIPAddress(new IPv6Impl(addr, scope)) {}
 
-IPAddress::IPAddress(const sockaddr& addr) : _pIPAddress(IsIPv4Sock(addr) ? (IPImpl*)new IPv4Impl(addr) : (IPImpl*)new IPv6Impl(addr)) {}
+IPAddress::IPAddress(const sockaddr& addr) { set(addr); }
 
 void IPAddress::setPort(UInt16 port) {
 	if (_pIPAddress->setPort(port))
@@ -601,7 +602,11 @@ IPAddress& IPAddress::reset() {
 }
 
 IPAddress& IPAddress::set(const sockaddr& addr) {
-	_pIPAddress.reset(IsIPv4Sock(addr) ? (IPImpl*)new IPv4Impl(addr) : (IPImpl*)new IPv6Impl(addr));
+	// address of each received packet, built in recycled memory
+	if (IsIPv4Sock(addr))
+		_pIPAddress = allocate_shared<IPv4Impl>(Recycler<IPv4Impl>(), addr);
+	else
+		_pIPAddress = allocate_shared<IPv6Impl>(Recycler<IPv6Impl>(), addr);
 	return *this;
 }
 
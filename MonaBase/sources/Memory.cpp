@@ -0,0 +1,67 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Memory.h"
+
+
+using namespace std;
+
+
+namespace Mona {
+
+atomic<UInt64> Memory::_Buffered(0);
+atomic<UInt64> Memory::_Queueing(0);
+atomic<UInt64> Memory::_Low(0);
+atomic<UInt64> Memory::_High(0);
+
+static Metrics::Gauge _BufferedGauge("mona_memory_buffered_bytes", "Bytes allocated by living buffers", "", []() { return Int64(Memory::Buffered()); });
+static Metrics::Gauge _QueueingGauge("mona_memory_queueing_bytes", "Bytes waiting in socket sending queues", "", []() { return Int64(Memory::Queueing()); });
+static Metrics::Gauge _PressureGauge("mona_memory_pressure", "Memory pressure level, 0 = none, 1 = low, 2 = high", "", []() { return Int64(Memory::GetPressure()); });
+
+Memory::Account::Account(const char* name) : name(name), _queueing(0),
+	_gauge("mona_protocol_queueing_bytes", "Bytes waiting in sending queues by protocol", Metrics::Label("protocol", name), [this]() { return Int64(_queueing.load()); }) {
+}
+
+void Memory::SetWatermarks(UInt64 low, UInt64 high) {
+	if (high && low > high)
+		low = high;
+	_Low = low;
+	_High = high;
+}
+
+Memory::Pressure Memory::GetPressure() {
+	UInt64 used(_Buffered);
+	UInt64 watermark(_High);
+	if (watermark && used >= watermark)
+		return PRESSURE_HIGH;
+	watermark = _Low;
+	return watermark && used >= watermark ? PRESSURE_LOW : PRESSURE_NONE;
+}
+
+void Memory::Queue(Account* pAccount, UInt64 size) {
+	_Queueing += size;
+	if (pAccount)
+		pAccount->_queueing += size;
+}
+
+void Memory::Unqueue(Account* pAccount, UInt64 size) {
+	_Queueing -= size;
+	if (pAccount)
+		pAccount->_queueing -= size;
+}
+
+
+} // namespace Mona
@@ -0,0 +1,239 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Metrics.h"
+#include "Mona/String.h"
+#include <chrono>
+#include <mutex>
+#include <set>
+
+
+using namespace std;
+
+
+namespace Mona {
+
+namespace {
+
+struct Less {
+	bool operator()(const Metrics::Metric* pA, const Metrics::Metric* pB) const {
+		int result(strcmp(pA->name, pB->name));
+		return result ? result < 0 : pA < pB; // same name consecutive to write HELP and TYPE once
+	}
+};
+
+struct Registry {
+	std::mutex							mutex;
+	std::set<const Metrics::Metric*, Less>	metrics;
+
+	static Registry& Get() {
+		static Registry& Instance(*new Registry()); // never deleted to stay valid for static metrics destruction
+		return Instance;
+	}
+};
+
+atomic<UInt8> _Shards(0);
+
+}
+
+
+Metrics::Metric::Metric(const char* type, const char* name, const char* help, string&& labels) : type(type), name(name), help(help), labels(move(labels)) {
+	Registry& registry(Registry::Get());
+	lock_guard<mutex> lock(registry.mutex);
+	registry.metrics.emplace(this);
+}
+
+Metrics::Metric::~Metric() {
+	Registry& registry(Registry::Get());
+	lock_guard<mutex> lock(registry.mutex);
+	registry.metrics.erase(this);
+}
+
+static string& WriteName(string& buffer, const char* name, const char* suffix, const string& labels, const char* le = NULL) {
+	buffer.append(name).append(suffix);
+	if (labels.empty() && !le)
+		return buffer += ' ';
+	buffer += '{';
+	buffer += labels;
+	if (le) {
+		if (!labels.empty())
+			buffer += ',';
+		String::Append(buffer, "le=\"", le, '"');
+	}
+	return buffer.append("} ");
+}
+
+
+UInt64 Metrics::Counter::value() const {
+	UInt64 value(0);
+	for (const Cell& cell : _shards)
+		value += cell.value.load(memory_order_relaxed);
+	return value;
+}
+
+void Metrics::Counter::write(string& buffer) const {
+	String::Append(WriteName(buffer, name, "", labels), value(), '\n');
+}
+
+void Metrics::Gauge::write(string& buffer) const {
+	String::Append(WriteName(buffer, name, "", labels), value(), '\n');
+}
+
+
+Metrics::Histogram::Histogram(const char* name, const char* help, string&& labels, bool sharded) : Metric("histogram", name, help, move(labels)),
+	_shards(new Shard[sharded ? SHARDS : 1]), _count(sharded ? SHARDS : 1) {
+}
+
+Metrics::Histogram::~Histogram() {
+	delete [] _shards;
+}
+
+UInt16 Metrics::Histogram::Index(UInt64 value) {
+	// upper-inclusive buckets to get power of 2 upper bounds: 0, 1, 2, 3, 4, ]4-5], ]5-6], ]6-7], ]7-8], ]8-10] ...
+	if (value <= 4)
+		return UInt16(value);
+	--value;
+	UInt8 power(63);
+	while (!(value >> power))
+		--power;
+	return 1 + (power - 1) * 4 + ((value >> (power - 2)) & 3);
+}
+
+UInt64 Metrics::Histogram::UpperBound(UInt16 index) {
+	if (index <= 4)
+		return index;
+	--index;
+	UInt8 power(index / 4 + 1);
+	return UInt64(4 + (index % 4) + 1) << (power - 2);
+}
+
+void Metrics::Histogram::record(UInt64 value) {
+	Shard& shard(_shards[_count > 1 ? Metrics::Shard() : 0]);
+	shard.counts[Index(value)].fetch_add(1, memory_order_relaxed);
+	shard.sum.fetch_add(value, memory_order_relaxed);
+}
+
+void Metrics::Histogram::buckets(UInt64 (&counts)[BUCKETS]) const {
+	memset(counts, 0, sizeof(counts));
+	for (UInt8 i = 0; i < _count; ++i) {
+		for (UInt16 j = 0; j < BUCKETS; ++j)
+			counts[j] += _shards[i].counts[j].load(memory_order_relaxed);
+	}
+}
+
+UInt64 Metrics::Histogram::count() const {
+	UInt64 counts[BUCKETS];
+	buckets(counts);
+	UInt64 count(0);
+	for (UInt64 value : counts)
+		count += value;
+	return count;
+}
+
+UInt64 Metrics::Histogram::sum() const {
+	UInt64 sum(0);
+	for (UInt8 i = 0; i < _count; ++i)
+		sum += _shards[i].sum.load(memory_order_relaxed);
+	return sum;
+}
+
+UInt64 Metrics::Histogram::quantile(double quantile) const {
+	UInt64 counts[BUCKETS];
+	buckets(counts);
+	UInt64 count(0);
+	for (UInt64 value : counts)
+		count += value;
+	if (!count)
+		return 0;
+	UInt64 rank(UInt64(quantile * count + 0.5));
+	if (!rank)
+		rank = 1;
+	count = 0;
+	for (UInt16 i = 0; i < BUCKETS; ++i) {
+		if ((count += counts[i]) >= rank)
+			return UpperBound(i);
+	}
+	return UpperBound(BUCKETS - 1);
+}
+
+void Metrics::Histogram::write(string& buffer) const {
+	UInt64 counts[BUCKETS];
+	buckets(counts);
+	UInt64 count(0);
+	UInt16 index(0);
+	string le;
+	for (UInt8 power = 0; power <= MAX_POWER; ++power) {
+		UInt64 bound(UInt64(1) << power);
+		while (UpperBound(index) <= bound)
+			count += counts[index++];
+		String::Append(WriteName(buffer, name, "_bucket", labels, String::Assign(le, bound).c_str()), count, '\n');
+	}
+	while (index < BUCKETS)
+		count += counts[index++];
+	String::Append(WriteName(buffer, name, "_bucket", labels, "+Inf"), count, '\n');
+	String::Append(WriteName(buffer, name, "_sum", labels), sum(), '\n');
+	String::Append(WriteName(buffer, name, "_count", labels), count, '\n');
+}
+
+
+Metrics::Traffic::Traffic(const string& labels) :
+	sent("mona_sent_bytes_total", "Bytes sent by sockets", string(labels)),
+	sentPackets("mona_sent_packets_total", "Packets sent by sockets", string(labels)),
+	received("mona_received_bytes_total", "Bytes received by sockets", string(labels)),
+	receivedPackets("mona_received_packets_total", "Packets received by sockets", string(labels)) {
+}
+
+
+Int64 Metrics::Now() {
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+string Metrics::Label(const char* key, const string& value) {
+	string label(key);
+	label.append("=\"");
+	for (char c : value) {
+		if (c == '\\' || c == '"')
+			label += '\\';
+		else if (c == '\n') {
+			label.append("\\n");
+			continue;
+		}
+		label += c;
+	}
+	return label += '"';
+}
+
+UInt8 Metrics::Shard() {
+	static thread_local UInt8 Shard(_Shards++ % SHARDS);
+	return Shard;
+}
+
+string& Metrics::Write(string& buffer) {
+	Registry& registry(Registry::Get());
+	lock_guard<mutex> lock(registry.mutex);
+	const char* name(NULL);
+	for (const Metric* pMetric : registry.metrics) {
+		if (!name || strcmp(name, pMetric->name) != 0) {
+			name = pMetric->name;
+			String::Append(buffer, "# HELP ", name, ' ', pMetric->help, "\n# TYPE ", name, ' ', pMetric->type, '\n');
+		}
+		pMetric->write(buffer);
+	}
+	return buffer;
+}
+
+
+} // namespace Mona
@@ -16,6 +16,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Packet.h"
 #include "Mona/Exceptions.h"
+#include "Mona/Recycler.h"
 
 using namespace std;
 
@@ -49,11 +50,38 @@ Packet Packet::operator-(UInt32 count) const {
 	return Packet(*this, _data, _size - count);
 }
 
+namespace {
+/*!
+Copy of small data with its reference counter in one recycled block */
+template<UInt32 CAPACITY>
+struct Bytes : Binary, virtual Object {
+	Bytes(const UInt8* data, UInt32 size) : _size(size) { memcpy(_data, data, size); }
+	const UInt8*	data() const { return _data; }
+	UInt32			size() const { return _size; }
+private:
+	UInt32	_size;
+	UInt8	_data[CAPACITY];
+};
+
+template<UInt32 CAPACITY>
+shared<const Binary> Copy(const UInt8* data, UInt32 size) {
+	return allocate_shared<Bytes<CAPACITY>>(Recycler<Bytes<CAPACITY>>(), data, size);
+}
+}
+
 const shared<const Binary>& Packet::bufferize() const {
 	if (_data && !*_ppBuffer) { // if has data, and _ppBuffer is empty (no bufferized) => bufferize!
 		_reference = false;
-		_ppBuffer = new shared<const Binary>(new Buffer(_size, _data));
-		_data = (*_ppBuffer)->data(); // fix new data address
+		if (_size <= 64) // acks, AMF headers...
+			_pBuffer = Copy<64>(_data, _size);
+		else if (_size <= 256)
+			_pBuffer = Copy<256>(_data, _size);
+		else if (_size <= 896) // stay under Recycling::MAX_SIZE with reference counter
+			_pBuffer = Copy<896>(_data, _size);
+		else
+			_pBuffer = allocate_shared<Buffer>(Recycler<Buffer>(), _size, _data);
+		_ppBuffer = &_pBuffer;
+		_data = _pBuffer->data(); // fix new data address
 	}
 	return *_ppBuffer;
 }
@@ -61,19 +89,19 @@ const shared<const Binary>& Packet::bufferize() const {
 Packet& Packet::set(const Packet&& packet) {
 	if (!packet.data()) // if size==0 the normal behavior is required to get the same data address
 		return set(NULL, 0);
-	if (!_reference)
-		delete _ppBuffer;
-	else
-		_reference = false;
-	_ppBuffer = new shared<const Binary>(packet.bufferize());
+	_reference = false;
+	_pBuffer = packet.bufferize();
+	_ppBuffer = &_pBuffer;
 	_data = packet._data;
 	_size = packet._size;
 	return *this;
 }
 
 Packet& Packet::set(const Packet& packet) {
+	if (&packet == this)
+		return *this;
 	if (!_reference) {
-		delete _ppBuffer;
+		_pBuffer.reset();
 		_reference = true;
 	}
 	_ppBuffer = packet._ppBuffer;
@@ -87,7 +115,7 @@ Packet& Packet::set(const shared<const Binary>& pBuffer) {
 	if (!pBuffer || !pBuffer->data())  // if pBuffer->size==0 the normal behavior is required to get the same data address
 		return set(NULL, 0);
 	if (!_reference) {
-		delete _ppBuffer;
+		_pBuffer.reset();
 		_reference = true;
 	}
 	_ppBuffer = &pBuffer;
@@ -98,7 +126,7 @@ Packet& Packet::set(const shared<const Binary>& pBuffer) {
 
 Packet& Packet::set(const void* data, UInt32 size) {
 	if (!_reference) {
-		delete _ppBuffer;
+		_pBuffer.reset();
 		_reference = true;
 	}
 	_ppBuffer = &Null().buffer();
@@ -17,22 +17,105 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Parameters.h"
 #include "Mona/String.h"
 #include "Mona/Exceptions.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
 
 using namespace std;
 
 namespace Mona {
 
+/*!
+Lowercase copy of a key, on the stack when short */
+struct LowerKey {
+	LowerKey(const string& key) : size(key.size()) {
+		char* lower(size < sizeof(_buffer) ? _buffer : &_string.assign(key)[0]);
+		for (UInt32 i = 0; i < size; ++i) {
+			char c(key[i]);
+			lower[i] = (c >= 'A' && c <= 'Z') ? (c - ('A' - 'a')) : c;
+		}
+		lower[size] = 0;
+		value = lower;
+	}
+	const char*		value;
+	const UInt32	size;
+private:
+	char	_buffer[64];
+	string	_string;
+};
+
+/*!
+Keys are interned to be shared between instances, limited to not grow indefinitely with keys received (HTTP headers for example) */
+static const char* Intern(const char* key, UInt32 size) {
+	static mutex					Mutex;
+	static unordered_set<string>	Keys;
+	string value(key, size);
+	lock_guard<mutex> lock(Mutex);
+	const auto& it = Keys.find(value); // find before to not allocate a node for an existing key
+	if (it != Keys.end())
+		return it->c_str();
+	if (Keys.size() >= 0x2000)
+		return NULL;
+	return Keys.emplace(move(value)).first->c_str();
+}
+
+Parameters::Entry::Entry(const string& key, const char* lowerKey, UInt32 size) : first(key), _cache(0), _integer(0), _decimal(0) {
+	_key = Intern(lowerKey, size);
+	if (!_key)
+		_key = _ownKey.assign(lowerKey, size).c_str();
+}
+
+UInt8 Parameters::Entry::parseNumber(UInt64& integer, double& decimal) const {
+	integer = 0;
+	decimal = 0;
+	long double number;
+	if (!String::ToNumber(second, number))
+		return CACHE_NUMBER;
+	decimal = double(number);
+	// integer is parsed digit by digit, long double can have just the precision of a double (MSVC)
+	const char* cur(second.c_str());
+	while (iscntrl(*cur) || *cur == ' ')
+		++cur;
+	UInt8 cache(CACHE_NUMBER | CACHE_IS_NUMBER | CACHE_IS_INTEGER);
+	if (*cur == '-') {
+		cache |= CACHE_IS_NEGATIVE;
+		++cur;
+	}
+	for (; isdigit(*cur); ++cur) {
+		UInt8 digit(*cur - '0');
+		if (integer > (std::numeric_limits<UInt64>::max() - digit) / 10)
+			break; // overflow
+		integer = integer * 10 + digit;
+	}
+	if (*cur) {
+		// decimal or too large
+		integer = 0;
+		cache &= ~(CACHE_IS_INTEGER | CACHE_IS_NEGATIVE);
+	}
+	return cache;
+}
+
+bool Parameters::Entry::toBoolean() const {
+	UInt8 cache(_cache);
+	if (!(cache & CACHE_BOOLEAN)) {
+		cache = String::IsFalse(second) ? CACHE_BOOLEAN : (CACHE_BOOLEAN | CACHE_IS_TRUE);
+		_cache |= cache;
+	}
+	return (cache & CACHE_IS_TRUE) ? true : false;
+}
+
 Parameters& Parameters::operator=(Parameters&& other) {
 	if (!other.count()) {
 		clear();
 		return *this;
 	}
 	// clear self!
-	_pMap.reset();
+	_entries.clear();
 	onParamClear();
 	// move data
-	_pMap = std::move(other._pMap);
+	_entries = std::move(other._entries);
 	// clear other
+	other._entries.clear();
 	other.onParamClear();
 	// onChange!
 	for (auto& it : *this)
@@ -40,12 +123,47 @@ Parameters& Parameters::operator=(Parameters&& other) {
 	return *this;
 }
 
+static vector<unique<Parameters::Entry>>::const_iterator LowerBound(const vector<unique<Parameters::Entry>>& entries, const char* lowerKey) {
+	return lower_bound(entries.begin(), entries.end(), lowerKey, [](const unique<Parameters::Entry>& pEntry, const char* key) {
+		return strcmp(pEntry->key(), key) < 0;
+	});
+}
+
+vector<unique<Parameters::Entry>>::const_iterator Parameters::lowerBound(const string& key) const {
+	return LowerBound(_entries, LowerKey(key).value);
+}
+
+const Parameters::Entry* Parameters::find(const string& key) const {
+	LowerKey lower(key);
+	// binary search by hand, shorter than lower_bound for the few entries expected
+	UInt32 low(0), high(_entries.size());
+	while (low < high) {
+		UInt32 middle((low + high) >> 1);
+		const Entry& entry(*_entries[middle]);
+		int result = strcmp(entry._key, lower.value);
+		if (!result)
+			return &entry;
+		if (result < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return NULL;
+}
+
+Parameters::Entry& Parameters::entry(const string& key) {
+	LowerKey lower(key);
+	auto it = LowerBound(_entries, lower.value);
+	if (it != _entries.end() && strcmp((*it)->_key, lower.value) == 0)
+		return **it;
+	return **_entries.emplace(it, new Entry(key, lower.value, lower.size));
+}
+
 Parameters::ForEach Parameters::band(const std::string& prefix) {
-	if (!_pMap)
-		return ForEach();
-	string end(prefix);
-	end.back() = prefix.back() + 1;
-	return ForEach(_pMap->lower_bound(prefix), _pMap->lower_bound(end));
+	LowerKey lower(prefix);
+	string end(lower.value, lower.size);
+	end.back() = end.back() + 1;
+	return ForEach(LowerBound(_entries, lower.value), LowerBound(_entries, end.c_str()));
 }
 
 bool Parameters::getString(const string& key, std::string& value) const {
@@ -62,7 +180,12 @@ const char* Parameters::getString(const string& key, const char* defaultValue) c
 }
 
 bool Parameters::getBoolean(const string& key, bool& value) const {
-	const char* temp = getParameter(key);
+	const Entry* pEntry(find(key));
+	if (pEntry) {
+		value = pEntry->toBoolean();
+		return true;
+	}
+	const char* temp = onParamUnfound(key);
 	if (!temp)
 		return false;
 	value = !String::IsFalse(temp); // otherwise considerate the value as true
@@ -70,32 +193,29 @@ bool Parameters::getBoolean(const string& key, bool& value) const {
 }
 
 const char* Parameters::getParameter(const string& key) const {
-	if (_pMap) {
-		const auto& it = _pMap->find(key);
-		if (it != _pMap->end())
-			return it->second.c_str();
-	}
+	const Entry* pEntry(find(key));
+	if (pEntry)
+		return pEntry->second.c_str();
 	return onParamUnfound(key);
 }
 
 Parameters& Parameters::clear() {
-	if (!_pMap || _pMap->empty())
+	if (_entries.empty())
 		return *this;
-	_pMap->clear();
+	_entries.clear();
 	onParamClear();
 	return *this;
 }
 
 bool Parameters::erase(const string& key) {
 	// erase
-	if (!_pMap)
-		return false;
-	const auto& it(_pMap->find(key));
-	if (it == _pMap->end())
+	LowerKey lower(key);
+	auto it = LowerBound(_entries, lower.value);
+	if (it == _entries.end() || strcmp((*it)->_key, lower.value) != 0)
 		return true;
-	if (_pMap->size() > 1) {
-		onParamChange(it->first, NULL);
-		_pMap->erase(it);
+	if (_entries.size() > 1) {
+		onParamChange((*it)->first, NULL);
+		_entries.erase(it);
 	} else
 		clear();
 	return true;
@@ -19,6 +19,10 @@ details (or else see http://mozilla.org/MPL/2.0/).
 	#include "windows.h"
 #endif
 #include "Mona/FileSystem.h"
+#include "Mona/BinaryReader.h"
+#include "Mona/BinaryWriter.h"
+#include "Mona/Crypto.h"
+#include "Mona/Logs.h"
 #include "Mona/Util.h"
 #include <fstream>
 #include <openssl/evp.h>
@@ -28,14 +32,169 @@ using namespace std;
 
 namespace Mona {
 
+enum {
+	SEGMENT_SIZE = 0x1000000, // beyond a new segment is created
+	COMPACT_SIZE = 0x100000 // obsolete size minimum before compaction
+};
+
+/*!
+Read a whole segment and call forEach for each valid record, returns the size of valid records
+Record = CRC32(4) | payload size(4) | payload, with payload = type(1) | path size(7bit) | path | value */
+static UInt32 ReadSegment(Exception& ex, const string& file, shared<Buffer>& pBuffer, const function<void(UInt32 offset, UInt32 size, string& path, const UInt8* value, UInt32 valueSize)>& forEach) {
+	File segment(file, File::MODE_READ);
+	if (!segment.load(ex))
+		return 0;
+	pBuffer.reset(new Buffer(UInt32(segment.size())));
+	UInt32 readen(0);
+	while (readen < pBuffer->size()) {
+		int result = segment.read(ex, pBuffer->data() + readen, pBuffer->size() - readen);
+		if (result < 0)
+			return 0;
+		if (!result)
+			break;
+		readen += result;
+	}
+	pBuffer->resize(readen);
+	BinaryReader reader(pBuffer->data(), pBuffer->size());
+	string path;
+	while (reader.available() >= 8) {
+		UInt32 offset(reader.position());
+		UInt32 crc(reader.read32());
+		UInt32 size(reader.read32());
+		if (size > reader.available() || Crypto::ComputeCRC32(reader.current(), size) != crc)
+			return offset; // torn or corrupted record
+		BinaryReader payload(reader.current(), size);
+		reader.next(size);
+		bool add(payload.read8() != 0);
+		payload.readString(path);
+		forEach(offset, reader.position() - offset, path, add ? payload.current() : NULL, payload.available());
+	}
+	return reader.position();
+}
+
+/*!
+Returns value of a record */
+static const UInt8* ReadValue(const UInt8* record, UInt32& size) {
+	BinaryReader reader(record + 8, size - 8);
+	reader.next(1); // type
+	reader.next(reader.read7BitEncoded()); // path
+	size = reader.available();
+	return reader.current();
+}
+
+static void DeleteOldEntry(const string& rootPath, const string& path) {
+	string directory(rootPath);
+	if (!path.empty())
+		FileSystem::MakeFolder(directory.append(path, 1, string::npos));
+	string name;
+	Exception ignore;
+	FileSystem::ListFiles(ignore, directory, [&name](const string& file, UInt16 level) {
+		if (FileSystem::IsFolder(file) || FileSystem::GetName(file, name).size() != 32)
+			return;
+		for (char c : name) {
+			if (!isxdigit(c) || (c > '9' && isupper(c)))
+				return;
+		}
+		Exception ignore;
+		FileSystem::Delete(ignore, file);
+	});
+	// erase the empty folders
+	while (directory.size() > rootPath.size() && FileSystem::Delete(ignore, directory))
+		FileSystem::GetParent(directory);
+}
+
 void PersistentData::load(Exception& ex, const string& rootDir, const ForEach& forEach, bool disableTransaction) {
 	flush();
 	_disableTransaction = disableTransaction;
-	FileSystem::MakeFile(_rootPath=rootDir);
-	loadDirectory(ex,_rootPath , "", forEach);
+	FileSystem::MakeFolder(_rootPath=rootDir);
+	_index.clear();
+	_segments.clear();
+	_pSegment.reset();
+	_segment = 0;
+	_size = _live = 0;
+	_dirty = false;
+	_buffer.clear();
+
+	// replay segments
+	Exception ignore;
+	string name;
+	FileSystem::ListFiles(ignore, _rootPath, [this, &name](const string& file, UInt16 level) {
+		UInt32 segment;
+		if (!FileSystem::IsFolder(file) && String::ICompare(FileSystem::GetExtension(file, name), "log") == 0 && String::ToNumber(FileSystem::GetBaseName(file, name), segment))
+			_segments.emplace(segment, 0);
+	});
+	map<UInt32, shared<Buffer>> buffers;
+	bool clean(true);
+	for (auto& it : _segments)
+		clean = replay(ex, it.first, buffers[it.first]);
+	if (!_segments.empty()) {
+		_segment = _segments.rbegin()->first;
+		// continue the last segment if valid
+		if (clean && _segments.rbegin()->second < SEGMENT_SIZE)
+			_pSegment.reset(new File(segmentPath(_segment, name), File::MODE_APPEND));
+	}
+
+	// import the old format
+	map<string, Packet> olds;
+	loadDirectory(ex, _rootPath, "", [&olds](const string& path, const UInt8* value, UInt32 size) {
+		shared<Buffer> pBuffer(new Buffer(size, value));
+		olds[path] = pBuffer;
+	});
+	if (!olds.empty()) {
+		for (auto& it : olds) {
+			if (!write(ex, it.first, it.second))
+				break;
+		}
+		// just sync, compaction would move records of loading buffers
+		if (!ex && writeBuffer(ex) && _pSegment->sync(ex)) {
+			for (auto& it : olds)
+				DeleteOldEntry(_rootPath, it.first);
+		}
+	}
+
+	// in path order to get parents before children
+	for (auto& it : _index) {
+		const auto& itBuffer = buffers.find(it.second.segment);
+		if (itBuffer == buffers.end()) {
+			const auto& itOld = olds.find(it.first);
+			if (itOld != olds.end())
+				forEach(it.first, itOld->second.data(), itOld->second.size());
+			continue;
+		}
+		UInt32 size(it.second.size);
+		const UInt8* value = ReadValue(itBuffer->second->data() + it.second.offset, size);
+		forEach(it.first, value, size);
+	}
 	_disableTransaction = false;
 }
 
+bool PersistentData::replay(Exception& ex, UInt32 segment, shared<Buffer>& pBuffer) {
+	string file;
+	UInt32 size = ReadSegment(ex, segmentPath(segment, file), pBuffer, [&](UInt32 offset, UInt32 size, string& path, const UInt8* value, UInt32 valueSize) {
+		auto it = _index.lower_bound(path);
+		if (it == _index.end() || it->first != path) {
+			if (value) {
+				_index.emplace_hint(it, piecewise_construct, forward_as_tuple(path), forward_as_tuple(segment, offset, size));
+				_live += size;
+			}
+			return;
+		}
+		_live -= it->second.size;
+		if (!value) {
+			_index.erase(it);
+			return;
+		}
+		it->second = Record(segment, offset, size);
+		_live += size;
+	});
+	UInt32& segmentSize(_segments[segment]);
+	_size += (segmentSize = pBuffer ? pBuffer->size() : 0);
+	if (size == segmentSize)
+		return true;
+	WARN("PersistentData ", file, " corrupted, ", segmentSize - size, " bytes ignored");
+	return false;
+}
+
 bool PersistentData::run(Exception& ex, const volatile bool& stopping) {
 
 	for (;;) {
@@ -52,88 +211,130 @@ bool PersistentData::run(Exception& ex, const volatile bool& stopping) {
 					stop();
 					return false;
 				}
-				if(_entries.empty()) {
+				if (!_entries.empty()) {
+					pEntry = move(_entries.front());
+					_entries.pop_front();
+				} else if (!_dirty) {
 					if (timeout)
 						stop();
 					if(stopping)
 						return true;
 					break;
 				}
-				pEntry = move(_entries.front());
-				_entries.pop_front();
 			}
-
-			processEntry(ex,*pEntry);
-			
+			if (pEntry)
+				processEntry(ex, *pEntry);
+			else
+				commit(ex); // end of batch
 		}
 	}
 }
 
 
 void PersistentData::processEntry(Exception& ex,Entry& entry) {
-	string directory(_rootPath);
-
 	// Security => formalize entry.path to avoid possible /../.. issue
 	if (entry.path.empty() || (entry.path.front() != '/' && entry.path.front() != '\\'))
 		entry.path.insert(0, "/");
+	FileSystem::Resolve(entry.path);
+	while (!entry.path.empty() && (entry.path.back() == '/' || entry.path.back() == '\\'))
+		entry.path.pop_back();
+	write(ex, entry.path, entry);
+}
 
-	FileSystem::MakeFolder(directory.append(FileSystem::Resolve(entry.path)));
-	string name,file;
-
-	if (entry) {
-
-		// add entry
-		if (!FileSystem::CreateDirectory(ex, directory, FileSystem::MODE_HEAVY)) {
-			ex.set<Ex::System::File>("Impossible to create database directory ", directory);
-			return;
+bool PersistentData::write(Exception& ex, const string& path, const Packet& packet) {
+	auto it = _index.find(path);
+	if (!packet && it == _index.end())
+		return true; // nothing to remove
+	if (!_pSegment || _segments[_segment] >= SEGMENT_SIZE) {
+		if (!writeBuffer(ex))
+			return false;
+		if (!FileSystem::CreateDirectory(ex, _rootPath, FileSystem::MODE_HEAVY)) {
+			ex.set<Ex::System::File>("Impossible to create database directory ", _rootPath);
+			return false;
 		}
+		string file;
+		_pSegment.reset(new File(segmentPath(++_segment, file), File::MODE_APPEND));
+		_segments[_segment] = 0;
+	}
+	UInt32 offset(_buffer.size());
+	BinaryWriter writer(_buffer);
+	writer.next(8).write8(packet ? 1 : 0).writeString(path).write(packet.data(), packet.size());
+	UInt32 size(_buffer.size() - offset);
+	BinaryWriter(_buffer.data() + offset, 8).write32(Crypto::ComputeCRC32(_buffer.data() + offset + 8, size - 8)).write32(size - 8);
+	if (_buffer.size() >= 0x10000 && !writeBuffer(ex))
+		return false;
+	UInt32& segmentSize(_segments[_segment]);
+	if (it != _index.end())
+		_live -= it->second.size;
+	if (!packet)
+		_index.erase(it);
+	else if (it == _index.end())
+		_index.emplace(piecewise_construct, forward_as_tuple(path), forward_as_tuple(_segment, segmentSize, size));
+	else
+		it->second = Record(_segment, segmentSize, size);
+	if (packet)
+		_live += size;
+	segmentSize += size;
+	_size += size;
+	_dirty = true;
+	return true;
+}
 
-		// compute md5
-		UInt8 result[16];
-		EVP_Digest(entry.data(), entry.size(), result, NULL, EVP_md5(), NULL);
-
-		String::Assign(name, String::Hex(result, sizeof(result)));
+bool PersistentData::writeBuffer(Exception& ex) {
+	if (!_buffer.size())
+		return true;
+	bool success(_pSegment->write(ex, _buffer.data(), _buffer.size()));
+	if (!success)
+		_pSegment.reset(); // continue on a new segment, the current one is possibly torn
+	_buffer.clear();
+	return success;
+}
 
-		// write the file
-		file.assign(directory).append(name);
-#if defined(_WIN32)
-		wchar_t wFile[PATH_MAX];
-		MultiByteToWideChar(CP_UTF8, 0, file.c_str(), -1, wFile, sizeof(wFile));
-		ofstream ofile(wFile, ios::out | ios::binary);
-#else
-		ofstream ofile(file.c_str(), ios::out | ios::binary);
-#endif
-		if (!ofile.good()) {
-			ex.set<Ex::System::File>("Impossible to write file ", file);
-			return;
-		}
-		ofile.write(STR entry.data(), entry.size());
-	}
+bool PersistentData::commit(Exception& ex) {
+	_dirty = false;
+	if (!writeBuffer(ex))
+		return false;
+	if (_pSegment && !_pSegment->sync(ex))
+		return false;
+	UInt64 obsolete(_size - _live);
+	if (_live ? (obsolete < COMPACT_SIZE || obsolete < _live) : !_size)
+		return true;
+	return compact(ex);
+}
 
-	// remove possible old value after writing to be safe!
-	bool hasData=false;
-	FileSystem::ForEach forEach([&ex, name, &file, &hasData](const string& path, UInt16 level){
-		// Delete just hex file
-		if (FileSystem::IsFolder(path) || FileSystem::GetName(path, file).size() != 32 || file == name) {
-			hasData = true;
-			return;
-		}
-		// is MD5?
-		for (char c : file) {
-			if (!isxdigit(c) || (c > '9' && isupper(c))) {
-				hasData = true;
+bool PersistentData::compact(Exception& ex) {
+	// copy live records in new segments, then delete the old ones
+	map<UInt32, UInt32> segments(_segments);
+	_pSegment.reset();
+	string file;
+	for (auto& it : segments) {
+		UInt32 segment(it.first);
+		shared<Buffer> pBuffer;
+		ReadSegment(ex, segmentPath(segment, file), pBuffer, [&](UInt32 offset, UInt32 size, string& path, const UInt8* value, UInt32 valueSize) {
+			if (!value || ex)
 				return;
-			}
-		}
-		if (!FileSystem::Delete(ex, path))
-			hasData = true;
-	});
-	Exception ignore;
-	// if directory doesn't exists it's already deleted so ignore ListFiles exception
-	FileSystem::ListFiles(ignore, directory, forEach);
-	// if remove and no sub value, erase the folder
-	if (!entry && !hasData)
-		FileSystem::Delete(ex,directory);
+			auto it = _index.find(path);
+			if (it != _index.end() && it->second.segment == segment && it->second.offset == offset)
+				write(ex, path, Packet(value, valueSize));
+		});
+		if (ex)
+			return false;
+	}
+	if (!writeBuffer(ex) || (_pSegment && !_pSegment->sync(ex)))
+		return false;
+	for (auto& it : segments) {
+		if (!FileSystem::Delete(ex, segmentPath(it.first, file)))
+			return false;
+		_size -= it.second;
+		_segments.erase(it.first);
+	}
+	_dirty = false;
+	if (_segments.empty()) {
+		// empty database
+		Exception ignore;
+		FileSystem::Delete(ignore, _rootPath);
+	}
+	return true;
 }
 
 
@@ -0,0 +1,154 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Recycler.h"
+#include <atomic>
+#include <mutex>
+
+
+using namespace std;
+
+
+namespace Mona {
+
+namespace {
+
+enum {
+	GRANULARITY = 64,
+	CLASSES = Recycling::MAX_SIZE / GRANULARITY,
+	BATCH = 64, // blocks exchanged with the global list
+	MAX_LOCAL = 4 * BATCH, // blocks kept by thread
+	MAX_GLOBAL = 0x4000 // blocks kept by class in the global list, beyond memory is released
+};
+
+struct Block {
+	Block* pNext;
+};
+
+struct List {
+	List() : pHead(NULL), count(0) {}
+	Block*	pHead;
+	UInt32	count;
+
+	void push(Block* pBlock) {
+		pBlock->pNext = pHead;
+		pHead = pBlock;
+		++count;
+	}
+	Block* pop() {
+		Block* pBlock(pHead);
+		pHead = pBlock->pNext;
+		--count;
+		return pBlock;
+	}
+	/*!
+	Move 'count' blocks (or less) to 'list' */
+	void move(List& list, UInt32 count) {
+		while (pHead && count--)
+			list.push(pop());
+	}
+};
+
+atomic<UInt64> _Allocations(0);
+
+struct Global {
+	std::mutex	access;
+	List		lists[CLASSES];
+
+	static Global& Get() {
+		static Global& Instance(*new Global()); // never deleted to stay valid for threads which end after the static destruction
+		return Instance;
+	}
+	/*!
+	Give blocks to the global list, and release them to the system beyond MAX_GLOBAL */
+	void release(UInt8 index, List& local, UInt32 count) {
+		List& global(lists[index]);
+		local.move(global, count);
+		while (global.count > MAX_GLOBAL)
+			::operator delete(global.pop());
+	}
+};
+
+/*!
+Trivially destructible so still readable after the Locals destruction, when other thread_local destructors allocate or free */
+thread_local bool _Exiting(false);
+
+struct Locals {
+	~Locals() {
+		_Exiting = true;
+		Global& global(Global::Get());
+		lock_guard<mutex> lock(global.access);
+		for (UInt8 i = 0; i < CLASSES; ++i)
+			global.release(i, lists[i], lists[i].count);
+	}
+	List	lists[CLASSES];
+};
+thread_local Locals _Locals;
+
+}
+
+
+void* Recycling::Allocate(size_t size) {
+	if (!size || size > MAX_SIZE)
+		return ::operator new(size);
+	UInt8 index((size - 1) / GRANULARITY);
+	if (_Exiting) {
+		// thread ending, _Locals is destroyed
+		Global& global(Global::Get());
+		lock_guard<mutex> lock(global.access);
+		List& list(global.lists[index]);
+		if (list.pHead)
+			return list.pop();
+	} else {
+		List& local(_Locals.lists[index]);
+		if (!local.pHead) {
+			Global& global(Global::Get());
+			lock_guard<mutex> lock(global.access);
+			global.lists[index].move(local, BATCH);
+		}
+		if (local.pHead)
+			return local.pop();
+	}
+	++_Allocations;
+	return ::operator new((index + 1) * GRANULARITY);
+}
+
+void Recycling::Deallocate(void* pBlock, size_t size) {
+	if (!size || size > MAX_SIZE)
+		return ::operator delete(pBlock);
+	UInt8 index((size - 1) / GRANULARITY);
+	Global& global(Global::Get());
+	if (_Exiting) {
+		// thread ending, _Locals is destroyed
+		List list;
+		list.push((Block*)pBlock);
+		lock_guard<mutex> lock(global.access);
+		return global.release(index, list, 1);
+	}
+	List& local(_Locals.lists[index]);
+	local.push((Block*)pBlock);
+	if (local.count <= MAX_LOCAL)
+		return;
+	lock_guard<mutex> lock(global.access);
+	global.release(index, local, BATCH);
+}
+
+UInt64 Recycling::Allocations() {
+	return _Allocations;
+}
+
+
+} // namespace Mona
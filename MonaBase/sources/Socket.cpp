@@ -25,11 +25,13 @@ using namespace std;
 
 namespace Mona {
 
+static Metrics::Traffic _Traffic("");
+
 Socket::Socket(Type type) :
 #if !defined(_WIN32)
 	_pWeakThis(NULL), _firstWritable(true),
 #endif
-	_nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), type(type), _recvTime(0), _sendTime(0), _sockfd(NET_INVALID_SOCKET), _threadReceive(0) {
+	_nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _paused(0), type(type), _recvTime(0), _sendTime(0), _sockfd(NET_INVALID_SOCKET), _threadReceive(0) {
 
 	init();
 }
@@ -39,19 +41,51 @@ Socket::Socket(NET_SOCKET sockfd, const sockaddr& addr) : _peerAddress(addr), _a
 #if !defined(_WIN32)
 	_pWeakThis(NULL), _firstWritable(true),
 #endif
-	_nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), type(Socket::TYPE_STREAM), _recvTime(Time::Now()), _sendTime(0), _sockfd(sockfd), _threadReceive(0) {
+	_nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _paused(0), type(Socket::TYPE_STREAM), _recvTime(Time::Now()), _sendTime(0), _sockfd(sockfd), _threadReceive(0) {
 
 	init();
 }
 
 
 Socket::~Socket() {
-	if (_sockfd == NET_INVALID_SOCKET)
+	if (_sockfd != NET_INVALID_SOCKET) {
+		// gracefull disconnection => flush + shutdown + close
+		/// shutdown + flush
+		shutdown();
+		NET_CLOSESOCKET(_sockfd);
+	}
+	Memory::Unqueue(_pAccount.get(), _queueing);
+}
+
+void Socket::setAccount(const shared<Memory::Account>& pAccount) {
+	lock_guard<mutex> lock(_mutexSending);
+	Memory::Unqueue(_pAccount.get(), _queueing);
+	_pAccount = pAccount;
+	Memory::Queue(_pAccount.get(), _queueing);
+}
+
+void Socket::send(UInt32 count, UInt32 packets) {
+	_sendTime = Time::Now();
+	_sendByteRate += count;
+	_Traffic.sent += count;
+	_Traffic.sentPackets += packets;
+	shared<Metrics::Traffic> pTraffic(atomic_load(&_pTraffic));
+	if (!pTraffic)
 		return;
-	// gracefull disconnection => flush + shutdown + close
-	/// shutdown + flush
-	shutdown();
-	NET_CLOSESOCKET(_sockfd);
+	pTraffic->sent += count;
+	pTraffic->sentPackets += packets;
+}
+
+void Socket::receive(UInt32 count) {
+	_recvTime = Time::Now();
+	_recvByteRate += count;
+	++_Traffic.receivedPackets;
+	_Traffic.received += count;
+	shared<Metrics::Traffic> pTraffic(atomic_load(&_pTraffic));
+	if (!pTraffic)
+		return;
+	++pTraffic->receivedPackets;
+	pTraffic->received += count;
 }
 
 bool Socket::shutdown(Socket::ShutdownType type) {
@@ -138,6 +172,15 @@ bool Socket::setSendBufferSize(Exception& ex, int size) {
 	return true;
 }
 
+bool Socket::setMaxPacingRate(Exception& ex, UInt32 rate) {
+#if defined(SO_MAX_PACING_RATE)
+	return setOption(ex, SOL_SOCKET, SO_MAX_PACING_RATE, rate);
+#else
+	ex.set<Ex::Unsupported>("Socket pacing unsupported on this platform");
+	return false;
+#endif
+}
+
 const SocketAddress& Socket::address() const {
 	if (_address && !_address.port()) {
 		// computable!
@@ -351,7 +394,11 @@ int Socket::receive(Exception& ex, void* buffer, UInt32 size, int flags, SocketA
 	if (rc < 0) {
 		if (error == NET_EAGAIN)
 			error = NET_EWOULDBLOCK; // if non blocking socket keep returns -1 to differenciate it of disconnection which returns 0 (a non-blocking socket should use available before to call receive)
-		if (pAddress)
+		if (error == NET_EWOULDBLOCK) {
+			// end of every non-blocking reception, share the same exception to not allocate it each time
+			static struct WouldBlock : Exception { WouldBlock() { SetException(*this, NET_EWOULDBLOCK); } } WouldBlock;
+			ex = WouldBlock;
+		} else if (pAddress)
 			SetException(ex, error, " (from=", *pAddress,", size=", size, ", flags=", flags, ")");
 		else if(_peerAddress)
 			SetException(ex, error, " (from=",_peerAddress,", size=", size, ", flags=", flags, ")");
@@ -405,11 +452,123 @@ int Socket::sendTo(Exception& ex, const void* data, UInt32 size, const SocketAdd
 	return rc;
 }
 
+int Socket::sendVector(Exception& ex, const Packet* packets, UInt32 count, int flags) {
+	if (_sockex) {
+		ex = _sockex;
+		return -1;
+	}
+
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+
+	if (count > SENDVECTOR_MAX)
+		count = SENDVECTOR_MAX; // rest will be queued
+	UInt32 size(0);
+	int rc;
+	int error;
+#if defined(_WIN32)
+	WSABUF buffers[SENDVECTOR_MAX];
+	for (UInt32 i = 0; i < count; ++i) {
+		buffers[i].buf = (char*)packets[i].data();
+		size += (buffers[i].len = packets[i].size());
+	}
+	DWORD sent;
+	do {
+		rc = ::WSASend(_sockfd, buffers, count, &sent, flags, NULL, NULL) ? -1 : int(sent);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+#else
+	iovec buffers[SENDVECTOR_MAX];
+	for (UInt32 i = 0; i < count; ++i) {
+		buffers[i].iov_base = (void*)packets[i].data();
+		size += (buffers[i].iov_len = packets[i].size());
+	}
+	msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = buffers;
+	msg.msg_iovlen = count;
+	do {
+		rc = ::sendmsg(_sockfd, &msg, flags);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+#endif
+	if (rc < 0) {
+		if (error == NET_EAGAIN)
+			error = NET_EWOULDBLOCK;
+		SetException(ex, error, " (address=", _peerAddress, ", size=", size, ", flags=", flags, ")");
+		return -1;
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+
+	send(rc, count);
+
+	if (UInt32(rc) < size && type == TYPE_DATAGRAM) {
+		ex.set<Ex::Net::Socket>("UDP Packet sent in pieces (address=", _peerAddress, ", size=", size, ", flags=", flags, ")");
+		return -1;
+	}
+	return rc;
+}
+
+int Socket::write(Exception& ex, const Packet* packets, UInt32 count, int flags) {
+	lock_guard<mutex> lock(_mutexSending);
+	int sent(0);
+	bool blocked(!_sendings.empty());
+	if (!blocked) {
+		sent = sendVector(ex, packets, count, flags);
+		if (sent < 0) {
+			if ((ex.cast<Ex::Net::Socket>().code == NET_ENOTCONN && _peerAddress) || ex.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK) {
+				// queue and wait onFlush, no error!
+				ex = nullptr;
+				sent = 0;
+				blocked = true;
+			} else {
+				if (type == TYPE_STREAM) {
+					if (!::shutdown(_sockfd, SHUTDOWN_BOTH)) // shutdown system to avoid to try to send before shutdown!
+						Net::LastError(); // to pick up _errno
+					_sendings.clear();
+				}
+				return -1;
+			}
+		}
+	}
+	// queue what has not been sent
+	if (type == TYPE_DATAGRAM) {
+		if (!blocked)
+			return sent; // datagram sent entirely (else sendVector fails)
+		// queue vectored packets as one datagram
+		shared<Buffer> pBuffer(new Buffer());
+		for (UInt32 i = 0; i < count; ++i)
+			pBuffer->append(packets[i].data(), packets[i].size());
+		_sendings.emplace_back(Packet(pBuffer), _peerAddress, flags);
+		_queueing += _sendings.back().size();
+		Memory::Queue(_pAccount.get(), _sendings.back().size());
+		return 0;
+	}
+	UInt32 rest(sent);
+	for (UInt32 i = 0; i < count; ++i) {
+		const Packet& packet(packets[i]);
+		if (rest >= packet.size()) {
+			rest -= packet.size();
+			continue;
+		}
+		if (rest) {
+			_sendings.emplace_back(packet + rest, _peerAddress, flags);
+			rest = 0;
+		} else
+			_sendings.emplace_back(packet, _peerAddress, flags);
+		_queueing += _sendings.back().size();
+		Memory::Queue(_pAccount.get(), _sendings.back().size());
+	}
+	return sent;
+}
+
 int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags) {
 	lock_guard<mutex> lock(_mutexSending);
 	if(!_sendings.empty()) {
 		_sendings.emplace_back(packet, address ? address : _peerAddress, flags);
 		_queueing += packet.size();
+		Memory::Queue(_pAccount.get(), packet.size());
 		return 0;
 	}
 
@@ -433,6 +592,7 @@ int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& addr
 
 	_sendings.emplace_back(packet+sent, address ? address : _peerAddress, flags);
 	_queueing += _sendings.back().size();
+	Memory::Queue(_pAccount.get(), _sendings.back().size());
 	return sent;
 }
 
@@ -469,8 +629,10 @@ bool Socket::flush(Exception& ex) {
 		}
 		_sendings.pop_front();
 	}
-	if (written)
+	if (written) {
 		_queueing -= written;
+		Memory::Unqueue(_pAccount.get(), written);
+	}
 	return true;
 }
 
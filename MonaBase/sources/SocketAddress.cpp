@@ -60,6 +60,15 @@ UInt16 SocketAddress::resolveService(Exception& ex,const char* service) {
 	return 0;
 }
 
+std::size_t SocketAddress::Hash::operator()(const SocketAddress& address) const {
+	// FNV-1a on host bytes and port
+	std::size_t hash(2166136261u);
+	const UInt8* data(BIN address.host().data());
+	for (UInt8 i = 0; i < address.host().size(); ++i)
+		hash = (hash ^ data[i]) * 16777619u;
+	return (hash ^ address.port()) * 16777619u;
+}
+
 bool SocketAddress::operator < (const SocketAddress& address) const {
 	if (family() != address.family())
 		return family() < address.family();
@@ -253,6 +253,8 @@ bool String::ToUTF8(char value, char (&buffer)[2]) {
 template bool  String::ToNumber(const char*, size_t, float&);
 template bool  String::ToNumber(Exception& ex, const char*, size_t, float&);
 template bool  String::ToNumber(const char*, size_t, double&);
+template bool  String::ToNumber(const char*, size_t, long double&);
+template bool  String::ToNumber(Exception& ex, const char*, size_t, long double&);
 template bool  String::ToNumber(Exception& ex, const char*, size_t, double&);
 template bool  String::ToNumber(const char*, size_t, unsigned char&);
 template bool  String::ToNumber(Exception& ex, const char*, size_t, unsigned char&);
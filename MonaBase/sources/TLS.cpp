@@ -161,6 +161,26 @@ int TLS::Socket::sendTo(Exception& ex, const void* data, UInt32 size, const Sock
 	return result;
 }
 
+int TLS::Socket::sendVector(Exception& ex, const Packet* packets, UInt32 count, int flags) {
+	if (!pTLS)
+		return Mona::Socket::sendVector(ex, packets, count, flags); // normal socket
+	// no gather writing with SSL, write packets one after the other
+	int sent(0);
+	for (UInt32 i = 0; i < count; ++i) {
+		int result = sendTo(ex, packets[i].data(), packets[i].size(), SocketAddress::Wildcard(), flags);
+		if (result < 0) {
+			if (!sent)
+				return result;
+			ex = nullptr; // error will be raised again on next sending
+			break;
+		}
+		sent += result;
+		if (UInt32(result) < packets[i].size())
+			break;
+	}
+	return sent;
+}
+
 UInt64 TLS::Socket::queueing() const {
 	if (!pTLS)
 		return Mona::Socket::queueing();
@@ -0,0 +1,264 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/ThreadPool.h"
+#include "Mona/FileSystem.h"
+#include "Mona/Metrics.h"
+#include "Mona/Logs.h"
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__APPLE__) && !defined(_BSD)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+using namespace std;
+
+
+namespace Mona {
+
+thread_local ThreadPool::Thread* ThreadPool::Thread::_PCurrent(NULL);
+
+static Metrics::Counter		_Runners("mona_threadpool_runners_total", "Runners executed by thread pools");
+static Metrics::Counter		_Stolen("mona_threadpool_stolen_total", "Runners stolen from the queue of another thread");
+static Metrics::Histogram	_Latency("mona_threadpool_latency_microseconds", "Time waited by runners in thread pool queues");
+
+static bool SetAffinity(Exception& ex, UInt16 cpu) {
+#if defined(_WIN32)
+	if (cpu >= sizeof(DWORD_PTR) * 8 || !SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu)) {
+		ex.set<Ex::System::Thread>("Impossible to pin thread on CPU ", cpu);
+		return false;
+	}
+	return true;
+#elif defined(__APPLE__) || defined(_BSD) || defined(__ANDROID__)
+	ex.set<Ex::Unsupported>("Thread CPU affinity unsupported on this platform");
+	return false;
+#else
+	if (cpu >= CPU_SETSIZE) {
+		ex.set<Ex::System::Thread>("Impossible to pin thread on CPU ", cpu);
+		return false;
+	}
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(cpu, &cpus);
+	int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+	if (!result)
+		return true;
+	ex.set<Ex::System::Thread>("Impossible to pin thread on CPU ", cpu, ", ", strerror(result));
+	return false;
+#endif
+}
+
+static Int32 NumaNode(UInt16 cpu) {
+#if defined(_WIN32)
+	UCHAR node;
+	return GetNumaProcessorNode(UCHAR(cpu), &node) && node != 0xFF ? node : -1;
+#elif defined(__APPLE__) || defined(_BSD)
+	return -1;
+#else
+	// a folder /sys/devices/system/cpu/cpuX/nodeY exists for the NUMA node Y of CPU X
+	string path;
+	for (Int32 node = 0; node < 64; ++node) {
+		if (FileSystem::Exists(String::Assign(path, "/sys/devices/system/cpu/cpu", cpu, "/node", node, '/')))
+			return node;
+	}
+	return -1;
+#endif
+}
+
+
+ThreadPool::ThreadPool(UInt16 threads) : _current(0), _stealing(false) {
+	_size = threads ? threads : Thread::ProcessorCount() * 2;
+	_threads.resize(_size);
+	for (UInt16 i = 0; i < _size; ++i)
+		_threads[i].reset(new Thread(*this, i));
+}
+
+void ThreadPool::join() {
+	for (unique<Thread>& pThread : _threads)
+		pThread->stop();
+}
+
+ThreadPool& ThreadPool::setAffinity(const vector<UInt16>& cpus) {
+	for (unique<Thread>& pThread : _threads) {
+		if (cpus.empty()) {
+			pThread->cpu = pThread->node = -1;
+			continue;
+		}
+		pThread->cpu = cpus[pThread->index % cpus.size()];
+		pThread->node = NumaNode(pThread->cpu);
+	}
+	return *this;
+}
+
+bool ThreadPool::setAffinity(Exception& ex, const char* cpus) {
+	vector<UInt16> values;
+	String::ForEach forEach([&](UInt32 index, const char* value) {
+		UInt16 first, last;
+		const char* separator(strchr(value, '-'));
+		if (separator) {
+			if (!String::ToNumber(value, separator - value, first) || !String::ToNumber(separator + 1, last) || last < first)
+				return false;
+		} else if (String::ToNumber(value, first))
+			last = first;
+		else
+			return false;
+		while (first <= last)
+			values.emplace_back(first++);
+		return true;
+	});
+	if (String::Split(string(cpus), ",", forEach, SPLIT_IGNORE_EMPTY | SPLIT_TRIM) == string::npos) { // copy because Split writes in
+		ex.set<Ex::Format>("Invalid CPU list ", cpus);
+		return false;
+	}
+	setAffinity(values);
+	return true;
+}
+
+ThreadPool::Stats& ThreadPool::stats(UInt16 index, Stats& stats, bool reset) const {
+	return _threads[index]->stats(stats, reset);
+}
+
+
+ThreadPool::Thread::Thread(const ThreadPool& pool, UInt16 index) : ThreadQueue("ThreadPool"), _pool(pool), index(index), cpu(-1), node(-1),
+	_busy(false), _latencies(0), _count(0) {
+}
+
+bool ThreadPool::Thread::queue(Exception& ex, const shared<Runner>& pRunner, bool stealable) {
+	bool busy;
+	{
+		lock_guard<mutex> lock(_mutex);
+		if (!start(ex))
+			return false;
+		(stealable ? _stealables : _runners).emplace_back(pRunner, Metrics::Now());
+		UInt32 depth(UInt32(_runners.size() + _stealables.size()));
+		if (depth > _stats.maxDepth)
+			_stats.maxDepth = depth;
+		busy = stealable && (_busy || depth > 1);
+		wakeUp.set();
+	}
+	if (!busy)
+		return true;
+	// this thread has already a job, wake up an idle thread to steal it
+	for (const unique<Thread>& pThread : _pool._threads) {
+		if (pThread.get() != this && !pThread->busy()) {
+			Exception exStart;
+			if (pThread->wake(exStart))
+				break;
+		}
+	}
+	return true;
+}
+
+bool ThreadPool::Thread::wake(Exception& ex) {
+	lock_guard<mutex> lock(_mutex);
+	if (!start(ex))
+		return false;
+	wakeUp.set();
+	return true;
+}
+
+ThreadPool::Stats& ThreadPool::Thread::stats(Stats& stats, bool reset) {
+	lock_guard<mutex> lock(_mutex);
+	stats = _stats;
+	stats.depth = UInt32(_runners.size() + _stealables.size());
+	stats.latency = _count ? (_latencies / _count) : 0;
+	if (reset) {
+		_stats.maxDepth = stats.depth;
+		_stats.maxLatency = 0;
+		_latencies = _count = 0;
+	}
+	return stats;
+}
+
+bool ThreadPool::Thread::pop(Job& job, bool stealer) {
+	lock_guard<mutex> lock(_mutex);
+	deque<Job, Recycler<Job>>* pJobs;
+	if (!stealer && !_runners.empty())
+		pJobs = &_runners;
+	else if (!_stealables.empty())
+		pJobs = &_stealables;
+	else
+		return false;
+	job = move(pJobs->front());
+	pJobs->pop_front();
+	UInt64 latency(Metrics::Now() - job.time);
+	if (latency > _stats.maxLatency)
+		_stats.maxLatency = latency;
+	_latencies += latency;
+	_Latency.record(latency);
+	++_count;
+	++_stats.runners;
+	++_Runners;
+	if (stealer) {
+		++_stats.stolen;
+		++_Stolen;
+	}
+	return true;
+}
+
+bool ThreadPool::Thread::steal(Job& job) {
+	// steal in priority to threads of the same NUMA node
+	const vector<unique<Thread>>& threads(_pool._threads);
+	for (UInt8 pass = node < 0 ? 1 : 0; pass < 2; ++pass) {
+		for (UInt16 i = 1; i < threads.size(); ++i) {
+			Thread& thread(*threads[(index + i) % threads.size()]);
+			if (!pass && thread.node != node)
+				continue;
+			if (thread.pop(job, true))
+				return true;
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::Thread::run(Exception&, const volatile bool& stopping) {
+	ThreadQueue::_PCurrent = _PCurrent = this;
+	if (cpu >= 0) {
+		Exception ex;
+		if (!SetAffinity(ex, UInt16(cpu)))
+			WARN("ThreadPool ", index, ", ", ex);
+	}
+
+	for (;;) {
+
+		bool timeout = !wakeUp.wait(120000); // 2 mn of timeout
+
+		for (;;) {
+			Job job;
+			if (!pop(job) && (!_pool._stealing || !steal(job))) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (!_runners.empty() || !_stealables.empty())
+					continue; // queued meanwhile
+				if (timeout)
+					stop(); // to set _stop immediatly!
+				if (stopping)
+					return true;
+				break;
+			}
+
+			_busy = true;
+			Exception ex;
+			setName(job.pRunner->name);
+			AUTO_ERROR(job.pRunner->run(ex), job.pRunner->name);
+			_busy = false;
+		}
+	}
+	return true;
+}
+
+} // namespace Mona
@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/ThreadQueue.h"
+#include "Mona/Metrics.h"
 #include "Mona/Logs.h"
 
 
@@ -25,6 +26,17 @@ namespace Mona {
 
 thread_local ThreadQueue* ThreadQueue::_PCurrent(NULL);
 
+static Metrics::Counter _Runners("mona_threadqueue_runners_total", "Runners executed by dedicated thread queues");
+
+bool ThreadQueue::push(Exception& ex, const shared<Runner>& pRunner) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!start(ex))
+		return false;
+	_runners.emplace_back(pRunner);
+	wakeUp.set();
+	return true;
+}
+
 bool ThreadQueue::run(Exception&, const volatile bool& stopping) {
 	_PCurrent = this;
 
@@ -50,6 +62,7 @@ bool ThreadQueue::run(Exception&, const volatile bool& stopping) {
 			Exception ex;
 			setName(pRunner->name);
 			AUTO_ERROR(pRunner->run(ex), pRunner->name);
+			++_Runners;
 		}
 	}
 	return true;
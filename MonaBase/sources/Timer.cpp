@@ -16,6 +16,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 
 #include "Mona/Timer.h"
+#include "Mona/Metrics.h"
+#include "Mona/Watchdog.h"
 #include "Mona/Logs.h"
 
 
@@ -23,6 +25,8 @@ using namespace std;
 
 namespace Mona {
 
+static Metrics::Histogram _Lag("mona_timer_lag_milliseconds", "Delay of timers raising, event loop lag");
+
 Timer::~Timer() {
 	for(const auto& it : _timers) {
 		for (const OnTimer* pTimer : *it.second)
@@ -83,8 +87,10 @@ UInt32 Timer::raise() {
 			return UInt32(waiting); // > 0!
 		auto itTimers(it->second);
 		_timers.erase(it);
+		_Lag.record(-waiting);
 		for (const OnTimer* pTimer : *itTimers) {
 			pTimer->_nextRaising = 0;
+			Watchdog::Task task(pTimer->target_type());
 			UInt32 timeout = (*pTimer)(UInt32(-waiting));
 			--_count;
 			if(timeout)
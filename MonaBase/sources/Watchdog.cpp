@@ -0,0 +1,158 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Watchdog.h"
+#include "Mona/Metrics.h"
+#include "Mona/Logs.h"
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <signal.h>
+#define MONA_BACKTRACE
+#endif
+
+
+using namespace std;
+
+
+namespace Mona {
+
+static Metrics::Counter		_Stalls("mona_watchdog_stalls_total", "Tasks exceeding the watchdog threshold");
+static Metrics::Histogram	_Durations("mona_watchdog_task_microseconds", "Duration of the tasks of watched event loops");
+
+#if defined(MONA_BACKTRACE)
+static void*		_Frames[64];
+static atomic<int>	_Count(-1);
+static void OnSample(int) { _Count = backtrace(_Frames, 64); }
+#endif
+
+thread_local Watchdog* Watchdog::_PCurrent(NULL);
+
+Watchdog::Watchdog() : Thread("Watchdog"), _time(0), _task(0), _name(NULL), _pType(NULL), _threshold(0), _sampling(false) {
+}
+
+bool Watchdog::start(Exception& ex, UInt32 threshold, bool sampling) {
+	if (running())
+		stop();
+	_threshold = threshold ? threshold : 1;
+	_sampling = sampling;
+	_thread = Thread::CurrentName();
+#if !defined(_WIN32)
+	_watched = pthread_self();
+#endif
+	if (sampling) {
+#if defined(MONA_BACKTRACE)
+		void* frame;
+		backtrace(&frame, 1); // first call loads libgcc, not async-signal-safe
+		struct sigaction sa;
+		sa.sa_handler = OnSample;
+		sa.sa_flags = SA_RESTART;
+		sigemptyset(&sa.sa_mask);
+		sigaction(SIGUSR2, &sa, 0);
+#else
+		WARN("Watchdog sampling unsupported on this platform");
+		_sampling = false;
+#endif
+	}
+	if (!Thread::start(ex))
+		return false;
+	_PCurrent = this;
+	return true;
+}
+
+void Watchdog::stop() {
+	if (_PCurrent == this)
+		_PCurrent = NULL;
+	Thread::stop();
+}
+
+string& Watchdog::name(string& buffer) const {
+	const type_info* pType(_pType);
+	if (pType)
+		return buffer.assign(typeof(*pType));
+	const char* name(_name);
+	return buffer.assign(name ? name : "?");
+}
+
+void Watchdog::Task::begin(const char* name, const type_info* pType) {
+	if (_pWatchdog->_time) {
+		_pWatchdog = NULL; // nested task, attribute to the first one
+		return;
+	}
+	_pWatchdog->_name = name;
+	_pWatchdog->_pType = pType;
+	++_pWatchdog->_task;
+	_pWatchdog->_time = Metrics::Now();
+}
+
+void Watchdog::Task::end() {
+	Int64 duration(Metrics::Now() - _pWatchdog->_time);
+	_pWatchdog->_time = 0;
+	_Durations.record(duration);
+	if (duration < Int64(_pWatchdog->_threshold) * 1000)
+		return;
+	string name;
+	WARN(_pWatchdog->name(name), " has blocked ", _pWatchdog->_thread, " thread during ", duration / 1000, "ms");
+}
+
+bool Watchdog::run(Exception&, const volatile bool& stopping) {
+	UInt32 reported(0);
+	string name;
+	while (!stopping) {
+		wakeUp.wait(_threshold > 4 ? _threshold / 4 : 1);
+		UInt32 task(_task);
+		Int64 time(_time);
+		if (!time || task == reported)
+			continue;
+		Int64 elapsed((Metrics::Now() - time) / 1000);
+		if (elapsed < _threshold)
+			continue;
+		reported = task;
+		++_Stalls;
+		WARN(_thread, " thread stalled since ", elapsed, "ms in ", this->name(name));
+		if (_sampling)
+			sample();
+	}
+	return true;
+}
+
+void Watchdog::sample() {
+#if defined(MONA_BACKTRACE)
+	static mutex Mutex; // static frames
+	lock_guard<mutex> lock(Mutex);
+	_Count = -1;
+	int error(pthread_kill(_watched, SIGUSR2));
+	if (error) {
+		WARN("Watchdog sampling of ", _thread, " thread, ", strerror(error));
+		return;
+	}
+	for (UInt8 i = 0; i < 100 && _Count < 0; ++i)
+		Thread::Sleep(1);
+	int count(_Count);
+	char** symbols(count > 0 ? backtrace_symbols(_Frames, count) : NULL);
+	if (!symbols) {
+		WARN("Watchdog sampling of ", _thread, " thread, backtrace unavailable");
+		return;
+	}
+	string stack;
+	for (int i = 2; i < count; ++i) // skip OnSample and signal frame
+		String::Append(stack, "\n\t", symbols[i]);
+	free(symbols);
+	WARN(_thread, " thread backtrace:", stack);
+#endif
+}
+
+
+} // namespace Mona
@@ -40,6 +40,7 @@ struct Client : Entity, virtual Object, Net::Stats {
 
 	const bool					connected;
 	const Time					connectionTime;
+	const UInt16				publications; // count of publications published by this client
 
 	 // user data (custom data)
 	template <typename DataType>
@@ -60,7 +61,7 @@ struct Client : Entity, virtual Object, Net::Stats {
 	virtual Writer&				writer() = 0;
 
 protected:
-	Client(const char* protocol) : protocol(protocol), _pData(NULL), connected(false), connectionTime(0) {}
+	Client(const char* protocol) : protocol(protocol), _pData(NULL), connected(false), connectionTime(0), publications(0) {}
 
 private:
 	mutable void*				_pData;
@@ -25,6 +25,10 @@ namespace Mona {
 
 struct Entity : virtual Object {
 	struct Comparator { bool operator()(const UInt8* a, const UInt8* b) const { return memcmp(a, b, SIZE)<0; } };
+	/*!
+	Hash and equality to key unordered containers by id, id is random so its first bytes are already a good hash */
+	struct Hash { std::size_t operator()(const UInt8* id) const { std::size_t hash; memcpy(&hash, id, sizeof(hash)); return hash; } };
+	struct Equal { bool operator()(const UInt8* a, const UInt8* b) const { return memcmp(a, b, SIZE) == 0; } };
 	template<typename EntityType>
 	struct Map : std::map<const UInt8*, EntityType*, Comparator> {
 		using std::map<const UInt8*, EntityType*, Comparator>::map;
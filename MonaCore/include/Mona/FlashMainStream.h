@@ -32,6 +32,7 @@ struct FlashMainStream : FlashStream, virtual Object {
 
 	FlashStream* getStream(UInt16 id);
 	void		 clearStreams();
+	UInt32		 streams() const { return _streams.size(); }
 
 	void flush() { for(auto& it : _streams) it.second.flush(); }
 	
@@ -0,0 +1,127 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/TSWriter.h"
+#include "Mona/Time.h"
+#include <deque>
+#include <set>
+
+namespace Mona {
+
+/*!
+	HLS/LL-HLS segmenter of one publication, muxes media one time in TS and cuts it in segments beginning on key frame,
+	and optionally in partial segments (LL-HLS). Segments are kept in a bounded ring of immutable packets shared by all the viewers.
+	URIs are relative: <name>.<sequence>.ts for a segment and <name>.<sequence>.<part>.ts for a partial segment.
+	/!\ Main thread only */
+struct HLSSegmenter : Media::Target, virtual Object {
+	struct Part : Packet, virtual Object {
+		Part(shared<Buffer>& pBuffer, UInt32 duration, bool independent) : Packet(pBuffer), duration(duration), independent(independent) {}
+		const UInt32	duration;
+		const bool		independent; // begins with a key frame (or audio only)
+	};
+	struct Segment : std::deque<Part>, virtual Object {
+		Segment(UInt32 sequence, UInt32 time, bool discontinuity) : sequence(sequence), time(time), duration(0), complete(false), discontinuity(discontinuity) {}
+		const UInt32	sequence;
+		const UInt32	time;
+		const bool		discontinuity;
+		UInt32			duration;
+		bool			complete;
+	};
+	/*!
+	Request waiting a segment or a partial segment (blocking playlist reload or preload hint),
+	onReady is raised with a null segmenter if segmenter is deleted before */
+	struct Waiter : virtual Object {
+		typedef Event<void(HLSSegmenter* pSegmenter)> ON(Ready);
+
+		Waiter() : sequence(0), part(-1), pSegmenter(NULL) {}
+		~Waiter() { if (pSegmenter) pSegmenter->unwait(*this); }
+
+		/*!
+		Waiting since 3 target durations, has to be answered even if unavailable (LL-HLS spec) */
+		bool expired() const { return pSegmenter && time.isElapsed(pSegmenter->targetDuration() * 3000); }
+
+		UInt32			sequence;
+		Int32			part; // -1 to wait the whole segment
+		Time			time;
+		HLSSegmenter*	pSegmenter;
+	};
+
+	/*!
+	Keep 'count' complete segments of 'duration' ms at less (cut on the next key frame),
+	'partDuration' is the partial segment target duration in ms, 0 disables LL-HLS */
+	HLSSegmenter(const std::string& name, UInt8 count = 6, UInt32 duration = 2000, UInt32 partDuration = 500);
+	~HLSSegmenter();
+
+	const std::string		name;
+	const UInt8				count;
+	const UInt32			duration;
+	const UInt32			partDuration;
+
+	const std::deque<Segment>&	segments() const { return _segments; }
+	const Segment*				segment(UInt32 sequence) const;
+	/*!
+	EXT-X-TARGETDURATION in seconds, rounded up to never be exceeded by a segment, see https://tools.ietf.org/html/rfc8216#section-4.3.3.1 */
+	UInt32						targetDuration() const { return _maxDuration > 1000 ? ((_maxDuration + 999) / 1000) : 1; }
+	/*!
+	Returns 1 if the segment (or its partial segment) is available, 0 if it's coming, -1 if it will never be available (too old or too far) */
+	Int8						available(UInt32 sequence, Int32 part = -1) const;
+	/*!
+	m3u8 playlist, built one time by segmenter change and shared by all the viewers */
+	const Packet&				playlist();
+
+	void						wait(Waiter& waiter);
+	void						unwait(Waiter& waiter);
+
+	bool beginMedia(const std::string& name, const Parameters& parameters);
+	bool writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Packet& packet, bool reliable);
+	bool writeVideo(UInt16 track, const Media::Video::Tag& tag, const Packet& packet, bool reliable);
+	void endMedia(const std::string& name);
+	void flush();
+
+private:
+	void cut(UInt32 time, bool independent);
+	void closePart(UInt32 time);
+
+	TSWriter						_writer;
+	MediaWriter::OnWrite			_onWrite;
+
+	std::deque<Segment>				_segments;
+	UInt32							_sequence;
+	UInt32							_discontinuities; // discontinuities removed from the ring (EXT-X-DISCONTINUITY-SEQUENCE)
+	bool							_discontinuity;
+	UInt32							_maxDuration;
+
+	shared<Buffer>					_pBuffer; // current partial segment
+	UInt32							_partTime;
+	bool							_partIndependent;
+	UInt32							_lastTime;
+
+	std::map<UInt16, Media::Video::Config> _videoConfigs;
+	bool							_newVideoConfig;
+	bool							_video;
+
+	Packet							_playlist;
+	bool							_changed;
+	std::set<Waiter*>				_waiters;
+};
+
+
+} // namespace Mona
@@ -141,14 +141,22 @@ struct HTTP : virtual Static {
 
 	static Type			 ParseType(const char* value, std::size_t size);
 	static UInt8		 ParseConnection(const char* value);
+	/*!
+	Returns true if 'coding' is accepted by the Accept-Encoding field 'value' (RFC 7231 5.3.4), 'value' can be null */
+	static bool			 AcceptEncoding(const char* value, const char* coding);
 
 	static bool			 WriteDirectoryEntries(Exception& ex, BinaryWriter& writer, const std::string& fullPath, const std::string& path, SortBy sortBy = SORTBY_NAME, Sort sort = SORT_ASC);
 
 	typedef std::function<void(const char* key, const char* data, UInt32 size)> OnCookie;
 	static bool			 WriteSetCookie(DataReader& reader, Buffer& buffer, const OnCookie& onCookie=nullptr);
 
+	/*!
+	Request header, fields are not copied: raw header stays in 'packet' where HTTPDecoder has ended in place every name and value with a '\0',
+	getString/getNumber/getBoolean/hasKey read fields here, and Parameters iteration lists just cookies */
 	struct Header : Parameters, virtual Object {
-		Header(const char* protocol, const SocketAddress& serverAddress);
+		Header(const char* protocol, const SocketAddress& serverAddress, const Packet& packet = Packet::Null());
+
+		const Packet	packet;
 
 		const char* protocol;
 
@@ -176,7 +184,14 @@ struct HTTP : virtual Static {
 
 		shared<WSDecoder>	pWSDecoder;
 
+		/*!
+		Parse a well-known field, 'value' must stay valid as long as header (in 'packet') */
 		void			set(const char* key, const char* value);
+		/*!
+		Copy "version", every field and cookies in 'parameters' (fields are not in the Header map) */
+		Parameters&		copyTo(Parameters& parameters) const;
+	private:
+		const char*		onParamUnfound(const std::string& key) const;
 	};
 
 
@@ -21,6 +21,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Mona.h"
 #include "Mona/HTTP/HTTPSender.h"
 #include "Mona/StringWriter.h"
+#include "Mona/Deflater.h"
 
 namespace Mona {
 
@@ -29,7 +30,7 @@ struct HTTPDataSender : HTTPSender, virtual Object {
 	HTTPDataSender(const shared<Socket>& pSocket,
 		const shared<const HTTP::Header>& pRequest,
 		shared<Buffer>& pSetCookie,
-		const char* code, MIME::Type mime, const char* subMime=NULL) : _mime(mime), _pBuffer(new Buffer(4, "\r\n\r\n")), _code(code), _subMime(subMime), HTTPSender("HTTPDataSender", pSocket, pRequest, pSetCookie) {
+		const char* code, MIME::Type mime, const char* subMime=NULL) : _mime(mime), _threshold(0), _pBuffer(new Buffer(4, "\r\n\r\n")), _code(code), _subMime(subMime), HTTPSender("HTTPDataSender", pSocket, pRequest, pSetCookie) {
 		if (!mime || !subMime || !(_pWriter = Media::Data::NewWriter(Media::Data::ToType(subMime), *_pBuffer)))
 			_pWriter = new StringWriter(*_pBuffer);
 	}
@@ -39,7 +40,7 @@ struct HTTPDataSender : HTTPSender, virtual Object {
 		const shared<const HTTP::Header>& pRequest,
 		shared<Buffer>& pSetCookie,
 		const char* errorCode, Args&&... args) :
-		_pBuffer(new Buffer(4, "\r\n\r\n")), _code(errorCode), _pWriter(NULL), _mime(MIME::TYPE_TEXT), _subMime("html; charset=utf-8"), HTTPSender("HTTPErrorSender", pSocket, pRequest, pSetCookie) {
+		_pBuffer(new Buffer(4, "\r\n\r\n")), _threshold(0), _code(errorCode), _pWriter(NULL), _mime(MIME::TYPE_TEXT), _subMime("html; charset=utf-8"), HTTPSender("HTTPErrorSender", pSocket, pRequest, pSetCookie) {
 		if (!_code)
 			_code = HTTP_CODE_406;
 		writeError(*_pBuffer, _code, std::forward<Args>(args)...);
@@ -49,9 +50,13 @@ struct HTTPDataSender : HTTPSender, virtual Object {
 
 
 	DataWriter&		writer() { return _pWriter ? *_pWriter : DataWriter::Null(); }
+	/*!
+	Compress content with 'pDeflater' (format negotiated before) if its size is at less 'threshold' bytes,
+	compression runs in the sending thread */
+	void			compress(const shared<Deflater>& pDeflater, UInt32 threshold) { _pDeflater = pDeflater; _threshold = threshold; }
 
 private:
-	void run(const HTTP::Header& request) { send(_code, _mime, _subMime, Packet(_pBuffer)); }
+	void run(const HTTP::Header& request);
 
 	const char*				_code;
 	MIME::Type				_mime;
@@ -59,6 +64,9 @@ private:
 
 	shared<Buffer>			_pBuffer;
 	DataWriter*				_pWriter;
+
+	shared<Deflater>		_pDeflater;
+	UInt32					_threshold;
 };
 
 
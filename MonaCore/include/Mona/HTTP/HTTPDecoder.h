@@ -29,18 +29,13 @@ namespace Mona {
 struct HTTPDecoder : Socket::Decoder, private StreamData<Socket&>, private Media::Source, virtual Object {
 	typedef Event<void(HTTP::Request&)> ON(Request);
 
-	HTTPDecoder(ServerAPI& api) : _pReader(NULL), _www(api.www), _decoded(0), _stage(CMD), _handler(api.handler) {
+	HTTPDecoder(ServerAPI& api) : _pReader(NULL), _www(api.www), _decoded(0), _scanned(0), _stage(HEADER), _handler(api.handler) {
 		FileSystem::MakeFile(_www);
 	}
 
 private:
-	// for header reading, keep this order!!
 	enum Stage {
-		CMD,
-		PATH,
-		VERSION,
-		LEFT,
-		RIGHT,
+		HEADER,
 		BODY,
 		PROGRESSIVE
 	};
@@ -56,6 +51,9 @@ private:
 
 	UInt32 decode(shared<Buffer>& pBuffer, const SocketAddress& address, const shared<Socket>& pSocket);
 	UInt32 onStreamData(Packet& buffer, Socket& socket);
+	/*!
+	Parse the complete header 'packet' (without its ending empty line) in place, without copy */
+	bool   parseHeader(const Packet& packet, Socket& socket);
 
 	template <typename ...Args>
 	void receive(Args&&... args) { _handler.queue(onRequest, std::forward<Args>(args)...); }
@@ -65,6 +63,7 @@ private:
 	shared<HTTP::Header>	_pHeader;
 	Path					_file;
 	UInt32					_decoded;
+	UInt32					_scanned; // header bytes already scanned without finding its end
 	std::string				_www;
 	const Handler&			_handler;
 	MediaReader*			_pReader;
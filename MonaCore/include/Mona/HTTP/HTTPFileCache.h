@@ -0,0 +1,109 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Path.h"
+#include "Mona/HTTP/HTTP.h"
+#include <list>
+
+namespace Mona {
+
+/*!
+	Bounded LRU cache of small static files shared by the HTTP sessions of one protocol, thread-safe (HTTPFileSender runs in the thread pool).
+	A file is checked on every hit with one stat against its last modification date and size, and reloaded if changed (reading is done out of the lock),
+	its entry keeps ready-to-send header fields and bodies, with precompressed variants when <file>.br or <file>.gz exists beside it */
+struct HTTPFileCache : virtual Object {
+	enum Encoding {
+		ENCODING_IDENTITY = 0,
+		ENCODING_GZIP,
+		ENCODING_BR,
+		ENCODING_COUNT
+	};
+	enum {
+		MAX_FILE_SIZE = 0x40000 // bigger files are not cached (read by IOFile)
+	};
+
+	/*!
+	Immutable cached file, can be sent by a HTTPFileSender even after its removing of the cache */
+	struct Entry : virtual Object {
+		struct Variant {
+			std::string	etag; // strong ETag, empty if variant is unavailable
+			Packet		header; // Last-Modified, ETag, Content-Encoding and Vary fields to pass to HTTPSender::send
+			Packet		body;
+		};
+		Entry() : mime(MIME::TYPE_UNKNOWN), subMime(NULL), size(0), lastModified(0) {}
+
+		MIME::Type	mime;
+		const char*	subMime;
+		Variant		variants[ENCODING_COUNT];
+		UInt32		size;
+		Int64		lastModified;
+
+		/*!
+		Best variant relating 'acceptEncoding' request field (can be null) */
+		const Variant& variant(const char* acceptEncoding) const;
+		/*!
+		True if client has already 'variant', If-None-Match has priority on If-Modified-Since (RFC 7232 6), 'ifNoneMatch' can be null */
+		bool		   notModified(const Variant& variant, const char* ifNoneMatch, Int64 ifModifiedSince) const;
+	};
+
+	HTTPFileCache(UInt32 capacity = 0x1000000) : _capacity(capacity), _size(0) {}
+
+	/*!
+	Capacity in bytes, 0 disables the cache */
+	UInt32	capacity() const { return _capacity; }
+	void	setCapacity(UInt32 capacity);
+
+	UInt32	size() const { return _size; }
+	UInt32	count() const { return _slots.size(); }
+
+	/*!
+	Get cached file, load it if not cached yet or changed, returns null if file can't be cached (unfound, too large, disabled cache) */
+	shared<const Entry> get(const Path& file);
+	void				clear();
+
+	static std::string& ETag(std::string& buffer, Int64 lastModified, UInt64 size, Encoding encoding = ENCODING_IDENTITY);
+	/*!
+	Weak comparison of If-None-Match value with 'etag' (RFC 7232 3.2) */
+	static bool			Match(const char* ifNoneMatch, const std::string& etag);
+
+private:
+	/*!
+	Slot without entry is loading, and is not in LRU list */
+	struct Slot : virtual Object {
+		Slot(const Path& file, Int64 lastModified, UInt64 size) : file(file), lastModified(lastModified), size(size) {}
+		const Path						file;
+		Int64							lastModified;
+		UInt64							size;
+		shared<const Entry>				pEntry;
+		std::list<Slot*>::iterator		it;
+	};
+	static shared<const Entry> Load(const Path& file, Int64 lastModified);
+	void remove(Slot& slot);
+
+	std::mutex						_mutex;
+	std::map<std::string, Slot>		_slots;
+	std::list<Slot*>				_lru; // most recently used in front
+	std::atomic<UInt32>				_capacity;
+	std::atomic<UInt32>				_size;
+};
+
+
+} // namespace Mona
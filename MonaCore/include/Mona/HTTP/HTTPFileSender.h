@@ -20,6 +20,7 @@ details (or else see http://www.gnu.org/licenses/).
 
 #include "Mona/Mona.h"
 #include "Mona/HTTP/HTTPSender.h"
+#include "Mona/HTTP/HTTPFileCache.h"
 
 
 namespace Mona {
@@ -31,7 +32,7 @@ struct HTTPFileSender : HTTPSender, FileReader, virtual Object {
 	HTTPFileSender(const shared<Socket>& pSocket,
 			   const shared<const HTTP::Header>& pRequest,
 			   shared<Buffer>& pSetCookie,
-				IOFile& ioFile, const Path& file, Parameters& properties);
+				IOFile& ioFile, HTTPFileCache& cache, const Path& file, Parameters& properties);
 
 
 	bool flush();
@@ -47,11 +48,13 @@ private:
 	};
 
 	void  run(const HTTP::Header& request);
-	bool  sendHeader(UInt64 fileSize);
+	bool  sendHeader(UInt64 fileSize, const std::string& etag);
+	bool  sendEntry(const HTTP::Header& request, const HTTPFileCache::Entry& entry);
 	void  sendFile(const Packet& packet);
 	
 	shared<File::Decoder> newDecoder();
 
+	HTTPFileCache&			_cache;
 	Parameters				_properties;
 	Path					_file;
 	Path					_appPath;
@@ -0,0 +1,63 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/HTTP/HTTPSender.h"
+
+namespace Mona {
+
+/*!
+	Send immutable packets shared between sessions (HLS playlist, segment or partial segment) without copy,
+	maxAge=0 means no-cache */
+struct HTTPSegmentSender : HTTPSender, virtual Object {
+	HTTPSegmentSender(const shared<Socket>& pSocket,
+		const shared<const HTTP::Header>& pRequest,
+		shared<Buffer>& pSetCookie,
+		MIME::Type mime, const char* subMime, UInt32 maxAge, std::vector<Packet>&& packets) : _mime(mime), _subMime(subMime), _maxAge(maxAge), _packets(std::move(packets)), HTTPSender("HTTPSegmentSender", pSocket, pRequest, pSetCookie) {}
+
+private:
+	void run(const HTTP::Header& request) {
+		shared<Buffer> pBuffer(new Buffer(4, "\r\n\r\n"));
+		BinaryWriter writer(*pBuffer);
+		HTTP_BEGIN_HEADER(writer)
+			if (_maxAge)
+				HTTP_ADD_HEADER("Cache-Control", "max-age=", _maxAge)
+			else
+				HTTP_ADD_HEADER("Cache-Control", "no-cache")
+		HTTP_END_HEADER
+		UInt64 size(0);
+		for (const Packet& packet : _packets)
+			size += packet.size();
+		if (!send(HTTP_CODE_200, _mime, _subMime, Packet(pBuffer), size) || request.type == HTTP::TYPE_HEAD)
+			return;
+		for (const Packet& packet : _packets) {
+			if (!send(packet))
+				return;
+		}
+	}
+
+	MIME::Type			_mime;
+	const char*			_subMime;
+	UInt32				_maxAge;
+	std::vector<Packet>	_packets;
+};
+
+
+} // namespace Mona
@@ -22,11 +22,13 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/QueryReader.h"
 #include "Mona/HTTP/HTTPWriter.h"
 #include "Mona/HTTP/HTTPDecoder.h"
+#include "Mona/HLSSegmenter.h"
 
 namespace Mona {
 
+struct HTTProtocol;
 struct HTTPSession : virtual Object, TCPSession {
-	HTTPSession(Protocol& protocol);
+	HTTPSession(HTTProtocol& protocol);
 
 private:
 	shared<Socket::Decoder> newDecoder();
@@ -34,6 +36,7 @@ private:
 
 	void			onParameters(const Parameters& parameters);
 	bool			manage();
+	UInt32			manageDelay();
 	void			flush();
 
 	void			close(); // usefull for Protocol upgrade like WebSocket upgrade
@@ -57,15 +60,27 @@ private:
 	void			processPost(Exception& ex, HTTP::Request& request);
 	void			processPut(Exception& ex, HTTP::Request& request);
 
+	/// \brief HLS GET on <name>.m3u8 or <name>.<sequence>[.<part>].ts, returns false if it's not a HLS request
+	bool			processHLS(Exception& ex, const Path& file);
+	void			writeHLS(HLSSegmenter* pSegmenter);
+	void			releaseHLS();
+
 	HTTPWriter			_writer;
 	Subscription*		_pSubscription;
 	Publication*		_pPublication;
 
 	unique<Session>		_pUpgradeSession;
 
+	HLSSegmenter::Waiter _hlsWaiter;
+	bool				_hlsPlaylist;
+
 	// options
 	std::string			_index;
 	bool				_indexDirectory;
+	std::string			_metrics;
+	UInt8				_hlsSegments;
+	UInt32				_hlsDuration;
+	UInt32				_hlsPartDuration;
 };
 
 
@@ -24,14 +24,19 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/HTTP/HTTPDataSender.h"
 #include "Mona/HTTP/HTTPMediaSender.h"
 #include "Mona/HTTP/HTTPFileSender.h"
+#include "Mona/HTTP/HTTPSegmentSender.h"
 
 namespace Mona {
 
 
 struct HTTPWriter : Writer, virtual Object {
-	HTTPWriter(TCPSession& session);
+	HTTPWriter(TCPSession& session, HTTPFileCache& fileCache);
 	~HTTPWriter();
 
+	/*!
+	Minimal size in bytes of data responses to compress (gzip or deflate) when client accepts it, 0 disables compression */
+	UInt32			compression;
+
 	void			beginRequest(const shared<const HTTP::Header>& pRequest);
 	void			endRequest();
 
@@ -45,8 +50,9 @@ struct HTTPWriter : Writer, virtual Object {
 	void			writeRaw(DataReader& reader);
 
 	bool			writeSetCookie(DataReader& reader, const HTTP::OnCookie& onCookie = nullptr) { if (!_pSetCookie) _pSetCookie.reset(new Buffer()); return HTTP::WriteSetCookie(reader, *_pSetCookie, onCookie); }
-	void			writeFile(const Path& file, Parameters& properties) { newSender<HTTPFileSender>(true, _session.api.ioFile, file, properties); }
+	void			writeFile(const Path& file, Parameters& properties) { newSender<HTTPFileSender>(true, _session.api.ioFile, _fileCache, file, properties); }
 	BinaryWriter&   writeRaw(const char* code);
+	void			writeSegment(MIME::Type mime, const char* subMime, UInt32 maxAge, std::vector<Packet>&& packets) { newSender<HTTPSegmentSender>(true, mime, subMime, maxAge, std::move(packets)); }
 
 	bool			beginMedia(const std::string& name, const Parameters& parameters);
 	bool			writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Packet& packet, bool reliable) { return newSender<HTTPMediaSend<Media::Audio>>(_pMediaWriter, track, tag, packet) ? true : false; }
@@ -93,6 +99,8 @@ private:
 
 	shared<MediaWriter>					_pMediaWriter;
 	TCPSession&							_session;
+	HTTPFileCache&						_fileCache;
+	shared<Deflater>					_pDeflater; // kept by connection to reuse zlib state
 	shared<Buffer>						_pSetCookie;
 
 	shared<const HTTP::Header>			_pRequest; // Last request
@@ -30,6 +30,12 @@ struct HTTProtocol : TCProtocol, virtual Object {
 		setNumber("port", pTLS ? 443 : 80);
 		setNumber("timeout", 7); // 7 seconds
 		setBoolean("index", true); // index directory, if false => forbid directory index, otherwise redirection to index
+		setNumber("hlsSegments", 6); // HLS segments kept in memory by publication
+		setNumber("hlsDuration", 2000); // HLS segment duration in ms, cut on the next key frame
+		setNumber("hlsPartDuration", 500); // LL-HLS partial segment duration in ms, 0 disables LL-HLS
+		setNumber("fileCache", fileCache.capacity()); // memory cache of small static files in bytes, 0 disables it
+		setNumber("compression", 1024); // minimal size in bytes of data responses to compress (gzip or deflate), 0 disables compression
+		setBoolean("metrics", false); // path of the Prometheus metrics (true for /metrics), disabled by default because its labels reveal publication names
 
 		onConnection = [this](const shared<Socket>& pSocket) {
 			// Create session
@@ -37,6 +43,15 @@ struct HTTProtocol : TCProtocol, virtual Object {
 		};
 	}
 	~HTTProtocol() { onConnection = nullptr; }
+
+	bool load(Exception& ex) {
+		if (!TCProtocol::load(ex))
+			return false;
+		fileCache.setCapacity(getNumber<UInt32>("fileCache"));
+		return true;
+	}
+
+	HTTPFileCache	fileCache;
 };
 
 
@@ -42,6 +42,9 @@ struct MIME : virtual Static {
 
 	static Type				Read(const Path& file, const char*& subType);
 	static Type				Read(const char* value, std::string& subType);
+	/*!
+	Read a Content-Type value without copy, 'subType' points in 'value' */
+	static Type				Read(const char* value, const char*& subType);
 	static BinaryWriter&	Write(BinaryWriter& writer, Type type, const char* subType=NULL);
 };
 
@@ -106,6 +106,28 @@ struct MediaFile : virtual Static {
 
 
 	struct Writer : Media::Target, Media::Stream, virtual Object {
+		enum Sync {
+			SYNC_NONE = 0, // let the system flush data to the disk
+			SYNC_END, // sync at the end of the recording
+			SYNC_FLUSH // sync after every flush
+		};
+		/*!
+		Recording defaults, overloadable by the beginMedia parameters with the same names:
+		- flushSize, size of the write-behind buffer flushed to the disk when full (clamped from 4KB to 8MB), 0 writes every media packet
+		- flushTime, flush the buffer if elapsed (in ms) since the last flush
+		- preallocation, disk space reserved ahead of writing, see File::preallocation
+		- direct, writes without system cache, see File::direct (ignored in append mode)
+		- sync, see Sync */
+		enum { FLUSH_SIZE_MIN = 0x1000, FLUSH_SIZE_MAX = 0x800000 };
+		static UInt32	FlushSize;
+		static UInt32	FlushTime;
+		static UInt32	Preallocation;
+		static bool		Direct;
+		static Sync		SyncMode;
+		/*!
+		Read "none", "end" or "flush" sync mode, returns false if unknown */
+		static bool ReadSync(const char* value, Sync& sync);
+
 		Writer(const Path& path, MediaWriter* pWriter, IOFile& io);
 		virtual ~Writer() { stop(); }
 
@@ -132,39 +154,43 @@ struct MediaFile : virtual Static {
 				return false; // Stream not started!
 			Exception ex;
 			bool success;
-			AUTO_ERROR(success = io.threadPool.queue(ex, std::make_shared<WriteType>(_pName, io, _pFile, _pWriter, args ...), _writeTrack), description());
+			AUTO_ERROR(success = io.threadPool.queue(ex, std::make_shared<WriteType>(_pName, _pOutput, _pWriter, args ...), _writeTrack), description());
 			if (success)
 				return true;
 			Stream::stop(ex);
 			return false;
 		}
 
+		/*!
+		Write-behind buffer of a recording, accessed only by the writing thread */
+		struct Output;
+
 		struct Write : Runner, virtual Object {
-			Write(const shared<std::string>& pName, IOFile& io, const shared<File>& pFile, const shared<MediaWriter>& pWriter);
+			Write(const shared<std::string>& pName, const shared<Output>& pOutput, const shared<MediaWriter>& pWriter);
 		protected:
 			MediaWriter::OnWrite	onWrite;
 			shared<MediaWriter>		pWriter;
+			shared<Output>			pOutput;
 		private:
 			virtual bool run(Exception& ex) { pWriter->beginMedia(onWrite); return true; }
 
-			shared<File>		_pFile;
 			shared<std::string>	_pName;
-			IOFile&				_io;
 		};
 
 		template<typename MediaType>
 		struct MediaWrite : Write, MediaType, virtual Object {
-			MediaWrite(const shared<std::string>& pName, IOFile& io, const shared<File>& pFile, const shared<MediaWriter>& pWriter,
-				   UInt16 track, const typename MediaType::Tag& tag, const Packet& packet) : Write(pName, io, pFile, pWriter), MediaType(track, tag, packet) {}
+			MediaWrite(const shared<std::string>& pName, const shared<Output>& pOutput, const shared<MediaWriter>& pWriter,
+				   UInt16 track, const typename MediaType::Tag& tag, const Packet& packet) : Write(pName, pOutput, pWriter), MediaType(track, tag, packet) {}
 			bool run(Exception& ex) { pWriter->writeMedia(MediaType::track, MediaType::tag, *this, onWrite); return true; }
 		};
 		struct EndWrite : Write, virtual Object {
-			EndWrite(const shared<std::string>& pName, IOFile& io, const shared<File>& pFile, const shared<MediaWriter>& pWriter) : Write(pName, io, pFile, pWriter) {}
-			bool run(Exception& ex) { pWriter->endMedia(onWrite); return true; }
+			EndWrite(const shared<std::string>& pName, const shared<Output>& pOutput, const shared<MediaWriter>& pWriter) : Write(pName, pOutput, pWriter) {}
+			bool run(Exception& ex);
 		};
 
 		File::OnError			_onError;
 		shared<File>			_pFile;
+		shared<Output>			_pOutput;
 		shared<MediaWriter>		_pWriter;
 		UInt16					_writeTrack;
 		bool					_running;
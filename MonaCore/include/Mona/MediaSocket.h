@@ -106,7 +106,9 @@ struct MediaSocket : virtual Static {
 
 
 	struct Writer : Media::Target, Media::Stream, virtual Object {
-		Writer(Media::Stream::Type type, const Path& path, MediaWriter* pWriter, const SocketAddress& address, IOSocket& io, const shared<TLS>& pTLS = nullptr);
+		/*!
+		bitrate in kbps paces UDP output (token bucket) to avoid burst loss on keyframes, 0 disables pacing */
+		Writer(Media::Stream::Type type, const Path& path, MediaWriter* pWriter, const SocketAddress& address, IOSocket& io, const Timer& timer, UInt32 bitrate = 0, const shared<TLS>& pTLS = nullptr);
 		virtual ~Writer() { stop(); }
 
 		void start();
@@ -115,8 +117,10 @@ struct MediaSocket : virtual Static {
 
 		const SocketAddress		address;
 		IOSocket&				io;
+		const Timer&			timer;
 		const Path				path;
-		UInt64					queueing() const { return _pSocket ? _pSocket->queueing() : 0; }
+		const UInt32			bitrate;
+		UInt64					queueing() const { return (_pSocket ? _pSocket->queueing() : 0) + (_pPacer ? _pPacer->queueing.load() : 0); }
 		const shared<Socket>&	socket();
 		Socket*					operator->() { return socket().get(); }
 
@@ -136,21 +140,61 @@ struct MediaSocket : virtual Static {
 				return false; // Stream not started!
 			Exception ex;
 			bool success;
-			AUTO_ERROR(success = io.threadPool.queue(ex, std::make_shared<SendType>(type, _pName, _pSocket, _pWriter, _pStreaming, args ...), _sendTrack), description());
-			if (success)
+			AUTO_ERROR(success = io.threadPool.queue(ex, std::make_shared<SendType>(type, _pName, _pSocket, _pWriter, _pStreaming, _pPacer, _fragmentSize, args ...), _sendTrack), description());
+			if (success) {
+				if (_pPacer && !_pacing) {
+					// arm pacing timer just while packets can be pending
+					_pacing = true;
+					timer.set(_onPacing, _pPacer->interval());
+				}
 				return true;
+			}
 			Stream::stop(ex);
 			return false;
 		}
 
+		/*!
+		Token bucket between MediaWriter::OnWrite and Socket::write, used only by the sending thread (_sendTrack) */
+		struct Pacer : virtual Object {
+			Pacer(UInt32 bitrate) : rate(UInt64(bitrate) * 125), queueing(0), sends(0), _credit(0), _time(0) {}
+
+			const UInt64			rate; // bytes/s
+			std::atomic<UInt64>		queueing;
+			std::atomic<UInt32>		sends; // Send runners alive, which can still push packets
+			/*!
+			Pacing cycle in ms */
+			UInt32			interval() const;
+
+			/*!
+			Bufferize packet to keep it beyond OnWrite */
+			void			push(Packet&& packet) { queueing += packet.size(); _packets.emplace_back(std::move(packet)); }
+			/*!
+			Next packet if sendable regarding the rate (or always if force), NULL otherwise */
+			const Packet*	front(bool force = false);
+			void			pop();
+		private:
+			std::deque<Packet>	_packets;
+			double				_credit;
+			Int64				_time;
+		};
+
 		struct Send : Runner, virtual Object {
-			Send(Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming);
+			Send(Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming, const shared<Pacer>& pPacer, UInt32 fragmentSize);
+			~Send() { if (pPacer) --pPacer->sends; }
 		protected:
 			MediaWriter::OnWrite	onWrite;
 			shared<MediaWriter>		pWriter;
+			shared<Pacer>			pPacer;
+
+			void write(const Packet& packet);
+			/*!
+			Write packets allowed by pacer */
+			void pace(bool force = false);
 		private:
 			virtual bool run(Exception& ex) { pWriter->beginMedia(onWrite); return true; }
 
+			Type					_type;
+			UInt32					_fragmentSize;
 			shared<Socket>			_pSocket;
 			shared<volatile bool>	_pStreaming;
 			shared<std::string>		_pName;
@@ -158,26 +202,34 @@ struct MediaSocket : virtual Static {
 
 		template<typename MediaType>
 		struct MediaSend : Send, MediaType, virtual Object {
-			MediaSend(Stream::Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming,
-				   UInt16 track, const typename MediaType::Tag& tag, const Packet& packet) : Send(type, pName, pSocket,pWriter, pStreaming), MediaType(track, tag, packet) {}
+			MediaSend(Stream::Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming, const shared<Pacer>& pPacer, UInt32 fragmentSize,
+				   UInt16 track, const typename MediaType::Tag& tag, const Packet& packet) : Send(type, pName, pSocket,pWriter, pStreaming, pPacer, fragmentSize), MediaType(track, tag, packet) {}
 			bool run(Exception& ex) { pWriter->writeMedia(MediaType::track, MediaType::tag, *this, onWrite); return true; }
 		};
 		struct EndSend : Send, virtual Object {
-			EndSend(Stream::Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming) : Send(type, pName, pSocket, pWriter, pStreaming) {}
-			bool run(Exception& ex) { pWriter->endMedia(onWrite); return true; }
+			EndSend(Stream::Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming, const shared<Pacer>& pPacer, UInt32 fragmentSize) : Send(type, pName, pSocket, pWriter, pStreaming, pPacer, fragmentSize) {}
+			bool run(Exception& ex) { pWriter->endMedia(onWrite); pace(true); return true; }
+		};
+		struct PaceSend : Send, virtual Object {
+			PaceSend(Stream::Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming, const shared<Pacer>& pPacer, UInt32 fragmentSize) : Send(type, pName, pSocket, pWriter, pStreaming, pPacer, fragmentSize) {}
+			bool run(Exception& ex) { pace(); return true; }
 		};
 
 		Socket::OnDisconnection			_onDisconnection;
 		Socket::OnFlush					_onFlush;
 		Socket::OnError					_onError;
+		Timer::OnTimer					_onPacing;
 
 		shared<Socket>					_pSocket;
 		shared<TLS>						_pTLS;
 		shared<MediaWriter>				_pWriter;
+		const UInt32					_fragmentSize; // TS in UDP is sent in datagrams of 7 TS packets, 0 sends every write as is
 		UInt16							_sendTrack;
 		bool							_subscribed;
 		shared<std::string>				_pName;
 		shared<volatile bool>			_pStreaming;
+		shared<Pacer>					_pPacer;
+		bool							_pacing;
 	};
 };
 
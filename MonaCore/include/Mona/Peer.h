@@ -63,6 +63,9 @@ struct Peer : Client, virtual Object {
 
 	bool						congested(UInt32 duration = Net::RTO_INIT) { return  _pNetStats ? _congestion(_pNetStats->queueing(), duration) : false;  }
 	UInt64						queueing() const { return _pNetStats ? _pNetStats->queueing() : 0; }
+	UInt32						congestionWindow() const { return _pNetStats ? _pNetStats->congestionWindow() : 0; }
+	UInt64						pacingRate() const { return _pNetStats ? _pNetStats->pacingRate() : 0; }
+	UInt32						inflight() const { return _pNetStats ? _pNetStats->inflight() : 0; }
 
 	
 	ICE&	ice(const Peer& peer);
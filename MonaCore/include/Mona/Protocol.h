@@ -30,6 +30,10 @@ struct Protocol : virtual Object, Parameters {
 
 	const SocketAddress	address; // protocol address
 
+	const shared<Memory::Account>	memory; // sending queues of the protocol sockets
+	const shared<Metrics::Traffic>	traffic; // bytes and packets of the protocol sockets
+	Metrics::Gauge					sessionCount;
+
 	ServerAPI&		api;
 	Sessions&		sessions;
 
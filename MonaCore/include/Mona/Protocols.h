@@ -123,8 +123,14 @@ private:
 		}
 
 		// Fix address after binding
-		if (pProtocol->socket())
+		if (pProtocol->socket()) {
 			address = pProtocol->socket()->address();
+			if (pProtocol->socket()->type == Socket::TYPE_DATAGRAM) {
+				// else TCP sockets are accounted by session
+				pProtocol->socket()->setAccount(pProtocol->memory);
+				pProtocol->socket()->setTraffic(pProtocol->traffic);
+			}
+		}
 		pProtocol->setString("host", address.host());
 		pProtocol->setNumber("port", address.port());
 
@@ -23,6 +23,8 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/ByteRate.h"
 #include "Mona/LostRate.h"
 #include "Mona/MediaFile.h"
+#include "Mona/HLSSegmenter.h"
+#include "Mona/Metrics.h"
 #include <set>
 
 namespace Mona {
@@ -85,6 +87,11 @@ struct Publication : Media::Source, Media::Properties, virtual NullableObject {
 	MediaFile::Writer*				recorder();
 	bool							recording() const { return _pRecording && ((MediaFile::Writer&)_pRecording->target).running(); }
 
+	HLSSegmenter*					segmenter() { return _pSegmenting ? (HLSSegmenter*)&_pSegmenting->target : NULL; }
+/*!
+	Start HLS segmentation if not already started (segmenter lives until publication stop), see HLSSegmenter */
+	HLSSegmenter&					startSegmenting(UInt8 count = 6, UInt32 duration = 2000, UInt32 partDuration = 500);
+
 	void							reportLost(UInt32 lost);
 	void							reportLost(Media::Type type, UInt32 lost);
 	void							reportLost(Media::Type type, UInt16 track, UInt32 lost);
@@ -109,6 +116,7 @@ struct Publication : Media::Source, Media::Properties, virtual NullableObject {
 private:
 	void startRecording(MediaFile::Writer& recorder, bool append);
 	void stopRecording();
+	void stopSegmenting();
 
 	void onParamChange(const std::string& key, const std::string* pValue) { _newProperties = true; Media::Properties::onParamChange(key, pValue); }
 	void onParamClear() { _newProperties = true; Media::Properties::onParamClear(); }
@@ -129,7 +137,10 @@ private:
 	bool							_newLost;
 	bool							_newProperties;
 
+	Metrics::Histogram				_fanout; // distribution time of one media packet to all the subscriptions
+
 	std::unique_ptr<Subscription>    _pRecording;
+	std::unique_ptr<Subscription>    _pSegmenting;
 };
 
 
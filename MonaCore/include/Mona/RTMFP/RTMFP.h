@@ -43,6 +43,7 @@ struct RTMFP : virtual Static {
 
 	enum { TIMESTAMP_SCALE = 4 };
 	enum { SENDABLE_MAX = 6 };
+	enum { RTO_MIN = 250 }; // ERTO minimum, see https://tools.ietf.org/html/rfc7016#section-3.5.2.2
 
 	enum {
 		SIZE_HEADER = 11,
@@ -107,9 +108,19 @@ struct RTMFP : virtual Static {
 		const UInt64 flowId;
 		const UInt32 lost;
 	};
+	/*!
+	SACK scoreboard of a writer acknowledgment (0x51 format: cumulative stage then couples of lost-1/received-1 ranges) */
+	struct Ack {
+		Ack(const Packet& packet, Int64 time);
+		const Int64									time; // reception time, to compute RTT without queueing delays
+		UInt64										stage; // cumulative stage acknowledged
+		UInt64										stageMax; // greatest stage received
+		std::vector<std::pair<UInt64, UInt64>>		holes; // stages lost [first, last] between stage and stageMax
+	};
 	struct Flush : virtual Object {
-		Flush(Int32 ping, bool keepalive, bool died, std::map<UInt64, Packet>& acks) :
-			ping(ping), acks(std::move(acks)), keepalive(keepalive), died(died) {}
+		Flush(Int64 time, Int32 ping, bool keepalive, bool died, std::map<UInt64, Packet>& acks) :
+			time(time), ping(ping), acks(std::move(acks)), keepalive(keepalive), died(died) {}
+		const Int64						time; // reception time
 		const Int32						ping; // if died, ping takes error
 		const bool						keepalive;
 		const bool						died;
@@ -153,6 +164,13 @@ struct RTMFP : virtual Static {
 	static UInt16			TimeNow() { return Time(Mona::Time::Now()); }
 	static UInt16			Time(Int64 time) { return UInt16(time / RTMFP::TIMESTAMP_SCALE); }
 
+	/*!
+	Jacobson/Karels estimator, updates srtt and rttvar with a RTT sample in ms and returns the new RTO, see https://tools.ietf.org/html/rfc6298 */
+	static UInt32			RTO(double& srtt, double& rttvar, Int64 rtt);
+	/*!
+	Repeat delay after a timeout */
+	static UInt32			Backoff(UInt32 delay) { return delay < 7072 ? UInt32(delay * 1.4142) : 10000; }
+
 
 	static BinaryWriter&	WriteAddress(BinaryWriter& writer, const SocketAddress& address, Location location);
 
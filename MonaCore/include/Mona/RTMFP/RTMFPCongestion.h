@@ -0,0 +1,142 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/RTMFP/RTMFP.h"
+#include <atomic>
+
+namespace Mona {
+
+/*!
+Congestion controller of a RTMFP session output, used just by RTMFPSender thread (excepting stats getters which are thread-safe).
+Window and pacing are in bytes, times in milliseconds */
+struct RTMFPCongestion : virtual Object {
+	/*!
+	Create a controller from its name: "fixed" (legacy window of RTMFP::SENDABLE_MAX packets), "reno", "cubic" or "bbr".
+	Returns NULL if name is unknown */
+	static RTMFPCongestion* New(const std::string& name);
+
+	const char* name;
+
+	UInt32	cwnd() const { return _cwnd; }
+	/*!
+	Pacing rate in bytes/second, 0 means no pacing */
+	UInt64	pacingRate() const { return _pacingRate; }
+	UInt32	inflight() const { return _inflight; }
+
+	/*!
+	Return true if a packet of size bytes can be sent now, regarding window and pacing */
+	bool	sendable(UInt32 size);
+	/*!
+	Return true if the last sendable refusal comes from pacing (and not from window) */
+	bool	paced() const { return _paced; }
+
+	void	onSent(UInt32 size);
+	/*!
+	Bytes acknowledged (cumulative or selectively), rtt is the sample got on this ack or 0 */
+	void	onAcked(UInt32 size, UInt32 rtt, UInt32 srtt);
+	/*!
+	Bytes which leave the network without acknowledgment (writer reset for example) */
+	void	onReleased(UInt32 size);
+	/*!
+	Hole detected by a SACK, window is reduced just once by RTT */
+	void	onLost(UInt32 srtt);
+	/*!
+	Retransmission timeout, window collapses just once by RTO even if several writers of the session time out */
+	void	onTimeout(UInt32 rto);
+
+protected:
+	RTMFPCongestion(const char* name, UInt32 cwnd = RTMFP::SENDABLE_MAX * RTMFP::SIZE_PACKET);
+
+	virtual void acked(UInt32 size, UInt32 rtt, UInt32 srtt) {}
+	virtual void lost() {}
+	virtual void timeout() {}
+
+	UInt32	minRTT() const { return _minRTT; }
+	void	setCwnd(UInt32 cwnd) { _cwnd = cwnd < (2 * RTMFP::SIZE_PACKET) ? (2 * RTMFP::SIZE_PACKET) : cwnd; }
+	void	setPacingRate(UInt64 rate) { _pacingRate = rate; }
+
+private:
+	std::atomic<UInt32>	_cwnd;
+	std::atomic<UInt64>	_pacingRate;
+	std::atomic<UInt32>	_inflight;
+	UInt32				_minRTT;
+	Int64				_minRTTTime;
+	Int64				_recoveryTime;
+	Int64				_timeoutTime;
+	// pacing token bucket
+	double				_credit;
+	Int64				_creditTime;
+	bool				_paced;
+};
+
+/*!
+Reno/NewReno window, slow start then AIMD */
+struct RTMFPReno : RTMFPCongestion, virtual Object {
+	RTMFPReno(const char* name = "reno") : RTMFPCongestion(name), _ssthresh(0xFFFFFFFF) {}
+protected:
+	void acked(UInt32 size, UInt32 rtt, UInt32 srtt);
+	void lost();
+	void timeout();
+
+	UInt32	_ssthresh;
+};
+
+/*!
+CUBIC window, see https://tools.ietf.org/html/rfc8312 */
+struct RTMFPCubic : RTMFPReno, virtual Object {
+	RTMFPCubic() : RTMFPReno("cubic"), _wMax(0), _k(0), _epoch(0) {}
+private:
+	void acked(UInt32 size, UInt32 rtt, UInt32 srtt);
+	void lost();
+	void timeout();
+
+	double	_wMax; // in packets
+	double	_k;
+	Int64	_epoch;
+};
+
+/*!
+BBR-like controller: pacing on bottleneck bandwidth estimation, window = 2 x BDP */
+struct RTMFPBBR : RTMFPCongestion, virtual Object {
+	RTMFPBBR();
+private:
+	void acked(UInt32 size, UInt32 rtt, UInt32 srtt);
+	void timeout();
+	void update();
+
+	enum State {
+		STATE_STARTUP = 0,
+		STATE_DRAIN,
+		STATE_PROBE_BW
+	};
+	State	_state;
+	double	_gain;
+	UInt8	_cycle;
+	Int64	_cycleTime;
+	// bandwidth estimation
+	UInt64	_bandwidth; // max filter, bytes/s
+	Int64	_bandwidthTime;
+	UInt64	_fullBandwidth;
+	UInt8	_fullRounds;
+	UInt32	_delivered;
+	Int64	_deliveredTime;
+};
+
+} // namespace Mona
@@ -23,47 +23,40 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Runner.h"
 #include "Mona/AMFWriter.h"
 #include "Mona/LostRate.h"
-#include "Mona/RTMFP/RTMFP.h"
+#include "Mona/RTMFP/RTMFPCongestion.h"
 
 namespace Mona {
 
 struct RTMFPSender : Runner, virtual Object {
 	struct Packet : Mona::Packet, virtual Object {
-		Packet(shared<Buffer>& pBuffer, UInt32 fragments, bool reliable) : fragments(fragments), Mona::Packet(pBuffer), reliable(reliable), _sizeSent(0) {}
+		Packet(shared<Buffer>& pBuffer, UInt32 fragments, bool reliable) : fragments(fragments), Mona::Packet(pBuffer), reliable(reliable), acked(false), _sizeSent(0), _sendTime(0), _repeated(false) {}
 		void setSent() {
-			if (_sizeSent)
+			_sendTime = Time::Now();
+			if (_sizeSent) {
+				_repeated = true;
 				return;
+			}
 			_sizeSent = size();
 			if (!reliable)
 				Mona::Packet::reset(); // release immediatly an unreliable packet!
 		}
 		const bool   reliable;
 		const UInt32 fragments;
+		bool		 acked; // selectively acknowledged (received after a hole)
 		UInt32		 sizeSent() const { return _sizeSent; }
+		Int64		 sendTime() const { return _sendTime; }
+		/*!
+		Karn's algorithm, a repeated packet can't give a RTT sample */
+		bool		 repeated() const { return _repeated; }
 	private:
 		UInt32 _sizeSent;
-	};
-	struct Session : virtual Object {
-		Session(const shared<RTMFP::Session>& pSession, const shared<Socket>& pSocket) :
-			sendable(RTMFP::SENDABLE_MAX), socket(*pSocket), pEncoder(new RTMFP::Engine(*pSession->pEncoder)),
-			queueing(0), _pSocket(pSocket), _pSession(pSession), sendLostRate(sendByteRate), sendTime(0) {}
-		UInt32					id() const { return _pSession->id; }
-		UInt32					farId() const { return _pSession->farId; }
-		std::atomic<Int64>&		initiatorTime() { return _pSession->initiatorTime; }
-		shared<RTMFP::Engine>	pEncoder;
-		Socket&					socket;
-		std::atomic<Int64>		sendTime;
-		ByteRate				sendByteRate;
-		LostRate				sendLostRate;
-		std::atomic<UInt64>		queueing;
-		UInt8					sendable;
-	private:
-		shared<Socket>			_pSocket;
-		shared<RTMFP::Session>	_pSession;
+		Int64  _sendTime;
+		bool   _repeated;
 	};
 	struct Queue : virtual Object, std::deque<shared<Packet>> {
 		template<typename SignatureType>
-		Queue(UInt64 id, UInt64 flowId, const SignatureType& signature) : id(id), stage(0), stageSending(0), stageAck(0), signature(STR signature.data(), signature.size()), flowId(flowId) {}
+		Queue(UInt64 id, UInt64 flowId, const SignatureType& signature) : id(id), stage(0), stageSending(0), stageAck(0), signature(STR signature.data(), signature.size()), flowId(flowId), waiting(false) {}
+		~Queue();
 
 		const UInt64				id;
 		const UInt64				flowId;
@@ -74,8 +67,40 @@ struct RTMFPSender : Runner, virtual Object {
 		UInt64						stageSending;
 		UInt64						stageAck;
 		std::deque<shared<Packet>>	sending;
+		std::atomic<bool>			waiting; // in Session::waitings
+		shared<RTMFPCongestion>		pCongestion; // to release its inflight bytes on deletion
 	};
 
+	struct Session : virtual Object {
+		Session(const shared<RTMFP::Session>& pSession, const shared<Socket>& pSocket, RTMFPCongestion* pCongestion) :
+			pCongestion(pCongestion), paced(false), socket(*pSocket), pEncoder(new RTMFP::Engine(*pSession->pEncoder)),
+			queueing(0), _pSocket(pSocket), _pSession(pSession), sendLostRate(sendByteRate), sendTime(0), _srtt(0), _rttvar(0), _rto(0) {}
+		UInt32					id() const { return _pSession->id; }
+		UInt32					farId() const { return _pSession->farId; }
+		std::atomic<Int64>&		initiatorTime() { return _pSession->initiatorTime; }
+		/*!
+		Jacobson/Karels estimator, see https://tools.ietf.org/html/rfc6298 */
+		void					setRTT(Int64 rtt);
+		UInt32					srtt() const { return UInt32(_srtt); }
+		/*!
+		Return 0 while no RTT sample */
+		UInt32					rto() const { return _rto; }
+		shared<RTMFP::Engine>	pEncoder;
+		Socket&					socket;
+		std::atomic<Int64>		sendTime;
+		ByteRate				sendByteRate;
+		LostRate				sendLostRate;
+		std::atomic<UInt64>		queueing;
+		const shared<RTMFPCongestion>	pCongestion;
+		std::deque<shared<Queue>>		waitings; // queues waiting congestion window or pacing
+		std::atomic<bool>				paced; // a queue waits pacing
+	private:
+		shared<Socket>			_pSocket;
+		shared<RTMFP::Session>	_pSession;
+		double					_srtt;
+		double					_rttvar;
+		std::atomic<UInt32>		_rto;
+	};
 	// Flush usage!
 	RTMFPSender(const shared<Queue>& pQueue) : Runner("RTMFPSender"), pQueue(pQueue) {}
 
@@ -88,11 +113,24 @@ protected:
 
 	shared<Queue>	pQueue;
 
+	/*!
+	Repeat packets not acknowledged, stageMax>0 limits repeatition to SACK holes lower than stageMax */
+	void	repeat(UInt64 stageMax = 0);
+
 private:
+	bool		 flush(const shared<Queue>& pFlushing);
+	void		 sendAbandon(UInt64 stage);
+
 	bool		 run(Exception& ex);
 	virtual void run() {}
 };
 
+/*!
+Flush queues waiting pacing */
+struct RTMFPPacer : RTMFPSender, virtual Object {
+	RTMFPPacer() : RTMFPSender("RTMFPPacer") {}
+};
+
 struct RTMFPCmdSender : RTMFPSender, virtual Object {
 	RTMFPCmdSender(UInt8 cmd) : RTMFPSender("RTMFPCmdSender"), _cmd(cmd) {}
 private:
@@ -102,20 +140,17 @@ private:
 };
 
 struct RTMFPAcquiter : RTMFPSender, virtual Object {
-	RTMFPAcquiter(const shared<RTMFPSender::Queue>& pQueue, UInt64 stageAck) : RTMFPSender("RTMFPAcquiter", pQueue), _stageAck(stageAck) {}
+	RTMFPAcquiter(const shared<RTMFPSender::Queue>& pQueue, RTMFP::Ack& ack) : RTMFPSender("RTMFPAcquiter", pQueue), _ack(std::move(ack)) {}
 private:
 	void	run();
 
-	UInt64	_stageAck;
+	RTMFP::Ack	_ack;
 };
 
 struct RTMFPRepeater : RTMFPSender, virtual Object {
-	RTMFPRepeater(const shared<RTMFPSender::Queue>& pQueue, UInt8 fragments = 0) : RTMFPSender("RTMFPRepeater", pQueue), _fragments(fragments) {}
+	RTMFPRepeater(const shared<RTMFPSender::Queue>& pQueue) : RTMFPSender("RTMFPRepeater", pQueue) {}
 private:
-	void	run();
-	void	sendAbandon(UInt64 stage);
-
-	UInt8	_fragments;
+	void	run() { pSession->pCongestion->onTimeout(pSession->rto()); repeat(); }
 };
 
 
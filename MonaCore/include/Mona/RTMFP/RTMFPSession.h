@@ -60,6 +60,9 @@ private:
 	UInt64				sendByteRate() const { return _pSenderSession->sendByteRate; }
 	double				sendLostRate() const { return _pSenderSession->sendLostRate; }
 	UInt64				queueing() const;
+	UInt32				congestionWindow() const { return _pSenderSession ? _pSenderSession->pCongestion->cwnd() : 0; }
+	UInt64				pacingRate() const { return _pSenderSession ? _pSenderSession->pCongestion->pacingRate() : 0; }
+	UInt32				inflight() const { return _pSenderSession ? _pSenderSession->pCongestion->inflight() : 0; }
 
 	void				onParameters(const Parameters& parameters);
 	bool				keepalive();
@@ -70,7 +73,7 @@ private:
 	// Implementation of RTMFPOutput
 	shared<RTMFPWriter>	newWriter(UInt64 flowId, const Packet& signature);
 	UInt64				resetWriter(UInt64 id);
-	UInt32				rto() const { return peer.rto(); }
+	UInt32				rto() const { UInt32 rto(_pSenderSession ? _pSenderSession->rto() : 0); return rto ? rto : peer.rto(); }
 	void				send(const shared<RTMFPSender>& pSender);
 
 	UInt8									_killing;
@@ -85,6 +88,8 @@ private:
 
 	shared<RTMFP::Session>					_pSession;
 	shared<RTMFPSender::Session>			_pSenderSession;
+	Timer::OnTimer							_onPacing;
+	bool									_pacing;
 
 	Time									_recvTime;
 	ByteRate								_recvByteRate;
@@ -32,7 +32,7 @@ struct RTMFPWriter : FlashWriter, virtual Object {
 	Writer&		newWriter() { return **_writers.emplace(_output.newWriter(_pQueue->flowId, Packet(_pQueue->signature.data(), _pQueue->signature.size()))).first; }
 
 	UInt64		queueing() const { return _output.queueing(); }
-	void		acquit(UInt64 stageAck, UInt32 lostCount);
+	void		acquit(RTMFP::Ack& ack);
 	bool		consumed() { return _writers.empty() && closed() && !_pSender && _pQueue.unique() && _pQueue->empty(); }
 
 	template <typename ...Args>
@@ -52,7 +52,7 @@ private:
 	void				flushing();
 	void				fail();
 
-	void				repeatMessages(UInt32 lostCount =0); // fragments=0 means all possible!
+	void				repeatMessages();
 	AMFWriter&			newMessage(bool reliable, const Packet& packet = Packet::Null());
 	AMFWriter&			write(AMF::Type type, UInt32 time, Media::Data::Type packetType, const Packet& packet, bool reliable);
 	
@@ -61,7 +61,6 @@ private:
 	shared<RTMFPSender>					_pSender;
 	shared<RTMFPSender::Queue>			_pQueue;
 	UInt64								_stageAck;
-	UInt32								_lostCount;
 	UInt32								_repeatDelay;
 	Time								_repeatTime;
 	std::set<shared<RTMFPWriter>>		_writers;
@@ -31,6 +31,7 @@ struct RTMPSession : TCPSession, virtual Object {
 
 private:
 	bool			manage();
+	UInt32			manageDelay();
 	void			flush();
 	void			kill(Int32 error=0, const char* reason = NULL);
 	
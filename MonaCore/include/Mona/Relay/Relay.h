@@ -0,0 +1,115 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Media.h"
+#include "Mona/Runner.h"
+#include "Mona/Socket.h"
+#include <deque>
+
+namespace Mona {
+
+/*!
+Binary relay between an origin and its edges, multiplexes publications over one TCP connection by edge
+FRAME		[UInt32=>size][UInt8=>type][7bit=>stream id][...body...]
+Edge to origin:
+SUBSCRIBE	[7bit=>window][...name...]
+UNSUBSCRIBE
+ACK			[7bit=>bytes] media bytes consumed, origin drops media beyond window bytes unacknowledged (except key frames)
+Origin to edge:
+MEDIA		[UInt8=>size header][tag header or data type + track(UInt16=>optional)][...data...] (MonaWriter header)
+PROPERTIES	[string=>key][string=>value]...
+END			publication stopped or reseted */
+struct Relay : virtual Static {
+	enum Type {
+		TYPE_SUBSCRIBE = 1,
+		TYPE_UNSUBSCRIBE,
+		TYPE_ACK,
+		TYPE_MEDIA,
+		TYPE_PROPERTIES,
+		TYPE_END
+	};
+	enum { FRAME_MAX = 0x1000000 }; // 16MB, a bigger frame is a protocol error
+
+	/*!
+	Frames sent in one vectored writing, media payloads are referenced (no copy) */
+	struct Sender : Runner, virtual Object {
+		Sender(const shared<Socket>& pSocket) : Runner("RelaySender"), _pSocket(pSocket), _pBuffer(new Buffer()), _writer(*_pBuffer), _frame(0), _body(0) {}
+
+		/*!
+		Begin a frame, its body has to be written in the returned writer before to end it */
+		BinaryWriter&	begin(Type type, UInt32 id);
+		/*!
+		End the frame with an optional payload, returns the body size */
+		UInt32			end(const Packet& payload = Packet::Null());
+
+		UInt32			writeMedia(UInt32 id, UInt16 track, const Media::Audio::Tag& tag, const Packet& packet) { WriteMedia(begin(TYPE_MEDIA, id), track, tag); return end(packet); }
+		UInt32			writeMedia(UInt32 id, UInt16 track, const Media::Video::Tag& tag, const Packet& packet) { WriteMedia(begin(TYPE_MEDIA, id), track, tag); return end(packet); }
+		UInt32			writeMedia(UInt32 id, UInt16 track, Media::Data::Type type, const Packet& packet) { WriteMedia(begin(TYPE_MEDIA, id), track, type); return end(packet); }
+
+	private:
+		bool			run(Exception& ex);
+
+		shared<Socket>							_pSocket;
+		shared<Buffer>							_pBuffer;
+		BinaryWriter							_writer;
+		UInt32									_frame; // position of the current frame
+		UInt32									_body; // position of the current frame body
+		std::deque<std::pair<UInt32, Packet>>	_payloads; // position in buffer => payload, deque to never copy a Packet (copy is a reference)
+	};
+
+	/*!
+	Read complete frames of buffer, onFrame(Type type, UInt32 id, const Packet& body) returns false to stop reading,
+	returns the size of the rest to keep (incomplete frame), or 0 with ex set on a frame empty or bigger than FRAME_MAX */
+	template<typename OnFrame>
+	static UInt32 Read(Exception& ex, const Packet& buffer, const OnFrame& onFrame) {
+		BinaryReader reader(buffer.data(), buffer.size());
+		while (reader.available() >= 4) {
+			UInt32 size(BinaryReader(reader.current(), 4).read32());
+			if (!size || size > FRAME_MAX) {
+				ex.set<Ex::Protocol>("Invalid relay frame size ", size);
+				return 0;
+			}
+			if (size > (reader.available() - 4))
+				break;
+			reader.next(4);
+			BinaryReader frame(reader.current(), size);
+			reader.next(size);
+			Type type(Type(frame.read8()));
+			UInt32 id(frame.read7BitEncoded());
+			if (!onFrame(type, id, Packet(buffer, frame.current(), frame.available())))
+				return 0;
+		}
+		return reader.available();
+	}
+
+	static BinaryWriter&	WriteMedia(BinaryWriter& writer, UInt16 track, const Media::Audio::Tag& tag) { return WriteTrack(tag.pack(writer.write8(tag.packSize() + (track ? 2 : 0))), track); }
+	static BinaryWriter&	WriteMedia(BinaryWriter& writer, UInt16 track, const Media::Video::Tag& tag) { return WriteTrack(tag.pack(writer.write8(tag.packSize() + (track ? 2 : 0))), track); }
+	static BinaryWriter&	WriteMedia(BinaryWriter& writer, UInt16 track, Media::Data::Type type) { return WriteTrack(writer.write8(track ? 3 : 1).write8(type), track); }
+	/*!
+	Read a MEDIA body to write it in source, returns false if the body is invalid */
+	static bool				ReadMedia(const Packet& body, Media::Source& source);
+
+private:
+	static BinaryWriter&	WriteTrack(BinaryWriter& writer, UInt16 track) { return track ? writer.write16(track) : writer; }
+};
+
+
+} // namespace Mona
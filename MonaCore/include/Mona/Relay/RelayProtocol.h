@@ -0,0 +1,45 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/TCProtocol.h"
+#include "Mona/Relay/RelaySession.h"
+
+namespace Mona {
+
+/*!
+Origin server of Relay, see Relay and Relayer for edge side */
+struct RelayProtocol : TCProtocol, virtual Object {
+	RelayProtocol(const char* name, ServerAPI& api, Sessions& sessions) : TCProtocol(name, api, sessions) {
+
+		setNumber("port", 1937);
+		setNumber("timeout", 60); // 60 seconds, edge disconnects when it relays nothing
+
+		onConnection = [this](const shared<Socket>& pSocket) {
+			// Create session
+			this->sessions.create<RelaySession>(*this).connect(pSocket);
+		};
+	}
+	~RelayProtocol() { onConnection = nullptr; }
+
+};
+
+
+} // namespace Mona
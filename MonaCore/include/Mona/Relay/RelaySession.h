@@ -0,0 +1,75 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/TCPSession.h"
+#include "Mona/Subscription.h"
+#include "Mona/Relay/Relay.h"
+
+namespace Mona {
+
+/*!
+Origin side of Relay, one session by edge and one subscription by stream relayed */
+struct RelaySession : TCPSession, virtual Object {
+	RelaySession(Protocol& protocol);
+
+private:
+	/*!
+	Target of one stream, drops media beyond its window of unacknowledged bytes to not penalize other streams */
+	struct Stream : Media::Target, virtual Object {
+		Stream(RelaySession& session, UInt32 id, UInt32 window) : id(id), subscription(*this), _session(session), _window(window), _unacked(0), _waitKeyFrame(false) {}
+
+		const UInt32	id;
+		Subscription	subscription;
+
+		UInt64			queueing() const { return _unacked > _window ? (_unacked - _window) : 0; }
+		void			ack(UInt32 bytes) { _unacked = bytes < _unacked ? (_unacked - bytes) : 0; }
+
+	private:
+		bool			beginMedia(const std::string& name, const Parameters& parameters) { return true; }
+		bool			writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Packet& packet, bool reliable);
+		bool			writeVideo(UInt16 track, const Media::Video::Tag& tag, const Packet& packet, bool reliable);
+		bool			writeData(UInt16 track, Media::Data::Type type, const Packet& packet, bool reliable);
+		bool			writeProperties(const Media::Properties& properties);
+		void			endMedia(const std::string& name);
+		void			flush() { _session.flush(); }
+
+		bool			drop();
+
+		RelaySession&	_session;
+		UInt32			_window;
+		UInt64			_unacked;
+		bool			_waitKeyFrame;
+	};
+
+	Relay::Sender&	sender();
+
+	bool			onFrame(Relay::Type type, UInt32 id, const Packet& body);
+
+	void			flush();
+	bool			manage();
+	void			kill(Int32 error = 0, const char* reason = NULL);
+
+	std::map<UInt32, Stream>	_streams;
+	shared<Relay::Sender>		_pSender;
+};
+
+
+} // namespace Mona
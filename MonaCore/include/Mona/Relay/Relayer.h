@@ -0,0 +1,75 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/TCPClient.h"
+#include "Mona/Publication.h"
+#include "Mona/Relay/Relay.h"
+
+namespace Mona {
+
+/*!
+Edge side of Relay, pulls from origin the publications subscribed without publisher here,
+one connection multiplexes all the streams, each one with its window of bytes in flight (see Relay) */
+struct Relayer : virtual Object {
+	Relayer(IOSocket& io);
+
+	const SocketAddress&	origin() const { return _origin; }
+	bool					running() const { return _origin ? true : false; }
+
+	void					start(const SocketAddress& origin, UInt32 window = 0x100000);
+	void					stop();
+
+	/*!
+	Start publication and pull its media from origin, returns false if relay is stopped or publication is already publishing */
+	bool					pull(Publication& publication);
+	/*!
+	Stop publication pulled, returns false if publication is not pulled */
+	bool					release(Publication& publication);
+	/*!
+	Reconnect origin if disconnected and acknowledges media received */
+	void					manage();
+
+private:
+	struct Stream : virtual Object {
+		Stream(Publication& publication) : publication(publication), received(0), flushing(false) {}
+		Publication&	publication;
+		UInt32			received; // bytes not yet acknowledged
+		bool			flushing;
+	};
+
+	bool					connect();
+	void					subscribe(UInt32 id, const Publication& publication);
+	void					ack(UInt32 id, Stream& stream);
+	bool					onFrame(Relay::Type type, UInt32 id, const Packet& body);
+	Relay::Sender&			sender();
+	void					flush();
+
+	TCPClient						_client;
+	SocketAddress					_origin;
+	UInt32							_window;
+	UInt32							_nextId;
+	std::map<UInt32, Stream>		_streams;
+	std::map<Publication*, UInt32>	_ids;
+	shared<Relay::Sender>			_pSender;
+};
+
+
+} // namespace Mona
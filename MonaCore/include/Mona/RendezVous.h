@@ -21,6 +21,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Mona.h"
 #include "Mona/SocketAddress.h"
 #include "Mona/Entity.h"
+#include "Mona/HashMap.h"
 
 namespace Mona {
 
@@ -38,6 +39,8 @@ struct RendezVous : virtual Object {
 
 private:
 	struct Peer : virtual Object {
+		Peer(const UInt8* peerId) : pData(NULL) { memcpy(id, peerId, sizeof(id)); }
+		UInt8					id[Entity::SIZE]; // key of _peers, caller peerId can be a temporary
 		SocketAddress			address;
 		SocketAddress			serverAddress;
 		std::set<SocketAddress> addresses;
@@ -48,8 +51,8 @@ private:
 
 	
 	std::mutex _mutex;
-	std::map<const UInt8*, Peer, Entity::Comparator>	_peers;
-	std::map<SocketAddress, Peer*>						_peersByAddress;
+	HashMap<const UInt8*, unique<Peer>, Entity::Hash, Entity::Equal>	_peers;
+	HashMap<SocketAddress, Peer*, SocketAddress::Hash>					_peersByAddress;
 		
 };
 
@@ -21,6 +21,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Mona.h"
 #include "Mona/Sessions.h"
 #include "Mona/Publish.h"
+#include "Mona/Watchdog.h"
 
 namespace Mona {
 
@@ -61,6 +62,7 @@ private:
 
 	Handler			_handler;
 	Timer			_timer;
+	Watchdog		_watchdog;
 	Protocols		_protocols;
 	Sessions		_sessions;
 	Path			_application;
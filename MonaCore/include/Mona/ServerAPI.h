@@ -27,6 +27,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/TLS.h"
 #include "Mona/Protocols.h"
 #include "Mona/Client.h"
+#include "Mona/Relay/Relayer.h"
 
 namespace Mona {
 
@@ -105,6 +106,8 @@ protected:
 	ServerAPI(const Path& application, const Path& www, const Handler& handler, const Protocols& protocols, const Timer& timer, UInt16 cores=0);
 	
 	void					manage();
+
+	Relayer					relayer; // edge relay, pulls publications without publisher here from an origin
 private:
 
 	bool					subscribe(Exception& ex, std::string& stream, Subscription& subscription, Client* pClient);
@@ -69,10 +69,21 @@ struct Session : virtual Object {
 	/*!
 	Manage every 2 seconds */
 	virtual bool manage();
+	/*!
+	Time in ms before the next manage required (timeout or ping deadline), 0 to be managed every 2 seconds (default).
+	Allows to Sessions to skip idle sessions, call wake() when session leaves its idle state */
+	virtual UInt32 manageDelay();
+	/*!
+	Pause or resume data reception (memory backpressure on publishers), returns false if unsupported (socket shared between sessions) */
+	virtual bool pauseReception(bool pause) { return false; }
 
 protected:
 	const bool			died; // keep it protected because just Sessions can check if session is died to delete it!
 
+	/*!
+	Manage the session on next Sessions::manage, without waiting its manageDelay */
+	void wake();
+
 	Session(Protocol& protocol, const SocketAddress& address, const char* name=NULL);
 	Session(Protocol& protocol, const shared<Peer>& pPeer, const char* name = NULL);
 	/*!
@@ -87,6 +98,7 @@ private:
 	mutable std::string			_name;
 	SESSION_OPTIONS				_sessionsOptions;
 	Protocol&					_protocol;
+	UInt32						_manageTick;
 
 
 	friend struct Sessions;
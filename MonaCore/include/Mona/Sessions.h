@@ -22,6 +22,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Socket.h"
 #include "Mona/Logs.h"
 #include "Mona/Entity.h"
+#include "Mona/HashMap.h"
 #include <set>
 
 namespace Mona {
@@ -33,11 +34,12 @@ enum {
 };
 
 /*!
-Allow to manage sessions + override obsolete session on address duplication */
+Allow to manage sessions + override obsolete session on address duplication,
+manage() touches just the sessions due on this tick (timing wheel), idle sessions are rescheduled on their next deadline */
 struct Session;
 struct Sessions : virtual Object {
 
-	Sessions() {}
+	Sessions() : _tick(0), _pressure(Memory::PRESSURE_NONE) {}
 	virtual ~Sessions();
 
 	template<typename SessionType = Session>
@@ -75,12 +77,8 @@ struct Sessions : virtual Object {
 		if (it != _freeIds.end()) {
 			id = *it;
 			_freeIds.erase(it);
-		} else {
-			if (_sessions.empty())
-				id = 1;
-			else
-				id = _sessions.rbegin()->first + 1;
-		}
+		} else // free ids are reused in first, so without free id, ids are 1 to size
+			id = _sessions.size() + 1;
 
 		while (!_sessions.emplace(id, pSession).second) {
 			CRITIC("Bad computing session id, id ", id, " already exists");
@@ -92,6 +90,7 @@ struct Sessions : virtual Object {
 		pSession->_sessionsOptions = options;
 		addByPeer(*pSession);
 		addByAddress(*pSession);
+		schedule(*pSession);
 		DEBUG(pSession->name(), " created");
 		return *pSession;
 	}
@@ -99,8 +98,21 @@ struct Sessions : virtual Object {
 	void	 manage();
 	
 private:
+	enum {
+		WHEEL_SIZE = 64 // ticks of 2 seconds, a session idle more than 128 seconds is just rescheduled
+	};
+
+	void    remove(const HashMap<UInt32, Session*>::iterator& it, SESSION_OPTIONS options);
+
+	/*!
+	Manage session in 'ticks' manage calls (1 = next manage) */
+	void	schedule(Session& session, UInt32 ticks = 1);
+	void	wake(UInt32 id);
 
-	void    remove(const std::map<UInt32, Session*>::iterator& it, SESSION_OPTIONS options);
+	/*!
+	Memory backpressure: on high pressure pauses publishers reception then evicts the biggest sending queues if it persists,
+	resumes publishers once memory is back under the low watermark */
+	void	relieve();
 
 	void	addByPeer(Session& session);
 	void	removeByPeer(Session& session);
@@ -109,10 +121,19 @@ private:
 	void	removeByAddress(Session& session);
 	void	removeByAddress(const SocketAddress& address, Session& session);
 
-	std::map<UInt32, Session*>			_sessions;
-	std::set<UInt32>					_freeIds;
-	Entity::Map<Session>				_sessionsByPeerId;
-	std::map<SocketAddress, Session*>	_sessionsByAddress[2]; // 0 - UDP, 1 - TCP
+	HashMap<UInt32, Session*>													_sessions;
+	std::set<UInt32>															_freeIds;
+	HashMap<const UInt8*, Session*, Entity::Hash, Entity::Equal>				_sessionsByPeerId;
+	HashMap<SocketAddress, Session*, SocketAddress::Hash>						_sessionsByAddress[2]; // 0 - UDP, 1 - TCP
+
+	std::vector<UInt32>															_wheel[WHEEL_SIZE]; // session ids by tick
+	std::vector<UInt32>															_dues;
+	UInt32																		_tick; // next tick
+
+	Memory::Pressure															_pressure;
+	std::set<UInt32>															_paused; // session ids with reception paused
+
+	friend struct Session;
 };
 
 
@@ -45,6 +45,8 @@ struct TCPSession : Session, private TCPClient, virtual Object {
 
 	virtual	void kill(Int32 error=0, const char* reason = NULL);
 
+	bool pauseReception(bool pause);
+
 protected:
 	/*!
 	Subscribe to this event to receive data in child session, or overloads newDecoder() function */
@@ -54,6 +56,7 @@ protected:
 
 	virtual void onParameters(const Parameters& parameters);
 	virtual bool manage();
+	virtual UInt32 manageDelay();
 	
 private:
 	void setSocketParameters(Socket& socket, const Parameters& parameters);
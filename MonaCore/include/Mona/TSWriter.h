@@ -38,7 +38,7 @@ class TSWriter : public MediaWriter, public virtual Object {
 		core error: ES_OUT_RESET_PCR called */
 public:
 	
-	TSWriter() : _version(0)  {}
+	TSWriter() : _version(0), _psiChanged(true) {}
 	~TSWriter();
 
 	void beginMedia(const OnWrite& onWrite);
@@ -46,15 +46,25 @@ public:
 	void writeVideo(UInt16 track, const Media::Video::Tag& tag, const Packet& packet, const OnWrite& onWrite);
 	void endMedia(const OnWrite& onWrite);
 
+	/*!
+	Write PAT+PMT of current tracks (nothing if no track), allows to repeat it on every segment beginning for example */
+	void writePMT(UInt32 time, const OnWrite& onWrite);
+
 private:
-	void	updatePMT(UInt32 time, const OnWrite& onWrite);
-	void    writePMT(UInt32 time, const OnWrite& onWrite);
+	/*!
+	Every frame is muxed in one contiguous buffer of 188 bytes TS packets, delivered in one onWrite call by flush */
+	Buffer&	buffer(UInt32 size);
+	void	flush(const OnWrite& onWrite);
+
+	void	updatePMT(UInt32 time);
+	void    writePMT(UInt32 time);
+	void	writePSI();
 
 	
-	void   writeES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, const Packet& packet, UInt32 esSize, const OnWrite& onWrite, bool randomAccess=true);
+	void   writeES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, const Packet& packet, UInt32 esSize, bool randomAccess=true);
 	
-	UInt8  writePES(UInt16 pid, UInt8& counter, UInt32 time, bool randomAccess, UInt32 size, const OnWrite& onWrite);
-	UInt8  writePES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, bool randomAccess, UInt32 size, const OnWrite& onWrite);
+	UInt8  writePES(UInt16 pid, UInt8& counter, UInt32 time, bool randomAccess, UInt32 size);
+	UInt8  writePES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, bool randomAccess, UInt32 size);
 
 	UInt8  writeAdaptiveHeader(UInt16 pid, UInt32 time, bool randomAccess, UInt8 fillSize, BinaryWriter& writer);
 
@@ -72,6 +82,9 @@ private:
 	UInt32						_timePMT;
 
 	UInt8						_buffer[188];
+	shared<Buffer>				_pBuffer;
+	UInt8						_psi[376]; // PAT+PMT cached, continuity counters patched on every write
+	bool						_psiChanged;
 	UInt8						_canWrite;
 	UInt32						_toWrite;
 };
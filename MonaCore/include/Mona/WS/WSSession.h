@@ -32,6 +32,7 @@ struct WSSession : Session, virtual Object {
 	WSWriter	writer;
 
 	bool		manage();
+	UInt32		manageDelay();
 	void		flush();
 	void		kill(Int32 error=0, const char* reason = NULL);
 
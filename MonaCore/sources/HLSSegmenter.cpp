@@ -0,0 +1,238 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/HLSSegmenter.h"
+#include "Mona/Logs.h"
+
+using namespace std;
+
+namespace Mona {
+
+typedef String::Format<double> Seconds;
+
+HLSSegmenter::HLSSegmenter(const string& name, UInt8 count, UInt32 duration, UInt32 partDuration) :
+	name(name), count(count ? count : 1), duration(duration), partDuration(partDuration), _maxDuration(duration),
+	_sequence(0), _discontinuities(0), _discontinuity(false), _partTime(0), _partIndependent(false), _lastTime(0),
+	_newVideoConfig(false), _video(false), _changed(false),
+	_onWrite([this](const Packet& packet) {
+		// packet is a whole muxed frame
+		if (_segments.empty() || _segments.back().complete)
+			return; // no segment opened, wait a key frame (PAT+PMT are written on segment beginning)
+		if (!_pBuffer)
+			_pBuffer.reset(new Buffer());
+		_pBuffer->append(packet.data(), packet.size());
+	}) {
+	DEBUG("HLS segmenter ", name, " created");
+}
+
+HLSSegmenter::~HLSSegmenter() {
+	set<Waiter*> waiters(move(_waiters));
+	for (Waiter* pWaiter : waiters) {
+		pWaiter->pSegmenter = NULL;
+		pWaiter->onReady(NULL);
+	}
+	DEBUG("HLS segmenter ", name, " deleted");
+}
+
+const HLSSegmenter::Segment* HLSSegmenter::segment(UInt32 sequence) const {
+	if (_segments.empty() || sequence < _segments.front().sequence || sequence > _segments.back().sequence)
+		return NULL;
+	return &_segments[sequence - _segments.front().sequence];
+}
+
+Int8 HLSSegmenter::available(UInt32 sequence, Int32 part) const {
+	if (sequence >= _sequence) // coming, but no more than 2 segments later
+		return sequence > (_sequence + 1) ? -1 : 0;
+	const Segment* pSegment(segment(sequence));
+	if (!pSegment)
+		return -1; // removed
+	return (pSegment->complete || (part >= 0 && UInt32(part) < pSegment->size())) ? 1 : 0;
+}
+
+void HLSSegmenter::wait(Waiter& waiter) {
+	waiter.pSegmenter = this;
+	waiter.time.update();
+	_waiters.emplace(&waiter);
+}
+
+void HLSSegmenter::unwait(Waiter& waiter) {
+	waiter.pSegmenter = NULL;
+	_waiters.erase(&waiter);
+}
+
+const Packet& HLSSegmenter::playlist() {
+	if (_playlist)
+		return _playlist;
+	shared<Buffer> pBuffer(new Buffer());
+	BinaryWriter writer(*pBuffer);
+	String::Append(writer, "#EXTM3U\n#EXT-X-VERSION:", partDuration ? 6 : 3, "\n#EXT-X-TARGETDURATION:", targetDuration(), '\n');
+	if (partDuration) {
+		String::Append(writer, "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=", Seconds("%.3f", partDuration * 3 / 1000.0), '\n');
+		String::Append(writer, "#EXT-X-PART-INF:PART-TARGET=", Seconds("%.3f", partDuration / 1000.0), '\n');
+	} else
+		writer.write(EXPAND("#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES\n"));
+	String::Append(writer, "#EXT-X-MEDIA-SEQUENCE:", _segments.empty() ? _sequence : _segments.front().sequence, '\n');
+	if (_discontinuities)
+		String::Append(writer, "#EXT-X-DISCONTINUITY-SEQUENCE:", _discontinuities, '\n');
+
+	// partial segments are useless for the old segments, keep them just on the 3 last ones
+	UInt32 partsFrom(_segments.size() > 3 ? _segments[_segments.size() - 3].sequence : 0);
+	for (const Segment& segment : _segments) {
+		if (segment.discontinuity)
+			writer.write(EXPAND("#EXT-X-DISCONTINUITY\n"));
+		if (partDuration && segment.sequence >= partsFrom) {
+			UInt32 index(0);
+			for (const Part& part : segment) {
+				String::Append(writer, "#EXT-X-PART:DURATION=", Seconds("%.3f", part.duration / 1000.0), ",URI=\"", name, '.', segment.sequence, '.', index++, ".ts\"");
+				writer.write(part.independent ? ",INDEPENDENT=YES\n" : "\n");
+			}
+		}
+		if (segment.complete)
+			String::Append(writer, "#EXTINF:", Seconds("%.3f", segment.duration / 1000.0), ",\n", name, '.', segment.sequence, ".ts\n");
+	}
+	if (partDuration && !_segments.empty()) {
+		const Segment& segment(_segments.back());
+		if (segment.complete)
+			String::Append(writer, "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"", name, '.', segment.sequence + 1, ".0.ts\"\n");
+		else
+			String::Append(writer, "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"", name, '.', segment.sequence, '.', segment.size(), ".ts\"\n");
+	}
+	return _playlist.set(pBuffer);
+}
+
+bool HLSSegmenter::beginMedia(const string& name, const Parameters& parameters) {
+	_discontinuity = !_segments.empty();
+	_writer.beginMedia(_onWrite);
+	return true;
+}
+
+bool HLSSegmenter::writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Packet& packet, bool reliable) {
+	if (!tag.isConfig)
+		cut(tag.time, !_video); // audio is a cut point just without video
+	_writer.writeAudio(track, tag, packet, _onWrite);
+	return true;
+}
+
+bool HLSSegmenter::writeVideo(UInt16 track, const Media::Video::Tag& tag, const Packet& packet, bool reliable) {
+	if (tag.frame == Media::Video::FRAME_CONFIG) {
+		// hold config to repeat it before the key frame of every segment
+		_videoConfigs[track].set(tag, packet);
+		_newVideoConfig = true;
+		return true;
+	}
+	_video = true;
+	cut(tag.time, tag.frame == Media::Video::FRAME_KEY);
+	if (_newVideoConfig) {
+		_newVideoConfig = false;
+		for (const auto& it : _videoConfigs) {
+			Media::Video::Tag config(it.second);
+			config.time = tag.time;
+			_writer.writeVideo(it.first, config, it.second, _onWrite);
+		}
+	}
+	_writer.writeVideo(track, tag, packet, _onWrite);
+	return true;
+}
+
+void HLSSegmenter::endMedia(const string& name) {
+	_writer.endMedia(_onWrite);
+	if (!_segments.empty() && !_segments.back().complete) {
+		Segment& segment(_segments.back());
+		closePart(_lastTime);
+		if (segment.empty()) {
+			// nothing in, remove it to keep sequence numbers contiguous
+			_segments.pop_back();
+			--_sequence;
+		} else {
+			segment.duration = _lastTime - segment.time;
+			segment.complete = true;
+		}
+		_playlist.reset();
+		_changed = true;
+	}
+	_pBuffer.reset();
+	_videoConfigs.clear();
+	_newVideoConfig = _video = false;
+	_discontinuity = true;
+}
+
+void HLSSegmenter::flush() {
+	if (!_changed)
+		return;
+	_changed = false;
+	vector<Waiter*> readies;
+	auto it = _waiters.begin();
+	while (it != _waiters.end()) {
+		if (!available((*it)->sequence, (*it)->part)) {
+			++it;
+			continue;
+		}
+		(*it)->pSegmenter = NULL;
+		readies.emplace_back(*it);
+		it = _waiters.erase(it);
+	}
+	for (Waiter* pWaiter : readies)
+		pWaiter->onReady(this);
+}
+
+void HLSSegmenter::cut(UInt32 time, bool independent) {
+	_lastTime = time;
+	if (!_segments.empty() && !_segments.back().complete) {
+		Segment& segment(_segments.back());
+		if (!independent || Int32(time - segment.time) < Int32(duration)) {
+			// cut partial segment a little before its target duration to never exceed it
+			if (partDuration && _pBuffer && _pBuffer->size() && Int32(time - _partTime) >= Int32(partDuration - partDuration / 10)) {
+				closePart(time);
+				_partIndependent = independent;
+			}
+			return;
+		}
+		closePart(time);
+		segment.duration = time - segment.time;
+		segment.complete = true;
+		if (segment.duration > _maxDuration)
+			_maxDuration = segment.duration;
+		while (_segments.size() > count) {
+			if (_segments.front().discontinuity)
+				++_discontinuities;
+			_segments.pop_front();
+		}
+	} else if (!independent)
+		return; // wait a key frame to begin a new segment
+
+	_segments.emplace_back(_sequence++, time, _discontinuity);
+	_discontinuity = false;
+	_partTime = time;
+	_partIndependent = true;
+	if (!_pBuffer || !_pBuffer->size())
+		_writer.writePMT(time, _onWrite); // every segment begins with PAT+PMT (nothing before the first track)
+	_newVideoConfig = !_videoConfigs.empty();
+	_playlist.reset();
+	_changed = true;
+}
+
+void HLSSegmenter::closePart(UInt32 time) {
+	if (!_pBuffer || !_pBuffer->size() || _segments.empty())
+		return;
+	_segments.back().emplace_back(_pBuffer, time - _partTime, _partIndependent); // capture buffer, immutable now
+	_partTime = time;
+	_playlist.reset();
+	_changed = true;
+}
+
+} // namespace Mona
@@ -34,7 +34,7 @@ bool HTTP::Send(Socket& socket, const Packet& packet) {
 	return result >= 0;
 }
 
-HTTP::Header::Header(const char* protocol, const SocketAddress& serverAddress) : accessControlRequestMethod(0), protocol(protocol),
+HTTP::Header::Header(const char* protocol, const SocketAddress& serverAddress, const Packet& packet) : packet(move(packet)), accessControlRequestMethod(0), protocol(protocol),
 	mime(MIME::TYPE_UNKNOWN),
 	type(TYPE_UNKNOWN),
 	version(0),
@@ -49,9 +49,55 @@ HTTP::Header::Header(const char* protocol, const SocketAddress& serverAddress) :
 	host(serverAddress) {
 }
 
-void HTTP::Header::set(const char* key, const char* value) {
-	value = setString(key, value).c_str();
+const char* HTTP::Header::onParamUnfound(const string& key) const {
+	if (!packet)
+		return NULL;
+	const char* line(STR packet.data());
+	const char* end(line + packet.size());
+	if (key == "version") {
+		if (!version)
+			return NULL;
+		// request line is "<command>\0<path>\0HTTP/<version>\0"
+		line += strlen(line) + 1;
+		line += strlen(line) + 1;
+		while (isblank(*line))
+			++line;
+		return line + 5;
+	}
+	// then every field line is "<name>\0[blanks]<value>\0[blanks]\r\n"
+	while ((line = STR memchr(line, '\n', end - line)) && ++line < end) {
+		if (String::ICompare(line, key) != 0)
+			continue;
+		line += key.size() + 1;
+		while (isblank(*line))
+			++line;
+		return line;
+	}
+	return NULL;
+}
 
+Parameters& HTTP::Header::copyTo(Parameters& parameters) const {
+	const char* value(onParamUnfound("version"));
+	if (value)
+		parameters.setString("version", value);
+	if (packet) {
+		const char* line(STR packet.data());
+		const char* end(line + packet.size());
+		while ((line = STR memchr(line, '\n', end - line)) && ++line < end) {
+			const char* lineEnd(STR memchr(line, '\n', end - line));
+			// name is ended by a '\0' on valid field line
+			if (!(value = STR memchr(line, 0, (lineEnd ? lineEnd : end) - line)) || value == line)
+				continue;
+			while (isblank(*++value));
+			parameters.setString(line, value);
+		}
+	}
+	for (const auto& it : *this)
+		parameters.setString(it.first, it.second); // cookies
+	return parameters;
+}
+
+void HTTP::Header::set(const char* key, const char* value) {
 	if (String::ICompare(key, "content-type") == 0) {
 		mime = MIME::Read(value, subMime);
 		if (!mime)
@@ -166,6 +212,31 @@ UInt8 HTTP::ParseConnection(const char* value) {
 	return type;
 }
 
+bool HTTP::AcceptEncoding(const char* value, const char* coding) {
+	// "<coding>;q=0" refuses explicitly the coding
+	if (!value)
+		return false;
+	size_t size(strlen(coding));
+	const char* cur(value);
+	while (*cur) {
+		while (*cur == ',' || isspace(*cur))
+			++cur;
+		const char* token(cur);
+		while (*cur && *cur != ',' && *cur != ';' && !isspace(*cur))
+			++cur;
+		bool found(size_t(cur - token) == size && String::ICompare(token, coding, size) == 0);
+		double quality(1);
+		while (*cur && *cur != ',') {
+			if ((*cur == 'q' || *cur == 'Q') && cur[1] == '=')
+				quality = atof(cur + 2);
+			++cur;
+		}
+		if (found)
+			return quality > 0;
+	}
+	return false;
+}
+
 struct EntriesComparator {
 	EntriesComparator(HTTP::SortBy sortBy, HTTP::Sort sort) : _sortBy(sortBy), _sort(sort) {}
 
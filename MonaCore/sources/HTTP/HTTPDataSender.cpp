@@ -0,0 +1,53 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/HTTP/HTTPDataSender.h"
+
+using namespace std;
+
+
+namespace Mona {
+
+void HTTPDataSender::run(const HTTP::Header& request) {
+	if (_pDeflater) {
+		// content begins after the header fields
+		const UInt8* content(_pBuffer->data());
+		while (memcmp(content++, EXPAND("\r\n\r\n")) != 0);
+		content += 3;
+		UInt32 size(UInt32(_pBuffer->data() + _pBuffer->size() - content));
+		if (size >= _threshold) {
+			shared<Buffer> pBuffer(new Buffer(UInt32(content - _pBuffer->data()), _pBuffer->data()));
+			BinaryWriter writer(*pBuffer);
+			HTTP_BEGIN_HEADER(writer)
+				HTTP_ADD_HEADER("Content-Encoding", _pDeflater->format == Deflater::FORMAT_GZIP ? "gzip" : "deflate");
+				HTTP_ADD_HEADER("Vary", "Accept-Encoding");
+			HTTP_END_HEADER
+			Exception ex;
+			bool success;
+			AUTO_ERROR(success = _pDeflater->deflate(ex, content, size, *pBuffer), "HTTP compression");
+			if (success) {
+				send(_code, _mime, _subMime, Packet(pBuffer));
+				return;
+			}
+		}
+	}
+	send(_code, _mime, _subMime, Packet(_pBuffer));
+}
+
+
+} // namespace Mona
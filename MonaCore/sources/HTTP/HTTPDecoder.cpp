@@ -34,6 +34,18 @@ UInt32 HTTPDecoder::decode(shared<Buffer>& pBuffer, const SocketAddress& address
 	return 0;
 }
 
+/*!
+Returns the end of the header (after its last field line) or NULL if '\r\n\r\n' is not found,
+memchr scans with SIMD instructions on the common libraries */
+static const UInt8* FindHeaderEnd(const UInt8* data, UInt32 size) {
+	const UInt8* end(data + size);
+	while ((data = BIN memchr(data, '\n', end - data)) && (end - ++data) >= 2) {
+		if (data[0] == '\r' && data[1] == '\n')
+			return data;
+	}
+	return NULL;
+}
+
 UInt32 HTTPDecoder::onStreamData(Packet& buffer, Socket& socket) {
 	if (_pUpgradeDecoder)
 		return _pUpgradeDecoder->onStreamData(buffer, socket);
@@ -45,143 +57,29 @@ UInt32 HTTPDecoder::onStreamData(Packet& buffer, Socket& socket) {
 	}
 
 	do {
-		/// read data
-		char* signifiant(STR buffer.data());
-		char* key(NULL);
-
-		while (_stage<BODY) {
-
-			if (buffer.size() < 2) {
-				// useless to parse if we have not at less one line which  to carry \r\n\r\n!
-				UInt32 rest(key ? (STR buffer.data() - key) : (STR buffer.data() - signifiant));
-				_decoded += rest;
-				if (rest > 0x2000) {
-					_ex.set<Ex::Protocol>("HTTP header too large (>8KB)");
-					break;
-				}
-				return rest;
-			}
-
-			if (!_pHeader)
-				_pHeader.reset(new HTTP::Header(socket.isSecure() ? "https" : "http", socket.address()));
-	
-			// if == '\r\n' (or '\0\n' since that it can have been modified for key/value parsing)
-			if (*buffer.data()=='\r' && *(buffer.data()+1) == '\n') {
-
-				if (_stage == LEFT) {
-					// \r\n\r\n!
-					buffer += 2;
-					_decoded -= 2;
-
-					// Try to fix mime if no content-type with file extension!
-					if (!_pHeader->mime)
-						_pHeader->mime = MIME::Read(_file, _pHeader->subMime);
-	
-					_pHeader->getNumber("content-length", _length = -1);
-
-					// Upgrade session?
-					if (_pHeader->connection&HTTP::CONNECTION_UPGRADE && String::ICompare(_pHeader->upgrade, "websocket") == 0) {
-						_pHeader->pWSDecoder.reset(new WSDecoder(_handler));
-						_pUpgradeDecoder = _pHeader->pWSDecoder;
-					}
-
-					_stage = BODY;
-					switch (_pHeader->type) {
-						case HTTP::TYPE_UNKNOWN:
-							_ex.set<Ex::Protocol>("No HTTP type");
-							break;
-						case HTTP::TYPE_POST:
-							if (_pHeader->mime != MIME::TYPE_VIDEO && _pHeader->mime != MIME::TYPE_AUDIO) {
-								if(_length<0)
-									_ex.set<Ex::Protocol>("HTTP post request without content-length (authorized just for POST media streaming or PUT request)");
-								break;
-							}
-							// Publish = POST + VIDEO/AUDIO
-							_pReader = MediaReader::New(_pHeader->subMime);
-							if (!_pReader)
-								_ex.set<Ex::Unsupported>("HTTP ", _pHeader->subMime, " publication unsupported");
-						case HTTP::TYPE_PUT:
-							_stage = PROGRESSIVE;
-							break;
-						case HTTP::TYPE_GET:
-							if (_pHeader->mime == MIME::TYPE_VIDEO || _pHeader->mime == MIME::TYPE_AUDIO)
-								_file.exists(); // preload disk attributes now in the thread!
-						default:
-							_length = 0;
-					}
-					break;
-				}
-
-				// KEY = VALUE
-				char* endValue(STR buffer.data());
-				while (isblank(*--endValue));
-
-				String::Scoped scoped(++endValue);
-				if (!key) { // version case!
-					String::ToNumber(signifiant + 5, _pHeader->version);
-					_pHeader->setNumber("version", _pHeader->version);
-				} else {
-					char* endValue(signifiant-1);
-					while (isblank(*--endValue)); // after the :
-					while (isblank(*--endValue)); // before the :
-					String::Scoped scoped(++endValue);
-					_pHeader->set(key, signifiant);
-					key = NULL;
-				}
-		
-				_stage = LEFT;
+		if (_stage == HEADER) {
+			// ignore empty lines before a request (RFC 7230 3.5)
+			while (buffer.size() >= 2 && buffer.data()[0] == '\r' && buffer.data()[1] == '\n') {
 				buffer += 2;
 				_decoded -= 2;
-				signifiant = STR buffer.data();
-				continue;
 			}
-
-			if ((_stage == LEFT || _stage == CMD || _stage == PATH) && isspace(*buffer.data())) {
-				if (_stage == CMD) {
-					// by default command == GET
-					size_t size(STR buffer.data() - signifiant);
-					if (!size) {
-						_ex.set<Ex::Protocol>("No HTTP command");
-						break;
-					}
-					if (!(_pHeader->type = HTTP::ParseType(signifiant, size))) {
-						_ex.set<Ex::Protocol>("Unknown HTTP type ", string(signifiant, 3));
-						break;
-					}
-					signifiant = STR buffer.data();
-					_stage = PATH;
-				} else if (_stage == PATH) {
-					// parse query
-					String::Scoped scoped(STR buffer.data());
-					size_t filePos = Util::UnpackUrl(signifiant, _pHeader->path, _pHeader->query);
-					if (filePos != string::npos) {
-						// is file!
-						_file.set(_www, _pHeader->path);
-						_pHeader->path.erase(filePos - 1);
-					} else
-						_file.set(_www, _pHeader->path, '/');
-					signifiant = STR buffer.data();
-					_stage = VERSION;
-				}
-				// We are on a space char, so trim it
-				++signifiant;
-			} else if (_stage <= VERSION) {
-				if (_stage == CMD && (STR buffer.data() - signifiant) > 7) { // not a HTTP valid packet, consumes all
-					_ex.set<Ex::Protocol>("Invalid HTTP packet");
-					break;
+			const UInt8* end(FindHeaderEnd(buffer.data() + _scanned, buffer.size() - _scanned));
+			if (!end) {
+				if (buffer.size() > 0x2000) {
+					_ex.set<Ex::Protocol>("HTTP header too large (>8KB)");
+				} else {
+					// wait the header end, next time rescan just the 3 last bytes which can be the beginning of \r\n\r\n
+					_scanned = buffer.size() > 3 ? (buffer.size() - 3) : 0;
+					return buffer.size();
 				}
-			} else if (!key && *buffer.data() == ':') {
-				// KEY
-				key = signifiant;
-				_stage = LEFT;
-				signifiant = STR buffer.data() + 1;
-			} else
-				_stage = RIGHT;
-
-			--_decoded;
-			++buffer;
-		}; // WHILE < BODY
-
+			} else {
+				_scanned = 0;
+				Packet header(buffer, buffer.data(), UInt32(end - buffer.data()));
+				buffer += header.size() + 2;
+				_decoded -= header.size() + 2;
+				parseHeader(header, socket);
+			}
+		}
 
 		// RECEPTION
 
@@ -205,7 +103,7 @@ UInt32 HTTPDecoder::onStreamData(Packet& buffer, Socket& socket) {
 			_length -= packet.size();
 		}
 		if(!_length)
-			_stage = CMD;
+			_stage = HEADER;
 	
 		_decoded -= packet.size();
 		buffer += packet.size();
@@ -226,4 +124,99 @@ UInt32 HTTPDecoder::onStreamData(Packet& buffer, Socket& socket) {
 }
 
 
+bool HTTPDecoder::parseHeader(const Packet& packet, Socket& socket) {
+	_pHeader.reset(new HTTP::Header(socket.isSecure() ? "https" : "http", socket.address(), packet));
+	// Request line, <command> <path> HTTP/<version>
+	char* line(STR packet.data());
+	char* end(line + packet.size());
+	char* lineEnd(STR memchr(line, '\r', end - line));
+	if (!lineEnd)
+		lineEnd = end;
+	*lineEnd = 0;
+	char* path(strchr(line, ' '));
+	if (!path || path == line) {
+		_ex.set<Ex::Protocol>("No HTTP command");
+		return false;
+	}
+	if (!(_pHeader->type = HTTP::ParseType(line, path - line))) {
+		_ex.set<Ex::Protocol>("Unknown HTTP type ", string(line, (path - line) > 7 ? 7 : (path - line)));
+		return false;
+	}
+	*path++ = 0;
+	while (*path == ' ')
+		++path;
+	char* version(strchr(path, ' '));
+	if (version) {
+		*version++ = 0;
+		while (*version == ' ')
+			++version;
+		if (String::ICompare(version, EXPAND("HTTP/")) == 0)
+			String::ToNumber(version + 5, _pHeader->version);
+	}
+	size_t filePos = Util::UnpackUrl(path, _pHeader->path, _pHeader->query);
+	if (filePos != string::npos) {
+		// is file!
+		_file.set(_www, _pHeader->path);
+		_pHeader->path.erase(filePos - 1);
+	} else
+		_file.set(_www, _pHeader->path, '/');
+
+	// Fields, <name>:<value>, no blank is allowed before the colon (RFC 7230 3.2.4)
+	while ((line = lineEnd + 1) < end) {
+		if (*line == '\n')
+			++line;
+		lineEnd = STR memchr(line, '\n', end - line);
+		if (!lineEnd)
+			lineEnd = end;
+		char* value(STR memchr(line, ':', lineEnd - line));
+		if (!value || value == line)
+			continue; // invalid field, ignore it
+		*value = 0;
+		char* endValue(lineEnd);
+		while (value < --endValue && isspace(*endValue)); // trim right (\r included)
+		*++endValue = 0;
+		while (++value < endValue && isblank(*value)); // trim left
+		_pHeader->set(line, value);
+	}
+
+	// Try to fix mime if no content-type with file extension!
+	if (!_pHeader->mime)
+		_pHeader->mime = MIME::Read(_file, _pHeader->subMime);
+
+	_pHeader->getNumber("content-length", _length = -1);
+
+	// Upgrade session?
+	if (_pHeader->connection&HTTP::CONNECTION_UPGRADE && String::ICompare(_pHeader->upgrade, "websocket") == 0) {
+		_pHeader->pWSDecoder.reset(new WSDecoder(_handler));
+		_pUpgradeDecoder = _pHeader->pWSDecoder;
+	}
+
+	_stage = BODY;
+	switch (_pHeader->type) {
+		case HTTP::TYPE_POST:
+			if (_pHeader->mime != MIME::TYPE_VIDEO && _pHeader->mime != MIME::TYPE_AUDIO) {
+				if (_length < 0) {
+					_ex.set<Ex::Protocol>("HTTP post request without content-length (authorized just for POST media streaming or PUT request)");
+					return false;
+				}
+				break;
+			}
+			// Publish = POST + VIDEO/AUDIO
+			_pReader = MediaReader::New(_pHeader->subMime);
+			if (!_pReader) {
+				_ex.set<Ex::Unsupported>("HTTP ", _pHeader->subMime, " publication unsupported");
+				return false;
+			}
+		case HTTP::TYPE_PUT:
+			_stage = PROGRESSIVE;
+			break;
+		case HTTP::TYPE_GET:
+			if (_pHeader->mime == MIME::TYPE_VIDEO || _pHeader->mime == MIME::TYPE_AUDIO)
+				_file.exists(); // preload disk attributes now in the thread!
+		default:
+			_length = 0;
+	}
+	return true;
+}
+
 } // namespace Mona
@@ -0,0 +1,214 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/HTTP/HTTPFileCache.h"
+#include "Mona/File.h"
+#include "Mona/Logs.h"
+
+using namespace std;
+
+namespace Mona {
+
+static const char* Encodings[] = { NULL, "gzip", "br" };
+static const char* Extensions[] = { NULL, ".gz", ".br" };
+
+static bool ReadFile(Exception& ex, const Path& path, Packet& packet) {
+	File file(path, File::MODE_READ);
+	if (!file.load(ex))
+		return false;
+	shared<Buffer> pBuffer(new Buffer(UInt32(path.size())));
+	UInt32 readen(0);
+	while (readen < pBuffer->size()) {
+		int result = file.read(ex, pBuffer->data() + readen, pBuffer->size() - readen);
+		if (result < 0)
+			return false;
+		if (!result)
+			break; // truncated during reading
+		readen += result;
+	}
+	pBuffer->resize(readen);
+	packet = pBuffer;
+	return true;
+}
+
+
+const HTTPFileCache::Entry::Variant& HTTPFileCache::Entry::variant(const char* acceptEncoding) const {
+	if (acceptEncoding) {
+		for (UInt8 encoding = ENCODING_COUNT - 1; encoding > ENCODING_IDENTITY; --encoding) {
+			if (!variants[encoding].etag.empty() && HTTP::AcceptEncoding(acceptEncoding, Encodings[encoding]))
+				return variants[encoding];
+		}
+	}
+	return variants[ENCODING_IDENTITY];
+}
+
+bool HTTPFileCache::Entry::notModified(const Variant& variant, const char* ifNoneMatch, Int64 ifModifiedSince) const {
+	return ifNoneMatch ? Match(ifNoneMatch, variant.etag) : ifModifiedSince >= lastModified;
+}
+
+shared<const HTTPFileCache::Entry> HTTPFileCache::Load(const Path& file, Int64 lastModified) {
+	shared<Entry> pEntry(new Entry());
+	pEntry->lastModified = lastModified;
+	Exception ex;
+	if (!ReadFile(ex, file, pEntry->variants[ENCODING_IDENTITY].body)) {
+		WARN("HTTP file cache, ", ex);
+		return nullptr;
+	}
+	ETag(pEntry->variants[ENCODING_IDENTITY].etag, lastModified, pEntry->variants[ENCODING_IDENTITY].body.size());
+	// precompressed variants, ignored if older than the file
+	bool vary(false);
+	for (UInt8 encoding = ENCODING_GZIP; encoding < ENCODING_COUNT; ++encoding) {
+		Path path(file, Extensions[encoding]);
+		if (path.lastModified() < lastModified || path.size() > MAX_FILE_SIZE)
+			continue;
+		Entry::Variant& variant(pEntry->variants[encoding]);
+		if (!ReadFile(ex = nullptr, path, variant.body)) {
+			WARN("HTTP file cache, ", ex);
+			continue;
+		}
+		ETag(variant.etag, path.lastModified(), variant.body.size(), Encoding(encoding));
+		vary = true;
+	}
+	// Create something to download by default!
+	pEntry->mime = MIME::Read(file, pEntry->subMime);
+	if (!pEntry->mime) {
+		pEntry->mime = MIME::TYPE_APPLICATION;
+		pEntry->subMime = "octet-stream";
+	}
+	// ready-to-send header fields
+	string date;
+	String::Assign(date, String::Date(Date(lastModified), Date::FORMAT_HTTP));
+	for (UInt8 encoding = ENCODING_IDENTITY; encoding < ENCODING_COUNT; ++encoding) {
+		Entry::Variant& variant(pEntry->variants[encoding]);
+		if (variant.etag.empty())
+			continue;
+		shared<Buffer> pBuffer(new Buffer(4, "\r\n\r\n"));
+		BinaryWriter writer(*pBuffer);
+		HTTP_BEGIN_HEADER(writer)
+			HTTP_ADD_HEADER("Last-Modified", date);
+			HTTP_ADD_HEADER("ETag", variant.etag);
+			if (encoding)
+				HTTP_ADD_HEADER("Content-Encoding", Encodings[encoding]);
+			if (vary)
+				HTTP_ADD_HEADER("Vary", "Accept-Encoding");
+		HTTP_END_HEADER
+		pEntry->size += pBuffer->size() + variant.body.size();
+		variant.header = pBuffer;
+	}
+	return pEntry;
+}
+
+void HTTPFileCache::setCapacity(UInt32 capacity) {
+	lock_guard<mutex> lock(_mutex);
+	_capacity = capacity;
+	while (_size > _capacity)
+		remove(*_lru.back());
+}
+
+void HTTPFileCache::clear() {
+	lock_guard<mutex> lock(_mutex);
+	_lru.clear();
+	_slots.clear();
+	_size = 0;
+}
+
+void HTTPFileCache::remove(Slot& slot) {
+	if (slot.pEntry) {
+		_size -= slot.pEntry->size;
+		_lru.erase(slot.it);
+	}
+	_slots.erase(_slots.find(slot.file));
+}
+
+shared<const HTTPFileCache::Entry> HTTPFileCache::get(const Path& file) {
+	if (!_capacity || file.isFolder())
+		return nullptr;
+	// just one stat by request, size and lastModified are read from the refreshed attributes
+	Int64 lastModified(file.lastModified(true));
+	UInt64 size(file.size());
+	{
+		lock_guard<mutex> lock(_mutex);
+		auto it = _slots.lower_bound(file);
+		if (it != _slots.end() && it->first == file) {
+			Slot& slot(it->second);
+			if (slot.lastModified == lastModified && slot.size == size) {
+				if (!slot.pEntry)
+					return nullptr; // loading by an other thread, read by IOFile meanwhile
+				_lru.splice(_lru.begin(), _lru, slot.it); // most recently used
+				return slot.pEntry;
+			}
+			remove(slot); // changed, deleted or too large now
+		}
+		if (!lastModified || size > MAX_FILE_SIZE)
+			return nullptr;
+		// slot without entry => loading
+		_slots.emplace(piecewise_construct, forward_as_tuple(file), forward_as_tuple(file, lastModified, size));
+	}
+	// read out of the lock (up to MAX_FILE_SIZE with its precompressed variants)
+	shared<const Entry> pEntry(Load(file, lastModified));
+	lock_guard<mutex> lock(_mutex);
+	auto it = _slots.find(file);
+	if (it == _slots.end() || it->second.pEntry || it->second.lastModified != lastModified || it->second.size != size)
+		return pEntry; // cache cleared or file changed meanwhile, don't publish
+	Slot& slot(it->second);
+	if (!pEntry) {
+		remove(slot); // unreadable
+		return nullptr;
+	}
+	slot.pEntry = pEntry;
+	_lru.emplace_front(&slot);
+	slot.it = _lru.begin();
+	_size += pEntry->size;
+	// remove least recently used files
+	while (_size > _capacity)
+		remove(*_lru.back()); // can be this file if alone and bigger than capacity
+	return pEntry;
+}
+
+string& HTTPFileCache::ETag(string& buffer, Int64 lastModified, UInt64 size, Encoding encoding) {
+	if (encoding)
+		return String::Assign(buffer, '"', lastModified, '-', size, '-', Encodings[encoding], '"');
+	return String::Assign(buffer, '"', lastModified, '-', size, '"');
+}
+
+bool HTTPFileCache::Match(const char* ifNoneMatch, const string& etag) {
+	const char* cur(ifNoneMatch);
+	while (*cur) {
+		while (*cur == ',' || isspace(*cur))
+			++cur;
+		if (*cur == '*')
+			return true;
+		if (*cur == 'W' && cur[1] == '/')
+			cur += 2;
+		const char* token(cur);
+		if (*cur == '"')
+			++cur;
+		while (*cur && *cur != '"' && *cur != ',')
+			++cur;
+		if (*cur == '"')
+			++cur;
+		if (size_t(cur - token) == etag.size() && memcmp(token, etag.data(), etag.size()) == 0)
+			return true;
+		while (*cur && *cur != ',')
+			++cur;
+	}
+	return false;
+}
+
+
+} // namespace Mona
@@ -27,8 +27,8 @@ namespace Mona {
 HTTPFileSender::HTTPFileSender(const shared<Socket>& pSocket,
 	const shared<const HTTP::Header>& pRequest,
 	shared<Buffer>& pSetCookie,
-	IOFile& ioFile, const Path& file, Parameters& properties) : HTTPSender("HTTPFileSender", pSocket, pRequest, pSetCookie),
-		_file(file), _properties(move(properties)), FileReader(ioFile), _head(pRequest->type==HTTP::TYPE_HEAD) {
+	IOFile& ioFile, HTTPFileCache& cache, const Path& file, Parameters& properties) : HTTPSender("HTTPFileSender", pSocket, pRequest, pSetCookie),
+		_file(file), _cache(cache), _properties(move(properties)), FileReader(ioFile), _head(pRequest->type==HTTP::TYPE_HEAD) {
 }
 
 bool HTTPFileSender::flush() {
@@ -97,6 +97,14 @@ void HTTPFileSender::run(const HTTP::Header& request) {
 	// FILE
 	// /!\ Here if !_head we have to call onFlush on end!
 
+	// small static file from memory (not with parameters which change the content)
+	shared<const HTTPFileCache::Entry> pEntry;
+	if (!_properties.count() && (pEntry = _cache.get(_file))) {
+		if (sendEntry(request, *pEntry) && !_head)
+			io.handler.queue(onFlush);
+		return;
+	}
+
 	onError = [this](const Exception& ex) {
 		ERROR(ex);
 		return shutdown(); // can't repair the session (client wait content-length!)
@@ -129,10 +137,14 @@ void HTTPFileSender::run(const HTTP::Header& request) {
 	}
 
 	/// not modified if there is no parameters file (impossible to determinate if the parameters have changed since the last request)
-	if (!_properties.count() && request.ifModifiedSince >= (*this)->lastModified()) {
-		if(send(HTTP_CODE_304) && !_head) // NOT MODIFIED
-			io.handler.queue(onFlush);
-		return;
+	if (!_properties.count()) {
+		HTTPFileCache::ETag(buffer, (*this)->lastModified(), (*this)->size());
+		const char* ifNoneMatch(request.getString("if-none-match")); // has priority on If-Modified-Since (RFC 7232 6)
+		if (ifNoneMatch ? HTTPFileCache::Match(ifNoneMatch, buffer) : request.ifModifiedSince >= (*this)->lastModified()) {
+			if (send(HTTP_CODE_304) && !_head) // NOT MODIFIED
+				io.handler.queue(onFlush);
+			return;
+		}
 	}
 
 	// Parsing file and replace with parameters every time requested by user (when properties returned by onRead):
@@ -155,13 +167,22 @@ void HTTPFileSender::run(const HTTP::Header& request) {
 		}
 		sendFile(Packet(pBuffer, pBuffer->data(), readen));
 	} else {
-		sendHeader((*this)->size());
+		sendHeader((*this)->size(), buffer);
 		if (!_head)
 			read();
 	}
 }
 
-bool HTTPFileSender::sendHeader(UInt64 fileSize) {
+bool HTTPFileSender::sendEntry(const HTTP::Header& request, const HTTPFileCache::Entry& entry) {
+	const HTTPFileCache::Entry::Variant& variant(entry.variant(request.getString("accept-encoding")));
+	if (entry.notModified(variant, request.getString("if-none-match"), request.ifModifiedSince))
+		return send(HTTP_CODE_304, MIME::TYPE_UNKNOWN, NULL, variant.header); // NOT MODIFIED
+	if (!send(HTTP_CODE_200, entry.mime, entry.subMime, variant.header, variant.body.size()))
+		return false;
+	return _head || !variant.body || send(variant.body);
+}
+
+bool HTTPFileSender::sendHeader(UInt64 fileSize, const string& etag) {
 	// Create something to download by default!
 	const char* subMime;
 	MIME::Type mime = MIME::Read(_file, subMime);
@@ -173,6 +194,8 @@ bool HTTPFileSender::sendHeader(UInt64 fileSize) {
 	BinaryWriter writer(*pBuffer);
 	HTTP_BEGIN_HEADER(writer)
 		HTTP_ADD_HEADER("Last-Modified", String::Date(Date((*this)->lastModified()), Date::FORMAT_HTTP));
+		if (!etag.empty())
+			HTTP_ADD_HEADER("ETag", etag);
 	HTTP_END_HEADER
 	return send(HTTP_CODE_200, mime, subMime, Packet(pBuffer), fileSize);
 }
@@ -251,7 +274,7 @@ void HTTPFileSender::sendFile(const Packet& packet) {
 
 	// Add rest size
 	size += cur - begin;
-	if (!sendHeader(size) || _head)
+	if (!sendHeader(size, String::Empty()) || _head)
 		return;
 
 	for (const Packet& packet : packets) {
@@ -17,10 +17,12 @@ details (or else see http://www.gnu.org/licenses/).
 */
 
 #include "Mona/HTTP/HTTPSession.h"
+#include "Mona/HTTP/HTTProtocol.h"
 #include "Mona/MapWriter.h"
 #include "Mona/QueryReader.h"
 #include "Mona/StringReader.h"
 #include "Mona/WS/WSSession.h"
+#include "Mona/Metrics.h"
 
 
 using namespace std;
@@ -29,10 +31,14 @@ using namespace std;
 namespace Mona {
 
 
-HTTPSession::HTTPSession(Protocol& protocol) : TCPSession(protocol), _pSubscription(NULL), _pPublication(NULL), _indexDirectory(true), _writer(*this),
+HTTPSession::HTTPSession(HTTProtocol& protocol) : TCPSession(protocol), _pSubscription(NULL), _pPublication(NULL), _indexDirectory(true), _writer(*this, protocol.fileCache),
+	_hlsPlaylist(false), _hlsSegments(6), _hlsDuration(2000), _hlsPartDuration(500),
 	_onRequest([this](HTTP::Request& request) {
 		if (request) { // else progressive! => PUT or POST media!
 
+			// answer now a HLS request waiting to keep responses in order
+			releaseHLS();
+
 			_writer.beginRequest(request);
 
 			if (!request.ex) {
@@ -49,7 +55,7 @@ HTTPSession::HTTPSession(Protocol& protocol) : TCPSession(protocol), _pSubscript
 				peer.setQuery(request->query);
 				peer.setServerAddress(request->host);
 				// properties = version + headers + cookies
-				peer.properties() = move(request);
+				request->copyTo(peer.properties().clear());
 
 				// Create parameters for onConnection or a GET onRead/onWrite/onInvocation
 				QueryReader parameters(peer.query.data(), peer.query.size());
@@ -163,6 +169,10 @@ HTTPSession::HTTPSession(Protocol& protocol) : TCPSession(protocol), _pSubscript
 		return _writer.writeSetCookie(reader, onCookie);
 	};
 
+	_hlsWaiter.onReady = [this](HLSSegmenter* pSegmenter) {
+		writeHLS(pSegmenter);
+		_writer.flush();
+	};
 }
 
 bool HTTPSession::handshake(HTTP::Request& request) {
@@ -197,12 +207,24 @@ void HTTPSession::onParameters(const Parameters& parameters) {
 		else
 			FileSystem::GetName(_index); // Redirect to the file (get name to prevent path insertion)
 	}
+	if (!parameters.getString("metrics", _metrics) || String::IsFalse(_metrics))
+		_metrics.clear();
+	else if (String::IsTrue(_metrics))
+		_metrics.assign("/metrics");
+	_hlsSegments = parameters.getNumber<UInt8, 6>("hlsSegments");
+	_hlsDuration = parameters.getNumber<UInt32, 2000>("hlsDuration");
+	_hlsPartDuration = parameters.getNumber<UInt32, 500>("hlsPartDuration");
+	_writer.compression = parameters.getNumber<UInt32, 1024>("compression");
 }
 
 bool HTTPSession::manage() {
 	if (_pUpgradeSession)
 		return _pUpgradeSession->manage();
 
+	// blocking HLS request answered after 3 target durations (LL-HLS spec), before TCP timeout
+	if (_hlsWaiter.expired())
+		releaseHLS();
+
 	if (!TCPSession::manage())
 		return false;
 
@@ -217,6 +239,14 @@ bool HTTPSession::manage() {
 	return true;
 }
 
+UInt32 HTTPSession::manageDelay() {
+	if (_pUpgradeSession)
+		return _pUpgradeSession->manageDelay();
+	if (_pSubscription || _pPublication || _hlsWaiter.pSegmenter)
+		return 0;
+	return TCPSession::manageDelay();
+}
+
 void HTTPSession::flush() {
 	if (_pUpgradeSession)
 		return _pUpgradeSession->flush();
@@ -227,6 +257,8 @@ void HTTPSession::flush() {
 
 void HTTPSession::close() {
 	peer.onCallProperties = nullptr;
+	if (_hlsWaiter.pSegmenter)
+		_hlsWaiter.pSegmenter->unwait(_hlsWaiter);
 	// unpublish and unsubscribe
 	closePublication();
 	closeSusbcription();
@@ -257,7 +289,7 @@ void HTTPSession::openSubscribtion(Exception& ex, const string& stream, Writer&
 	closeSusbcription();
 	_pSubscription = new Subscription(writer);
 	if (api.subscribe(ex, stream, peer, *_pSubscription, peer.query.c_str()))
-		return;
+		return wake(); // not idle now
 	delete _pSubscription;
 	_pSubscription = NULL;
 }
@@ -273,6 +305,8 @@ void HTTPSession::closeSusbcription() {
 void HTTPSession::openPublication(Exception& ex, const Path& stream) {
 	closePublication();
 	_pPublication = api.publish(ex, peer, stream, peer.query.c_str());
+	if (_pPublication)
+		wake(); // not idle now
 }
 
 void HTTPSession::closePublication() {
@@ -304,9 +338,16 @@ void HTTPSession::processGet(Exception& ex, HTTP::Request& request, QueryReader&
 	if (!file.isFolder()) {
 		// FILE //
 
-		// TODO m3u8
-		// https://developer.apple.com/library/ios/technotes/tn2288/_index.html
-		// CODECS => https://tools.ietf.org/html/rfc6381
+		// 0 - metrics of the server in Prometheus format
+		string metrics;
+		if (!_metrics.empty() && String::Assign(metrics, peer.path, '/', file.name()) == _metrics) {
+			metrics.clear();
+			Metrics::Write(metrics);
+			shared<Buffer> pBuffer(new Buffer(metrics.size(), metrics.data()));
+			vector<Packet> packets;
+			packets.emplace_back(pBuffer); // capture in place (a copy would reference a temporary packet)
+			return _writer.writeSegment(MIME::TYPE_TEXT, "plain; version=0.0.4", 0, move(packets));
+		}
 
 		// 1 - priority on client method
 		if (file.extension().empty() && peer.onInvocation(ex, file.name(), parameters)) // can be method!
@@ -320,6 +361,9 @@ void HTTPSession::processGet(Exception& ex, HTTP::Request& request, QueryReader&
 				ex.set<Ex::Net::Permission>("No authorization to see the content of ", peer.path,"/",file.name());
 			return;
 		}
+		// If onRead has been authorised, and that the file is a HLS playlist or segment, and it doesn't exists, serve it from the publication segmenter
+		if (!file.exists() && processHLS(ex, file))
+			return;
 		// If onRead has been authorised, and that the file is a multimedia file, and it doesn't exists (no VOD, filePath.lastModified()==0 means "doesn't exists")
 		// Subscribe for a live stream with the basename file as stream name
 		if (!file.exists() && request->type == HTTP::TYPE_GET && (request->mime == MIME::TYPE_VIDEO || request->mime == MIME::TYPE_AUDIO))
@@ -349,6 +393,101 @@ void HTTPSession::processGet(Exception& ex, HTTP::Request& request, QueryReader&
 	_writer.writeFile(file, fileProperties); // folder view or index redirection (without pass by onRead because can create a infinite loop)
 }
 
+bool HTTPSession::processHLS(Exception& ex, const Path& file) {
+	// https://tools.ietf.org/html/rfc8216 + LL-HLS extension
+	bool playlist(String::ICompare(file.extension(), "m3u8") == 0);
+	if (!playlist && String::ICompare(file.extension(), "ts") != 0)
+		return false;
+	string name(file.baseName());
+	UInt32 sequence(0);
+	Int32 part(-1);
+	if (!playlist) {
+		// <name>.<sequence>.ts or <name>.<sequence>.<part>.ts
+		size_t dot(name.find_last_of('.'));
+		if (dot == string::npos || !String::ToNumber(name.c_str() + dot + 1, sequence))
+			return false; // live TS stream
+		name.resize(dot);
+		UInt32 value;
+		dot = name.find_last_of('.');
+		if (dot != string::npos && String::ToNumber(name.c_str() + dot + 1, value)) {
+			const auto& it(api.publications.find(name.substr(0, dot)));
+			if (it != api.publications.end() && ((Publication&)it->second).segmenter()) {
+				part = sequence;
+				sequence = value;
+				name.resize(dot);
+			}
+		}
+	}
+	const auto& it(api.publications.find(name));
+	if (it == api.publications.end() || !it->second.publishing()) {
+		if (!playlist)
+			return false; // live TS stream
+		ex.set<Ex::Unfound>("Publication ", name, " unfound");
+		return true;
+	}
+	Publication& publication((Publication&)it->second);
+	HLSSegmenter* pSegmenter(publication.segmenter());
+	if (!pSegmenter) {
+		if (!playlist)
+			return false; // live TS stream
+		pSegmenter = &publication.startSegmenting(_hlsSegments, _hlsDuration, _hlsPartDuration);
+	}
+
+	if (playlist) {
+		// Blocking playlist reload with _HLS_msn and _HLS_part, otherwise wait at less one segment
+		Parameters parameters;
+		Util::UnpackQuery(peer.query, parameters);
+		if (parameters.getNumber("_HLS_msn", sequence)) {
+			if (!parameters.getNumber("_HLS_part", part))
+				part = -1;
+		} else if (!pSegmenter->segments().empty())
+			sequence = pSegmenter->segments().front().sequence;
+	}
+	_hlsPlaylist = playlist;
+	_hlsWaiter.sequence = sequence;
+	_hlsWaiter.part = part;
+	if (pSegmenter->available(sequence, part))
+		writeHLS(pSegmenter);
+	else {
+		pSegmenter->wait(_hlsWaiter); // response held until available
+		wake(); // to release it after 3 target durations
+	}
+	return true;
+}
+
+void HTTPSession::writeHLS(HLSSegmenter* pSegmenter) {
+	if (!pSegmenter)
+		return _writer.writeError(HTTP_CODE_404, "HLS stream ended");
+	Int8 available(pSegmenter->available(_hlsWaiter.sequence, _hlsWaiter.part));
+	if (_hlsPlaylist) {
+		if (available < 0 && (pSegmenter->segments().empty() || _hlsWaiter.sequence > pSegmenter->segments().back().sequence))
+			return _writer.writeError(HTTP_CODE_400, "HLS segment ", _hlsWaiter.sequence, " too far");
+		if (!available)
+			return _writer.writeError(HTTP_CODE_503, "HLS segment ", _hlsWaiter.sequence, " unavailable yet");
+		return _writer.writeSegment(MIME::TYPE_APPLICATION, "vnd.apple.mpegurl", 0, { pSegmenter->playlist() });
+	}
+	const HLSSegmenter::Segment* pSegment(available > 0 ? pSegmenter->segment(_hlsWaiter.sequence) : NULL);
+	if (!pSegment || (_hlsWaiter.part >= 0 && UInt32(_hlsWaiter.part) >= pSegment->size())) {
+		if (!available)
+			return _writer.writeError(HTTP_CODE_503, "HLS segment ", _hlsWaiter.sequence, " unavailable yet");
+		return _writer.writeError(HTTP_CODE_404, "HLS segment ", _hlsWaiter.sequence, " unfound");
+	}
+	// segments are immutable, cacheable while they stay in the playlist
+	UInt32 maxAge(pSegmenter->count * pSegmenter->duration / 1000);
+	if (_hlsWaiter.part >= 0)
+		return _writer.writeSegment(MIME::TYPE_VIDEO, "mp2t", maxAge, { (*pSegment)[_hlsWaiter.part] });
+	return _writer.writeSegment(MIME::TYPE_VIDEO, "mp2t", maxAge, vector<Packet>(pSegment->begin(), pSegment->end()));
+}
+
+void HTTPSession::releaseHLS() {
+	HLSSegmenter* pSegmenter(_hlsWaiter.pSegmenter);
+	if (!pSegmenter)
+		return;
+	pSegmenter->unwait(_hlsWaiter);
+	writeHLS(pSegmenter);
+	_writer.flush();
+}
+
 void HTTPSession::processPut(Exception& ex, HTTP::Request& request) {
 	if (request) {
 		// TODO peer.onWriteFile + Forbidden response if return false
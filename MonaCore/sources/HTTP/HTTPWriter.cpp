@@ -57,7 +57,7 @@ private:
 };
 
 
-HTTPWriter::HTTPWriter(TCPSession& session) : _requestCount(0),_requesting(false),_session(session) {}
+HTTPWriter::HTTPWriter(TCPSession& session, HTTPFileCache& fileCache) : compression(0), _requestCount(0),_requesting(false),_session(session),_fileCache(fileCache) {}
 
 HTTPWriter::~HTTPWriter() {
 	for (shared<HTTPSender>& pSender : _flushings)
@@ -84,6 +84,9 @@ void HTTPWriter::closing(Int32 error, const char* reason) {
 
 
 void HTTPWriter::beginRequest(const shared<const HTTP::Header>& pRequest) {
+	// pipelined request, push the previous response now to not override it and keep responses in the order of requests
+	if (_pResponse)
+		flush();
 	++_requestCount;
 	_pRequest = pRequest;
 	_requesting = true;
@@ -147,7 +150,26 @@ DataWriter& HTTPWriter::writeMessage(bool isResponse) {
 		pSender = newSender<HTTPDataSender>(isResponse, HTTP_CODE_200, MIME::TYPE_APPLICATION, "json");
 	else
 		pSender = newSender<HTTPDataSender>(isResponse, HTTP_CODE_200, _pRequest->mime, _pRequest->subMime);
-	return pSender ? pSender->writer() : DataWriter::Null();
+	if (!pSender)
+		return DataWriter::Null();
+	if (!compression)
+		return pSender->writer();
+	// compress text content (JSON, XML-RPC, query or text) if client accepts it
+	Media::Data::Type type(_pRequest->mime ? Media::Data::ToType(_pRequest->subMime) : Media::Data::TYPE_JSON);
+	if (_pRequest->mime != MIME::TYPE_TEXT && type != Media::Data::TYPE_JSON && type != Media::Data::TYPE_XMLRPC && type != Media::Data::TYPE_QUERY)
+		return pSender->writer();
+	const char* acceptEncoding(_pRequest->getString("accept-encoding"));
+	Deflater::Format format;
+	if (HTTP::AcceptEncoding(acceptEncoding, "gzip"))
+		format = Deflater::FORMAT_GZIP;
+	else if (HTTP::AcceptEncoding(acceptEncoding, "deflate"))
+		format = Deflater::FORMAT_ZLIB;
+	else
+		return pSender->writer();
+	if (!_pDeflater || _pDeflater->format != format)
+		_pDeflater.reset(new Deflater(format));
+	pSender->compress(_pDeflater, compression);
+	return pSender->writer();
 }
 
 void HTTPWriter::writeRaw(DataReader& reader) {
@@ -47,6 +47,7 @@ MIME::Type MIME::Read(const Path& file, const char*& subType) {
 		{ "aac",{ TYPE_AUDIO, "aac" } },
 		{ "svg", { TYPE_APPLICATION, "svg+xml"} },
 		{ "m3u", { TYPE_AUDIO, "m3u"} },
+		{ "m3u8", { TYPE_APPLICATION, "vnd.apple.mpegurl"} },
 		{ "swf", { TYPE_APPLICATION, "x-shockwave-flash"} },
 		{ "jpg", { TYPE_IMAGE, "jpeg"} },
 		{ "jpeg", { TYPE_IMAGE, "jpeg"} },
@@ -70,15 +71,22 @@ MIME::Type MIME::Read(const Path& file, const char*& subType) {
 
 
 MIME::Type MIME::Read(const char* value, string& subType) {
+	const char* subValue;
+	Type type(Read(value, subValue));
+	subType.assign(subValue);
+	return type;
+}
+
+MIME::Type MIME::Read(const char* value, const char*& subType) {
 	// subtype
 	const char* comma = strchr(value, ';');
 	const char* slash = (const char*)memchr(value, '/', comma ? comma - value : strlen(value));
 	if (slash)
-		subType.assign(slash + 1);
+		subType = slash + 1;
 	else if (comma)
-		subType.assign(comma);
+		subType = comma;
 	else
-		subType.assign(EXPAND("html; charset=utf-8"));
+		subType = "html; charset=utf-8";
 
 	// type
 	if (String::ICompare(value,EXPAND("text"))==0)
@@ -253,13 +253,14 @@ UInt32	Media::Stream::RecvBufferSize(0);
 UInt32	Media::Stream::SendBufferSize(0);
 
 Media::Stream* Media::Stream::New(Exception& ex, const char* description, const Timer& timer, IOFile& ioFile, IOSocket& ioSocket, const shared<TLS>& pTLS) {
-	// Net => [@][address] [type/TLS][/MediaFormat] [parameter MediaFormat]
+	// Net => [@][address] [type/TLS][/MediaFormat] [parameter MediaFormat] [bitrate=kbps]
 	// File = > @file[.format][MediaFormat][parameter]
 	
 	SocketAddress address;
 	Type type(TYPE_FILE);
-	bool isSecure(false), isTarget(false), isPort(false), isAddress(false);
+	bool isSecure(false), isTarget(false), isPort(false), isAddress(false), isTyped(false);
 	string format;
+	UInt32 bitrate(0); // pacing of UDP target
 	Path   path;
 	String::ForEach forEach([&](UInt32 index, const char* value) {
 		if (!index) {
@@ -294,6 +295,14 @@ Media::Stream* Media::Stream::New(Exception& ex, const char* description, const
 				path.set(slash);
 			return isAddress;
 		}
+		if (String::ICompare(value, EXPAND("bitrate=")) == 0) {
+			if (!String::ToNumber(value + 8, bitrate))
+				WARN("Invalid stream bitrate ", value + 8);
+			return true;
+		}
+		if (isTyped)
+			return true; // parameter
+		isTyped = true;
 		
 		String::ForEach forEach([&](UInt32 index, const char* value) {
 			if (String::ICompare(value, "UDP") == 0) {
@@ -317,7 +326,7 @@ Media::Stream* Media::Stream::New(Exception& ex, const char* description, const
 			return false;
 		});
 		String::Split(value, "/", forEach);
-		return false;
+		return true;
 	});
 	String::Split(description, " \t", forEach, SPLIT_IGNORE_EMPTY | SPLIT_TRIM);
 
@@ -371,7 +380,7 @@ Media::Stream* Media::Stream::New(Exception& ex, const char* description, const
 	
 	if (isTarget) {
 		if (MediaWriter* pWriter = MediaWriter::New(format.c_str()))
-			return new MediaSocket::Writer(type, path, pWriter, address, ioSocket, isSecure ? pTLS : nullptr);
+			return new MediaSocket::Writer(type, path, pWriter, address, ioSocket, timer, bitrate, isSecure ? pTLS : nullptr);
 	} else if (MediaReader* pReader = MediaReader::New(format.c_str()))
 		return new MediaSocket::Reader(type, path, pReader, address, ioSocket, isSecure ? pTLS : nullptr);
 	ex.set<Ex::Unsupported>("Stream ", TypeToString(type), " format ",format, " not supported");
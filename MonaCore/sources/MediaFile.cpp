@@ -108,13 +108,191 @@ void MediaFile::Reader::stop() {
 }
 
 
-MediaFile::Writer::Write::Write(const shared<string>& pName, IOFile& io, const shared<File>& pFile, const shared<MediaWriter>& pWriter) : Runner("MediaFileWrite"), _io(io), _pFile(pFile), pWriter(pWriter), _pName(pName),
+UInt32				MediaFile::Writer::FlushSize(0x40000);
+UInt32				MediaFile::Writer::FlushTime(1000);
+UInt32				MediaFile::Writer::Preallocation(0x400000);
+bool				MediaFile::Writer::Direct(false);
+MediaFile::Writer::Sync	MediaFile::Writer::SyncMode(SYNC_END);
+
+bool MediaFile::Writer::ReadSync(const char* value, Sync& sync) {
+	if (String::ICompare(value, "none") == 0)
+		sync = SYNC_NONE;
+	else if (String::ICompare(value, "end") == 0)
+		sync = SYNC_END;
+	else if (String::ICompare(value, "flush") == 0)
+		sync = SYNC_FLUSH;
+	else
+		return false;
+	return true;
+}
+
+#define BLOCK_POOL_MAX	0x4000000 // 64MB of recycled blocks at most, for all the recordings
+
+/*!
+Write-behind block aligned on File::DIRECT_ALIGNMENT, its memory is recycled between recordings */
+struct Block : Binary, virtual Object {
+	Block(UInt32 capacity) : capacity(capacity), _size(0) {
+		{
+			lock_guard<mutex> lock(_Mutex);
+			auto it = _Pool.find(capacity);
+			if (it != _Pool.end()) {
+				_data = it->second.back();
+				it->second.pop_back();
+				if (it->second.empty())
+					_Pool.erase(it);
+				_Pooled -= capacity;
+				return;
+			}
+		}
+#if defined(_WIN32)
+		_data = BIN _aligned_malloc(capacity, File::DIRECT_ALIGNMENT);
+#else
+		if (posix_memalign((void**)&_data, File::DIRECT_ALIGNMENT, capacity))
+			_data = NULL;
+#endif
+	}
+	~Block() {
+		if (!_data)
+			return;
+		{
+			lock_guard<mutex> lock(_Mutex);
+			if ((_Pooled + capacity) <= BLOCK_POOL_MAX) {
+				_Pool[capacity].emplace_back(_data);
+				_Pooled += capacity;
+				return;
+			}
+		}
+#if defined(_WIN32)
+		_aligned_free(_data);
+#else
+		free(_data);
+#endif
+	}
+
+	const UInt32	capacity;
+	/*!
+	False if memory allocation has failed */
+	bool			allocated() const { return _data ? true : false; }
+
+	const UInt8*	data() const { return _data; }
+	UInt32			size() const { return _size; }
+	UInt32			available() const { return capacity - _size; }
+
+	UInt32 append(const void* data, UInt32 size) {
+		if (size > available())
+			size = available();
+		memcpy(_data + _size, data, size);
+		_size += size;
+		return size;
+	}
+	void resize(UInt32 size) { _size = size; }
+
+private:
+	UInt8*	_data;
+	UInt32	_size;
+
+	static mutex							_Mutex;
+	static map<UInt32, vector<UInt8*>>		_Pool;
+	static UInt64							_Pooled;
+};
+mutex							Block::_Mutex;
+map<UInt32, vector<UInt8*>>		Block::_Pool;
+UInt64							Block::_Pooled(0);
+
+struct MediaFile::Writer::Output : virtual Object {
+	Output(IOFile& io, const shared<File>& pFile, const File::OnError& onError, UInt32 flushSize, UInt32 flushTime, Sync sync) : _io(io), _pFile(pFile), _onError(onError), _flushTime(flushTime), _sync(sync), _ended(false), _failed(false),
+		_flushSize(flushSize ? ((flushSize + File::DIRECT_ALIGNMENT - 1) & ~(File::DIRECT_ALIGNMENT - 1)) : 0), _direct(pFile->direct) {}
+	~Output() { if (!_ended) flush(true); }
+
+	const string& path() const { return _pFile->path(); }
+
+	void write(const Packet& packet) {
+		if (_failed)
+			return;
+		if (!_flushSize)
+			return _io.write(_pFile, packet);
+		const UInt8* data(packet.data());
+		UInt32 size(packet.size());
+		while (size) {
+			if (!_pBlock && !newBlock(_pBlock))
+				return;
+			UInt32 copied = _pBlock->append(data, size);
+			data += copied;
+			size -= copied;
+			if (!_pBlock->available())
+				flush();
+		}
+		if (_pBlock && _time.isElapsed(_flushTime))
+			flush();
+	}
+
+	void flush(bool end = false) {
+		if (_pBlock) {
+			shared<Block> pNext;
+			if (_direct && !end) {
+				// keep the unaligned tail for the next block to continue direct writing
+				UInt32 tail(_pBlock->size() & (File::DIRECT_ALIGNMENT - 1));
+				if (tail == _pBlock->size())
+					return; // wait more data
+				if (tail) {
+					if (!newBlock(pNext))
+						return;
+					pNext->append(_pBlock->data() + _pBlock->size() - tail, tail);
+					_pBlock->resize(_pBlock->size() - tail);
+				}
+			}
+			_io.write(_pFile, Packet(shared<const Binary>(move(_pBlock))));
+			_pBlock = move(pNext);
+		}
+		_time.update();
+		if (end) {
+			_ended = true;
+			if (_sync)
+				_io.sync(_pFile);
+		} else if (_sync == SYNC_FLUSH)
+			_io.sync(_pFile);
+	}
+
+private:
+	bool newBlock(shared<Block>& pBlock) {
+		pBlock.reset(new Block(_flushSize));
+		if (pBlock->allocated())
+			return true;
+		pBlock.reset();
+		_failed = true;
+		// fail the recording on main thread
+		Exception ex;
+		ex.set<Ex::System::Memory>("Write-behind block of ", _flushSize, " bytes impossible to allocate");
+		_io.handler.queue(_onError, ex);
+		return false;
+	}
+
+	IOFile&				_io;
+	shared<File>		_pFile;
+	File::OnError		_onError; // subscribed on main thread by the constructor
+	shared<Block>		_pBlock;
+	const UInt32		_flushSize;
+	const UInt32		_flushTime;
+	const Sync			_sync;
+	const bool			_direct;
+	Time				_time;
+	bool				_ended;
+	bool				_failed;
+};
+
+MediaFile::Writer::Write::Write(const shared<string>& pName, const shared<Output>& pOutput, const shared<MediaWriter>& pWriter) : Runner("MediaFileWrite"), pOutput(pOutput), pWriter(pWriter), _pName(pName),
 	onWrite([this](const Packet& packet) {
-		DUMP_REQUEST(_pName->c_str(), packet.data(), packet.size(), _pFile->path());
-		_io.write(_pFile, packet);
+		DUMP_REQUEST(_pName->c_str(), packet.data(), packet.size(), this->pOutput->path());
+		this->pOutput->write(packet);
 	}) {
 }
 
+bool MediaFile::Writer::EndWrite::run(Exception& ex) {
+	pWriter->endMedia(onWrite);
+	pOutput->flush(true);
+	return true;
+}
+
 MediaFile::Writer::Writer(const Path& path, MediaWriter* pWriter, IOFile& io) :
 	Media::Stream(TYPE_FILE), io(io), _writeTrack(0), _running(false), path(path), _pWriter(pWriter) {
 	_onError = [this](const Exception& ex) { Stream::stop(LOG_ERROR, ex); };
@@ -128,7 +306,27 @@ bool MediaFile::Writer::beginMedia(const string& name, const Parameters& paramet
 	if (!_running)
 		return false; // Not started => no Log, just ejects
 	// New media, so open the file to write here => overwrite by default, otherwise append if requested!
-	io.open(_pFile, path, _onError, parameters.getBoolean<false>("append"));
+	bool append(parameters.getBoolean<false>("append"));
+	io.open(_pFile, path, _onError, append);
+	_pFile->preallocation = Preallocation;
+	parameters.getNumber("preallocation", _pFile->preallocation);
+	_pFile->direct = Direct;
+	parameters.getBoolean("direct", _pFile->direct);
+	if (append)
+		_pFile->direct = false; // position unaligned
+	Sync sync(SyncMode);
+	const char* value = parameters.getString("sync");
+	if (value && !ReadSync(value, sync))
+		WARN(description(), " unknown sync mode ", value);
+	UInt32 flushSize(FlushSize), flushTime(FlushTime);
+	parameters.getNumber("flushSize", flushSize);
+	parameters.getNumber("flushTime", flushTime);
+	if (flushSize && (flushSize < FLUSH_SIZE_MIN || flushSize > FLUSH_SIZE_MAX)) {
+		UInt32 clamped(flushSize < FLUSH_SIZE_MIN ? FLUSH_SIZE_MIN : FLUSH_SIZE_MAX);
+		WARN(description(), " flushSize ", flushSize, " clamped to ", clamped);
+		flushSize = clamped;
+	}
+	_pOutput.reset(new Output(io, _pFile, _onError, flushSize, flushTime, sync));
 	INFO(description(), " starts");
 	_pName.reset(new string(name));
 	return write<Write>();
@@ -142,6 +340,7 @@ void MediaFile::Writer::endMedia(const string& name) {
 
 void MediaFile::Writer::stop() {
 	_pName.reset();
+	_pOutput.reset(); // flushed by the last writing if not ended
 	if(_pFile) {
 		io.close(_pFile);
 		INFO(description(), " stops");
@@ -151,5 +350,4 @@ void MediaFile::Writer::stop() {
 }
 
 
-
 } // namespace Mona
@@ -161,20 +161,79 @@ const shared<Socket>& MediaSocket::Reader::socket() {
 
 
 
-MediaSocket::Writer::Send::Send(Type type, const shared<string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming) : Runner("MediaSocketSend"), _pSocket(pSocket), pWriter(pWriter),
-	_pStreaming(pStreaming), _pName(pName),
-	onWrite([this, type](const Packet& packet) {
-		DUMP_REQUEST(_pName->c_str(), packet.data(), packet.size(), _pSocket->peerAddress());
-		Exception ex;
-		UInt64 byteRate = _pSocket->sendByteRate(); // Get byteRate before write to start computing cycle on 0!
-		int result = _pSocket->write(ex, packet);
-		if (result && !*_pStreaming && byteRate) {
-			INFO("Stream target ", TypeToString(type), "://", _pSocket->peerAddress(), '|', this->pWriter->format(), " starts");
-			*_pStreaming = true;
+UInt32 MediaSocket::Writer::Pacer::interval() const {
+	// time to send a TS UDP datagram (7 TS packets)
+	UInt64 interval(rate ? (7 * 188 * 1000 / rate) : 10);
+	return interval < 1 ? 1 : (interval > 10 ? 10 : UInt32(interval));
+}
+
+const Packet* MediaSocket::Writer::Pacer::front(bool force) {
+	if (_packets.empty())
+		return NULL;
+	const Packet& packet(_packets.front());
+	if (force)
+		return &packet;
+	Int64 now(Time::Now());
+	if (_time) {
+		_credit += (now - _time) * rate / 1000.0;
+		// burst limited to one pacing cycle
+		double burst(rate * interval() / 1000.0);
+		if (burst < packet.size())
+			burst = packet.size();
+		if (_credit > burst)
+			_credit = burst;
+	} else
+		_credit = packet.size();
+	_time = now;
+	return _credit >= packet.size() ? &packet : NULL;
+}
+
+void MediaSocket::Writer::Pacer::pop() {
+	UInt32 size(_packets.front().size());
+	_credit -= size;
+	queueing -= size;
+	_packets.pop_front();
+}
+
+MediaSocket::Writer::Send::Send(Type type, const shared<string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter, const shared<volatile bool>& pStreaming, const shared<Pacer>& pPacer, UInt32 fragmentSize) : Runner("MediaSocketSend"), _pSocket(pSocket), pWriter(pWriter),
+	_pStreaming(pStreaming), _pName(pName), pPacer(pPacer), _type(type), _fragmentSize(fragmentSize),
+	onWrite([this](const Packet& packet) {
+		// TS writer delivers a whole frame, in UDP send it in datagrams of 7 TS packets
+		UInt32 size(_fragmentSize ? _fragmentSize : packet.size());
+		Packet datagram(packet);
+		while (datagram) {
+			Packet fragment(datagram, datagram.data(), datagram.size() > size ? size : datagram.size());
+			datagram += fragment.size();
+			if (this->pPacer)
+				this->pPacer->push(move(fragment));
+			else
+				write(fragment);
 		}
-		if (ex || result<0)
-			WARN("Stream target ", TypeToString(type), "://", _pSocket->peerAddress(), '|', this->pWriter->format(), ", ", ex);
 	}) {
+	if (pPacer)
+		++pPacer->sends;
+}
+
+void MediaSocket::Writer::Send::write(const Packet& packet) {
+	DUMP_REQUEST(_pName->c_str(), packet.data(), packet.size(), _pSocket->peerAddress());
+	Exception ex;
+	UInt64 byteRate = _pSocket->sendByteRate(); // Get byteRate before write to start computing cycle on 0!
+	int result = _pSocket->write(ex, packet);
+	if (result && !*_pStreaming && byteRate) {
+		INFO("Stream target ", TypeToString(_type), "://", _pSocket->peerAddress(), '|', pWriter->format(), " starts");
+		*_pStreaming = true;
+	}
+	if (ex || result<0)
+		WARN("Stream target ", TypeToString(_type), "://", _pSocket->peerAddress(), '|', pWriter->format(), ", ", ex);
+}
+
+void MediaSocket::Writer::Send::pace(bool force) {
+	if (!pPacer)
+		return;
+	while (const Packet* pPacket = pPacer->front(force)) {
+		write(*pPacket);
+		pPacer->pop();
+	}
 }
 
 const shared<Socket>& MediaSocket::Writer::socket() {
@@ -188,14 +247,31 @@ const shared<Socket>& MediaSocket::Writer::socket() {
 			AUTO_ERROR(_pSocket->setRecvBufferSize(ex, RecvBufferSize), description(), " receiving buffer setting");
 		if (SendBufferSize)
 			AUTO_ERROR(_pSocket->setSendBufferSize(ex, SendBufferSize), description(), " sending buffer setting");
+		if (bitrate && type == TYPE_UDP) {
+			_pPacer.reset(new Pacer(bitrate));
+			// kernel pacing in complement if available
+			if (!_pSocket->setMaxPacingRate(ex = nullptr, UInt32(_pPacer->rate)))
+				DEBUG(description(), " kernel pacing, ", ex);
+		}
 	}
 	return _pSocket;
 }
 
-MediaSocket::Writer::Writer(Type type, const Path& path, MediaWriter* pWriter, const SocketAddress& address, IOSocket& io, const shared<TLS>& pTLS) :
-	Media::Stream(type), io(io), _pTLS(pTLS), address(address), _sendTrack(0), _subscribed(false), path(path), _pWriter(pWriter), _pStreaming(new bool(false)) {
+MediaSocket::Writer::Writer(Type type, const Path& path, MediaWriter* pWriter, const SocketAddress& address, IOSocket& io, const Timer& timer, UInt32 bitrate, const shared<TLS>& pTLS) :
+	Media::Stream(type), io(io), timer(timer), bitrate(bitrate), _pTLS(pTLS), address(address), _sendTrack(0), _subscribed(false), path(path), _pWriter(pWriter), _pStreaming(new bool(false)), _pacing(false),
+	_fragmentSize(type == TYPE_UDP && String::ICompare(pWriter->subMime(), "mp2t") == 0 ? (7 * 188) : 0) {
 	_onDisconnection = [this]() { Stream::stop<Ex::Net::Socket>(LOG_WARN, this->address, "disconnection"); };
 	_onError = [this](const Exception& ex) { Stream::stop(*_pStreaming ? LOG_WARN : LOG_DEBUG, ex); };
+	_onPacing = [this](UInt32 delay) -> UInt32 {
+		if (!_pPacer)
+			return _pacing = false;
+		if (_pPacer->queueing) {
+			if (!send<PaceSend>())
+				return _pacing = false; // stopped
+		} else if (!_pPacer->sends)
+			return _pacing = false; // idle, next media sending rearms the timer
+		return _pPacer->interval();
+	};
 }
 
 void MediaSocket::Writer::start() {
@@ -207,6 +283,7 @@ void MediaSocket::Writer::start() {
 		AUTO_ERROR(_subscribed = io.subscribe(ex, socket(), nullptr, _onFlush, _onError, _onDisconnection), description());
 		if (!_subscribed) {
 			_pSocket.reset();
+			_pPacer.reset();
 			return Stream::stop(ex);
 		}
 	}
@@ -259,6 +336,9 @@ void MediaSocket::Writer::stop() {
 		return;
 	io.unsubscribe(_pSocket);
 	_pSocket.reset();
+	timer.set(_onPacing, 0);
+	_pacing = false;
+	_pPacer.reset();
 	// reset _pWriter because could be used by different thread by new Socket and its sending thread
 	_pWriter.reset(MediaWriter::New(_pWriter->format()));
 	_pName.reset();
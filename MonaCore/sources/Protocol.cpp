@@ -25,11 +25,13 @@ namespace Mona {
 
 
 Protocol::Protocol(const char* name, ServerAPI& api, Sessions& sessions) :
-	name(name), api(api), sessions(sessions) {
+	name(name), memory(make_shared<Memory::Account>(name)),
+	traffic(make_shared<Metrics::Traffic>(Metrics::Label("protocol", name))), sessionCount("mona_sessions", "Sessions alive by protocol", Metrics::Label("protocol", name)), api(api), sessions(sessions) {
 }
 
 Protocol::Protocol(const char* name, Protocol& tunnel) :
-	name(name), api(tunnel.api), sessions(tunnel.sessions), _pSocket(tunnel._pSocket) {
+	name(name), memory(make_shared<Memory::Account>(name)),
+	traffic(make_shared<Metrics::Traffic>(Metrics::Label("protocol", name))), sessionCount("mona_sessions", "Sessions alive by protocol", Metrics::Label("protocol", name)), api(tunnel.api), sessions(tunnel.sessions), _pSocket(tunnel._pSocket) {
 	// copy parameters from tunnel (publicHost, publicPort,  etc...)
 	for (auto& it : tunnel)
 		setString(it.first, it.second);
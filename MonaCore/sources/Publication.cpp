@@ -35,12 +35,14 @@ namespace Mona {
 
 Publication::Publication(const string& name): _latency(0),
 	audios(_audios), videos(_videos), datas(_datas), _lostRate(_byteRate),
-	_publishing(false),_new(false), _newProperties(false), _newLost(false), _name(name) {
+	_publishing(false),_new(false), _newProperties(false), _newLost(false), _name(name),
+	_fanout("mona_publication_fanout_microseconds", "Distribution time of media packets to subscribers", Metrics::Label("publication", name), false) {
 	DEBUG("New publication ",name);
 }
 
 Publication::~Publication() {
 	stopRecording();
+	stopSegmenting();
 	// delete _listeners!
 	if (!subscriptions.empty())
 		CRITIC("Publication ",_name," with subscribers is deleting")
@@ -126,6 +128,27 @@ void Publication::stopRecording() {
 	_pRecording.reset();
 }
 
+HLSSegmenter& Publication::startSegmenting(UInt8 count, UInt32 duration, UInt32 partDuration) {
+	if (_pSegmenting)
+		return (HLSSegmenter&)_pSegmenting->target;
+	HLSSegmenter* pSegmenter = new HLSSegmenter(_name, count, duration, partDuration);
+	_pSegmenting.reset(new Subscription(*pSegmenter));
+	NOTE("Start ", _name, " HLS segmentation");
+	_pSegmenting->pPublication = this;
+	((set<Subscription*>&)subscriptions).emplace(_pSegmenting.get());
+	return *pSegmenter;
+}
+
+void Publication::stopSegmenting() {
+	if (!_pSegmenting)
+		return;
+	NOTE("Stop ", _name, " HLS segmentation");
+	((set<Subscription*>&)subscriptions).erase(_pSegmenting.get());
+	_pSegmenting->pPublication = NULL;
+	delete &_pSegmenting->target;
+	_pSegmenting.reset();
+}
+
 MediaFile::Writer* Publication::recorder() {
 	if (!_pRecording)
 		return NULL;
@@ -176,6 +199,7 @@ void Publication::stop() {
 		return; // already done
 
 	stopRecording();
+	stopSegmenting();
 
 	_publishing =false;
 
@@ -291,10 +315,12 @@ void Publication::writeAudio(UInt16 track, const Media::Audio::Tag& tag, const P
 	_audios.byteRate += packet.size() + sizeof(tag);
 	_new = true;
 	// TRACE("Audio ",tag.time);
+	Int64 time(Metrics::Now());
 	for (auto& it : subscriptions) {
 		if (it->pPublication == this || !it->pPublication) // If subscriber is subscribed
 			it->writeAudio(track, tag, packet);
 	}
+	_fanout.record(Metrics::Now() - time);
 	onAudio(track, tag, packet);
 	
 	// Hold config packet after video distribution to avoid to distribute two times config packet if subscription call beginMedia
@@ -331,10 +357,12 @@ void Publication::writeVideo(UInt16 track, const Media::Video::Tag& tag, const P
 	_videos.byteRate += packet.size() + sizeof(tag);
 	_new = true;
 	// TRACE("Video ", tag.time);
+	Int64 time(Metrics::Now());
 	for (auto& it : subscriptions) {
 		if (it->pPublication == this || !it->pPublication) // If subscriber is subscribed
 			it->writeVideo(track, tag, packet);
 	}
+	_fanout.record(Metrics::Now() - time);
 	onVideo(track, tag, packet);
 
 	// Hold config packet after video distribution to avoid to distribute two times config packet if subscription call beginMedia
@@ -361,10 +389,12 @@ void Publication::writeData(UInt16 track, Media::Data::Type type, const Packet&
 	_byteRate += packet.size();
 	_datas.byteRate += packet.size();
 	_new = true;
+	Int64 time(Metrics::Now());
 	for (auto& it : subscriptions) {
 		if (it->pPublication == this || !it->pPublication) // If subscriber is subscribed
 			it->writeData(track, type, packet);
 	}
+	_fanout.record(Metrics::Now() - time);
 	onData(track, type, packet);
 }
 
@@ -74,6 +74,39 @@ void RTMFP::Group::unjoin(RTMFP::Member& member) {
 	delete this;
 }
 
+RTMFP::Ack::Ack(const Packet& packet, Int64 time) : time(time) {
+	BinaryReader reader(packet.data(), packet.size());
+	stageMax = stage = reader.read7BitLongValue();
+	while (reader.available()) {
+		UInt64 first(stageMax + 1);
+		stageMax += reader.read7BitLongValue() + 1;
+		holes.emplace_back(first, stageMax);
+		if (!reader.available()) {
+			// no received range after, peer has not received more
+			holes.pop_back();
+			stageMax = first - 1;
+			break;
+		}
+		stageMax += reader.read7BitLongValue() + 1;
+	}
+}
+
+UInt32 RTMFP::RTO(double& srtt, double& rttvar, Int64 rtt) {
+	if (rtt <= 0)
+		rtt = 1;
+	if (!srtt) {
+		srtt = double(rtt);
+		rttvar = rtt / 2.0;
+	} else {
+		rttvar = (3 * rttvar + (srtt > rtt ? (srtt - rtt) : (rtt - srtt))) / 4.0;
+		srtt = (7 * srtt + rtt) / 8.0;
+	}
+	double rto(srtt + 4 * rttvar);
+	if (rto < RTO_MIN)
+		return RTO_MIN;
+	return rto > Net::RTO_MAX ? UInt32(Net::RTO_MAX) : UInt32(rto);
+}
+
 Buffer& RTMFP::InitBuffer(shared<Buffer>& pBuffer, UInt8 marker) {
 	pBuffer.reset(new Buffer(6));
 	return BinaryWriter(*pBuffer).write8(marker).write16(RTMFP::TimeNow()).buffer();
@@ -0,0 +1,243 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+*/
+
+#include "Mona/RTMFP/RTMFPCongestion.h"
+#include <cmath>
+
+using namespace std;
+
+namespace Mona {
+
+#define PACING_BURST	10 // ms of pacing rate which can be sent in a burst
+
+RTMFPCongestion* RTMFPCongestion::New(const string& name) {
+	if (String::ICompare(name, "cubic") == 0)
+		return new RTMFPCubic();
+	if (String::ICompare(name, "reno") == 0)
+		return new RTMFPReno();
+	if (String::ICompare(name, "bbr") == 0)
+		return new RTMFPBBR();
+	if (String::ICompare(name, "fixed") == 0)
+		return new RTMFPCongestion("fixed");
+	return NULL;
+}
+
+RTMFPCongestion::RTMFPCongestion(const char* name, UInt32 cwnd) : name(name), _cwnd(cwnd), _pacingRate(0), _inflight(0),
+	_minRTT(0), _minRTTTime(0), _recoveryTime(0), _timeoutTime(0), _credit(0), _creditTime(0), _paced(false) {
+}
+
+bool RTMFPCongestion::sendable(UInt32 size) {
+	_paced = false;
+	if (_inflight && (_inflight + size) > _cwnd)
+		return false; // always one packet sendable if nothing in flight
+	UInt64 rate(_pacingRate);
+	if (!rate)
+		return true;
+	// pacing token bucket
+	Int64 now(Time::Now());
+	_credit += (now - _creditTime) * rate / 1000.0;
+	_creditTime = now;
+	double burst(rate * PACING_BURST / 1000.0);
+	if (burst < (2 * RTMFP::SIZE_PACKET))
+		burst = 2 * RTMFP::SIZE_PACKET;
+	if (_credit > burst)
+		_credit = burst;
+	if (_credit >= size)
+		return true;
+	_paced = true;
+	return false;
+}
+
+void RTMFPCongestion::onSent(UInt32 size) {
+	_inflight += size;
+	if (_pacingRate)
+		_credit -= size;
+}
+
+void RTMFPCongestion::onReleased(UInt32 size) {
+	// can be called by an other thread on queue deletion
+	UInt32 inflight(_inflight);
+	while (!_inflight.compare_exchange_weak(inflight, size > inflight ? 0 : (inflight - size)));
+}
+
+void RTMFPCongestion::onAcked(UInt32 size, UInt32 rtt, UInt32 srtt) {
+	onReleased(size);
+	if (rtt) {
+		// min RTT on a 10 seconds window
+		Int64 now(Time::Now());
+		if (!_minRTT || rtt <= _minRTT || (now - _minRTTTime) > 10000) {
+			_minRTT = rtt;
+			_minRTTTime = now;
+		}
+	}
+	acked(size, rtt, srtt);
+}
+
+void RTMFPCongestion::onLost(UInt32 srtt) {
+	Int64 now(Time::Now());
+	if (_recoveryTime && (now - _recoveryTime) < (srtt ? srtt : RTMFP::RTO_MIN))
+		return; // already reduced during this RTT
+	_recoveryTime = now;
+	lost();
+}
+
+void RTMFPCongestion::onTimeout(UInt32 rto) {
+	Int64 now(Time::Now());
+	if (_timeoutTime && (now - _timeoutTime) < (rto ? rto : RTMFP::RTO_MIN))
+		return; // already collapsed by an other writer timeout during this RTO
+	_timeoutTime = _recoveryTime = now;
+	timeout();
+}
+
+
+void RTMFPReno::acked(UInt32 size, UInt32 rtt, UInt32 srtt) {
+	UInt32 cwnd(this->cwnd());
+	if ((inflight() + size) * 2 < cwnd)
+		return; // application limited, window is not validated (RFC 7661)
+	if (cwnd < _ssthresh)
+		setCwnd(cwnd + size); // slow start
+	else
+		setCwnd(cwnd + UInt32(UInt64(RTMFP::SIZE_PACKET) * size / cwnd)); // congestion avoidance
+}
+
+void RTMFPReno::lost() {
+	setCwnd(cwnd() / 2);
+	_ssthresh = cwnd();
+}
+
+void RTMFPReno::timeout() {
+	setCwnd(cwnd() / 2);
+	_ssthresh = cwnd();
+	setCwnd(RTMFP::SIZE_PACKET);
+}
+
+
+#define CUBIC_C		0.4
+#define CUBIC_BETA	0.7
+
+void RTMFPCubic::acked(UInt32 size, UInt32 rtt, UInt32 srtt) {
+	if (cwnd() < _ssthresh)
+		return RTMFPReno::acked(size, rtt, srtt); // slow start
+	if ((inflight() + size) * 2 < cwnd())
+		return; // application limited
+	Int64 now(Time::Now());
+	double cwnd(double(this->cwnd()) / RTMFP::SIZE_PACKET);
+	if (!_epoch) {
+		_epoch = now;
+		if (_wMax <= cwnd) {
+			_wMax = cwnd;
+			_k = 0;
+		} else
+			_k = cbrt((_wMax - cwnd) / CUBIC_C);
+	}
+	UInt32 delay(minRTT() ? minRTT() : (srtt ? srtt : RTMFP::RTO_MIN));
+	double t((now - _epoch + delay) / 1000.0);
+	double target(CUBIC_C * pow(t - _k, 3) + _wMax);
+	// TCP-friendly region
+	double estimation(_wMax * CUBIC_BETA + (3 * (1 - CUBIC_BETA) / (1 + CUBIC_BETA)) * (t * 1000 / delay));
+	if (estimation > target)
+		target = estimation;
+	if (target > cwnd)
+		cwnd += (target - cwnd) / cwnd * size / RTMFP::SIZE_PACKET;
+	setCwnd(UInt32(cwnd * RTMFP::SIZE_PACKET));
+}
+
+void RTMFPCubic::lost() {
+	double cwnd(double(this->cwnd()) / RTMFP::SIZE_PACKET);
+	// fast convergence
+	_wMax = cwnd < _wMax ? (cwnd * (1 + CUBIC_BETA) / 2) : cwnd;
+	setCwnd(UInt32(cwnd * CUBIC_BETA * RTMFP::SIZE_PACKET));
+	_ssthresh = this->cwnd();
+	_epoch = 0;
+}
+
+void RTMFPCubic::timeout() {
+	_wMax = double(cwnd()) / RTMFP::SIZE_PACKET;
+	RTMFPReno::timeout();
+	_epoch = 0;
+}
+
+
+#define BBR_STARTUP_GAIN 2.885 // 2/ln(2)
+static const double BBRGains[] = { 1.25, 0.75, 1, 1, 1, 1, 1, 1 };
+
+RTMFPBBR::RTMFPBBR() : RTMFPCongestion("bbr"), _state(STATE_STARTUP), _gain(BBR_STARTUP_GAIN), _cycle(0), _cycleTime(0),
+	_bandwidth(0), _bandwidthTime(0), _fullBandwidth(0), _fullRounds(0), _delivered(0), _deliveredTime(0) {
+}
+
+void RTMFPBBR::acked(UInt32 size, UInt32 rtt, UInt32 srtt) {
+	Int64 now(Time::Now());
+	if (!_deliveredTime)
+		_deliveredTime = now;
+	_delivered += size;
+	UInt32 round(minRTT() ? minRTT() : (srtt ? srtt : RTMFP::RTO_MIN));
+	Int64 elapsed(now - _deliveredTime);
+	if (elapsed < round)
+		return; // wait one round at least to get a delivery rate sample
+	UInt64 rate(_delivered * 1000ull / elapsed);
+	_delivered = 0;
+	_deliveredTime = now;
+	// max filter on 10 rounds
+	if (rate >= _bandwidth || (now - _bandwidthTime) > (10 * round)) {
+		_bandwidth = rate;
+		_bandwidthTime = now;
+	}
+	switch (_state) {
+		case STATE_STARTUP:
+			if (_bandwidth >= (_fullBandwidth * 1.25)) {
+				_fullBandwidth = _bandwidth;
+				_fullRounds = 0;
+			} else if (++_fullRounds >= 3) {
+				// bandwidth plateau, pipe is full
+				_state = STATE_DRAIN;
+				_gain = 1 / BBR_STARTUP_GAIN;
+			}
+			break;
+		case STATE_DRAIN:
+			if (inflight() > (_bandwidth * round / 1000))
+				break;
+			_state = STATE_PROBE_BW;
+			_cycleTime = now;
+			_gain = BBRGains[_cycle = 0];
+			break;
+		default: // STATE_PROBE_BW
+			if ((now - _cycleTime) < round)
+				break;
+			_cycleTime = now;
+			_gain = BBRGains[_cycle = (_cycle + 1) % (sizeof(BBRGains) / sizeof(BBRGains[0]))];
+	}
+	update();
+}
+
+void RTMFPBBR::timeout() {
+	// conservative until next bandwidth sample
+	setCwnd(4 * RTMFP::SIZE_PACKET);
+}
+
+void RTMFPBBR::update() {
+	if (!_bandwidth)
+		return;
+	setPacingRate(UInt64(_bandwidth * _gain));
+	UInt64 bdp(_bandwidth * minRTT() / 1000);
+	UInt64 cwnd(UInt64(bdp * (_state == STATE_STARTUP ? BBR_STARTUP_GAIN : 2)));
+	if (cwnd < (4 * RTMFP::SIZE_PACKET))
+		cwnd = 4 * RTMFP::SIZE_PACKET;
+	setCwnd(cwnd > 0x7FFFFFFF ? 0x7FFFFFFF : UInt32(cwnd));
+}
+
+
+} // namespace Mona
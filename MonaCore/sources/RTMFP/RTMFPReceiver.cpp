@@ -50,6 +50,7 @@ bool RTMFPReceiver::obsolete() {
 
 
 void RTMFPReceiver::receive(Socket& socket, shared<Buffer>& pBuffer, const SocketAddress& address) {
+	Int64 now(Time::Now());
 	if (_died) {
 		if (_died.isElapsed(2000)) {
 			_died.update();
@@ -151,23 +152,33 @@ void RTMFPReceiver::receive(Socket& socket, shared<Buffer>& pBuffer, const Socke
 					const auto& it = acks.emplace(id, Packet());
 					if (it.second || it.first->second) { // to avoid to override a RTMFPWriter fails!
 						if(type == 0x50) {
-							// convert to 0x51!
-							const UInt8* begin(message.current());
-							message.read7BitLongValue(); // stage!
-							UInt8* lostBuffer(BIN message.current());
-							UInt32 lostCount(0);
+							// convert bitmap to 0x51 ranges to keep the whole SACK scoreboard
+							shared<Buffer> pAck(new Buffer());
+							BinaryWriter writer(*pAck);
+							writer.write7BitLongValue(message.read7BitLongValue()); // stage!
+							UInt32 lost(1), received(0); // stage+1 is always lost
 							while (message.available()) {
 								UInt8 bits(message.read8());
 								for (UInt8 i = 0; i < 8; ++i) {
 									if (bits & 1) {
-										message.next(message.available());
-										break;
+										if (lost) {
+											writer.write7BitValue(lost - 1);
+											lost = 0;
+										}
+										++received;
+									} else {
+										if (received) {
+											writer.write7BitValue(received - 1);
+											received = 0;
+										}
+										++lost;
 									}
-									++lostCount;
 									bits >>= 1;
 								}
 							}
-							it.first->second.set(Packet(packet, begin, (lostBuffer - begin) + BinaryWriter(lostBuffer, 4).write7BitValue(lostCount).size()));
+							if (received) // last lost are not holes (not received yet)
+								writer.write7BitValue(received - 1);
+							it.first->second.set(pAck);
 						} else
 							it.first->second.set(Packet(packet, message.current(), message.available()));
 					}
@@ -254,7 +265,7 @@ void RTMFPReceiver::receive(Socket& socket, shared<Buffer>& pBuffer, const Socke
 
 	if(_pBuffer)
 		RTMFP::Send(socket, Packet(pEncoder->encode(_pBuffer, farId, address)), address);
-	_handler.queue(onFlush, ping, keepalive, _died ? true : false, acks);
+	_handler.queue(onFlush, now, ping, keepalive, _died ? true : false, acks);
 }
 
 Buffer& RTMFPReceiver::write(Socket& socket, const SocketAddress& address, UInt8 type, UInt16 size) {
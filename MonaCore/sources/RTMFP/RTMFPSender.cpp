@@ -24,27 +24,56 @@ using namespace std;
 
 namespace Mona {
 
+RTMFPSender::Queue::~Queue() {
+	if (!pCongestion)
+		return;
+	for (const shared<Packet>& pPacket : sending) {
+		if (!pPacket->acked)
+			pCongestion->onReleased(pPacket->sizeSent());
+	}
+}
+
 bool RTMFPSender::run(Exception&) {	
 	run();
-	if (!pQueue)
+	if (pQueue && !pQueue->waiting && !flush(pQueue))
 		return true;
+	// Flush queues waiting window or pacing
+	while (!pSession->waitings.empty()) {
+		shared<Queue> pWaiting(move(pSession->waitings.front()));
+		pSession->waitings.pop_front();
+		pWaiting->waiting = false;
+		if (!flush(pWaiting))
+			return true;
+	}
+	pSession->paced = false;
+	return true;
+}
 
-	// Flush Queue!
-	while (pSession->sendable && !pQueue->empty()) {
-		TRACE("Stage ", pQueue->stageSending+1, " sent");
-		shared<Packet>& pPacket(pQueue->front());
-		if (!RTMFP::Send(pSession->socket, *pPacket, address)) {
-			pSession->sendable = 0;
-			break;
+bool RTMFPSender::flush(const shared<Queue>& pFlushing) {
+	RTMFPCongestion& congestion(*pSession->pCongestion);
+	if (!pFlushing->pCongestion)
+		pFlushing->pCongestion = pSession->pCongestion;
+	while (!pFlushing->empty()) {
+		shared<Packet>& pPacket(pFlushing->front());
+		if (!congestion.sendable(pPacket->size()) || !RTMFP::Send(pSession->socket, *pPacket, address)) {
+			// wait window, pacing or socket
+			if (!pFlushing->waiting) {
+				pFlushing->waiting = true;
+				pSession->waitings.emplace_front(pFlushing);
+			}
+			if (congestion.paced())
+				pSession->paced = true;
+			return false;
 		}
-		--pSession->sendable;
+		TRACE("Stage ", pFlushing->stageSending + 1, " sent");
 		pSession->sendTime = Time::Now();
 		pSession->sendByteRate += pPacket->size();
 		pSession->queueing -= pPacket->size();
 		pPacket->setSent();
-		pQueue->stageSending += pPacket->fragments;
-		pQueue->sending.emplace_back(pPacket);
-		pQueue->pop_front();
+		congestion.onSent(pPacket->sizeSent());
+		pFlushing->stageSending += pPacket->fragments;
+		pFlushing->sending.emplace_back(pPacket);
+		pFlushing->pop_front();
 	}
 	return true;
 }
@@ -56,55 +85,103 @@ void RTMFPCmdSender::run() {
 	RTMFP::Send(pSession->socket, Mona::Packet(pSession->pEncoder->encode(pBuffer, pSession->farId(), address)), address);
 }
 
+void RTMFPSender::Session::setRTT(Int64 rtt) {
+	_rto = RTMFP::RTO(_srtt, _rttvar, rtt);
+}
+
 void RTMFPAcquiter::run() {
 	// ACK!
-	if (_stageAck > pQueue->stageSending) {
-		ERROR("stageAck ", _stageAck, " superior to sending stage ", pQueue->stageSending, " on writer ", pQueue->id);
-		_stageAck = pQueue->stageSending;
+	if (_ack.stage > pQueue->stageSending) {
+		ERROR("stageAck ", _ack.stage, " superior to sending stage ", pQueue->stageSending, " on writer ", pQueue->id);
+		_ack.stage = pQueue->stageSending;
 	}
-	while (!pQueue->sending.empty() && _stageAck > pQueue->stageAck) {
-		pQueue->stageAck += pQueue->sending.front()->fragments;
+	if (_ack.stageMax > pQueue->stageSending)
+		_ack.stageMax = pQueue->stageSending;
+	Int64 rtt(0);
+	UInt32 acked(0);
+	while (!pQueue->sending.empty() && _ack.stage > pQueue->stageAck) {
+		Packet& packet(*pQueue->sending.front());
+		if (!packet.acked) {
+			acked += packet.sizeSent();
+			if (!packet.repeated())
+				rtt = _ack.time - packet.sendTime();
+		}
+		pQueue->stageAck += packet.fragments;
 		pQueue->sending.pop_front();
-		pSession->sendable = RTMFP::SENDABLE_MAX; // has progressed, can send max!
 	}
+	if (_ack.holes.empty()) {
+		if (rtt)
+			pSession->setRTT(rtt);
+		if (acked)
+			pSession->pCongestion->onAcked(acked, UInt32(rtt), pSession->srtt());
+		return;
+	}
+	// SACK scoreboard, mark packets received after holes
+	UInt64 stage(pQueue->stageAck);
+	auto itHole(_ack.holes.begin());
+	for (shared<Packet>& pPacket : pQueue->sending) {
+		if (stage >= _ack.stageMax)
+			break;
+		UInt64 first(stage + 1);
+		stage += pPacket->fragments;
+		while (itHole != _ack.holes.end() && itHole->second < first)
+			++itHole;
+		if (pPacket->acked || (itHole != _ack.holes.end() && itHole->first <= stage))
+			continue; // already acked or lost (one of its fragments at least)
+		pPacket->acked = true;
+		acked += pPacket->sizeSent();
+		if (!pPacket->repeated())
+			rtt = _ack.time - pPacket->sendTime();
+	}
+	if (rtt)
+		pSession->setRTT(rtt);
+	if (acked)
+		pSession->pCongestion->onAcked(acked, UInt32(rtt), pSession->srtt());
+	pSession->pCongestion->onLost(pSession->srtt());
+	// repeat just holes
+	repeat(_ack.stageMax);
 }
 
-void RTMFPRepeater::run() {
+void RTMFPSender::repeat(UInt64 stageMax) {
 	// REPEAT
 	bool oneReliable = false;
 	UInt64 abandonStage = 0;
 	UInt64 stage = pQueue->stageAck;
 	UInt8 sendable(RTMFP::SENDABLE_MAX);
+	UInt32 srtt(pSession->srtt());
+	if (!srtt)
+		srtt = RTMFP::RTO_MIN;
 	for (shared<Packet>& pPacket : pQueue->sending) {
-		DEBUG("Stage ", stage + 1, " repeated");
+		if (stageMax && stage >= stageMax)
+			break; // not reported lost by the last SACK
 		stage += pPacket->fragments;
+		if (pPacket->acked)
+			continue; // received by peer, no need to repeat it
 		if (pPacket->reliable) {
 			oneReliable = true;
 			if (abandonStage) {
 				sendAbandon(abandonStage);
 				abandonStage = 0;
 			}
-			if (!RTMFP::Send(pSession->socket, *pPacket, address)) {
-				pSession->sendable = 0; // pause sending!
-				break;
-			}
+			// On SACK repeat just once by RTT to avoid a retransmission storm on every ack received
+			if (stageMax && pPacket->repeated() && (Time::Now() - pPacket->sendTime()) < srtt)
+				continue;
+			DEBUG("Stage ", stage - pPacket->fragments + 1, " repeated");
+			if (!RTMFP::Send(pSession->socket, *pPacket, address))
+				break; // pause sending!
+			pPacket->setSent();
 			if (!--sendable)
 				break;
 		} else if (!oneReliable) {
 			abandonStage = stage;
 			pSession->sendLostRate += pPacket->sizeSent();
 		}
-		if (_fragments) {
-			if (pPacket->fragments >= _fragments)
-				break;
-			_fragments -= pPacket->fragments;
-		}
 	}
 	if (abandonStage)
 		sendAbandon(abandonStage);
 }
 
-void RTMFPRepeater::sendAbandon(UInt64 stage) {
+void RTMFPSender::sendAbandon(UInt64 stage) {
 	shared<Buffer> pBuffer;
 	BinaryWriter writer(RTMFP::InitBuffer(pBuffer, pSession->initiatorTime()));
 	writer.write8(0x10).write16(2 + Binary::Get7BitValueSize(pQueue->id) + Binary::Get7BitValueSize(stage));
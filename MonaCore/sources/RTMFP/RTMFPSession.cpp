@@ -42,7 +42,7 @@ void RTMFPSession::Flow::unjoin() {
 }
 
 RTMFPSession::RTMFPSession(RTMFProtocol& protocol, ServerAPI& api, const shared<Peer>& pPeer) : 
-		_recvLostRate(_recvByteRate), _pFlow(NULL), _mainStream(api, *pPeer), _killing(0), _senderTrack(0), Session(protocol, pPeer), _nextWriterId(0), _timesKeepalive(0) {
+		_recvLostRate(_recvByteRate), _pFlow(NULL), _mainStream(api, *pPeer), _killing(0), _senderTrack(0), Session(protocol, pPeer), _nextWriterId(0), _timesKeepalive(0), _pacing(false) {
 
 	_mainStream.onStart = [this](UInt16 id, FlashWriter& writer) {
 		// Stream Begin signal
@@ -52,12 +52,28 @@ RTMFPSession::RTMFPSession(RTMFProtocol& protocol, ServerAPI& api, const shared<
 		// Stream EOF signal
 		writer.writeRaw().write16(1).write32(id);
 	};
+	_onPacing = [this](UInt32 delay) -> UInt32 {
+		if (!_pSenderSession || !_pSenderSession->paced)
+			return _pacing = false;
+		send(make_shared<RTMFPPacer>());
+		// next raising when a packet becomes sendable regarding pacing rate
+		UInt64 rate(_pSenderSession->pCongestion->pacingRate());
+		UInt64 timeout(rate ? (RTMFP::SIZE_PACKET * 1000 / rate) : 1);
+		return timeout < 1 ? 1 : (timeout > 10 ? 10 : UInt32(timeout));
+	};
 }
 
 void RTMFPSession::init(const shared<RTMFP::Session>& pSession) {
 	memcpy(BIN peer.id, pSession->peerId, Entity::SIZE);
 	_pSession = pSession;
-	_pSenderSession.reset(new RTMFPSender::Session(pSession, socket()));
+	string congestion("cubic");
+	protocol().getString("congestion", congestion);
+	RTMFPCongestion* pCongestion(RTMFPCongestion::New(congestion));
+	if (!pCongestion) {
+		WARN("Unknown RTMFP congestion control ", congestion, ", cubic used");
+		pCongestion = new RTMFPCubic();
+	}
+	_pSenderSession.reset(new RTMFPSender::Session(pSession, socket(), pCongestion));
 
 	_pSession->onAddress = [this](SocketAddress& address) {
 		// onAddress is defined on _pSession so 
@@ -191,12 +207,8 @@ void RTMFPSession::init(const shared<RTMFP::Session>& pSession) {
 			const Packet& ack(it.second);
 			if (ack) {
 				// ACK
-				BinaryReader reader(ack.data(), ack.size());
-				UInt64 stage(reader.read7BitLongValue());
-				UInt32 lostCount(0);
-				if (reader.available())
-					lostCount += UInt32(reader.read7BitLongValue()) + 1;
-				itWriter->second->acquit(stage, lostCount);
+				RTMFP::Ack sack(ack, flush.time);
+				itWriter->second->acquit(sack);
 			} else // FAIL
 				itWriter->second->fail("Writer rejected on session ", name());
 		}
@@ -274,6 +286,7 @@ void RTMFPSession::kill(Int32 error, const char* reason) {
 		_pSession->onFlush = nullptr;
 		_pSession.reset();
 	}
+	api.timer.set(_onPacing, 0);
 	Session::kill(error, reason);
 	_writers.clear();
 }
@@ -348,6 +361,11 @@ void RTMFPSession::flush() {
 		} else
 			++it;
 	}
+	// a sending queue waits pacing rate
+	if (!_pacing && _pSenderSession && _pSenderSession->paced) {
+		_pacing = true;
+		api.timer.set(_onPacing, 1);
+	}
 }
 
 void RTMFPSession::send(const shared<RTMFPSender>& pSender) {
@@ -27,7 +27,7 @@ namespace Mona {
 
 
 RTMFPWriter::RTMFPWriter(UInt64 id, UInt64 flowId, const Binary& signature, RTMFP::Output& output) :
-		_repeatDelay(0), _output(output), _stageAck(0), _lostCount(0) {
+		_repeatDelay(0), _output(output), _stageAck(0) {
 	_pQueue.reset(new RTMFPSender::Queue(id, flowId, signature));
 }
 
@@ -37,7 +37,7 @@ void RTMFPWriter::fail() {
 
 	// clear resources excepting QoS to detect this lost flow of data
 	_stageAck = 0;
-	_repeatDelay = _lostCount = 0;
+	_repeatDelay = 0;
 	_pQueue.reset(new RTMFPSender::Queue(_output.resetWriter(_pQueue->id), _pQueue->flowId, _pQueue->signature));
 }
 
@@ -47,54 +47,40 @@ void RTMFPWriter::closing(Int32 code, const char* reason) {
 		newMessage(true); // Send a MESSAGE_END just in the case where the receiver has been created
 }
 
-void RTMFPWriter::acquit(UInt64 stageAck, UInt32 lostCount) {
-	TRACE("Ack ", stageAck, " on writer ", _pQueue->id," (lostCount=",lostCount,")");
+void RTMFPWriter::acquit(RTMFP::Ack& ack) {
+	TRACE("Ack ", ack.stage, " on writer ", _pQueue->id," (holes=",ack.holes.size(),")");
 	// have to continue to become consumed even if writer closed!
-	if (stageAck > _stageAck) {
+	if (ack.stage > _stageAck) {
 		// progress!
-		_stageAck = stageAck;
-		_lostCount = 0;
+		_stageAck = ack.stage;
 		// reset repeat time on progression!
 		_repeatDelay = _output.rto();
 		_repeatTime.update();
-		// continue sending
-		_output.send(make_shared<RTMFPAcquiter>(_pQueue, _stageAck));
+	} else if (ack.holes.empty()) {
+		DEBUG("Ack ", ack.stage, " obsolete on writer ", _pQueue->id);
 		return;
 	}
-	if (!lostCount) {
-		DEBUG("Ack ", stageAck, " obsolete on writer ", _pQueue->id);
-		return;
-	}
-	if (lostCount > _lostCount) {
-		/// emulate ERTO-timeout=ping if lost infos =>
-		// repeating is caused by a gap in ack-range, it can be a packet lost or an non-ordering transfer
-		// to avoid a self-sustaining congestion repeated just the first missing packet if lost infos are present
-		// and just once time (raising=true, to emulate first RTMFP ERTO=ping), let do the trigger after
-		repeatMessages(_lostCount = lostCount);
-	}
+	// continue sending, and repeat just holes of SACK scoreboard if lost infos are present
+	// (RTMFPAcquiter repeats a hole just once by RTT to avoid a self-sustaining congestion)
+	_output.send(make_shared<RTMFPAcquiter>(_pQueue, ack));
 }
 
-void RTMFPWriter::repeatMessages(UInt32 lostCount) {
-	if (lostCount) {
-		// means that there is something lost! We can start a repeation without wait end of current sending
-		_output.send(make_shared<RTMFPRepeater>(_pQueue, lostCount>0xFF ? 0xFF : lostCount));
-		return;
-	}
-	if (!_pQueue.unique())
-		return; // wait next! is sending, wait before to repeat packets
-	// REPEAT!
-	if (_pQueue->empty()) {
+void RTMFPWriter::repeatMessages() {
+	if (!_pQueue.unique()) {
+		// a sender holds the queue (message or ack pending), skip repeat which could be acknowledged by this pending ack,
+		// excepting if the queue just waits congestion window, to not block a window full of lost packets
+		if (!_repeatDelay || !_pQueue->waiting || _pQueue.use_count() > 2)
+			return;
+	} else if (_pQueue->empty() && _pQueue->sending.empty()) { // unique here, so sending can be read safely
 		// nothing to repeat, stop repeat
 		_repeatDelay = 0;
 		return;
 	}
+	// REPEAT!
 	if (!_repeatTime.isElapsed(_repeatDelay))
 		return;
 	_repeatTime.update();
-	if (_repeatDelay<7072)
-		_repeatDelay = (UInt32)(_repeatDelay*1.4142);
-	else
-		_repeatDelay = 10000;
+	_repeatDelay = RTMFP::Backoff(_repeatDelay);
 	_output.send(make_shared<RTMFPRepeater>(_pQueue));
 }
 
@@ -35,6 +35,7 @@ RTMFProtocol::RTMFProtocol(const char* name, ServerAPI& api, Sessions& sessions)
 	setNumber("port", 1935);
 	setNumber("keepalivePeer",   10);
 	setNumber("keepaliveServer", 15);
+	setString("congestion", "cubic");
 
 	_onHandshake = [this](RTMFP::Handshake& handshake) {
 		BinaryReader reader(handshake.data(), handshake.size());
@@ -29,14 +29,13 @@ RTMPSender::RTMPSender(AMF::Type type, UInt32 time, UInt32	streamId,
 					   const shared<RC4_KEY>& pEncryptKey,
 					   Media::Data::Type packetType,
 					   const Packet& packet) : Runner("RTMPSender"),  _type(type), _time(time), _streamId(streamId), _packetType(packetType), _packet(move(packet)),
-							_pChannel(pChannel), _pSocket(pSocket), _pEncryptKey(pEncryptKey),
-							writer(*new Buffer(18)) {  // 18 => maximum header size!
-	_pBuffer.reset(&writer->buffer());
+							_pChannel(pChannel), _pSocket(pSocket), _pEncryptKey(pEncryptKey), writer(_buffer) {
 }
 
 bool RTMPSender::run(Exception&) {
-	if (_packet && _packetType!=(writer.amf0 ? Media::Data::TYPE_AMF0 : Media::Data::TYPE_AMF)) {
-		DataReader* pReader = Media::Data::NewReader(_packetType, _packet);
+	// Media payload is shared unchanged, just data have to be converted
+	if (_packet && _type != AMF::TYPE_AUDIO && _type != AMF::TYPE_VIDEO && _packetType!=(writer.amf0 ? Media::Data::TYPE_AMF0 : Media::Data::TYPE_AMF)) {
+		unique_ptr<DataReader> pReader(Media::Data::NewReader(_packetType, _packet));
 		if (pReader)
 			pReader->read(writer); // Convert to AMF
 		else
@@ -47,7 +46,7 @@ bool RTMPSender::run(Exception&) {
 	UInt32 absoluteTime(_time);
 	UInt8 headerFlag(0);
 	RTMP::Channel& channel(*_pChannel);
-	UInt32 bodySize(writer->size() + _packet.size());
+	UInt32 bodySize(_buffer.size() + _packet.size());
 
 	if (channel.id == 2)
 		_streamId = 0; // channel 2 sends always message to streamId 0 (see specification)
@@ -81,8 +80,8 @@ bool RTMPSender::run(Exception&) {
 	else if (channel.id > 63)
 		++headerSize;
 
-	_pBuffer->clip(18 - headerSize); // += offset!
-	BinaryWriter writer(_pBuffer->data(), headerSize);
+	UInt8 header[18]; // 18 => maximum header size!
+	BinaryWriter writer(header, headerSize);
 
 	if (channel.id>319) {
 		writer.write8((headerFlag << 6) | 1);
@@ -110,33 +109,33 @@ bool RTMPSender::run(Exception&) {
 	if (_time >= 0xFFFFFF)
 		writer.write32(absoluteTime); // must be absolute here
 
+	// header + body in one vectored writing
+	Packet packets[3] = { Packet(header, headerSize), Packet(_buffer.data(), _buffer.size()), _packet };
 	if (_pEncryptKey) {
-		DUMP_RESPONSE("RTMPE", _pBuffer->data(), _pBuffer->size(), _pSocket->peerAddress());
-		RC4(_pEncryptKey.get(), _pBuffer->size(), _pBuffer->data(), _pBuffer->data());
-	} else
-		DUMP_RESPONSE(_pSocket->isSecure() ? "RTMPS" : "RTMP", _pBuffer->data(), _pBuffer->size(), _pSocket->peerAddress());
-
-	Exception ex;
-	if (_pSocket->write(ex, Packet(_pBuffer)) < 0) {
-		WARN(ex);
-		return true;
-	}
-
-	if (_packet) {
-		if (_pEncryptKey) {
+		DUMP_RESPONSE("RTMPE", header, headerSize, _pSocket->peerAddress());
+		RC4(_pEncryptKey.get(), headerSize, header, header);
+		if (_buffer.size()) {
+			DUMP_RESPONSE("RTMPE", _buffer.data(), _buffer.size(), _pSocket->peerAddress());
+			RC4(_pEncryptKey.get(), _buffer.size(), _buffer.data(), _buffer.data());
+		}
+		if (_packet) {
+			// payload is shared (can't be encrypted in place), use a scratch buffer reused by this thread
+			thread_local Buffer Scratch;
 			DUMP_RESPONSE("RTMPE", _packet.data(), _packet.size(), _pSocket->peerAddress());
-			_pBuffer.reset(new Buffer(_packet.size()));
-			RC4(_pEncryptKey.get(), _packet.size(), _packet.data(), _pBuffer->data());
-			_packet.set(_pBuffer);
-		} else
+			RC4(_pEncryptKey.get(), _packet.size(), _packet.data(), Scratch.resize(_packet.size(), false).data());
+			packets[2].set(Scratch.data(), _packet.size());
+		}
+	} else {
+		DUMP_RESPONSE(_pSocket->isSecure() ? "RTMPS" : "RTMP", header, headerSize, _pSocket->peerAddress());
+		if (_buffer.size())
+			DUMP_RESPONSE(_pSocket->isSecure() ? "RTMPS" : "RTMP", _buffer.data(), _buffer.size(), _pSocket->peerAddress());
+		if (_packet)
 			DUMP_RESPONSE(_pSocket->isSecure() ? "RTMPS" : "RTMP", _packet.data(), _packet.size(), _pSocket->peerAddress());
-		if(_pSocket->write(ex, _packet)<0 && !ex)
-			WARN(ex);
 	}
-	
-	if (ex)
-		WARN(ex);
 
+	Exception ex;
+	if (_pSocket->write(ex, packets, 3) < 0 || ex)
+		WARN(ex);
 	return true;
 }
 
@@ -82,6 +82,7 @@ RTMPSession::RTMPSession(Protocol& protocol) : _first(true), _controller(2, *thi
 		// Stream Begin signal
 		_controller.writeRaw().write16(0).write32(id);
 		_controller.flush();
+		wake(); // not idle now
 	};
 	_mainStream.onStop = [this](UInt16 id, FlashWriter& writer) {
 		// Stream EOF signal
@@ -135,6 +136,20 @@ bool RTMPSession::manage() {
 	return true;
 }
 
+UInt32 RTMPSession::manageDelay() {
+	if (_mainStream.streams())
+		return 0;
+	UInt32 delay(TCPSession::manageDelay());
+	if (!peer.connected)
+		return delay;
+	// ping deadline
+	Int64 elapsed(peer.pingTime.elapsed());
+	if (elapsed >= (timeout() >> 1))
+		return 0;
+	elapsed = (timeout() >> 1) - elapsed;
+	return elapsed < delay ? UInt32(elapsed) : delay;
+}
+
 void RTMPSession::flush() {
 	// controller flush
 	_controller.flush();
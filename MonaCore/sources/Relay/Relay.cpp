@@ -0,0 +1,94 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/Relay/Relay.h"
+
+using namespace std;
+
+namespace Mona {
+
+BinaryWriter& Relay::Sender::begin(Type type, UInt32 id) {
+	_frame = _pBuffer->size();
+	_writer.write32(0).write8(type).write7BitEncoded(id);
+	_body = _pBuffer->size();
+	return _writer;
+}
+
+UInt32 Relay::Sender::end(const Packet& payload) {
+	UInt32 size(_pBuffer->size());
+	BinaryWriter(_pBuffer->data() + _frame, 4).write32(size - _frame - 4 + payload.size());
+	if (payload) {
+		// sent in an other thread, hold the payload buffer (or a copy if unbuffered)
+		const UInt8* data(payload.data());
+		shared<const Binary> pBuffer(payload.buffer());
+		if (!pBuffer) {
+			pBuffer.reset(new Buffer(payload.size(), data));
+			data = pBuffer->data();
+		}
+		_payloads.emplace_back(piecewise_construct, forward_as_tuple(size), forward_as_tuple(pBuffer, data, payload.size()));
+	}
+	return size - _body + payload.size();
+}
+
+bool Relay::Sender::run(Exception& ex) {
+	Packet buffer(_pBuffer);
+	// interleave headers (one buffer) and payloads (referenced)
+	vector<Packet> packets;
+	packets.reserve(_payloads.size() * 2 + 1);
+	UInt32 position(0);
+	for (const auto& it : _payloads) {
+		packets.emplace_back(buffer, buffer.data() + position, it.first - position);
+		packets.emplace_back(it.second);
+		position = it.first;
+	}
+	if (position < buffer.size())
+		packets.emplace_back(buffer, buffer.data() + position, buffer.size() - position);
+	return _pSocket->write(ex, packets.data(), packets.size()) != -1;
+}
+
+bool Relay::ReadMedia(const Packet& body, Media::Source& source) {
+	BinaryReader reader(body.data(), body.size());
+	UInt8 size(reader.read8());
+	if (!size || reader.available() < size)
+		return false;
+	UInt16 track(0);
+	if (size < 4) {
+		Media::Data::Type type(Media::Data::Type(reader.read8()));
+		if (size >= 3)
+			track = reader.read16();
+		source.writeData(track, type, Packet(body, reader.current(), reader.available()));
+		return true;
+	}
+	if (size & 1) {
+		Media::Video::Tag tag;
+		tag.unpack(reader);
+		if ((size - tag.packSize()) >= 2)
+			track = reader.read16();
+		source.writeVideo(track, tag, Packet(body, reader.current(), reader.available()));
+		return true;
+	}
+	Media::Audio::Tag tag;
+	tag.unpack(reader);
+	if ((size - tag.packSize()) >= 2)
+		track = reader.read16();
+	source.writeAudio(track, tag, Packet(body, reader.current(), reader.available()));
+	return true;
+}
+
+
+} // namespace Mona
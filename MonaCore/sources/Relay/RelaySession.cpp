@@ -0,0 +1,167 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/Relay/RelaySession.h"
+#include "Mona/ServerAPI.h"
+
+using namespace std;
+
+namespace Mona {
+
+static Metrics::Counter _Dropped("mona_relay_dropped_total", "Media frames dropped by relay backpressure");
+
+RelaySession::RelaySession(Protocol& protocol) : TCPSession(protocol) {
+	onData = [this](Packet& buffer) -> UInt32 {
+		Exception ex;
+		UInt32 rest(Relay::Read(ex, buffer, [this](Relay::Type type, UInt32 id, const Packet& body) { return onFrame(type, id, body); }));
+		if (ex) {
+			ERROR(name(), ", ", ex);
+			kill(ERROR_PROTOCOL);
+		}
+		return rest;
+	};
+}
+
+Relay::Sender& RelaySession::sender() {
+	if (!_pSender)
+		_pSender.reset(new Relay::Sender(socket()));
+	return *_pSender;
+}
+
+bool RelaySession::onFrame(Relay::Type type, UInt32 id, const Packet& body) {
+	BinaryReader reader(body.data(), body.size());
+	switch (type) {
+		case Relay::TYPE_SUBSCRIBE: {
+			UInt32 window(reader.read7BitEncoded());
+			string stream(STR reader.current(), reader.available());
+			const auto& it = _streams.emplace(piecewise_construct, forward_as_tuple(id), forward_as_tuple(*this, id, window));
+			if (!it.second) {
+				WARN(name(), " relays already ", stream);
+				break;
+			}
+			Exception ex;
+			if (api.subscribe(ex, stream, it.first->second.subscription)) {
+				INFO(name(), " relays ", stream);
+				break;
+			}
+			_streams.erase(it.first);
+			sender().begin(Relay::TYPE_END, id);
+			sender().end();
+			flush();
+			break;
+		}
+		case Relay::TYPE_UNSUBSCRIBE: {
+			const auto& it = _streams.find(id);
+			if (it == _streams.end())
+				break;
+			api.unsubscribe(it->second.subscription);
+			_streams.erase(it);
+			break;
+		}
+		case Relay::TYPE_ACK: {
+			const auto& it = _streams.find(id);
+			if (it != _streams.end())
+				it->second.ack(reader.read7BitEncoded());
+			break;
+		}
+		default:
+			ERROR(name(), " unexpected relay frame ", type);
+			kill(ERROR_PROTOCOL);
+			return false;
+	}
+	return true;
+}
+
+void RelaySession::flush() {
+	if (!_pSender)
+		return;
+	send(_pSender);
+	_pSender.reset();
+}
+
+bool RelaySession::manage() {
+	if (!TCPSession::manage())
+		return false;
+	for (auto& it : _streams) {
+		if (!it.second.subscription.ejected())
+			continue;
+		WARN(name(), " relay of ", it.second.subscription.name(), " ejected, edge acknowledges too slowly");
+		it.second.subscription.reset(); // restart on next key frame
+	}
+	flush();
+	return true;
+}
+
+void RelaySession::kill(Int32 error, const char* reason) {
+	if (died)
+		return;
+	onData = nullptr;
+	for (auto& it : _streams)
+		api.unsubscribe(it.second.subscription);
+	_streams.clear();
+	_pSender.reset(); // edge disconnected, useless to signal the end of its streams
+	TCPSession::kill(error, reason);
+}
+
+
+bool RelaySession::Stream::drop() {
+	++_Dropped;
+	return true;
+}
+
+bool RelaySession::Stream::writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Packet& packet, bool reliable) {
+	if (!tag.isConfig && _unacked > _window)
+		return drop();
+	_unacked += _session.sender().writeMedia(id, track, tag, packet);
+	return true;
+}
+
+bool RelaySession::Stream::writeVideo(UInt16 track, const Media::Video::Tag& tag, const Packet& packet, bool reliable) {
+	if (tag.frame == Media::Video::FRAME_KEY)
+		_waitKeyFrame = false;
+	else if (tag.frame != Media::Video::FRAME_CONFIG && (_waitKeyFrame || _unacked > _window)) {
+		_waitKeyFrame = true; // following frames are undecodable until next key frame
+		return drop();
+	}
+	_unacked += _session.sender().writeMedia(id, track, tag, packet);
+	return true;
+}
+
+bool RelaySession::Stream::writeData(UInt16 track, Media::Data::Type type, const Packet& packet, bool reliable) {
+	if (!reliable && _unacked > _window)
+		return drop();
+	_unacked += _session.sender().writeMedia(id, track, type, packet);
+	return true;
+}
+
+bool RelaySession::Stream::writeProperties(const Media::Properties& properties) {
+	BinaryWriter& writer(_session.sender().begin(Relay::TYPE_PROPERTIES, id));
+	for (const auto& it : properties)
+		writer.writeString(it.first).writeString(it.second);
+	_session.sender().end();
+	return true;
+}
+
+void RelaySession::Stream::endMedia(const string& name) {
+	_session.sender().begin(Relay::TYPE_END, id);
+	_session.sender().end();
+	_waitKeyFrame = false;
+}
+
+
+} // namespace Mona
@@ -0,0 +1,198 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/Relay/Relayer.h"
+#include "Mona/Logs.h"
+
+using namespace std;
+
+namespace Mona {
+
+Relayer::Relayer(IOSocket& io) : _client(io), _window(0), _nextId(0) {
+	_client.onData = [this](Packet& buffer) {
+		Exception ex;
+		UInt32 rest(Relay::Read(ex, buffer, [this](Relay::Type type, UInt32 id, const Packet& body) { return onFrame(type, id, body); }));
+		if (ex) {
+			ERROR("Relay origin ", _origin, ", ", ex);
+			_client->shutdown(); // disconnection, not here to keep reception buffer valid
+		}
+		for (auto& it : _streams) {
+			if (!it.second.flushing)
+				continue;
+			it.second.flushing = false;
+			it.second.publication.flush();
+		}
+		flush(); // acknowledgments
+		return rest;
+	};
+	_client.onError = [this](const Exception& ex) { WARN("Relay origin ", _origin, ", ", ex); };
+	_client.onDisconnection = [this](const SocketAddress&) {
+		_pSender.reset();
+		if (_streams.empty())
+			return;
+		WARN("Relay origin ", _origin, " disconnected");
+		for (auto& it : _streams) {
+			it.second.received = 0;
+			it.second.publication.reset(); // wait reconnection
+		}
+	};
+}
+
+void Relayer::start(const SocketAddress& origin, UInt32 window) {
+	stop();
+	_origin = origin;
+	_window = window ? window : 1;
+	NOTE("Relay edge of ", _origin);
+}
+
+void Relayer::stop() {
+	if (!_origin)
+		return;
+	for (auto& it : _streams)
+		it.second.publication.stop();
+	_streams.clear();
+	_ids.clear();
+	_client.disconnect();
+	_origin.reset();
+}
+
+bool Relayer::pull(Publication& publication) {
+	if (!_origin || publication.publishing())
+		return false;
+	UInt32 id(++_nextId);
+	_ids.emplace(&publication, id);
+	_streams.emplace(piecewise_construct, forward_as_tuple(id), forward_as_tuple(publication));
+	publication.start();
+	INFO("Relay ", publication.name(), " from ", _origin);
+	if (_client.connected() || _client.connecting()) {
+		subscribe(id, publication);
+		flush();
+	} else
+		connect(); // subscribes all the streams
+	return true;
+}
+
+bool Relayer::release(Publication& publication) {
+	const auto& it = _ids.find(&publication);
+	if (it == _ids.end())
+		return false;
+	if (_client.connected() || _client.connecting()) {
+		sender().begin(Relay::TYPE_UNSUBSCRIBE, it->second);
+		sender().end();
+		flush();
+	}
+	_streams.erase(it->second);
+	_ids.erase(it);
+	publication.stop();
+	return true;
+}
+
+void Relayer::manage() {
+	if (!_origin)
+		return;
+	if (_streams.empty()) {
+		_client.disconnect(); // nothing to relay
+		return;
+	}
+	if (!_client.connected())
+		return (void)connect();
+	// acknowledges the rest, keeps alive the connection too
+	for (auto& it : _streams)
+		ack(it.first, it.second);
+	flush();
+}
+
+bool Relayer::connect() {
+	if (_client.connected() || _client.connecting())
+		return true;
+	Exception ex;
+	bool success;
+	AUTO_WARN(success = _client.connect(ex, _origin), "Relay origin ", _origin);
+	if (!success)
+		return false;
+	for (const auto& it : _streams)
+		subscribe(it.first, it.second.publication);
+	flush();
+	return true;
+}
+
+void Relayer::subscribe(UInt32 id, const Publication& publication) {
+	sender().begin(Relay::TYPE_SUBSCRIBE, id).write7BitEncoded(_window).write(publication.name());
+	sender().end();
+}
+
+void Relayer::ack(UInt32 id, Stream& stream) {
+	sender().begin(Relay::TYPE_ACK, id).write7BitEncoded(stream.received);
+	sender().end();
+	stream.received = 0;
+}
+
+bool Relayer::onFrame(Relay::Type type, UInt32 id, const Packet& body) {
+	const auto& it = _streams.find(id);
+	if (it == _streams.end())
+		return true; // released
+	Stream& stream(it->second);
+	Publication& publication(stream.publication);
+	switch (type) {
+		case Relay::TYPE_MEDIA:
+			if (!Relay::ReadMedia(body, publication)) {
+				WARN("Relay ", publication.name(), " invalid media");
+				break;
+			}
+			stream.flushing = true;
+			if ((stream.received += body.size()) >= (_window >> 2))
+				ack(id, stream);
+			break;
+		case Relay::TYPE_PROPERTIES: {
+			BinaryReader reader(body.data(), body.size());
+			string key, value;
+			publication.clear();
+			while (reader.available()) {
+				reader.readString(key);
+				publication.setString(key, reader.readString(value));
+			}
+			stream.flushing = true;
+			break;
+		}
+		case Relay::TYPE_END:
+			publication.reset();
+			break;
+		default:
+			ERROR("Relay origin ", _origin, " unexpected frame ", type);
+			_client->shutdown(); // disconnection, not here to keep reception buffer valid
+			return false;
+	}
+	return true;
+}
+
+Relay::Sender& Relayer::sender() {
+	if (!_pSender)
+		_pSender.reset(new Relay::Sender(_client.socket()));
+	return *_pSender;
+}
+
+void Relayer::flush() {
+	if (!_pSender)
+		return;
+	Exception ex;
+	AUTO_WARN(_client.send(ex, _pSender), "Relay origin ", _origin);
+	_pSender.reset();
+}
+
+
+} // namespace Mona
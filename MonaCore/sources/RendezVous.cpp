@@ -30,10 +30,12 @@ void RendezVous::setIntern(const UInt8* peerId, const SocketAddress& address, co
 	const auto& it = _peers.find(peerId);
 	Peer* pPeer;
 	if (it != _peers.end()) {
-		pPeer = &it->second;
-		_peersByAddress.erase(it->second.address); // change address!
-	} else
-		pPeer = &_peers[peerId];
+		pPeer = it->second.get();
+		_peersByAddress.erase(pPeer->address); // change address!
+	} else {
+		pPeer = new Peer(peerId);
+		_peers.emplace(pPeer->id, pPeer);
+	}
 	pPeer->address = address;
 	pPeer->serverAddress = serverAddress;
 	pPeer->pData = pData;
@@ -47,7 +49,7 @@ void RendezVous::erase(const UInt8* peerId) {
 	const auto& it = _peers.find(peerId);
 	if (it == _peers.end())
 		return;
-	_peersByAddress.erase(it->second.address);
+	_peersByAddress.erase(it->second->address);
 	_peers.erase(it);
 }
 
@@ -56,7 +58,7 @@ void* RendezVous::meetIntern(const SocketAddress& aAddress, const UInt8* bPeerId
 	const auto& bIt = _peers.find(bPeerId);
 	if (bIt == _peers.end())
 		return NULL;
-	Peer& b(bIt->second);
+	Peer& b(*bIt->second);
 	bAddress = b.address;
 	Peer* pA;
 	const auto& aIt = _peersByAddress.find(aAddress);
@@ -20,6 +20,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/BufferPool.h"
 #include "Mona/TSReader.h"
 #include "Mona/MediaSocket.h"
+#include "Mona/MediaFile.h"
 
 
 using namespace std;
@@ -59,6 +60,21 @@ bool Server::start(const Parameters& parameters) {
 	Exception ex;
 	AUTO_ERROR(FileSystem::CreateDirectory(ex, _www), "Application directory creation");
 
+	// ThreadPool configs, before sockets start to queue runners
+	bool stealing;
+	if (getBoolean("threadPool.stealing", stealing))
+		threadPool.setStealing(stealing);
+	const char* affinity = getString("threadPool.affinity");
+	if (affinity)
+		AUTO_WARN(threadPool.setAffinity(ex = nullptr, affinity), "ThreadPool affinity");
+
+	// Memory budget in MB (see Memory), low watermark is 3/4 of high by default
+	UInt32 high(0), low;
+	getNumber("memory.high", high);
+	if (!getNumber("memory.low", low))
+		low = high - high / 4;
+	Memory::SetWatermarks(UInt64(low) << 20, UInt64(high) << 20);
+
 	bool result;
 	AUTO_ERROR(result = Thread::start(ex), "Server");
 	return result;
@@ -98,11 +114,29 @@ bool Server::run(Exception&, const volatile bool& stopping) {
 			WARN("No TLS/SSL server protocols, no key.pem file")
 		else
 			AUTO_ERROR(TLS::Create(ex=nullptr, cert, key, pTLSServer), "SSL Server");
+
+		// Stall detector of the event loop, threshold in ms (0 disables it)
+		UInt32 threshold(500);
+		bool sampling(false);
+		getNumber("watchdog", threshold);
+		getBoolean("watchdog.sampling", sampling);
+		if (threshold)
+			AUTO_WARN(_watchdog.start(ex = nullptr, threshold, sampling), "Watchdog");
 	
 		UInt32 countClient(0);
 		Sessions sessions;
 		_protocols.start(*this, sessions);
-		// TODO? ((RelayServer&)relayer).start(exWarn)
+		// Edge relay of an origin (host:port of its RELAY protocol), window in bytes by stream
+		const char* origin = getString("relay.origin");
+		if (origin) {
+			SocketAddress address;
+			UInt32 window(0x100000);
+			getNumber("relay.window", window);
+			if (address.setWithDNS(ex = nullptr, origin))
+				relayer.start(address, window);
+			else
+				ERROR("Relay origin ", origin, ", ", ex);
+		}
 
 		// Load streams before onStart because can change API properties!
 		loadStreams(streams);
@@ -113,6 +147,8 @@ bool Server::run(Exception&, const volatile bool& stopping) {
 		startStreams(streams, publications, subscriptions);
 
 		onManage = ([&](UInt32) {
+			if (Memory::GetPressure())
+				bufferPool.clear(); // release unused buffers before to penalize sessions
 			ServerAPI::manage(); // in first to mark obsolete publication/subscription
 			sessions.manage(); // in first to detect session useless died
 			_protocols.manage(); // manage custom protocol manage (resource protocols)
@@ -129,7 +165,7 @@ bool Server::run(Exception&, const volatile bool& stopping) {
 			manage(); // client manage (script, etc..)
 			if (clients.size() != countClient)
 				INFO((countClient = clients.size()), " clients");
-			// TODO? relayer.manage();
+			relayer.manage();
 			return 2000;
 		}); // manage every 2 seconds!
 		_timer.set(onManage, 2000);
@@ -164,7 +200,7 @@ bool Server::run(Exception&, const volatile bool& stopping) {
 	for (Publication* pPublication : publications)
 		unpublish(*pPublication);
 
-	// TODO? terminate relay server ((RelayServer&)relayer).stop();
+	relayer.stop();
 
 	// stop event to unload children resource (before to release sockets, threads, and buffers)
 	onStop();
@@ -183,6 +219,7 @@ bool Server::run(Exception&, const volatile bool& stopping) {
 	Buffer::SetAllocator();
 	bufferPool.clear();
 
+	_watchdog.stop();
 	NOTE("Server stopped");
 	_application.reset();
 	_www.reset();
@@ -200,6 +237,14 @@ void Server::loadStreams(multimap<string, Media::Stream*>& streams) {
 		Media::Stream::RecvBufferSize = bufferSize;
 	if (getNumber("stream.sendBufferSize", bufferSize))
 		Media::Stream::SendBufferSize = bufferSize;
+	// Recording configs
+	getNumber("record.flushSize", MediaFile::Writer::FlushSize);
+	getNumber("record.flushTime", MediaFile::Writer::FlushTime);
+	getNumber("record.preallocation", MediaFile::Writer::Preallocation);
+	getBoolean("record.direct", MediaFile::Writer::Direct);
+	const char* sync = getString("record.sync");
+	if (sync && !MediaFile::Writer::ReadSync(sync, MediaFile::Writer::SyncMode))
+		WARN("Unknown record.sync mode ", sync, ", use none, end or flush");
 
 	Exception ex;
 	string temp;
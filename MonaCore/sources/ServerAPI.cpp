@@ -29,7 +29,7 @@ using namespace std;
 namespace Mona {
 
 ServerAPI::ServerAPI(const Path& application, const Path& www, const Handler& handler, const Protocols& protocols, const Timer& timer, UInt16 cores) :
-	threadPool(cores * 2), application(application), www(www), protocols(protocols), timer(timer), handler(handler), ioSocket(handler, threadPool), ioFile(handler, threadPool), publications(_publications), clients() {
+	threadPool(cores * 2), application(application), www(www), protocols(protocols), timer(timer), handler(handler), ioSocket(handler, threadPool), ioFile(handler, threadPool), publications(_publications), clients(), relayer(ioSocket) {
 }
 
 void ServerAPI::manage() {
@@ -113,6 +113,8 @@ Publication* ServerAPI::publish(Exception& ex, const string& stream, const char*
 				if (onFileAccess(ex, append ? File::MODE_APPEND : File::MODE_WRITE, path, arguments, properties, pClient)) {
 					parameters.getBoolean("append", append);
 					publication.start(new MediaFile::Writer(path, pWriter, ioFile), append);
+					if (pClient)
+						++(UInt16&)pClient->publications;
 					return &publication;
 				}
 				delete pWriter;
@@ -120,6 +122,8 @@ Publication* ServerAPI::publish(Exception& ex, const string& stream, const char*
 				WARN(ex.set<Ex::Unsupported>(stream, " recording format ", ext, " not supported"));
 		}
 		publication.start();
+		if (pClient)
+			++(UInt16&)pClient->publications;
 		return &publication;
 	}
 
@@ -137,6 +141,8 @@ Publication* ServerAPI::publish(Exception& ex, const string& stream, const char*
 
 void ServerAPI::unpublish(Publication& publication, Client* pClient) {
 	publication.stop();
+	if (pClient && pClient->publications)
+		--(UInt16&)pClient->publications;
 	const auto& it = _publications.find(publication.name());
 	if(it == _publications.end()) {
 		WARN("Publication ", publication.name()," unfound");
@@ -198,6 +204,8 @@ bool ServerAPI::subscribe(Exception& ex, const string& stream, Subscription& sub
 	}
 
 	((set<Subscription*>&)publication.subscriptions).emplace(&subscription);
+	if (!publication.publishing())
+		relayer.pull(publication); // no publisher here, pull it from origin if relay is configured
 
 	if (subscription.pPublication) {
 		// publication switch (MBR)
@@ -243,6 +251,8 @@ void ServerAPI::unsubscribe(Subscription& subscription, Publication& publication
 		if (itWaitingKey->second.subscriptions.empty())
 			_waitingKeys.erase(itWaitingKey);
 	}
+	if (publication.subscriptions.empty())
+		relayer.release(publication);
 	if (!publication)
 		_publications.erase(publication.name());
 }
@@ -39,19 +39,19 @@ Int32 Session::ToError(const Exception& ex) {
 }
 
 Session::Session(Protocol& protocol, const shared<Peer>& pPeer, const char* name) : _pPeer(pPeer), peer(*pPeer),
-	_protocol(protocol), _name(name ? name : ""), api(protocol.api), died(false), _id(0) {
+	_protocol(protocol), _name(name ? name : ""), api(protocol.api), died(false), _id(0), _manageTick(0) {
 	init(*this);
 }
 	
 Session::Session(Protocol& protocol, const SocketAddress& address, const char* name) : peer(*new Peer(protocol.api, protocol.name)),
-	_protocol(protocol),_name(name ? name : ""), api(protocol.api), died(false), _id(0) {
+	_protocol(protocol),_name(name ? name : ""), api(protocol.api), died(false), _id(0), _manageTick(0) {
 	_pPeer.reset(&peer);
 	peer.setAddress(address);
 	init(*this);
 }
 
 Session::Session(Protocol& protocol, Session& session) : _pPeer(session._pPeer), peer(*session._pPeer),
-	_sessionsOptions(session._sessionsOptions), _protocol(protocol), api(protocol.api), died(false), _id(session._id) {
+	_sessionsOptions(session._sessionsOptions), _protocol(protocol), api(protocol.api), died(false), _id(session._id), _manageTick(0) {
 	// Morphing
 	((string&)peer.protocol) = protocol.name;
 	peer.onParameters = nullptr;
@@ -60,6 +60,7 @@ Session::Session(Protocol& protocol, Session& session) : _pPeer(session._pPeer),
 }
 
 void Session::init(Session& session) {
+	++_protocol.sessionCount;
 	peer.setServerAddress(_protocol.address);
 	peer.onParameters = [this, &session](Parameters& parameters) {
 		struct Params : Parameters {
@@ -74,6 +75,7 @@ void Session::init(Session& session) {
 }
 
 Session::~Session() {
+	--_protocol.sessionCount;
 	if (!died)
 		CRITIC(name(), " deleted without being closed");
 }
@@ -101,6 +103,12 @@ void Session::kill(Int32 error, const char* reason) {
 	// Unsubscribe onClose before onDisconnection which could close the main writer (and so recall kill)
 	peer.onClose = nullptr;
 	peer.onDisconnection();
+	wake(); // to be deleted on next manage
+}
+
+void Session::wake() {
+	if (_id)
+		_protocol.sessions.wake(_id);
 }
 
 bool Session::manage() {
@@ -116,5 +124,9 @@ bool Session::manage() {
 	return true;
 }
 
+UInt32 Session::manageDelay() {
+	return 0;
+}
+
 
 } // namespace Mona
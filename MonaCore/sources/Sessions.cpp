@@ -19,11 +19,19 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Sessions.h"
 #include "Mona/UDProtocol.h"
 #include "Mona/Session.h"
+#include "Mona/Metrics.h"
+#include <algorithm>
 
 using namespace std;
 
 namespace Mona {
 
+// Server::onManage period
+#define MANAGE_INTERVAL	2000
+
+static Metrics::Counter		_Evicted("mona_sessions_evicted_total", "Sessions evicted to respect the memory budget");
+static Metrics::Histogram	_Manage("mona_sessions_manage_microseconds", "Duration of the session management ticks", "", false);
+
 Sessions::~Sessions() {
 	// delete sessions
 	if (!_sessions.empty())
@@ -73,22 +81,14 @@ void Sessions::removeByAddress(const SocketAddress& address, Session& session) {
 			return; // if no address, was not registered!
 
 		auto& map(dynamic_cast<UDProtocol*>(&session.protocol()) ? _sessionsByAddress[0] : _sessionsByAddress[1]);
-		if (map.erase(address) == 0) {
+		if (map.erase(address) == 0)
 			ERROR(session.name(), " unfound in address sessions collection with key ", address);
-			for (auto it = map.begin(); it != map.end(); ++it) {
-				if (it->second == &session) {
-					INFO("The correct key was ", it->first);
-					map.erase(it);
-					break;
-				}
-			}
-		}
 	}
 }
 
 void Sessions::addByPeer(Session& session) {
 	if (session._sessionsOptions&SESSION_BYPEER) {
-		const auto& it = _sessionsByPeerId.emplace(session);
+		const auto& it = _sessionsByPeerId.emplace(session.peer.id, &session);
 		if (it.second)
 			return;
 		INFO(it.first->second->name(), " overloaded by ", session.name(), " (by peer id)");
@@ -103,20 +103,12 @@ void Sessions::addByPeer(Session& session) {
 
 void Sessions::removeByPeer(Session& session) {
 	if (session._sessionsOptions&SESSION_BYPEER) {
-		if (_sessionsByPeerId.erase(session.peer.id) == 0) {
+		if (_sessionsByPeerId.erase(session.peer.id) == 0)
 			ERROR(session.name(), " unfound in peer sessions collection with key ", String::Hex(session.peer.id, Entity::SIZE));
-			for (auto it = _sessionsByPeerId.begin(); it != _sessionsByPeerId.end(); ++it) {
-				if (it->second == &session) {
-					INFO("The correct key was ", String::Hex(it->first, Entity::SIZE));
-					_sessionsByPeerId.erase(it);
-					break;
-				}
-			}
-		}
 	}
 }
 
-void Sessions::remove(const map<UInt32, Session*>::iterator& it, SESSION_OPTIONS options) {
+void Sessions::remove(const HashMap<UInt32, Session*>::iterator& it, SESSION_OPTIONS options) {
 	Session& session(*it->second);
 	DEBUG(session.name(), " deleted");
 
@@ -135,19 +127,87 @@ void Sessions::remove(const map<UInt32, Session*>::iterator& it, SESSION_OPTIONS
 }
 
 
+void Sessions::schedule(Session& session, UInt32 ticks) {
+	if (!ticks)
+		ticks = 1;
+	else if (ticks >= WHEEL_SIZE)
+		ticks = WHEEL_SIZE - 1;
+	session._manageTick = _tick + ticks - 1;
+	_wheel[session._manageTick % WHEEL_SIZE].emplace_back(session._id);
+}
+
+void Sessions::wake(UInt32 id) {
+	const auto& it = _sessions.find(id);
+	if (it != _sessions.end() && Int32(it->second->_manageTick - _tick) > 0)
+		schedule(*it->second); // not already due on next tick
+}
+
+void Sessions::relieve() {
+	Memory::Pressure pressure(Memory::GetPressure());
+	if (pressure != _pressure) {
+		if (pressure == Memory::PRESSURE_HIGH)
+			WARN("Memory high watermark reached, ", Memory::Buffered() / 1024, "KB buffered (", Memory::Queueing() / 1024, "KB queueing), publishers paused")
+		else if (pressure)
+			WARN("Memory low watermark reached, ", Memory::Buffered() / 1024, "KB buffered (", Memory::Queueing() / 1024, "KB queueing), non-key frames dropped")
+		else
+			NOTE("Memory back under low watermark, ", Memory::Buffered() / 1024, "KB buffered");
+	}
+	if (pressure == Memory::PRESSURE_HIGH) {
+		bool persistent(_pressure == Memory::PRESSURE_HIGH); // pausing publishers has not been enough
+		vector<pair<UInt64, Session*>> offenders;
+		for (auto& it : _sessions) {
+			Session& session(*it.second);
+			if (session.died)
+				continue;
+			if (session.peer.publications && _paused.emplace(it.first).second && !session.pauseReception(true))
+				_paused.erase(it.first);
+			if (!persistent)
+				continue;
+			UInt64 queueing(session.peer.queueing());
+			if (queueing)
+				offenders.emplace_back(queueing, &session);
+		}
+		// evict the biggest sending queues until to free the memory exceeding high watermark
+		sort(offenders.begin(), offenders.end(), [](const pair<UInt64, Session*>& a, const pair<UInt64, Session*>& b) { return a.first > b.first; });
+		UInt64 buffered(Memory::Buffered()), excess(buffered > Memory::High() ? buffered - Memory::High() : 0);
+		for (auto& it : offenders) {
+			WARN(it.second->name(), " evicted, ", it.first / 1024, "KB queueing exceed memory budget");
+			it.second->kill(Session::ERROR_CONGESTED, "memory budget exceeded");
+			++_Evicted;
+			if (it.first >= excess)
+				break;
+			excess -= it.first;
+		}
+	} else if (!pressure && !_paused.empty()) {
+		for (UInt32 id : _paused) {
+			const auto& it = _sessions.find(id);
+			if (it != _sessions.end() && !it->second->died)
+				it->second->pauseReception(false);
+		}
+		_paused.clear();
+	}
+	_pressure = pressure;
+}
+
 void Sessions::manage() {
-	auto it = _sessions.begin();
-	while (it != _sessions.end()) {
+	Int64 time(Metrics::Now());
+	relieve(); // in first to evict sessions on this tick
+	UInt32 tick(_tick++);
+	_dues.swap(_wheel[tick % WHEEL_SIZE]);
+	for (UInt32 id : _dues) {
+		const auto& it = _sessions.find(id);
+		if (it == _sessions.end() || it->second->_manageTick != tick)
+			continue; // deleted or rescheduled
 		Session& session(*it->second);
 		if (!session.died && session.manage())
 			session.flush();
-		if (session.died) {
-			auto itRemove(it++);
-			remove(itRemove, SESSION_BYPEER | SESSION_BYADDRESS);
-			continue;
-		}
-		++it;
+		if (session.died)
+			remove(it, SESSION_BYPEER | SESSION_BYADDRESS);
+		else
+			schedule(session, session.manageDelay() / MANAGE_INTERVAL);
 	}
+	_dues.clear();
+	_Manage.record(Metrics::Now() - time);
 }
 
 
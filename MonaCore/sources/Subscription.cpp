@@ -20,6 +20,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Publication.h"
 #include "Mona/MapWriter.h"
 #include "Mona/Util.h"
+#include "Mona/Memory.h"
 #include "Mona/Logs.h"
 
 
@@ -294,6 +295,13 @@ void Subscription::writeVideo(UInt16 track, const Media::Video::Tag& tag, const
 		videoTrack.waitKeyFrame = false;
 	}
 
+	if (!isConfig && tag.frame != Media::Video::FRAME_KEY && Memory::GetPressure() && target.queueing()) {
+		// memory backpressure, a subscriber which queues gets just key frames
+		++_videos.dropped;
+		videoTrack.waitKeyFrame = true;
+		return;
+	}
+
 	if (congested()) {
 		if (_videos.reliable || _congestion(target.queueing(), Net::RTO_MAX)) {
 			_ejected = EJECTED_BANDWITDH;
@@ -29,6 +29,8 @@ TCPSession::TCPSession(Protocol& protocol) : TCPClient(api.ioSocket), onData(TCP
 void TCPSession::connect(const shared<Socket>& pSocket) {
 	peer.setAddress(pSocket->peerAddress());
 	setSocketParameters(*pSocket, protocol());
+	pSocket->setAccount(protocol().memory);
+	pSocket->setTraffic(protocol().traffic);
 
 	onError = [this](const Exception& ex) { WARN(name(), ", ", ex); };
 	onDisconnection = [this](const SocketAddress&) { kill(ERROR_SOCKET); };
@@ -89,6 +91,16 @@ void TCPSession::kill(Int32 error, const char* reason) {
 	disconnect();
 }
 
+bool TCPSession::pauseReception(bool pause) {
+	if (!socket())
+		return false;
+	if (pause)
+		api.ioSocket.pause(socket());
+	else
+		api.ioSocket.resume(socket());
+	return true;
+}
+
 bool TCPSession::manage() {
 	if (!Session::manage())
 		return false;
@@ -101,5 +113,17 @@ bool TCPSession::manage() {
 	return true;
 }
 
+UInt32 TCPSession::manageDelay() {
+	if (socket()->queueing())
+		return 0; // sending, check congestion on every manage
+	if (!_timeout)
+		return 0xFFFFFFFF;
+	// timeout when reception and sending are both idle
+	Int64 elapsed(socket()->recvTime().elapsed());
+	if (socket()->sendTime().elapsed() < elapsed)
+		elapsed = socket()->sendTime().elapsed();
+	return elapsed < _timeout ? UInt32(_timeout - elapsed) : 0;
+}
+
 
 } // namespace Mona
@@ -51,7 +51,8 @@ static UInt8 _FF[182] = {
 	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
 };
 
-static const Packet _Fill(_FF,sizeof(_FF));
+// PAT + PMT
+#define PSI_SIZE			376
 
 TSWriter::~TSWriter() {
 	for (const auto& it : _audios) {
@@ -87,35 +88,66 @@ void TSWriter::endMedia(const OnWrite& onWrite) {
 	_pids.clear();
 }
 
-void TSWriter::updatePMT(UInt32 time, const OnWrite& onWrite) {
+Buffer& TSWriter::buffer(UInt32 size) {
+	if (!_pBuffer) {
+		// estimation of TS size: 184 bytes of payload by cell + PES headers and PAT/PMT
+		_pBuffer.reset(new Buffer(((size + 64) / 184 + 4) * 188));
+		_pBuffer->clear(); // keep capacity
+	}
+	return *_pBuffer;
+}
+
+void TSWriter::flush(const OnWrite& onWrite) {
+	if (_pBuffer && _pBuffer->size())
+		onWrite(Packet(_pBuffer)); // capture the buffer, immutable now
+}
+
+void TSWriter::updatePMT(UInt32 time) {
 	++_version;
-	writePMT(time, onWrite);
+	_psiChanged = true;
+	writePMT(time);
 }
 
 void TSWriter::writePMT(UInt32 time, const OnWrite& onWrite) {
+	if (!onWrite || (_videos.empty() && _audios.empty()))
+		return; // no program!
+	buffer(PSI_SIZE);
+	writePMT(time);
+	flush(onWrite);
+}
+
+void TSWriter::writePMT(UInt32 time) {
 	// Write just one PAT+PMT table on codec change to save bandwith and because programs can't change during TSWriter session (see http://www.etherguidesystems.com/help/sdos/mpeg/syntax/tablesections/pat.aspx)
 	// Now write inside the both first 188 bytes packet (PAT + PMT) to allow recomposition stream on client side in a easy way (save the packet, and reuse it at stream beginning)
 	// No splitable format for now, so maximum programs (tracks) for PMT is 33!
+	// Tables are computed (CRC included) just on version change, then only continuity counters are patched (CRC doesn't cover them)
 
+	if (_psiChanged) {
+		_psiChanged = false;
+		writePSI();
+	}
+	_psi[3] = 0x10 | (_pids.emplace(0, 0).first->second++ % 0x10);
+	_psi[191] = 0x10 | (_pids.emplace(0x20, 0).first->second++ % 0x10);
+	_pBuffer->append(_psi, PSI_SIZE);
+	_timePMT = time;
+}
 
-	// PAT => 47 60 00 10   Pointer: 00   TableID: 00   Length: B0 0D   Fix: 00 01 C1 00 00   Program: 00 01 F0 00   CRC: 9D B0 81 9C 
-	BinaryWriter writer(_buffer, 188);
-	const auto& itPAT(_pids.emplace(0, 0).first);
-	writer.write(EXPAND("\x47\x60\x00")).write8(0x10 | (itPAT->second++ % 0x10));
-	writer.write(EXPAND("\x00\x00\xB0\x0D\x00\x01\xC1\x00\x00\x00\x01\xE0\x20"));
-	// Write CRC
-	writer.write32(Crypto::ComputeCRC32(_buffer + 5, writer.size() - 5));
-	onWrite(writer);
-	// Fill with FF
-	onWrite(Packet(_Fill, _Fill.data(), 188 - writer.size()));
-
+void TSWriter::writePSI() {
+	{
+		// PAT => 47 60 00 10   Pointer: 00   TableID: 00   Length: B0 0D   Fix: 00 01 C1 00 00   Program: 00 01 F0 00   CRC: 9D B0 81 9C 
+		BinaryWriter writer(_psi, 188);
+		writer.write(EXPAND("\x47\x60\x00\x10"));
+		writer.write(EXPAND("\x00\x00\xB0\x0D\x00\x01\xC1\x00\x00\x00\x01\xE0\x20"));
+		// Write CRC
+		writer.write32(Crypto::ComputeCRC32(_psi + 5, writer.size() - 5));
+		// Fill with FF
+		memset(_psi + writer.size(), 0xFF, 188 - writer.size());
+	}
 
 	// PMT (PID = 8188) => 47 60 20 10   Pointer: 00   TableID: 02
-	writer.clear();
-	writer.write(EXPAND("\x47\x60\x20"));
-
-	const auto& itPMT(_pids.emplace(0x20, 0).first);
-	writer.write8(0x10 | (itPMT->second++ % 0x10)); // playload flag + counter
+	UInt8* pmt(_psi + 188);
+	BinaryWriter writer(pmt, 188);
+	writer.write(EXPAND("\x47\x60\x20\x10")); // playload flag + counter
 	writer.write16(2); // Pointer 00 + Table id 02, always 2 for PMT
 
 	writer.next(2); // length
@@ -150,21 +182,19 @@ void TSWriter::writePMT(UInt32 time, const OnWrite& onWrite) {
 	}
 
 	// Write len
-	BinaryWriter(_buffer + 6, 2).write16(0xB000 | ((writer.size()-4)&0x3FF));
+	BinaryWriter(pmt + 6, 2).write16(0xB000 | ((writer.size()-4)&0x3FF));
 
 	// Write CRC
-	writer.write32(Crypto::ComputeCRC32(_buffer + 5, writer.size() - 5));
+	writer.write32(Crypto::ComputeCRC32(pmt + 5, writer.size() - 5));
 
-	onWrite(writer);
 	// Fill with FF
-	onWrite(Packet(_Fill, _Fill.data(), 188 - writer.size()));
-
-	_timePMT = time;
+	memset(pmt + writer.size(), 0xFF, 188 - writer.size());
 }
 
 void TSWriter::writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Packet& packet, const OnWrite& onWrite) {
 	if (!onWrite)
 		return;
+	buffer(packet.size());
 
 	auto it(_audios.lower_bound(track));
 	bool newTrack(false);
@@ -188,35 +218,38 @@ void TSWriter::writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Pack
 		
 		// add the new track
 		it = _audios.emplace_hint(it, track, tag.codec == Media::Audio::CODEC_AAC ? new ADTSWriter() : NULL);
-		updatePMT(tag.time, onWrite);
+		updatePMT(tag.time);
 		newTrack = true;
 	} else if (tag.codec == Media::Audio::CODEC_AAC) {
 		if (!it->second) {
 			it->second = new ADTSWriter();
-			updatePMT(tag.time, onWrite); // change from MP3 to AAC
+			updatePMT(tag.time); // change from MP3 to AAC
 			newTrack = true;
 		}
 	} else if (it->second) {
 		it->second->endMedia();
 		delete it->second;
 		it->second = NULL;
-		updatePMT(tag.time, onWrite); // change from AAC to MP3
+		updatePMT(tag.time); // change from AAC to MP3
 	}
 
 	UInt8 streamId(distance(_audios.begin(),it));
 	const auto& itPID(_pids.emplace(FIRST_AUDIO_PID + it->first, 0).first);
 
-	if (!it->second) // MP3
-		return writeES(itPID->first, itPID->second, streamId, tag.time, 0, packet, packet.size(), onWrite);
+	if (!it->second) { // MP3
+		writeES(itPID->first, itPID->second, streamId, tag.time, 0, packet, packet.size());
+		return flush(onWrite);
+	}
 
 	// AAC
 	if (newTrack)
 		it->second->beginMedia();
 	UInt32 finalSize;
-	TrackWriter::OnWrite onAudioWrite([this, &itPID, streamId, &tag, &onWrite, &finalSize](const Packet& packet){
-		writeES(itPID->first, itPID->second, streamId, tag.time, 0, packet, finalSize, onWrite);
+	TrackWriter::OnWrite onAudioWrite([this, &itPID, streamId, &tag, &finalSize](const Packet& packet){
+		writeES(itPID->first, itPID->second, streamId, tag.time, 0, packet, finalSize);
 	});
 	it->second->writeAudio(tag, packet, onAudioWrite, finalSize);
+	flush(onWrite);
 //	if (_canWrite || _toWrite)
 //		int breakPoint = 0;
 }
@@ -224,6 +257,7 @@ void TSWriter::writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Pack
 void TSWriter::writeVideo(UInt16 track, const Media::Video::Tag& tag, const Packet& packet, const OnWrite& onWrite) {
 	if (!onWrite)
 		return;
+	buffer(packet.size());
 
 	auto it(_videos.lower_bound(track));
 	bool newTrack(false);
@@ -247,7 +281,7 @@ void TSWriter::writeVideo(UInt16 track, const Media::Video::Tag& tag, const Pack
 		
 		// add the new track
 		it = _videos.emplace_hint(it, piecewise_construct, forward_as_tuple(track),forward_as_tuple());
-		updatePMT(tag.time, onWrite);
+		updatePMT(tag.time);
 		newTrack = true;
 	}
 
@@ -256,46 +290,46 @@ void TSWriter::writeVideo(UInt16 track, const Media::Video::Tag& tag, const Pack
 	if (newTrack)
 		it->second.beginMedia();
 	UInt32 finalSize;
-	TrackWriter::OnWrite onVideoWrite([this, &itPID, streamId, &tag, &onWrite, &finalSize](const Packet& packet){
-		writeES(itPID->first, itPID->second, streamId, tag.time, tag.compositionOffset, packet, finalSize, onWrite, tag.frame==Media::Video::FRAME_KEY);
+	TrackWriter::OnWrite onVideoWrite([this, &itPID, streamId, &tag, &finalSize](const Packet& packet){
+		writeES(itPID->first, itPID->second, streamId, tag.time, tag.compositionOffset, packet, finalSize, tag.frame==Media::Video::FRAME_KEY);
 	});
 	it->second.writeVideo(tag, packet, onVideoWrite, finalSize);
+	flush(onWrite);
 //	if (_canWrite || _toWrite)
 //		int breakPoint = 0;
 }
 
-void TSWriter::writeES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, const Packet& packet, UInt32 esSize, const OnWrite& onWrite, bool randomAccess) {
+void TSWriter::writeES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, const Packet& packet, UInt32 esSize, bool randomAccess) {
 	
 	Packet data(packet);
-
 	while (data) {
 		if (!_toWrite) {
 			if (_canWrite) {
 				ERROR("TS writer program ", pid, " has miscalculated PES split and fill size");
-				onWrite(Packet(_Fill, _Fill.data(), _canWrite));
+				_pBuffer->append(_FF, _canWrite);
 			}
-			_canWrite = writePES(pid, counter, streamId, time, compositionOffset, randomAccess, _toWrite = esSize, onWrite);
+			_canWrite = writePES(pid, counter, streamId, time, compositionOffset, randomAccess, _toWrite = esSize);
 		} else if (!_canWrite)
-			_canWrite = writePES(pid, counter, time, randomAccess, _toWrite, onWrite);
-		Packet fragment(data, data.data(), data.size() > _canWrite ? _canWrite : data.size());
-		onWrite(fragment);
-		data += fragment.size();
-		_canWrite -= fragment.size();
-		if (fragment.size()>_toWrite) {
+			_canWrite = writePES(pid, counter, time, randomAccess, _toWrite);
+		UInt32 size(data.size() > _canWrite ? _canWrite : data.size());
+		_pBuffer->append(data.data(), size);
+		data += size;
+		_canWrite -= size;
+		if (size>_toWrite) {
 			ERROR("TS writer program ",pid," has miscalculated its finalSize");
 			_toWrite = 0;
 		} else
-			_toWrite -= fragment.size();
+			_toWrite -= size;
 	}
 }
 
-UInt8 TSWriter::writePES(UInt16 pid, UInt8& counter, UInt32 time, bool randomAccess, UInt32 size, const OnWrite& onWrite) {
+UInt8 TSWriter::writePES(UInt16 pid, UInt8& counter, UInt32 time, bool randomAccess, UInt32 size) {
 
 	BinaryWriter writer(_buffer, 13);
 	writer.write8(0x47).write16(pid);
 	if (size >= 184) {
 		writer.write8(0x10 | (counter++ % 0x10));
-		onWrite(writer);
+		_pBuffer->append(writer.data(), writer.size());
 		return 184;
 	}
 	// fill
@@ -303,16 +337,15 @@ UInt8 TSWriter::writePES(UInt16 pid, UInt8& counter, UInt32 time, bool randomAcc
 	writer.write8(0x30 | (counter++ % 0x10)); // adaptation flag
 	fillSize -= writeAdaptiveHeader(pid, time, randomAccess, fillSize, writer);
 
-	onWrite(writer);
-	if (fillSize)
-		onWrite(Packet(_Fill, _Fill.data(), fillSize));
+	_pBuffer->append(writer.data(), writer.size());
+	_pBuffer->append(_FF, fillSize);
 	return size;
 }
 
-UInt8 TSWriter::writePES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, bool randomAccess, UInt32 size, const OnWrite& onWrite) {
+UInt8 TSWriter::writePES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time, UInt32 compositionOffset, bool randomAccess, UInt32 size) {
 
 	if (Int32(time-_timePMT) >= PMT_PERIOD)
-		writePMT(time, onWrite); // send periodic PMT infos
+		writePMT(time); // send periodic PMT infos
 	
 	UInt64 pts(0), dts(0);
 	UInt8 flags(0), length(0);
@@ -348,7 +381,7 @@ UInt8 TSWriter::writePES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time
 			else if (deltaTime >= 500) { // 500ms without PCR track, pulse it now (urgent)
 				// just PCR program (_pidPCR) can deliver the PCR timecode
 				const auto& it(_pids.emplace(_pidPCR, 0).first);
-				onWrite(Packet(_Fill, _Fill.data(), writePES(it->first, it->second, streamId, time, compositionOffset, false, 0, onWrite)));
+				_pBuffer->append(_FF, writePES(it->first, it->second, streamId, time, compositionOffset, false, 0));
 			}
 		}
 	}
@@ -388,11 +421,11 @@ UInt8 TSWriter::writePES(UInt16 pid, UInt8& counter, UInt8 streamId, UInt32 time
 		writer.write8(((dts>>29)&0x0E) | 0x21).write16(((dts >> 14) & 0xfffe) | 1).write16(((dts << 1) & 0xfffe) | 1);
 
 	if (fillSize) {
-		onWrite(Packet(writer.data(),pusiPos));
-		onWrite(Packet(_Fill, _Fill.data(), fillSize));
-		onWrite(Packet(writer.data()+pusiPos,writer.size()-pusiPos));
+		_pBuffer->append(writer.data(), pusiPos);
+		_pBuffer->append(_FF, fillSize);
+		_pBuffer->append(writer.data() + pusiPos, writer.size() - pusiPos);
 	} else
-		onWrite(writer);
+		_pBuffer->append(writer.data(), writer.size());
 	return 188 - writer.size()-fillSize;
 }
 
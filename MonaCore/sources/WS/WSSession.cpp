@@ -126,7 +126,7 @@ void WSSession::openSubscribtion(Exception& ex, string& stream, Writer& writer)
 	closeSusbcription();
 	_pSubscription = new Subscription(writer);
 	if (api.subscribe(ex, stream, peer, *_pSubscription))
-		return;
+		return wake(); // not idle now
 	delete _pSubscription;
 	_pSubscription = NULL;
 }
@@ -142,6 +142,8 @@ void WSSession::openPublication(Exception& ex, string& stream) {
 	closePublication();
 	_pPublication=api.publish(ex, peer, stream);
 	_media = 1;
+	if (_pPublication)
+		wake(); // not idle now
 }
 void WSSession::closePublication(){
 	if (!_pPublication)
@@ -250,6 +252,14 @@ bool WSSession::manage() {
 	return true;
 }
 
+UInt32 WSSession::manageDelay() {
+	if (_pSubscription || _pPublication || _tcpSession.socket()->queueing() || !peer.connected)
+		return 0;
+	// ping deadline
+	Int64 elapsed(peer.pingTime.elapsed());
+	return elapsed < (_tcpSession.timeout() / 2) ? UInt32(_tcpSession.timeout() / 2 - elapsed) : 0;
+}
+
 void WSSession::flush() {
 	// flush publication
 	if (_pPublication)
@@ -30,6 +30,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "MonaServer.h"
 #include <openssl/evp.h>
 #include "Mona/AMFReader.h"
+#include "Mona/AMFWriter.h"
 #include "Mona/JSONReader.h"
 #include "Mona/JSONWriter.h"
 #include "Mona/XMLRPCReader.h"
@@ -288,6 +289,42 @@ int LUAInvoker::ListFiles(lua_State *pState) {
 	SCRIPT_CALLBACK_RETURN
 }
 
+int	LUAInvoker::Work(lua_State *pState) {
+	// mona:work(function, ...[, callback]) runs function of the worker.lua file of the calling application on its script worker
+	SCRIPT_CALLBACK(Invoker, invoker)
+		const char* function(SCRIPT_READ_STRING(NULL));
+		// application of the caller, path of its environment
+		lua_Debug debug;
+		const char* path(NULL);
+		string app;
+		if (lua_getstack(pState, 1, &debug) && lua_getinfo(pState, "f", &debug)) {
+			lua_getfenv(pState, -1);
+			lua_getfield(pState, -1, "path");
+			if ((path = lua_tostring(pState, -1)))
+				app.assign(path);
+			lua_pop(pState, 3);
+		}
+		if (!function)
+			SCRIPT_ERROR("work requires a function name as first argument")
+		else if (!path)
+			SCRIPT_ERROR("work has to be called from an application")
+		else {
+			int callback(LUA_REFNIL);
+			if (SCRIPT_READ_AVAILABLE && lua_isfunction(pState, -1)) {
+				callback = luaL_ref(pState, LUA_REGISTRYINDEX); // pop callback
+				--__results;
+			}
+			shared<ScriptWorkers::Job> pJob(new ScriptWorkers::Job(app, function, callback));
+			AMFWriter writer(pJob->arguments);
+			SCRIPT_READ_NEXT(ScriptReader(pState, SCRIPT_READ_AVAILABLE).read(writer));
+			if (!((MonaServer&)invoker).workers.post(pJob)) {
+				luaL_unref(pState, LUA_REGISTRYINDEX, callback);
+				SCRIPT_ERROR("work impossible without script workers, see script.workers configuration")
+			}
+		}
+	SCRIPT_CALLBACK_RETURN
+}
+
 int	LUAInvoker::Sha256(lua_State *pState) {
 	SCRIPT_CALLBACK(Invoker,invoker)
 		while(SCRIPT_READ_AVAILABLE) {
@@ -485,6 +522,8 @@ int LUAInvoker::IndexConst(lua_State *pState) {
 				lua_replace(pState, -2);
 			} else if (strcmp(name,"listFiles")==0) {
 				SCRIPT_WRITE_FUNCTION(LUAInvoker::ListFiles)
+			} else if (strcmp(name,"work")==0) {
+				SCRIPT_WRITE_FUNCTION(LUAInvoker::Work)
 			}else {
 				Script::Collection(pState,1, "configs");
 				lua_getfield(pState, -1, name);
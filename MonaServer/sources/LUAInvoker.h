@@ -53,6 +53,7 @@ private:
 	static int	Md5(lua_State *pState);
 	static int	ListFiles(lua_State *pState);
 	static int	Sha256(lua_State *pState);
+	static int	Work(lua_State *pState);
 
 	/// \brief Generic function for serialization
 	/// lua -> DataType
@@ -43,6 +43,29 @@ MonaServer::MonaServer(const Parameters& configs, TerminateSignal& terminateSign
 	configs.getString("application.dir", pathApp);
 	_wwwPath.assign(pathApp).append("www");
 	_dataPath.assign(pathApp).append("data");
+	_jit = configs.getBoolean<true>("script.jit");
+	_workers = configs.getNumber<UInt8>("script.workers");
+
+	workers.onResult = [this](shared<ScriptWorkers::Job>& pJob) {
+		if (!pJob->error.empty())
+			ERROR(pJob->error);
+		if (pJob->callback == LUA_REFNIL)
+			return;
+		SCRIPT_BEGIN(_pState)
+			lua_rawgeti(_pState, LUA_REGISTRYINDEX, pJob->callback);
+			luaL_unref(_pState, LUA_REGISTRYINDEX, pJob->callback);
+			int top(lua_gettop(_pState));
+			// callback(true, ...) on success, callback(false, error) on failure
+			lua_pushboolean(_pState, pJob->error.empty() ? 1 : 0);
+			if (pJob->error.empty()) {
+				ScriptWriter writer(_pState);
+				AMFReader(pJob->results.data(), pJob->results.size()).read(writer);
+			} else
+				lua_pushstring(_pState, pJob->error.c_str());
+			if (lua_pcall(_pState, lua_gettop(_pState) - top, 0, 0) != 0)
+				SCRIPT_ERROR(Script::LastError(_pState))
+		SCRIPT_END
+	};
 
 	onPublicationData = [this](const Publication& publication,DataReader& data) {
 		SCRIPT_BEGIN(_pState)
@@ -232,7 +255,7 @@ void MonaServer::stopService(Service& service) {
 
 void MonaServer::onStart() {
 	
-	_pState = Script::CreateState();
+	_pState = Script::CreateState(_jit);
 
 
 	// init root server application
@@ -328,6 +351,11 @@ void MonaServer::onStart() {
 	// start servers
 	servers.start(*this);
 
+	// start script workers
+	ex.set(Exception::NIL);
+	if (!workers.start(ex, _workers, handler, _wwwPath, _jit))
+		ERROR("Script workers, ", ex)
+
 	// start the application (if exists)
 	ex.set(Exception::NIL);
 	_pService->open(ex);
@@ -340,6 +368,7 @@ void MonaServer::onStop() {
 	// delete service before servers.stop() to avoid a crash bug
 	if(_pService)
 		_pService.reset();
+	workers.stop();
 	Script::CloseState(_pState);
 	_pState = NULL;
 	if (_data.writing()) {
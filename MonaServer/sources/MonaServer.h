@@ -22,6 +22,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/TerminateSignal.h"
 #include "Servers.h"
 #include "Service.h"
+#include "ScriptWorkers.h"
 #include "Mona/PersistentData.h"
 
 
@@ -31,6 +32,7 @@ public:
 	~MonaServer();
 
 	Servers					servers;
+	ScriptWorkers			workers;
 
 	bool					start(const Mona::Parameters& configs);
 
@@ -96,5 +98,7 @@ private:
 
 	std::string					_wwwPath;
 	std::string					_dataPath;
+	bool						_jit;
+	Mona::UInt8					_workers; // count of script workers
 };
 
@@ -23,12 +23,13 @@ details (or else see http://www.gnu.org/licenses/).
 #include <math.h>
 extern "C" {
 	#include "luajit-2.0/lualib.h"
+	#include "luajit-2.0/luajit.h"
 }
 
 using namespace std;
 using namespace Mona;
 
-lua_Debug	Script::LuaDebug;
+thread_local lua_Debug	Script::LuaDebug;
 
 const char* Script::LastError(lua_State *pState) {
 	int top = lua_gettop(pState);
@@ -86,11 +87,27 @@ int Script::Panic(lua_State *pState) {
 	return 0;
 }
 
-lua_State* Script::CreateState() {
-	lua_State* pState = lua_open();
+lua_State* Script::CreateState(bool jit) {
+	lua_State* pState = luaL_newstate();
 	luaL_openlibs(pState);
 	lua_atpanic(pState,&Script::Panic);
 
+	if (!luaJIT_setmode(pState, 0, LUAJIT_MODE_ENGINE | (jit ? LUAJIT_MODE_ON : LUAJIT_MODE_OFF)))
+		WARN("Impossible to ", jit ? "enable" : "disable", " LuaJIT compiler");
+
+	// metatable of bytes written by ScriptWriter, FFI view on the __raw string to read it without copy (bytes.data[i], bytes.size)
+	if (luaL_dostring(pState, "local cast = require('ffi').cast\n"
+		"return { __index = function(bytes, key)\n"
+		"	if key == 'size' then return #rawget(bytes, '__raw') end\n"
+		"	if key ~= 'data' then return end\n"
+		"	local data = cast('const uint8_t*', rawget(bytes, '__raw')) -- __raw string keeps memory alive\n"
+		"	rawset(bytes, 'data', data)\n"
+		"	return data\n"
+		"end }") == 0)
+		lua_setfield(pState, LUA_REGISTRYINDEX, "|bytes");
+	else
+		WARN("LuaJIT FFI unavailable, ", LastError(pState));
+
 	lua_pushcfunction(pState,&Script::Error);
 	lua_setglobal(pState,"ERROR");
 	lua_pushcfunction(pState,&Script::Warn);
@@ -93,7 +93,7 @@ public:
 	static Mona::UInt8*	ToId(const Mona::UInt8* data, Mona::UInt32& size);
 
 	static void			CloseState(lua_State* pState);
-	static lua_State*	CreateState();
+	static lua_State*	CreateState(bool jit=true);
 
 	static int Next(lua_State* pState);
 	static int Next(lua_State* pState, int index);
@@ -448,7 +448,7 @@ public:
 		Script::LuaDebug.currentline = 0;
 	}
 
-	static lua_Debug	LuaDebug;
+	static thread_local lua_Debug	LuaDebug; // thread_local for script workers
 
 private:
 
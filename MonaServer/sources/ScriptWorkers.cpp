@@ -0,0 +1,148 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "ScriptWorkers.h"
+#include "ScriptReader.h"
+#include "ScriptWriter.h"
+#include "Mona/AMFReader.h"
+#include "Mona/AMFWriter.h"
+#include "Mona/FileSystem.h"
+#include "Mona/Logs.h"
+
+using namespace std;
+using namespace Mona;
+
+
+bool ScriptWorkers::start(Exception& ex, UInt8 count, const Handler& handler, const string& wwwPath, bool jit) {
+	stop();
+	while (_workers.size() < count) {
+		_workers.emplace_back(new Worker(handler, onResult, wwwPath, jit));
+		if (!_workers.back()->start(ex)) {
+			stop();
+			return false;
+		}
+	}
+	if (count)
+		NOTE(count, " script workers started");
+	return true;
+}
+
+void ScriptWorkers::stop() {
+	_workers.clear(); // join threads
+}
+
+bool ScriptWorkers::post(const shared<Job>& pJob) {
+	if (_workers.empty())
+		return false;
+	// affinity by application, sub applications stay on the worker of their parent
+	size_t end(pJob->app.find('/', 1));
+	_workers[hash<string>()(pJob->app.substr(0, end)) % _workers.size()]->post(pJob);
+	return true;
+}
+
+
+void ScriptWorkers::Worker::post(const shared<Job>& pJob) {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_jobs.emplace_back(pJob);
+	}
+	wakeUp.set();
+}
+
+bool ScriptWorkers::Worker::run(Exception& ex, const volatile bool& stopping) {
+	lua_State* pState(Script::CreateState(_jit));
+	deque<shared<Job>> jobs;
+	while (!stopping) {
+		wakeUp.wait();
+		{
+			lock_guard<mutex> lock(_mutex);
+			jobs.swap(_jobs);
+		}
+		for (shared<Job>& pJob : jobs) {
+			execute(pState, *pJob);
+			_handler.queue(_onResult, pJob);
+		}
+		jobs.clear();
+	}
+	_apps.clear();
+	Script::CloseState(pState);
+	return true;
+}
+
+void ScriptWorkers::Worker::execute(lua_State* pState, Job& job) {
+	// stack restored on every exit, the VM lives as long as the worker
+	int top(lua_gettop(pState));
+	string file;
+	String::Assign(file, _wwwPath, job.app, "/worker.lua");
+	FileSystem::Attributes attributes;
+	FileSystem::GetAttributes(file, attributes);
+
+	App& app(_apps[job.app]);
+	if (app.reference == LUA_REFNIL || app.lastModified != attributes.lastModified) {
+		// (re)load worker.lua in its own environment which inherits globals
+		luaL_unref(pState, LUA_REGISTRYINDEX, app.reference);
+		app.reference = LUA_REFNIL;
+		app.lastModified = attributes.lastModified;
+		if (!attributes) {
+			String::Assign(job.error, "Application ", job.app, " has no worker.lua file");
+			return;
+		}
+		if (luaL_loadfile(pState, file.c_str()) != 0) {
+			job.error.assign(Script::LastError(pState));
+			lua_settop(pState, top);
+			return;
+		}
+		lua_newtable(pState);
+		lua_newtable(pState);
+		lua_pushvalue(pState, LUA_GLOBALSINDEX);
+		lua_setfield(pState, -2, "__index");
+		lua_setmetatable(pState, -2);
+		lua_pushvalue(pState, -1);
+		lua_setfenv(pState, -3);
+		app.reference = luaL_ref(pState, LUA_REGISTRYINDEX);
+		if (lua_pcall(pState, 0, 0, 0) != 0) {
+			job.error.assign(Script::LastError(pState));
+			luaL_unref(pState, LUA_REGISTRYINDEX, app.reference);
+			app.reference = LUA_REFNIL;
+			lua_settop(pState, top);
+			return;
+		}
+		INFO("Worker www", job.app, " loaded");
+	}
+
+	lua_rawgeti(pState, LUA_REGISTRYINDEX, app.reference);
+	lua_getfield(pState, -1, job.function.c_str());
+	lua_replace(pState, -2);
+	if (!lua_isfunction(pState, -1)) {
+		lua_settop(pState, top);
+		String::Assign(job.error, "Function ", job.function, " doesn't exist in worker www", job.app);
+		return;
+	}
+	{
+		ScriptWriter writer(pState);
+		AMFReader(job.arguments.data(), job.arguments.size()).read(writer);
+	}
+	if (lua_pcall(pState, lua_gettop(pState) - top - 1, LUA_MULTRET, 0) != 0) {
+		job.error.assign(Script::LastError(pState));
+		lua_settop(pState, top);
+		return;
+	}
+	AMFWriter writer(job.results);
+	ScriptReader(pState, lua_gettop(pState) - top).read(writer);
+	lua_settop(pState, top);
+}
@@ -0,0 +1,86 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Thread.h"
+#include "Mona/Handler.h"
+#include "Script.h"
+#include <deque>
+#include <map>
+
+/*!
+	Lua VMs running on their own thread to execute CPU-heavy script code in parallel of the server thread.
+	An application (first level of Service path) is pinned to one worker VM where its worker.lua files are loaded (reloaded on change),
+	its jobs are so executed in order and can keep a state between them.
+	Nothing is shared between VMs, arguments and results are AMF serialized (message passing).
+	Opt-in offload: Client callbacks and their objects stay on the server VM, only functions called by mona:work run on a worker */
+struct ScriptWorkers : virtual Mona::Object {
+	struct Job : virtual Mona::Object {
+		Job(const std::string& app, const char* function, int callback) : app(app), function(function), callback(callback) {}
+
+		const std::string	app; // Service path
+		const std::string	function; // function of worker.lua
+		const int			callback; // reference in server VM, LUA_REFNIL if no callback
+		Mona::Buffer		arguments; // AMF
+		Mona::Buffer		results; // AMF
+		std::string			error;
+	};
+	typedef Mona::Event<void(Mona::shared<Job>&)> ON(Result); // raised on server thread
+
+	ScriptWorkers() {}
+	~ScriptWorkers() { stop(); }
+
+	Mona::UInt8	count() const { return Mona::UInt8(_workers.size()); }
+
+	bool start(Mona::Exception& ex, Mona::UInt8 count, const Mona::Handler& handler, const std::string& wwwPath, bool jit);
+	void stop();
+
+	bool post(const Mona::shared<Job>& pJob);
+
+private:
+	struct Worker : private Mona::Thread, virtual Mona::Object {
+		Worker(const Mona::Handler& handler, const OnResult& onResult, const std::string& wwwPath, bool jit) :
+			Mona::Thread("ScriptWorker"), _handler(handler), _onResult(onResult), _wwwPath(wwwPath), _jit(jit) {}
+		~Worker() { stop(); }
+
+		bool start(Mona::Exception& ex) { return Mona::Thread::start(ex); }
+		void post(const Mona::shared<Job>& pJob);
+
+	private:
+		struct App : virtual Mona::Object {
+			App() : reference(LUA_REFNIL), lastModified(0) {}
+			int			reference; // environment of worker.lua
+			Mona::Int64	lastModified;
+		};
+
+		bool run(Mona::Exception& ex, const volatile bool& stopping);
+		void execute(lua_State* pState, Job& job);
+
+		const Mona::Handler&		_handler;
+		OnResult					_onResult;
+		const std::string			_wwwPath;
+		const bool					_jit;
+
+		std::mutex					_mutex;
+		std::deque<Mona::shared<Job>>	_jobs;
+		std::map<std::string, App>	_apps; // worker thread only
+	};
+
+	std::vector<Mona::unique<Worker>>	_workers;
+};
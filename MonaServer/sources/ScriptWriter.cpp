@@ -94,6 +94,11 @@ UInt64 ScriptWriter::writeBytes(const UInt8* data,UInt32 size) {
 	lua_newtable(_pState);
 	lua_pushlstring(_pState,(const char*)data,size);
 	lua_setfield(_pState,-2,"__raw");
+	lua_getfield(_pState, LUA_REGISTRYINDEX, "|bytes");
+	if (lua_istable(_pState, -1))
+		lua_setmetatable(_pState, -2);
+	else
+		lua_pop(_pState, 1);
 	UInt64 ref(reference());
 	end();
 	return ref;
@@ -0,0 +1,40 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/Logs.h"
+
+using namespace Mona;
+using namespace std;
+
+
+bool PoolBench::run(const string& module, UInt32 duration) {
+	if (module.empty()) {
+		for (auto& it : _benchs)
+			it.second->run(duration);
+		return true;
+	}
+	auto itBench = _benchs.equal_range(module);
+	if (itBench.first == itBench.second)
+		itBench = _benchs.equal_range(module + "Bench");
+	if (itBench.first == itBench.second)
+		return false;
+	for (auto& it = itBench.first; it != itBench.second; ++it)
+		it->second->run(duration);
+	return true;
+}
@@ -0,0 +1,87 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/String.h"
+#include <chrono>
+#include <map>
+
+/*!
+	Micro benchmark, run(duration) repeats the measured code during 'duration' ms and logs its throughput */
+struct Bench : virtual Mona::Object {
+	Bench(const std::string& type) : _name(type.data(), type.size() - 5) {}
+
+	const std::string& name() const { return _name; }
+
+	virtual void run(Mona::UInt32 duration) = 0;
+
+	/*!
+	Call function until 'duration' ms elapsed, returns the number of calls and assigns the real elapsed time in us */
+	template<typename FunctionType>
+	static Mona::UInt64 Loop(Mona::UInt32 duration, Mona::UInt64& elapsed, FunctionType&& function) {
+		Mona::UInt64 count(0);
+		std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+		do {
+			// check time every 16 calls to measure the code and not the clock
+			for (Mona::UInt8 i = 0; i < 16; ++i)
+				function();
+			count += 16;
+			elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		} while (elapsed < duration * 1000ull);
+		return count;
+	}
+	/*!
+	Rate by second */
+	static double Rate(double value, Mona::UInt64 elapsed) { return elapsed ? (value * 1000000 / elapsed) : 0; }
+
+private:
+	std::string _name;
+};
+
+/// \class Container of Bench classes
+struct PoolBench : virtual Mona::Object {
+	template<typename BenchType>
+	bool makeAndRegister() {
+		const std::string& type = Mona::typeof<BenchType>();
+		_benchs.emplace(std::piecewise_construct, std::forward_as_tuple(std::string(type.data(), type.find("::"))), std::forward_as_tuple(new BenchType(type)));
+		return true;
+	}
+
+	/*!
+	Run the benchs of the module, or all the benchs if empty, returns false if module doesn't exist */
+	bool run(const std::string& module, Mona::UInt32 duration);
+
+	static PoolBench& Instance() { static PoolBench Pool; return Pool; }
+
+private:
+	PoolBench() {}
+
+	std::multimap<const std::string, std::unique_ptr<Bench>, Mona::String::IComparator> _benchs;
+};
+
+/// Macro for adding new benchs in a Bench cpp, inside a namespace named as the module
+#define ADD_BENCH(NAME) struct NAME##BENCH : Bench { \
+	NAME##BENCH(const std::string& type) : Bench(type) {}\
+	void run(Mona::UInt32 duration);\
+private:\
+	static const bool _BenchCreated;\
+};\
+const bool NAME##BENCH::_BenchCreated = PoolBench::Instance().makeAndRegister<NAME##BENCH>();\
+void NAME##BENCH::run(Mona::UInt32 duration)
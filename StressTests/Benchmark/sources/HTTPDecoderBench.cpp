@@ -0,0 +1,85 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/HTTP/HTTPDecoder.h"
+#include "Mona/ServerAPI.h"
+#include "Mona/Protocols.h"
+#include "Mona/Logs.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace HTTPDecoderBench {
+
+struct BenchAPI : ServerAPI {
+	BenchAPI(const Handler& handler, const Protocols& protocols, const Timer& timer) : ServerAPI(Path::Home(), Path::Home(), handler, protocols, timer, 1) {}
+	bool running() { return true; }
+};
+
+/*!
+	Decode 'requests' requests of the same connection, 'pipelined' by reception, and dispatch them to the main thread as a HTTPSession would do */
+static void Decode(UInt32 duration, const char* name, const string& request, UInt32 pipelined) {
+	Signal signal;
+	Handler handler(signal);
+	Parameters parameters;
+	Protocols protocols(parameters);
+	Timer timer;
+	BenchAPI api(handler, protocols, timer);
+
+	shared<Socket> pSocket(new Socket(Socket::TYPE_STREAM));
+	shared<HTTPDecoder> pDecoder(new HTTPDecoder(api));
+	UInt64 requests(0), bytes(0);
+	pDecoder->onRequest = [&requests](HTTP::Request& request) {
+		if (request && request->getString("host")) // read a header field to include its cost
+			++requests;
+	};
+	string data;
+	for (UInt32 i = 0; i < pipelined; ++i)
+		data += request;
+
+	UInt64 elapsed;
+	Bench::Loop(duration, elapsed, [&]() {
+		shared<Buffer> pBuffer(new Buffer(data.size(), data.data()));
+		((Socket::Decoder&)*pDecoder).decode(pBuffer, SocketAddress::Wildcard(), pSocket);
+		handler.flush();
+		bytes += data.size();
+	});
+	if (requests != (bytes / request.size()))
+		ERROR(name, " ", bytes / request.size() - requests, " requests lost");
+	NOTE(name, " x", pipelined, " by reception: ", UInt32(Bench::Rate(requests, elapsed)), " requests/s by core (",
+		String::Format<double>("%.1f", Bench::Rate(bytes, elapsed) / 1048576), " MB/s)");
+}
+
+ADD_BENCH(Requests) {
+	// browser-like GET and JSON RPC POST (API workload)
+	static const string Get("GET /app/index.html?session=1234 HTTP/1.1\r\nHost: localhost:8080\r\nUser-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/115.0\r\n"
+		"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\nAccept-Language: en-US,en;q=0.5\r\nAccept-Encoding: gzip, deflate\r\n"
+		"Connection: keep-alive\r\nCookie: user=mona; theme=dark\r\nCache-Control: max-age=0\r\n\r\n");
+	static const string Body("{\"jsonrpc\":\"2.0\",\"method\":\"getStats\",\"params\":[\"live\",42],\"id\":7}");
+	static const string Post(String("POST /app/rpc HTTP/1.1\r\nHost: localhost:8080\r\nUser-Agent: bench/1.0\r\nAccept: application/json\r\n"
+		"Content-Type: application/json\r\nConnection: keep-alive\r\nContent-Length: ", Body.size(), "\r\n\r\n", Body));
+
+	duration /= 4;
+	Decode(duration, "GET", Get, 1);
+	Decode(duration, "GET", Get, 16);
+	Decode(duration, "POST JSON", Post, 1);
+	Decode(duration, "POST JSON", Post, 16);
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/HashMap.h"
+#include "Mona/SocketAddress.h"
+#include "Mona/Entity.h"
+#include "Mona/Util.h"
+#include "Mona/Logs.h"
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+
+using namespace Mona;
+using namespace std;
+
+namespace HashMapBench {
+
+/*!
+	Lookups of present keys in a random order, to measure the cost of the cache misses rather than of a hot path */
+template<typename MapType, typename KeyType>
+static double Lookups(UInt32 duration, MapType& map, const vector<KeyType>& keys) {
+	for (UInt32 i = 0; i < keys.size(); ++i)
+		map.emplace(keys[i], i);
+	vector<KeyType> lookups(keys);
+	shuffle(lookups.begin(), lookups.end(), mt19937(Util::Random<UInt32>()));
+	UInt32 index(0), found(0);
+	UInt64 elapsed;
+	UInt64 count = Bench::Loop(duration, elapsed, [&]() {
+		if (map.find(lookups[index]) != map.end())
+			++found;
+		if (++index == lookups.size())
+			index = 0;
+	});
+	if (found != count)
+		ERROR("Key lookup failed");
+	return Bench::Rate(count, elapsed) / 1000000;
+}
+
+template<typename KeyType, typename HashType, typename ComparatorType, typename EqualType>
+static void Compare(UInt32 duration, const char* type, const vector<KeyType>& keys) {
+	double rates[3];
+	{
+		map<KeyType, UInt32, ComparatorType> map;
+		rates[0] = Lookups(duration, map, keys);
+	}
+	{
+		unordered_map<KeyType, UInt32, HashType, EqualType> map;
+		rates[1] = Lookups(duration, map, keys);
+	}
+	{
+		HashMap<KeyType, UInt32, HashType, EqualType> map;
+		rates[2] = Lookups(duration, map, keys);
+	}
+	NOTE(type, " x", keys.size(), " lookups in M/s: std::map ", String::Format<double>("%.1f", rates[0]),
+		", std::unordered_map ", String::Format<double>("%.1f", rates[1]), ", HashMap ", String::Format<double>("%.1f", rates[2]));
+}
+
+ADD_BENCH(Lookup) {
+	static const UInt32 Counts[] = { 10000, 100000, 1000000 };
+	// duration shared between 2 key types x 3 counts x 3 containers
+	duration = max(duration / 18, 1u);
+	for (UInt32 count : Counts) {
+		// Session/RendezVous keys: random IPv4 addresses, and 32-bytes peer ids (pointers on ids as Entity)
+		vector<SocketAddress> addresses;
+		addresses.reserve(count);
+		while (addresses.size() < count) {
+			UInt32 host(Util::Random<UInt32>());
+			addresses.emplace_back(IPAddress(in_addr({ host })), Util::Random<UInt16>() | 1);
+		}
+		sort(addresses.begin(), addresses.end());
+		addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+		Compare<SocketAddress, SocketAddress::Hash, less<SocketAddress>, equal_to<SocketAddress>>(duration, "SocketAddress", addresses);
+
+		vector<UInt8> ids(count * Entity::SIZE);
+		Util::Random(ids.data(), ids.size());
+		vector<const UInt8*> peerIds(count);
+		for (UInt32 i = 0; i < count; ++i)
+			peerIds[i] = ids.data() + i * Entity::SIZE;
+		Compare<const UInt8*, Entity::Hash, Entity::Comparator, Entity::Equal>(duration, "Peer id", peerIds);
+	}
+}
+
+}
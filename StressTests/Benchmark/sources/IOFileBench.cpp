@@ -0,0 +1,129 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/FileReader.h"
+#include "Mona/FileWriter.h"
+#include "Mona/FileSystem.h"
+#include "Mona/Logs.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace IOFileBench {
+
+static const char*	Folder("IOFileBench/");
+static const UInt32 VODS(4); // VOD files shared by readers
+static const UInt32 VOD_SIZE(0x800000);
+static const UInt32 RECORD_SIZE(0x1000000); // a recorder restarts its file beyond
+
+static struct MainHandler : Handler {
+	MainHandler() : Handler(signal) {}
+	Signal signal;
+} _Handler;
+
+/*!
+	Readers read in loop one of the VOD files by 64KB, recorders write 16KB packets in their own file with 64KB queued at most by file,
+	returns the MB/s readen and written */
+static void Run(UInt32 duration, UInt32 readers, UInt32 recorders, double& readRate, double& writeRate) {
+	ThreadPool threadPool;
+	IOFile io(_Handler, threadPool);
+	File::OnError onError([](const Exception& ex) { FATAL_ERROR("IOFile bench, ", ex); });
+	shared<Buffer> pBuffer(new Buffer(0x4000));
+	memset(pBuffer->data(), 0x47, pBuffer->size());
+	Packet packet(pBuffer);
+
+	UInt64 readen(0), written(0);
+	vector<unique<FileReader>> vods(readers);
+	vector<unique<FileWriter>> records(recorders);
+	vector<UInt32> sizes(recorders);
+	chrono::steady_clock::time_point start(chrono::steady_clock::now());
+	for (UInt32 i = 0; i < readers; ++i) {
+		FileReader& reader(*(vods[i] = unique<FileReader>(new FileReader(io))));
+		reader.onError = onError;
+		reader.onReaden = [&reader, &readen](shared<Buffer>& pBuffer, bool end) {
+			readen += pBuffer->size();
+			if (end)
+				reader->reset();
+			reader.read();
+		};
+		reader.open(String(Folder, "vod", i % VODS, ".ts")).read();
+	}
+	for (UInt32 i = 0; i < recorders; ++i) {
+		FileWriter& writer(*(records[i] = unique<FileWriter>(new FileWriter(io))));
+		writer.onError = onError;
+		writer.onFlush = []() {}; // wake up the loop
+		writer.open(String(Folder, "record", i, ".ts"));
+	}
+
+	UInt64 elapsed;
+	Bench::Loop(duration, elapsed, [&]() {
+		for (UInt32 i = 0; i < recorders; ++i) {
+			FileWriter& writer(*records[i]);
+			if (sizes[i] >= RECORD_SIZE) {
+				writer.open(String(Folder, "record", i, ".ts"));
+				sizes[i] = 0;
+			}
+			while (!writer->queueing() && sizes[i] < RECORD_SIZE) {
+				writer.write(packet);
+				sizes[i] += packet.size();
+				written += packet.size();
+			}
+		}
+		if (!_Handler.flush())
+			_Handler.signal.wait(1);
+	});
+	vods.clear();
+	records.clear();
+	io.join(); // recorded data written
+	_Handler.flush();
+	elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+	readRate = Bench::Rate(double(readen), elapsed) / 0x100000;
+	writeRate = Bench::Rate(double(written), elapsed) / 0x100000;
+}
+
+ADD_BENCH(VOD) {
+	static const UInt32 Concurrencies[][2] = { { 8, 0 }, { 0, 8 }, { 64, 16 }, { 256, 64 } };
+	// duration shared between 4 concurrencies x 2 engines
+	duration = max(duration / 8, 1u);
+	Exception ex;
+	if (!FileSystem::CreateDirectory(ex, Folder)) {
+		ERROR(ex);
+		return;
+	}
+	shared<Buffer> pBuffer(new Buffer(VOD_SIZE));
+	memset(pBuffer->data(), 0x47, pBuffer->size());
+	for (UInt32 i = 0; i < VODS; ++i) {
+		if (!File(String(Folder, "vod", i, ".ts"), File::MODE_WRITE).write(ex, pBuffer->data(), pBuffer->size())) {
+			ERROR(ex);
+			return;
+		}
+	}
+	bool uring(IOFile::GetURing());
+	for (const UInt32* concurrency : Concurrencies) {
+		double rates[4];
+		IOFile::SetURing(false);
+		Run(duration, concurrency[0], concurrency[1], rates[0], rates[1]);
+		IOFile::SetURing(true);
+		Run(duration, concurrency[0], concurrency[1], rates[2], rates[3]);
+		NOTE(concurrency[0], " readers + ", concurrency[1], " recorders in MB/s: thread engine ", String::Format<double>("%.0f", rates[0]), " read ",
+			String::Format<double>("%.0f", rates[1]), " written, io_uring ", String::Format<double>("%.0f", rates[2]), " read ", String::Format<double>("%.0f", rates[3]), " written");
+	}
+	IOFile::SetURing(uring);
+	FileSystem::Delete(ex, Folder, FileSystem::MODE_HEAVY);
+}
+
+}
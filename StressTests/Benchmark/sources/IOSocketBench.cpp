@@ -0,0 +1,97 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/UDPSocket.h"
+#include "Mona/BufferPool.h"
+#include "Mona/Logs.h"
+#include <new>
+
+using namespace Mona;
+using namespace std;
+
+// count every heap allocation of the process
+static atomic<UInt64> _Mallocs(0);
+void* operator new(size_t size) {
+	++_Mallocs;
+	void* pMemory = malloc(size ? size : 1);
+	if (!pMemory)
+		throw bad_alloc();
+	return pMemory;
+}
+void operator delete(void* pMemory) noexcept { free(pMemory); }
+
+namespace IOSocketBench {
+
+static const UInt32 BATCH(32); // packets sent before to wait their reception
+
+static struct MainHandler : Handler {
+	MainHandler() : Handler(signal) {}
+	Signal signal;
+} _Handler;
+
+ADD_BENCH(UDPReceive) {
+	Timer timer;
+	BufferPool bufferPool(timer);
+	Buffer::SetAllocator(bufferPool);
+	ThreadPool threadPool;
+	IOSocket io(_Handler, threadPool);
+	Exception ex;
+
+	UInt64 received(0);
+	UDPSocket receiver(io);
+	receiver.onError = [](const Exception& ex) { FATAL_ERROR("IOSocket bench, ", ex); };
+	receiver.onPacket = [&received](shared<Buffer>& pBuffer, const SocketAddress& address) { ++received; };
+	if (!receiver.bind(ex, IPAddress::Loopback()))
+		FATAL_ERROR("IOSocket bench, ", ex);
+	SocketAddress target(IPAddress::Loopback(), receiver->address().port());
+	Socket sender(Socket::TYPE_DATAGRAM);
+	char data[100];
+	memset(data, 0x47, sizeof(data));
+
+	UInt64 sent(0), lost(0);
+	function<void()> send([&]() {
+		for (UInt32 i = 0; i < BATCH; ++i) {
+			if (sender.sendTo(ex, data, sizeof(data), target) < 0)
+				FATAL_ERROR("IOSocket bench, ", ex);
+		}
+		sent += BATCH;
+		while (received < sent) {
+			if (!_Handler.flush() && !_Handler.signal.wait(1000)) {
+				lost += sent - received; // UDP lost
+				received = sent;
+			}
+		}
+	});
+
+	// warm up free lists and pools
+	UInt64 elapsed;
+	Bench::Loop(max(duration / 10, 1u), elapsed, send);
+
+	UInt64 mallocs(_Mallocs);
+	received = sent = lost = 0;
+	UInt64 count = Bench::Loop(duration, elapsed, send);
+	mallocs = _Mallocs - mallocs;
+
+	receiver.close();
+	threadPool.join();
+	_Handler.flush();
+	Buffer::SetAllocator();
+	NOTE("UDP loopback reception of ", String::Format<double>("%.0f", Bench::Rate(double(count * BATCH), elapsed)), " packets/s, ",
+		String::Format<double>("%.2f", double(mallocs) / (count * BATCH)), " mallocs by packet (", lost, " packets lost)");
+}
+
+}
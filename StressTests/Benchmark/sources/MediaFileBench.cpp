@@ -0,0 +1,89 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/MediaFile.h"
+#include "Mona/TSWriter.h"
+#include "Mona/FileSystem.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace MediaFileBench {
+
+static const char*	Folder("MediaFileBench/");
+static const UInt32 RECORD_SIZE(0x200000);
+
+static struct MainHandler : Handler {
+	MainHandler() : Handler(signal) {}
+	Signal signal;
+} _Handler;
+
+/*!
+	'recordings' TS recordings of 2MB written simultaneously by video frames of 1500 bytes, returns the MB/s of media recorded */
+static double Run(UInt32 recordings, const Parameters& parameters) {
+	shared<Buffer> pFrame(new Buffer(1500));
+	memset(pFrame->data(), 0x55, pFrame->size());
+	BinaryWriter(pFrame->data(), 5).write32(pFrame->size() - 4).write8(0x41);
+	Packet frame(pFrame);
+	Media::Video::Tag tag(Media::Video::CODEC_H264);
+
+	chrono::steady_clock::time_point start(chrono::steady_clock::now());
+	{
+		ThreadPool threadPool;
+		IOFile io(_Handler, threadPool);
+		vector<unique<MediaFile::Writer>> writers(recordings);
+		for (UInt32 i = 0; i < recordings; ++i) {
+			MediaFile::Writer& writer(*(writers[i] = unique<MediaFile::Writer>(new MediaFile::Writer(String(Folder, "record", i, ".ts"), new TSWriter(), io))));
+			writer.start();
+			writer.beginMedia("bench", parameters);
+		}
+		for (UInt32 size = 0; size < RECORD_SIZE; size += frame.size()) {
+			tag.time = size / frame.size() * 40;
+			for (unique<MediaFile::Writer>& pWriter : writers)
+				pWriter->writeVideo(0, tag, frame, true);
+		}
+		for (unique<MediaFile::Writer>& pWriter : writers)
+			pWriter->endMedia("bench");
+		writers.clear();
+		threadPool.join(); // muxed
+		io.join(); // written
+	}
+	_Handler.flush();
+	UInt64 elapsed(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+	return Bench::Rate(double(recordings) * RECORD_SIZE, elapsed) / 0x100000;
+}
+
+ADD_BENCH(Record) {
+	// fixed amount of data, 'duration' is ignored
+	Exception ex;
+	if (!FileSystem::CreateDirectory(ex, Folder)) {
+		ERROR(ex);
+		return;
+	}
+	Parameters unbuffered, buffered, direct;
+	unbuffered.setNumber("flushSize", 0);
+	unbuffered.setNumber("preallocation", 0);
+	direct.setBoolean("direct", true);
+	for (UInt32 recordings : { 16, 128, 256 }) {
+		double rates[3] = { Run(recordings, unbuffered), Run(recordings, buffered), Run(recordings, direct) };
+		NOTE(recordings, " recordings in MB/s: ", String::Format<double>("%.0f", rates[0]), " unbuffered, ", String::Format<double>("%.0f", rates[1]),
+			" write-behind + preallocation, ", String::Format<double>("%.0f", rates[2]), " direct");
+	}
+	FileSystem::Delete(ex, Folder, FileSystem::MODE_HEAVY);
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/Packet.h"
+#include "Mona/Recycler.h"
+#include "Mona/Logs.h"
+#include <deque>
+
+using namespace Mona;
+using namespace std;
+
+namespace PacketBench {
+
+static const UInt32 BATCH(256); // packets queued before to be released
+
+/*!
+	Queue of small messages (as acks or AMF headers) bufferized to be kept after their emission call */
+static void Run(UInt32 duration, UInt32 size) {
+	string data(size, 'a');
+	deque<Packet> packets;
+	UInt64 elapsed;
+	UInt64 allocations(Recycling::Allocations());
+	UInt64 count = Bench::Loop(duration, elapsed, [&]() {
+		for (UInt32 i = 0; i < BATCH; ++i) {
+			Packet packet(data.data(), size);
+			packets.emplace_back(move(packet)); // bufferize
+			Packet copy(packets.back()); // reference without touching to the reference counter
+		}
+		packets.clear();
+	});
+	NOTE(size, " bytes packets bufferized at ", String::Format<double>("%.0f", Bench::Rate(double(count * BATCH), elapsed)), " packets/s (",
+		Recycling::Allocations() - allocations, " blocks allocated)");
+}
+
+ADD_BENCH(Bufferize) {
+	Run(duration / 3, 32);
+	Run(duration / 3, 512);
+	Run(duration / 3, 4096);
+}
+
+}
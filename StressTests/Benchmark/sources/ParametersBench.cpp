@@ -0,0 +1,117 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/Parameters.h"
+#include "Mona/Logs.h"
+#include <map>
+
+using namespace Mona;
+using namespace std;
+
+namespace ParametersBench {
+
+/*!
+	Previous storage of Parameters (std::map with case-insensitive comparator and parsing on every read) with its change events, as reference */
+struct MapParameters : virtual Object {
+	typedef Event<void(const std::string& key, const std::string* pValue)> ON(Change);
+	typedef Event<void()>												   ON(Clear);
+
+	const char* getString(const string& key) const {
+		const auto& it = _map.find(key);
+		return it == _map.end() ? NULL : it->second.c_str();
+	}
+	template<typename NumberType>
+	bool getNumber(const string& key, NumberType& value) const { const char* temp = getString(key); return temp && String::ToNumber<NumberType>(temp, value); }
+	void setString(const string& key, const char* value) {
+		const auto& it = _map.emplace(key, string()).first;
+		it->second.assign(value);
+		onParamChange(it->first, &it->second);
+	}
+	void clear() {
+		if (_map.empty())
+			return;
+		_map.clear();
+		onParamClear();
+	}
+protected:
+	virtual void onParamChange(const std::string& key, const std::string* pValue) { onChange(key, pValue); }
+	virtual void onParamClear() { onClear(); }
+private:
+	map<string, string, String::IComparator> _map;
+};
+
+// headers of a typical HTTP request, keys as sent and as readen
+static const char* Headers[][2] = {
+	{ "Host", "localhost:80" }, { "User-Agent", "Mozilla/5.0 (X11; Linux x86_64; rv:60.0) Gecko/20100101 Firefox/60.0" },
+	{ "Accept", "text/html,application/xhtml+xml" }, { "Accept-Language", "en-US,en;q=0.5" }, { "Accept-Encoding", "gzip, deflate" },
+	{ "Connection", "keep-alive" }, { "Upgrade-Insecure-Requests", "1" }, { "Cache-Control", "max-age=0" },
+	{ "If-Modified-Since", "Tue, 15 Nov 1994 08:12:31 GMT" }, { "Range", "bytes=0-1023" }, { "Content-Length", "348" },
+	{ "Referer", "http://localhost/index.html" }
+};
+static const string Reads[] = { "host", "connection", "accept-encoding", "if-none-match", "content-length", "range", "upgrade", "origin" };
+
+template<typename ParametersType>
+static void Run(UInt32 duration, ParametersType& params, double& lookups, double& numbers, double& builds) {
+	for (auto& header : Headers)
+		params.setString(header[0], header[1]);
+	// lookups of present and absent keys
+	UInt32 index(0), found(0);
+	UInt64 elapsed;
+	UInt64 count = Bench::Loop(duration, elapsed, [&]() {
+		if (params.getString(Reads[index]))
+			++found;
+		if (++index == (sizeof(Reads) / sizeof(Reads[0])))
+			index = 0;
+	});
+	lookups = Bench::Rate(count, elapsed) / 1000000;
+	// number reads of the same key (as a subscription parameter or a config read on every packet)
+	UInt32 size(0);
+	count = Bench::Loop(duration, elapsed, [&]() {
+		UInt32 value;
+		if (params.getNumber(Reads[4], value))
+			size += value;
+	});
+	numbers = Bench::Rate(count, elapsed) / 1000000;
+	// build and clear of the whole set
+	count = Bench::Loop(duration, elapsed, [&]() {
+		params.clear();
+		for (auto& header : Headers)
+			params.setString(header[0], header[1]);
+	});
+	builds = Bench::Rate(count, elapsed) / 1000;
+	if (!found || !size)
+		ERROR("Parameters lookup failed");
+}
+
+ADD_BENCH(Lookup) {
+	duration = max(duration / 6, 1u);
+	double rates[2][3];
+	{
+		MapParameters params;
+		Run(duration, params, rates[0][0], rates[0][1], rates[0][2]);
+	}
+	{
+		Parameters params;
+		Run(duration, params, rates[1][0], rates[1][1], rates[1][2]);
+	}
+	NOTE(sizeof(Headers) / sizeof(Headers[0]), " HTTP headers, std::map => Parameters: ",
+		String::Format<double>("%.1f", rates[0][0]), " => ", String::Format<double>("%.1f", rates[1][0]), " M lookups/s, ",
+		String::Format<double>("%.1f", rates[0][1]), " => ", String::Format<double>("%.1f", rates[1][1]), " M numbers/s, ",
+		String::Format<double>("%.0f", rates[0][2]), " => ", String::Format<double>("%.0f", rates[1][2]), " K builds/s");
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/PersistentData.h"
+#include "Mona/FileSystem.h"
+#include "Mona/Logs.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace PersistentDataBench {
+
+static const char* Folder("PersistentDataBench/");
+
+/*!
+	Store 'duration' x 100 entries of 64 bytes in a 3-levels tree, then measure the load of the database */
+ADD_BENCH(Load) {
+	Exception ex;
+	UInt32 entries(max(duration, 10u) * 100);
+	PersistentData data;
+	data.load(ex, Folder, nullptr);
+	string value(64, 'v');
+	chrono::steady_clock::time_point start(chrono::steady_clock::now());
+	for (UInt32 i = 0; i < entries; ++i)
+		data.add(ex, String("/app", i % 10, "/user", i % 1000, "/field", i), Packet(value.data(), value.size()));
+	data.flush();
+	UInt64 elapsed(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+	NOTE(entries, " entries stored at ", UInt32(Rate(entries, elapsed)), " entries/s");
+
+	UInt32 count(0);
+	start = chrono::steady_clock::now();
+	data.load(ex, Folder, [&count](const string& path, const UInt8* value, UInt32 size) { ++count; });
+	elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+	if (ex)
+		ERROR(ex);
+	NOTE(count, " entries loaded in ", elapsed / 1000, "ms (", UInt32(Rate(count, elapsed)), " entries/s)");
+	FileSystem::Delete(ex, Folder, FileSystem::MODE_HEAVY);
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/TSWriter.h"
+#include "Mona/Logs.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace TSWriterBench {
+
+/*!
+	Mux of a synthetic 25fps H264 stream (key frame every second) and of a 43fps AAC stream, on one core */
+ADD_BENCH(Mux) {
+	// Frames in AVCC format (NAL size + NAL), one IDR of 24KB and then P frames of 4KB
+	shared<Buffer> pKey(new Buffer(24 * 1024)), pFrame(new Buffer(4 * 1024)), pAudio(new Buffer(372));
+	for (Buffer* pBuffer : { pKey.get(), pFrame.get(), pAudio.get() })
+		memset(pBuffer->data(), 0x55, pBuffer->size());
+	BinaryWriter(pKey->data(), 5).write32(pKey->size() - 4).write8(0x65);
+	BinaryWriter(pFrame->data(), 5).write32(pFrame->size() - 4).write8(0x41);
+	Packet key(pKey), frame(pFrame), audio(pAudio);
+	UInt8 aacConfig[] = { 0x12, 0x10 };
+
+	Media::Video::Tag videoTag(Media::Video::CODEC_H264);
+	Media::Audio::Tag audioTag(Media::Audio::CODEC_AAC);
+	audioTag.rate = 44100;
+	audioTag.channels = 2;
+
+	// output is gathered in a contiguous buffer as a segmenter or a socket send buffer does
+	Buffer sink;
+	UInt64 output(0), writes(0);
+	MediaWriter::OnWrite onWrite([&sink, &output, &writes](const Packet& packet) {
+		if (sink.size() > 0x100000)
+			sink.clear();
+		sink.append(packet.data(), packet.size());
+		output += packet.size();
+		++writes;
+	});
+
+	TSWriter writer;
+	writer.beginMedia(onWrite);
+	audioTag.isConfig = true;
+	audioTag.time = 0;
+	writer.writeAudio(0, audioTag, Packet(aacConfig, sizeof(aacConfig)), onWrite);
+	audioTag.isConfig = false;
+
+	UInt64 input(0), frames(0), elapsed;
+	UInt32 videoTime(0), audioTime(0);
+	Loop(duration, elapsed, [&]() {
+		// 25 video frames and 43 audio frames by second
+		if ((audioTime * 25) <= (videoTime * 43)) {
+			audioTag.time = audioTime++ * 1000 / 43;
+			writer.writeAudio(0, audioTag, audio, onWrite);
+			input += audio.size();
+		} else {
+			videoTag.time = videoTime * 40;
+			videoTag.frame = (videoTime++ % 25) ? Media::Video::FRAME_INTER : Media::Video::FRAME_KEY;
+			const Packet& packet(videoTag.frame == Media::Video::FRAME_KEY ? key : frame);
+			writer.writeVideo(0, videoTag, packet, onWrite);
+			input += packet.size();
+		}
+		++frames;
+	});
+	writer.endMedia(onWrite);
+
+	NOTE("TSWriter mux ", String::Format<double>("%.1f", Rate(input, elapsed) / 1048576), " MB/s by core (", UInt32(Rate(frames, elapsed)), " frames/s), ",
+		String::Format<double>("%.1f", double(writes) / frames), " writes by frame, ", String::Format<double>("%.2f", double(output) / input), " TS overhead ratio");
+}
+
+}
@@ -0,0 +1,83 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Bench.h"
+#include "Mona/ThreadPool.h"
+#include "Mona/Logs.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace ThreadPoolBench {
+
+static const UInt16 THREADS(4);
+static const UInt32 BATCH(64); // runners queued before to wait their end
+static const UInt32 HEAVY(8); // 1 heavy runner (blocking 1ms) every 8 runners
+
+struct Job : Runner, virtual Object {
+	Job(bool heavy, atomic<UInt32>& count, Signal& done) : Runner(heavy ? "Heavy" : "Light"), _heavy(heavy), _count(count), _done(done) {}
+private:
+	bool run(Exception& ex) {
+		if (_heavy)
+			Thread::Sleep(1); // as a big file transfer or a blocking call
+		if (++_count == BATCH)
+			_done.set();
+		return true;
+	}
+	bool			_heavy;
+	atomic<UInt32>&	_count;
+	Signal&			_done;
+};
+
+/*!
+	Untracked runners where the heavy ones fall always on the same thread with round-robin,
+	returns runners/s and average latency in us */
+static void Run(UInt32 duration, bool stealing, double& rate, UInt64& latency) {
+	ThreadPool threadPool(THREADS);
+	threadPool.setStealing(stealing);
+	Exception ex;
+	atomic<UInt32> count;
+	Signal done;
+	UInt64 elapsed;
+	UInt64 batches = Bench::Loop(duration, elapsed, [&]() {
+		count = 0;
+		for (UInt32 i = 0; i < BATCH; ++i) {
+			if (!threadPool.queue(ex, make_shared<Job>(!(i % HEAVY), count, done)))
+				FATAL_ERROR("ThreadPool bench, ", ex);
+		}
+		done.wait();
+	});
+	threadPool.join();
+	rate = Bench::Rate(double(batches * BATCH), elapsed);
+	latency = 0;
+	for (UInt16 i = 0; i < THREADS; ++i) {
+		ThreadPool::Stats stats;
+		latency += threadPool.stats(i, stats).latency;
+	}
+	latency /= THREADS;
+}
+
+ADD_BENCH(Skewed) {
+	duration = max(duration / 2, 1u);
+	double rates[2];
+	UInt64 latencies[2];
+	Run(duration, false, rates[0], latencies[0]);
+	Run(duration, true, rates[1], latencies[1]);
+	NOTE(THREADS, " threads, 1 heavy runner every ", HEAVY, ", round-robin => work-stealing: ", String::Format<double>("%.0f", rates[0]), " => ",
+		String::Format<double>("%.0f", rates[1]), " runners/s, ", latencies[0], " => ", latencies[1], " us of average latency");
+}
+
+}
@@ -0,0 +1,59 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/Application.h"
+#include "Mona/Logs.h"
+#include "Bench.h"
+#include "Version.h"
+
+using namespace Mona;
+using namespace std;
+
+/*!
+	Micro benchmarks of the hot paths of MonaBase and MonaCore, one core, throughputs are logged */
+struct BenchApp : Application {
+private:
+	const char* defineVersion() { return STRINGIZE(MONA_VERSION); }
+
+	void defineOptions(Exception& ex, Options& options) {
+		options.add(ex, "module", "m", "Module to bench (TSWriter for example), all the modules by default.")
+			.argument("module");
+		options.add(ex, "duration", "d", "Duration of every bench in ms, default is 1000.")
+			.argument("ms");
+
+		Application::defineOptions(ex, options);
+	}
+
+///// MAIN
+	int main() {
+		string module;
+		UInt32 duration(1000);
+		argument("module", module);
+		argument("duration", duration);
+		if (!PoolBench::Instance().run(module, duration)) {
+			ERROR("Module ", module, " does not exist");
+			return EXIT_USAGE;
+		}
+		return EXIT_OK;
+	}
+};
+
+
+int main(int argc, const char* argv[]) {
+	return BenchApp().run(argc, argv);
+}
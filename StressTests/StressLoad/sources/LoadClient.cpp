@@ -0,0 +1,523 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "LoadClient.h"
+#include "Mona/BinaryReader.h"
+#include "Mona/BinaryWriter.h"
+#include "Mona/Logs.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace Mona {
+
+static const char* FindHeaderEnd(const Packet& buffer) {
+	static const char End[] = "\r\n\r\n";
+	const char* end(search(STR buffer.data(), STR buffer.data() + buffer.size(), End, End + 4));
+	return end == STR buffer.data() + buffer.size() ? NULL : end + 4;
+}
+
+
+static BinaryWriter& WriteWSFrame(BinaryWriter& writer, UInt8 type, const void* data, UInt32 size) {
+	// client frame, masked with a null key
+	writer.write8(0x80 | type);
+	if (size < 126)
+		writer.write8(0x80 | UInt8(size));
+	else if (size <= 0xFFFF)
+		writer.write8(0x80 | 126).write16(size);
+	else
+		writer.write8(0x80 | 127).write64(size);
+	return writer.write32(0).write(data, size);
+}
+
+
+LoadClient* LoadClient::NewSubscriber(const char* protocol, IOSocket& io, LoadStats& stats, const string& stream) {
+	if (String::ICompare(protocol, "rtmp") == 0)
+		return new RTMPSubscriber(io, stats, stream);
+	if (String::ICompare(protocol, "ws") == 0)
+		return new WSSubscriber(io, stats, stream);
+	if (String::ICompare(protocol, "http") == 0)
+		return new HTTPSubscriber(io, stats, stream);
+	if (String::ICompare(protocol, "echo") == 0)
+		return new WSEcho(io, stats, stream);
+	return NULL;
+}
+
+LoadClient::LoadClient(IOSocket& io, LoadStats& stats, const string& stream) : TCPClient(io), stats(stats), stream(stream),
+	_startTime(0), _ready(false), _stopping(false), _sequence(0) {
+	onError = [this](const Exception& ex) {
+		++this->stats.errors;
+		DEBUG(this->stream, " client, ", ex);
+	};
+	onDisconnection = [this](const SocketAddress& address) {
+		if (_ready) {
+			_ready = false;
+			--this->stats.subscribers;
+		}
+		if (!_stopping)
+			++this->stats.disconnections;
+	};
+	onData = [this](Packet& buffer) { return onReception(buffer); };
+}
+
+LoadClient::~LoadClient() {
+	stop();
+	onData = nullptr;
+	onDisconnection = nullptr;
+	onError = nullptr;
+}
+
+bool LoadClient::start(Exception& ex, const SocketAddress& address) {
+	String::Assign(host, address);
+	_startTime = Time::Now();
+	_stopping = false;
+	if (!connect(ex, address))
+		return false;
+	return onStart(ex);
+}
+
+void LoadClient::stop() {
+	_stopping = true;
+	disconnect();
+}
+
+bool LoadClient::send(const void* data, UInt32 size) {
+	Exception ex;
+	if (TCPClient::send(ex, Packet(data, size)))
+		return true;
+	++stats.errors;
+	DEBUG(stream, " client, ", ex);
+	return false;
+}
+
+bool LoadClient::sendUpgrade() {
+	string request;
+	String::Assign(request, "GET / HTTP/1.1\r\nHost: ", host, "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n");
+	return send(request.data(), request.size());
+}
+
+Int8 LoadClient::readUpgrade(Packet& buffer) {
+	const char* end(FindHeaderEnd(buffer));
+	if (!end)
+		return -1;
+	if (String::ICompare(STR buffer.data(), "HTTP/1.1 101", 12) != 0) {
+		++stats.errors;
+		DEBUG(stream, " WebSocket upgrade failed, ", string(STR buffer.data(), end - STR buffer.data() - 4));
+		stop();
+		return 0;
+	}
+	buffer += UInt32(end - STR buffer.data());
+	return 1;
+}
+
+void LoadClient::setReady() {
+	if (_ready)
+		return;
+	_ready = true;
+	++stats.subscribers;
+	Int64 now(Time::Now());
+	stats.connectTimes.emplace_back(UInt32(now - _startTime));
+	stats.lastReady = now;
+}
+
+void LoadClient::onFrame(const UInt8* data, UInt32 size) {
+	if (size < PAYLOAD_HEADER)
+		return; // not a frame of publisher (empty audio/video configuration packet)
+	setReady();
+	BinaryReader reader(data, size);
+	UInt64 time(reader.read64());
+	UInt32 sequence(reader.read32());
+	UInt64 now(LoadStats::Now());
+	stats.latencies.emplace_back(now > time ? UInt32(now - time) : 0);
+	if (_sequence && sequence > _sequence)
+		stats.lost += sequence - _sequence;
+	_sequence = sequence + 1;
+	++stats.frames;
+	stats.bytes += size;
+}
+
+
+LoadPublisher::LoadPublisher(IOSocket& io, LoadStats& stats, const string& stream, UInt32 frameSize, UInt32 keyInterval) : LoadClient(io, stats, stream),
+	_frameSize(frameSize < PAYLOAD_HEADER ? PAYLOAD_HEADER : frameSize), _keyInterval(keyInterval ? keyInterval : 1), _sequence(0), _startTime(0), _upgraded(false) {
+}
+
+bool LoadPublisher::onStart(Exception& ex) {
+	_startTime = LoadStats::Now();
+	return sendUpgrade();
+}
+
+UInt32 LoadPublisher::onReception(Packet& buffer) {
+	if (_upgraded)
+		return 0; // ignore server messages
+	switch (readUpgrade(buffer)) {
+		case -1:
+			return buffer.size();
+		case 0:
+			return 0;
+		default:;
+	}
+	_upgraded = true;
+	string message("[\"@publish\",\"");
+	message.append(stream).append("\"]");
+	_buffer.clear();
+	BinaryWriter writer(_buffer);
+	WriteWSFrame(writer, 1, message.data(), message.size());
+	send(_buffer);
+	return 0;
+}
+
+bool LoadPublisher::writeFrame() {
+	if (!_upgraded)
+		return true; // wait upgrade
+	_buffer.clear();
+	BinaryWriter writer(_buffer);
+	UInt64 now(LoadStats::Now());
+	// binary header message [size][time][codec|frame], Sorenson codec to stay outside of any H264 parsing
+	UInt8 header[] = { 5, 0, 0, 0, 0, UInt8((2 << 3) | ((_sequence % _keyInterval) ? 2 : 1)) };
+	BinaryWriter(header + 1, 4).write32(UInt32((now - _startTime) / 1000));
+	WriteWSFrame(writer, 2, header, sizeof(header));
+	// binary payload message
+	Buffer payload;
+	BinaryWriter(payload).write64(now).write32(++_sequence).next(_frameSize - PAYLOAD_HEADER);
+	memset(payload.data() + PAYLOAD_HEADER, 0, payload.size() - PAYLOAD_HEADER);
+	WriteWSFrame(writer, 2, payload.data(), payload.size());
+	return send(_buffer);
+}
+
+
+bool HTTPSubscriber::onStart(Exception& ex) {
+	string request;
+	String::Assign(request, "GET /", stream, ".flv HTTP/1.1\r\nHost: ", host, "\r\n\r\n");
+	return send(request.data(), request.size());
+}
+
+UInt32 HTTPSubscriber::onReception(Packet& buffer) {
+	if (_header) {
+		const char* end(FindHeaderEnd(buffer));
+		if (!end)
+			return buffer.size();
+		if (String::ICompare(STR buffer.data(), "HTTP/1.1 200", 12) != 0) {
+			++stats.errors;
+			DEBUG(stream, " HTTP subscription failed, ", string(STR buffer.data(), end - STR buffer.data() - 4));
+			stop();
+			return 0;
+		}
+		buffer += UInt32(end - STR buffer.data());
+		_header = false;
+		setReady();
+	}
+	if (_flvHeader) {
+		if (buffer.size() < 13)
+			return buffer.size();
+		buffer += 13; // FLV header + first previous tag size
+		_flvHeader = false;
+	}
+	while (buffer.size() >= 11) {
+		BinaryReader reader(buffer.data(), buffer.size());
+		UInt8 type(reader.read8());
+		UInt32 size(reader.read24());
+		if (buffer.size() < (15 + size))
+			break;
+		if (type == 9 && size)
+			onFrame(buffer.data() + 12, size - 1); // skip video codec byte
+		buffer += 15 + size;
+	}
+	return buffer.size();
+}
+
+
+bool WSSubscriber::onStart(Exception& ex) {
+	return sendUpgrade();
+}
+
+UInt32 WSSubscriber::onReception(Packet& buffer) {
+	if (!_upgraded) {
+		switch (readUpgrade(buffer)) {
+			case -1:
+				return buffer.size();
+			case 0:
+				return 0;
+			default:;
+		}
+		_upgraded = true;
+		string message("[\"@subscribe\",\"");
+		message.append(stream).append("\"]");
+		Buffer frame;
+		BinaryWriter writer(frame);
+		WriteWSFrame(writer, 1, message.data(), message.size());
+		if (!send(frame))
+			return 0;
+		setReady();
+	}
+	while (buffer.size() >= 2) {
+		BinaryReader reader(buffer.data(), buffer.size());
+		UInt8 type(reader.read8() & 0x0F);
+		UInt8 byte(reader.read8());
+		UInt64 size(byte & 0x7F);
+		if (size == 126)
+			size = reader.available() < 2 ? 0xFFFFFFFF : reader.read16();
+		else if (size == 127)
+			size = reader.available() < 8 ? 0xFFFFFFFF : reader.read64();
+		if (byte & 0x80)
+			reader.next(4); // mask, never used by server
+		if (reader.available() < size)
+			break;
+		const UInt8* data(reader.current());
+		switch (type) {
+			case 2: // binary => [size][media tag][payload]
+				if (size && size > (UInt64(*data) + 1))
+					onFrame(data + *data + 1, UInt32(size - *data - 1));
+				break;
+			case 8: // close
+				stop();
+				return 0;
+			case 9: { // ping => pong
+				Buffer pong;
+				BinaryWriter writer(pong);
+				WriteWSFrame(writer, 10, data, UInt32(size));
+				send(pong);
+				break;
+			}
+			default:; // text, JSON data
+		}
+		buffer += reader.position() + UInt32(size);
+	}
+	return buffer.size();
+}
+
+
+bool WSEcho::onStart(Exception& ex) {
+	return sendUpgrade();
+}
+
+bool WSEcho::sendEcho() {
+	string message("[\"echo\",");
+	String::Append(message, ++_sequence, ']');
+	Buffer frame;
+	BinaryWriter writer(frame);
+	WriteWSFrame(writer, 1, message.data(), message.size());
+	_time = LoadStats::Now();
+	return send(frame);
+}
+
+UInt32 WSEcho::onReception(Packet& buffer) {
+	if (!_upgraded) {
+		switch (readUpgrade(buffer)) {
+			case -1:
+				return buffer.size();
+			case 0:
+				return 0;
+			default:;
+		}
+		_upgraded = true;
+		if (!sendEcho())
+			return 0;
+		setReady();
+	}
+	while (buffer.size() >= 2) {
+		BinaryReader reader(buffer.data(), buffer.size());
+		UInt8 type(reader.read8() & 0x0F);
+		UInt64 size(reader.read8() & 0x7F); // never masked by server
+		if (size == 126)
+			size = reader.available() < 2 ? 0xFFFFFFFF : reader.read16();
+		else if (size == 127)
+			size = reader.available() < 8 ? 0xFFFFFFFF : reader.read64();
+		if (reader.available() < size)
+			break;
+		switch (type) {
+			case 1: { // JSON response
+				UInt64 now(LoadStats::Now());
+				stats.latencies.emplace_back(UInt32(now - _time));
+				++stats.frames;
+				stats.bytes += UInt32(size);
+				sendEcho();
+				break;
+			}
+			case 8: // close
+				stop();
+				return 0;
+			case 9: { // ping => pong
+				Buffer pong;
+				BinaryWriter writer(pong);
+				WriteWSFrame(writer, 10, reader.current(), UInt32(size));
+				send(pong);
+				break;
+			}
+			default:;
+		}
+		buffer += reader.position() + UInt32(size);
+	}
+	return buffer.size();
+}
+
+
+static BinaryWriter& WriteAMFString(BinaryWriter& writer, const char* value) {
+	UInt16 size(UInt16(strlen(value)));
+	return writer.write8(2).write16(size).write(value, size);
+}
+static BinaryWriter& WriteAMFProperty(BinaryWriter& writer, const char* name, const string& value) {
+	UInt16 size(UInt16(strlen(name)));
+	writer.write16(size).write(name, size);
+	return WriteAMFString(writer, value.c_str());
+}
+
+bool RTMPSubscriber::onStart(Exception& ex) {
+	// C0 + C1, random C1 without digest => simple handshake
+	Buffer handshake;
+	BinaryWriter writer(handshake);
+	writer.write8(3).write32(0).write32(0).writeRandom(1528);
+	return send(handshake);
+}
+
+bool RTMPSubscriber::sendMessage(UInt8 channel, UInt8 type, UInt32 streamId, const Buffer& body) {
+	// chunk size is set to 4096 before, message always in one chunk
+	Buffer message;
+	BinaryWriter writer(message);
+	writer.write8(channel).write24(0).write24(body.size()).write8(type);
+	writer.write8(streamId).write8(streamId >> 8).write8(streamId >> 16).write8(streamId >> 24);
+	writer.write(body.data(), body.size());
+	return send(message);
+}
+
+UInt32 RTMPSubscriber::onReception(Packet& buffer) {
+	if (_handshake) {
+		// S0 + S1 + S2
+		if (buffer.size() < 3073)
+			return buffer.size();
+		_handshake = false;
+		// C2 = S1 echo
+		if (!send(buffer.data() + 1, 1536))
+			return 0;
+		buffer += 3073;
+
+		Buffer body;
+		BinaryWriter writer(body);
+		writer.write32(4096);
+		if (!sendMessage(2, 1, 0, body))
+			return 0;
+		writer.clear();
+		WriteAMFString(writer, "connect").write8(0).writeDouble(1).write8(3);
+		WriteAMFProperty(writer, "app", String::Empty());
+		WriteAMFProperty(writer, "flashVer", "LNX 9,0,124,2");
+		string url("rtmp://");
+		WriteAMFProperty(writer, "tcUrl", url.append(host).append("/"));
+		writer.write16(0).write8(9);
+		if (!sendMessage(3, 20, 0, body))
+			return 0;
+	}
+	while (buffer) {
+		BinaryReader reader(buffer.data(), buffer.size());
+		UInt8 byte(reader.read8());
+		UInt8 format(byte >> 6);
+		UInt32 id(byte & 0x3F);
+		UInt32 headerSize((id < 2 ? (id + 1) : 0) + (format == 0 ? 11 : (format == 1 ? 7 : (format == 2 ? 3 : 0))));
+		if (reader.available() < headerSize)
+			break;
+		if (id == 0)
+			id = reader.read8() + 64;
+		else if (id == 1)
+			id = reader.read8() + (reader.read8() << 8) + 64;
+		Channel& channel(_channels[id]);
+		if (format < 3) {
+			channel.extended = reader.read24() >= 0xFFFFFF;
+			if (format < 2) {
+				channel.length = reader.read24();
+				channel.type = reader.read8();
+				if (!format) {
+					channel.streamId = reader.read8();
+					channel.streamId += reader.read8() << 8;
+					channel.streamId += reader.read8() << 16;
+					channel.streamId += reader.read8() << 24;
+				}
+			}
+		}
+		if (channel.extended && reader.next(4) < 4)
+			break;
+		UInt32 size(channel.length - channel.body.size());
+		if (size > _chunkSize)
+			size = _chunkSize;
+		if (reader.available() < size)
+			break;
+		channel.body.append(reader.current(), size);
+		buffer += reader.position() + size;
+		if (channel.body.size() < channel.length)
+			continue;
+		onMessage(channel.type, channel.body.data(), channel.body.size());
+		channel.body.clear();
+		if (!connected())
+			return 0;
+	}
+	return buffer.size();
+}
+
+void RTMPSubscriber::onMessage(UInt8 type, const UInt8* data, UInt32 size) {
+	BinaryReader reader(data, size);
+	switch (type) {
+		case 1: // chunk size
+			_chunkSize = reader.read32() & 0x7FFFFFFF;
+			break;
+		case 4: { // user control
+			if (reader.read16() != 6)
+				break;
+			// ping => pong
+			Buffer body;
+			BinaryWriter writer(body);
+			writer.write16(7).write32(reader.read32());
+			sendMessage(2, 4, 0, body);
+			break;
+		}
+		case 9: // video
+			if (size)
+				onFrame(data + 1, size - 1); // skip video codec byte
+			break;
+		case 20: { // AMF0 invocation
+			string name;
+			if (reader.read8() != 2)
+				break;
+			reader.read(reader.read16(), name);
+			double transaction(reader.read8() == 0 ? reader.readDouble() : 0);
+			if (name == "_result") {
+				Buffer body;
+				BinaryWriter writer(body);
+				if (transaction == 1) {
+					WriteAMFString(writer, "createStream").write8(0).writeDouble(2).write8(5);
+					sendMessage(3, 20, 0, body);
+				} else if (transaction == 2) {
+					if (reader.read8() != 5 || reader.read8() != 0)
+						break;
+					UInt32 streamId(UInt32(reader.readDouble()));
+					WriteAMFString(writer, "play").write8(0).writeDouble(0).write8(5);
+					WriteAMFString(writer, stream.c_str());
+					sendMessage(8, 20, streamId, body);
+				}
+			} else if (name == "onStatus") {
+				static const char Start[] = "NetStream.Play.Start";
+				if (search(data, data + size, Start, Start + sizeof(Start) - 1) != (data + size))
+					setReady();
+			} else if (name == "_error" || name == "close") {
+				++stats.errors;
+				DEBUG(stream, " RTMP subscription failed, ", name);
+				stop();
+			}
+			break;
+		}
+		default:; // audio, data, acks
+	}
+}
+
+} // namespace Mona
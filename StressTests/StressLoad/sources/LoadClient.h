@@ -0,0 +1,158 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/TCPClient.h"
+#include "LoadStats.h"
+#include <map>
+
+namespace Mona {
+
+/*!
+	Simulated client of the load session, every frame payload starts with the publisher time (8 bytes) and a sequence number (4 bytes)
+	to compute fan-out latency on subscriber side */
+struct LoadClient : TCPClient, virtual Object {
+	enum { PAYLOAD_HEADER = 12 };
+
+	virtual ~LoadClient();
+
+	const std::string	stream;
+
+	bool	start(Exception& ex, const SocketAddress& address);
+	void	stop();
+	bool	ready() const { return _ready; }
+
+	static LoadClient* NewSubscriber(const char* protocol, IOSocket& io, LoadStats& stats, const std::string& stream);
+
+protected:
+	LoadClient(IOSocket& io, LoadStats& stats, const std::string& stream);
+
+	bool	send(const void* data, UInt32 size);
+	bool	send(const Buffer& buffer) { return send(buffer.data(), buffer.size()); }
+	void	setReady();
+	/*!
+	WebSocket upgrade request and response, readUpgrade returns -1 to wait more data, 0 on failure and 1 on success */
+	bool	sendUpgrade();
+	Int8	readUpgrade(Packet& buffer);
+	void	onFrame(const UInt8* data, UInt32 size);
+
+	LoadStats&	stats;
+	std::string	host;
+
+private:
+	/*!
+	Write the first request, called just after TCP connect */
+	virtual bool	onStart(Exception& ex) = 0;
+	/*!
+	Returns the rest of data to keep for the next reception */
+	virtual UInt32	onReception(Packet& buffer) = 0;
+
+	Int64	_startTime;
+	bool	_ready;
+	bool	_stopping;
+	UInt32	_sequence;
+};
+
+/*!
+	WebSocket publication with ["@publish", stream] JSON message, every frame is sent in two binary messages: [size][tag] and [payload] */
+struct LoadPublisher : LoadClient, virtual Object {
+	LoadPublisher(IOSocket& io, LoadStats& stats, const std::string& stream, UInt32 frameSize, UInt32 keyInterval);
+
+	bool writeFrame();
+
+private:
+	bool	onStart(Exception& ex);
+	UInt32	onReception(Packet& buffer);
+
+	const UInt32	_frameSize;
+	const UInt32	_keyInterval;
+	UInt32			_sequence;
+	UInt64			_startTime;
+	bool			_upgraded;
+	Buffer			_buffer;
+};
+
+/*!
+	HTTP GET live FLV subscription */
+struct HTTPSubscriber : LoadClient, virtual Object {
+	HTTPSubscriber(IOSocket& io, LoadStats& stats, const std::string& stream) : LoadClient(io, stats, stream), _header(true), _flvHeader(true) {}
+
+private:
+	bool	onStart(Exception& ex);
+	UInt32	onReception(Packet& buffer);
+
+	bool	_header;
+	bool	_flvHeader;
+};
+
+/*!
+	WebSocket subscription with ["@subscribe", stream] JSON message, media arrives in binary frames [size][tag][payload] */
+struct WSSubscriber : LoadClient, virtual Object {
+	WSSubscriber(IOSocket& io, LoadStats& stats, const std::string& stream) : LoadClient(io, stats, stream), _upgraded(false) {}
+
+private:
+	bool	onStart(Exception& ex);
+	UInt32	onReception(Packet& buffer);
+
+	bool	_upgraded;
+};
+
+/*!
+	WebSocket invocation ["echo", sequence] of a script application returning its arguments (function client:echo(...) return ... end),
+	the next invocation is sent on response to measure script callbacks by second and their round-trip time */
+struct WSEcho : LoadClient, virtual Object {
+	WSEcho(IOSocket& io, LoadStats& stats, const std::string& stream) : LoadClient(io, stats, stream), _upgraded(false), _sequence(0), _time(0) {}
+
+private:
+	bool	onStart(Exception& ex);
+	UInt32	onReception(Packet& buffer);
+	bool	sendEcho();
+
+	bool	_upgraded;
+	UInt32	_sequence;
+	UInt64	_time;
+};
+
+/*!
+	RTMP subscription with simple handshake, AMF0 connect/createStream/play */
+struct RTMPSubscriber : LoadClient, virtual Object {
+	RTMPSubscriber(IOSocket& io, LoadStats& stats, const std::string& stream) : LoadClient(io, stats, stream), _handshake(true), _chunkSize(128) {}
+
+private:
+	struct Channel : virtual Object {
+		Channel() : length(0), type(0), streamId(0), extended(false) {}
+		Buffer	body;
+		UInt32	length;
+		UInt8	type;
+		UInt32	streamId;
+		bool	extended;
+	};
+
+	bool	onStart(Exception& ex);
+	UInt32	onReception(Packet& buffer);
+	void	onMessage(UInt8 type, const UInt8* data, UInt32 size);
+	bool	sendMessage(UInt8 channel, UInt8 type, UInt32 streamId, const Buffer& body);
+
+	bool					_handshake;
+	UInt32					_chunkSize;
+	std::map<UInt32, Channel>	_channels;
+};
+
+} // namespace Mona
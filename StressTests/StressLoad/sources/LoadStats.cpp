@@ -0,0 +1,123 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "LoadStats.h"
+#include "Mona/Time.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#if !defined(_WIN32)
+	#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace Mona {
+
+UInt64 LoadStats::Now() {
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+UInt32 LoadStats::Percentile(vector<UInt32>& values, double percent) {
+	if (values.empty())
+		return 0;
+	size_t index(size_t(values.size() * percent / 100));
+	if (index >= values.size())
+		index = values.size() - 1;
+	nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+
+LoadUsage::LoadUsage(UInt32 pid) : pid(pid), rss(0), cpu(0), _time(0), _ticks(0) {}
+
+bool LoadUsage::update() {
+#if defined(__linux__)
+	string path("/proc/");
+	if (pid)
+		String::Append(path, pid);
+	else
+		path += "self";
+
+	// RSS
+	ifstream status(path + "/status");
+	if (!status)
+		return false;
+	string line;
+	while (getline(status, line)) {
+		if (line.compare(0, 6, "VmRSS:") != 0)
+			continue;
+		rss = stoull(line.substr(6)) * 1024;
+		break;
+	}
+
+	// process CPU, utime and stime are the 14th and 15th fields, after the command name which can contain spaces
+	ifstream stat(path + "/stat");
+	if (!getline(stat, line))
+		return false;
+	size_t found(line.rfind(')'));
+	if (found == string::npos)
+		return false;
+	istringstream fields(line.substr(found + 2));
+	string field;
+	UInt64 ticks(0);
+	for (UInt8 i = 3; i <= 15 && fields >> field; ++i) {
+		if (i >= 14)
+			ticks += stoull(field);
+	}
+	Int64 now(Time::Now());
+	if (_time && now > _time)
+		cpu = (ticks - _ticks) * 100000.0 / sysconf(_SC_CLK_TCK) / (now - _time);
+	_ticks = ticks;
+	_time = now;
+
+	// cores
+	ifstream cores("/proc/stat");
+	UInt32 index(0);
+	while (getline(cores, line)) {
+		if (line.compare(0, 3, "cpu") != 0)
+			break;
+		if (!isdigit(line[3]))
+			continue; // global line
+		istringstream values(line);
+		values >> field; // cpuN
+		UInt64 total(0), idle(0), value;
+		for (UInt8 i = 0; values >> value; ++i) {
+			total += value;
+			if (i == 3 || i == 4) // idle + iowait
+				idle += value;
+		}
+		UInt64 busy(total - idle);
+		if (index >= _total.size()) {
+			_total.emplace_back(0);
+			_busy.emplace_back(0);
+			this->cores.emplace_back(0);
+		}
+		if (_total[index] && total > _total[index])
+			this->cores[index] = (busy - _busy[index]) * 100.0 / (total - _total[index]);
+		_total[index] = total;
+		_busy[index++] = busy;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // namespace Mona
@@ -0,0 +1,75 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/String.h"
+#include <vector>
+
+namespace Mona {
+
+/*!
+	Counters of the load session, updated only by the main thread (handler flush) */
+struct LoadStats : virtual Object {
+	LoadStats() : subscribers(0), publishers(0), errors(0), disconnections(0), frames(0), lost(0), bytes(0), lastReady(0) {}
+
+	UInt32	subscribers; // subscribers ready to receive media
+	UInt32	publishers; // publishers sending media
+	UInt32	errors;
+	UInt32	disconnections; // unexpected disconnections
+	UInt64	frames; // frames received by all the subscribers
+	UInt64	lost; // frames lost (sequence gap)
+	UInt64	bytes;
+
+	Int64	lastReady;
+
+	std::vector<UInt32>	connectTimes; // ms from TCP connect to subscription
+	std::vector<UInt32>	latencies; // us from publisher write to subscriber reception
+
+	/*!
+	Monotonic clock in microseconds, shared by publishers and subscribers of the same process */
+	static UInt64 Now();
+	/*!
+	Sort values and return the percentile wanted, 0 if empty */
+	static UInt32 Percentile(std::vector<UInt32>& values, double percent);
+};
+
+/*!
+	Sample of RSS and CPU usage of a process and of each core, read from /proc (Linux only) */
+struct LoadUsage : virtual Object {
+	LoadUsage(UInt32 pid = 0);
+
+	const UInt32 pid;
+
+	/*!
+	Take a sample, returns false if unavailable on this platform or if process doesn't exist anymore */
+	bool	update();
+
+	UInt64				rss; // bytes
+	double				cpu; // % of one core used by the process since the previous sample
+	std::vector<double>	cores; // % of each core busy since the previous sample
+
+private:
+	Int64				_time;
+	UInt64				_ticks;
+	std::vector<UInt64>	_busy;
+	std::vector<UInt64>	_total;
+};
+
+} // namespace Mona
@@ -0,0 +1,238 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/Application.h"
+#include "Mona/Timer.h"
+#include "Mona/Logs.h"
+#include "LoadClient.h"
+#include "Version.h"
+
+using namespace Mona;
+using namespace std;
+
+/*!
+	Load generator: M publishers (WebSocket) and N subscribers (RTMP, WS or HTTP live FLV) against a local server,
+	reports connections/sec, fan-out latency percentiles, RSS and CPU usage.
+	With echo protocol N WebSocket clients invoke in loop the echo function of a script application instead,
+	to report script callbacks/sec and round-trip latency percentiles (see www/main.lua for the script application) */
+struct LoadApp : Application {
+	LoadApp() : _handler(_signal), _io(_handler, _threadPool), _lastReport(0), _lastFrames(0), _echo(false) {}
+
+private:
+	const char* defineVersion() { return STRINGIZE(MONA_VERSION); }
+
+	void defineOptions(Exception& ex, Options& options) {
+		options.add(ex, "address", "a", "Server address to load, host:port, default is localhost with default port of the protocol.")
+			.argument("address");
+		options.add(ex, "publishAddress", "pa", "WebSocket address where publishing, host:port, default is the server address with port 80 for rtmp.")
+			.argument("address");
+		options.add(ex, "protocol", "p", "Subscriber protocol: rtmp, ws, http (live FLV) or echo (script callbacks), default is rtmp.")
+			.argument("protocol");
+		options.add(ex, "subscribers", "s", "Number of subscribers, default is 100.")
+			.argument("number");
+		options.add(ex, "publishers", "pu", "Number of publishers (WebSocket), subscribers are spread over them, default is 1.")
+			.argument("number");
+		options.add(ex, "rate", "r", "Subscribers to connect by second, 0 connects all of them in one time (default).")
+			.argument("number");
+		options.add(ex, "duration", "t", "Duration of the test in seconds, default is 30.")
+			.argument("seconds");
+		options.add(ex, "fps", "f", "Frames by second of every publisher, default is 25.")
+			.argument("number");
+		options.add(ex, "frameSize", "fs", "Size of frame in bytes, default is 1024.")
+			.argument("bytes");
+		options.add(ex, "stream", "n", "Base name of streams published, default is \"load\".")
+			.argument("name");
+		options.add(ex, "pid", "pid", "Server process id to report its RSS and CPU usage (Linux only).")
+			.argument("pid");
+
+		Application::defineOptions(ex, options);
+	}
+
+	static bool SetAddress(Exception& ex, SocketAddress& address, const string& value, UInt16 defaultPort) {
+		if (value.find(':') == string::npos)
+			return address.setWithDNS(ex, value, defaultPort);
+		return address.setWithDNS(ex, value);
+	}
+
+	void report(Int64 elapsed) {
+		UInt32 interval(UInt32(elapsed - _lastReport));
+		_lastReport = elapsed;
+		_selfUsage.update();
+		String line(elapsed / 1000, "s, ", _stats.subscribers, '/', _subscribers.size(), " subscribers, ", _stats.publishers, " publishers, ",
+			(_stats.frames - _lastFrames) * 1000 / (interval ? interval : 1), _echo ? " callbacks/s, " : " frames/s, ", _stats.lost, " lost, ", _stats.errors, " errors, self ",
+			_selfUsage.rss / 1048576, "MB ", UInt32(_selfUsage.cpu), "% CPU");
+		_lastFrames = _stats.frames;
+		if (_pServerUsage && _pServerUsage->update())
+			String::Append(line, ", server ", _pServerUsage->rss / 1048576, "MB ", UInt32(_pServerUsage->cpu), "% CPU");
+		NOTE(line);
+	}
+
+	void summary(Int64 elapsed, UInt32 subscribers, Int64 rampTime, LoadUsage& selfUsage, LoadUsage* pServerUsage) {
+		NOTE("SUMMARY");
+		rampTime = _stats.lastReady > rampTime ? (_stats.lastReady - rampTime) : 0;
+		NOTE("Connections: ", _stats.connectTimes.size(), '/', subscribers, " in ", rampTime, "ms (",
+			_stats.connectTimes.size() * 1000 / (rampTime ? rampTime : 1), "/s), connect time p50=", LoadStats::Percentile(_stats.connectTimes, 50),
+			"ms p90=", LoadStats::Percentile(_stats.connectTimes, 90), "ms p99=", LoadStats::Percentile(_stats.connectTimes, 99), "ms");
+		NOTE(_echo ? "Round-trip latency: p50=" : "Fan-out latency: p50=", LoadStats::Percentile(_stats.latencies, 50), "us p90=", LoadStats::Percentile(_stats.latencies, 90),
+			"us p99=", LoadStats::Percentile(_stats.latencies, 99), "us max=", LoadStats::Percentile(_stats.latencies, 100), "us");
+		NOTE(_echo ? "Callbacks: " : "Frames: ", _stats.frames, " received (", _stats.bytes * 8 / (elapsed ? elapsed : 1), "kbps), ", _stats.lost, " lost, ",
+			_stats.errors, " errors, ", _stats.disconnections, " unexpected disconnections");
+		LoadUsage* pUsages[] = { &selfUsage, pServerUsage };
+		for (LoadUsage* pUsage : pUsages) {
+			if (!pUsage || !pUsage->update())
+				continue;
+			NOTE(pUsage->pid ? "Server" : "Load generator", " usage: RSS ", pUsage->rss / 1048576, "MB, CPU ", UInt32(pUsage->cpu), "%");
+		}
+		if (selfUsage.cores.empty())
+			return;
+		String line("CPU by core:");
+		for (UInt32 i = 0; i < selfUsage.cores.size(); ++i)
+			String::Append(line, " #", i, '=', UInt32(selfUsage.cores[i]), '%');
+		NOTE(line);
+	}
+
+///// MAIN
+	int main() {
+		string protocol("rtmp"), stream("load"), value;
+		UInt32 subscribers(100), publishers(1), rate(0), duration(30), fps(25), frameSize(1024), pid(0);
+		argument("protocol", protocol);
+		argument("stream", stream);
+		argument("subscribers", subscribers);
+		argument("publishers", publishers);
+		argument("rate", rate);
+		argument("duration", duration);
+		argument("fps", fps);
+		argument("frameSize", frameSize);
+		// periodic usages and whole test usages
+		unique_ptr<LoadUsage> pServerUsage;
+		if (argument("pid", pid) && pid) {
+			_pServerUsage.reset(new LoadUsage(pid));
+			pServerUsage.reset(new LoadUsage(pid));
+			pServerUsage->update();
+		}
+		LoadUsage selfUsage;
+		selfUsage.update();
+		if (!publishers)
+			publishers = 1;
+		if (!fps)
+			fps = 1;
+
+		_echo = protocol == "echo";
+		if (!_echo && protocol != "rtmp" && protocol != "ws" && protocol != "http") {
+			ERROR("Unknown protocol ", protocol);
+			return EXIT_USAGE;
+		}
+		Exception ex;
+		SocketAddress address, publishAddress;
+		if (!argument("address", value))
+			value.assign("localhost");
+		if (!SetAddress(ex, address, value, protocol == "rtmp" ? 1935 : 80)) {
+			ERROR("Invalid address ", value, ", ", ex);
+			return EXIT_USAGE;
+		}
+		if (!argument("publishAddress", value))
+			publishAddress.set(address.host(), protocol == "rtmp" ? 80 : address.port());
+		else if (!SetAddress(ex, publishAddress, value, 80)) {
+			ERROR("Invalid publication address ", value, ", ", ex);
+			return EXIT_USAGE;
+		}
+		NOTE(_echo ? 0 : publishers, " publishers on ", publishAddress, ", ", subscribers, ' ', protocol, " subscribers on ", address, " during ", duration, "s");
+
+		// Publishers
+		for (UInt32 i = 0; !_echo && i < publishers; ++i) {
+			_publishers.emplace_back(new LoadPublisher(_io, _stats, String(stream, i), frameSize, fps));
+			if (_publishers.back()->start(ex, publishAddress))
+				++_stats.publishers;
+			else
+				ERROR("Publisher ", _publishers.back()->stream, ", ", ex);
+		}
+		Timer::OnTimer onFrame([this, fps](UInt32 count) {
+			for (auto& pPublisher : _publishers) {
+				if (pPublisher->connected() || pPublisher->connecting())
+					pPublisher->writeFrame();
+			}
+			return 1000 / fps;
+		});
+		_timer.set(onFrame, 1000 / fps);
+
+		// Subscribers, after a delay to let publications begin
+		_subscribers.reserve(subscribers);
+		Int64 start(Time::Now()), rampTime(0);
+		Timer::OnTimer onRamp([&](UInt32 count) {
+			if (!rampTime)
+				rampTime = Time::Now();
+			UInt32 target(rate ? UInt32((Time::Now() - start - 500) * rate / 1000 + 1) : subscribers);
+			Exception ex;
+			while (_subscribers.size() < target && _subscribers.size() < subscribers) {
+				_subscribers.emplace_back(LoadClient::NewSubscriber(protocol.c_str(), _io, _stats, String(stream, _subscribers.size() % publishers)));
+				if (!_subscribers.back()->start(ex, address))
+					DEBUG("Subscriber ", _subscribers.size(), ", ", ex);
+			}
+			return _subscribers.size() < subscribers ? 10 : 0;
+		});
+		_timer.set(onRamp, 500);
+
+		bool running(true);
+		Timer::OnTimer onReport([&](UInt32 count) {
+			Int64 elapsed(Time::Now() - start);
+			report(elapsed);
+			if (elapsed < (duration * 1000))
+				return 1000;
+			running = false;
+			return 0;
+		});
+		_timer.set(onReport, 1000);
+
+		while (running) {
+			if (_signal.wait(_timer.raise()))
+				_handler.flush();
+		}
+		Int64 elapsed(Time::Now() - start);
+		subscribers = _subscribers.size();
+
+		_timer.set(onFrame, 0);
+		_timer.set(onRamp, 0);
+		_subscribers.clear();
+		_publishers.clear();
+		_threadPool.join();
+		_handler.flush();
+
+		summary(elapsed, subscribers, rampTime, selfUsage, pServerUsage.get());
+		return EXIT_OK;
+	}
+
+	Signal								_signal;
+	Handler								_handler;
+	ThreadPool							_threadPool;
+	IOSocket							_io;
+	Timer								_timer;
+
+	LoadStats							_stats;
+	LoadUsage							_selfUsage;
+	unique_ptr<LoadUsage>				_pServerUsage;
+	Int64								_lastReport;
+	UInt64								_lastFrames;
+	bool								_echo;
+	vector<unique_ptr<LoadPublisher>>	_publishers;
+	vector<unique_ptr<LoadClient>>		_subscribers;
+};
+
+
+int main(int argc, const char* argv[]) {
+	return LoadApp().run(argc, argv);
+}
@@ -0,0 +1,12 @@
+-- Echo application of StressLoad -p=echo, copy it in the www folder of MonaServer (root application):
+--   ./MonaServer
+--   ./StressLoad -p=echo -a=localhost:80 -s=100 -t=30 -pid=<MonaServer pid>
+-- Then compare callbacks/s and round-trip percentiles with LuaJIT compiler disabled, MonaServer.ini:
+--   [script]
+--   jit=false
+
+function onConnection(client)
+	function client:echo(...)
+		return ...
+	end
+end
@@ -0,0 +1,90 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/Deflater.h"
+#include "Mona/Util.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace DeflaterTest {
+
+static string& Inflate(const Buffer& buffer, Deflater::Format format, string& result) {
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	CHECK(inflateInit2(&stream, format) == Z_OK);
+	stream.next_in = (Bytef*)buffer.data();
+	stream.avail_in = buffer.size();
+	char data[1024];
+	int status;
+	do {
+		stream.next_out = (Bytef*)data;
+		stream.avail_out = sizeof(data);
+		status = inflate(&stream, Z_NO_FLUSH);
+		CHECK(status == Z_OK || status == Z_STREAM_END);
+		result.append(data, sizeof(data) - stream.avail_out);
+	} while (status != Z_STREAM_END);
+	CHECK(!stream.avail_in); // no data after end of stream
+	inflateEnd(&stream);
+	return result;
+}
+
+static string Json(UInt32 count) {
+	string json("[");
+	for (UInt32 i = 0; i < count; ++i)
+		String::Append(json, i ? "," : "", "{\"name\":\"stream", i, "\",\"subscribers\":", Util::Random<UInt16>() % 100, ",\"live\":true}");
+	return json += ']';
+}
+
+ADD_TEST(Formats) {
+	string json(Json(500)), result;
+	Exception ex;
+	Deflater::Format formats[] = { Deflater::FORMAT_GZIP, Deflater::FORMAT_ZLIB, Deflater::FORMAT_RAW };
+	for (Deflater::Format format : formats) {
+		Deflater deflater(format);
+		Buffer buffer(2, "ab"); // append to existing content
+		CHECK(deflater.deflate(ex, json.data(), json.size(), buffer) && !ex);
+		CHECK(buffer.size() > 2 && buffer.size() < json.size() / 3 && memcmp(buffer.data(), "ab", 2) == 0);
+		CHECK(Inflate(Buffer(buffer.size() - 2, buffer.data() + 2), format, result.assign("")) == json);
+	}
+}
+
+ADD_TEST(Streaming) {
+	string json(Json(1000)), result;
+	Exception ex;
+	Deflater deflater;
+	Buffer buffer;
+	// several streams with the same deflater, each one written in several parts
+	for (UInt8 i = 0; i < 3; ++i) {
+		buffer.clear();
+		UInt32 offset(0);
+		while (offset < json.size()) {
+			UInt32 size = Util::Random<UInt16>() % 2000;
+			if (size > (json.size() - offset))
+				size = json.size() - offset;
+			CHECK(deflater.deflate(ex, json.data() + offset, size, buffer, false) && !ex);
+			offset += size;
+		}
+		CHECK(deflater.deflate(ex, NULL, 0, buffer) && !ex);
+		CHECK(Inflate(buffer, deflater.format, result.assign("")) == json);
+	}
+	// empty stream
+	CHECK(deflater.deflate(ex, NULL, 0, buffer.clear()) && !ex && buffer.size());
+	CHECK(Inflate(buffer, deflater.format, result.assign("")).empty());
+}
+
+}
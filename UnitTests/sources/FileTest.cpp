@@ -56,6 +56,51 @@ ADD_TEST(File) {
 	}
 }
 
+ADD_TEST(WritingOptions) {
+	Exception ex;
+	const char* name("options.mona");
+	alignas(File::DIRECT_ALIGNMENT) static UInt8 Data[3 * File::DIRECT_ALIGNMENT];
+	for (UInt32 i = 0; i < sizeof(Data); ++i)
+		Data[i] = UInt8(i);
+
+	{
+		// preallocation doesn't change the logical size
+		File file(name, File::MODE_WRITE);
+		file.preallocation = 0x100000;
+		CHECK(file.write(ex, Data, 100) && !ex);
+		CHECK(file.size(true) == 100);
+		CHECK(file.write(ex, Data + 100, 200) && !ex);
+		CHECK(file.sync(ex) && !ex);
+		CHECK(file.size(true) == 300);
+	}
+	CHECK(FileSystem::GetSize(ex, name) == 300 && !ex);
+
+	{
+		// direct writing, the unaligned tail is written through the system cache
+		File file(name, File::MODE_WRITE);
+		file.direct = true;
+		file.preallocation = 0x100000;
+		CHECK(file.write(ex, Data, 2 * File::DIRECT_ALIGNMENT) && !ex);
+		CHECK(file.write(ex, Data + 2 * File::DIRECT_ALIGNMENT, 100) && !ex);
+		CHECK(file.sync(ex) && !ex);
+	}
+	{
+		File file(name, File::MODE_READ);
+		UInt8 data[sizeof(Data)];
+		CHECK(file.read(ex, data, sizeof(data)) == (2 * File::DIRECT_ALIGNMENT + 100) && !ex);
+		CHECK(memcmp(data, Data, 2 * File::DIRECT_ALIGNMENT + 100) == 0);
+	}
+
+	{
+		// preallocation resumes from the end in append mode
+		File file(name, File::MODE_APPEND);
+		file.preallocation = 0x100000;
+		CHECK(file.write(ex, EXPAND("Salut")) && !ex);
+	}
+	CHECK(FileSystem::GetSize(ex, name) == (2 * File::DIRECT_ALIGNMENT + 105) && !ex);
+	CHECK(FileSystem::Delete(ex, name) && !ex);
+}
+
 static struct MainHandler : Handler {
 	MainHandler() : Handler(_signal) {}
 	bool join(UInt32 count) {
@@ -73,7 +118,7 @@ private:
 } _Handler;
 static ThreadPool	_ThreadPool;
 
-ADD_TEST(FileReader) {
+static void Read() {
 	IOFile		io(_Handler, _ThreadPool);
 
 	const char* name("temp.mona");
@@ -100,7 +145,7 @@ ADD_TEST(FileReader) {
 	CHECK(_Handler.join(3));
 }
 
-ADD_TEST(FileWriter) {
+static void Write() {
 	IOFile		io(_Handler, _ThreadPool);
 	const char* name("temp.mona");
 	Exception ex;
@@ -127,4 +172,17 @@ ADD_TEST(FileWriter) {
 	CHECK(FileSystem::Delete(ex, name) && !ex);
 }
 
+ADD_TEST(FileReader) { Read(); }
+ADD_TEST(FileWriter) { Write(); }
+
+ADD_TEST(URing) {
+	// io_uring engine, or thread engine if unavailable
+	Exception ex;
+	CHECK(File("temp.mona", File::MODE_WRITE).write(ex, EXPAND("Salut")) && !ex);
+	IOFile::SetURing(true);
+	Read();
+	Write();
+	IOFile::SetURing(false);
+}
+
 }
@@ -0,0 +1,219 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/HLSSegmenter.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace HLSSegmenterTest {
+
+/*!
+	Synthetic H264 (AVCC) and AAC frames */
+struct Source : virtual Object {
+	Source(HLSSegmenter& segmenter) : _segmenter(segmenter), _video(Media::Video::CODEC_H264), _audio(Media::Audio::CODEC_AAC) {
+		shared<Buffer> pKey(new Buffer(1000)), pFrame(new Buffer(300)), pAudio(new Buffer(100));
+		for (Buffer* pBuffer : { pKey.get(), pFrame.get(), pAudio.get() })
+			memset(pBuffer->data(), 0x55, pBuffer->size());
+		BinaryWriter(pKey->data(), 5).write32(pKey->size() - 4).write8(0x65);
+		BinaryWriter(pFrame->data(), 5).write32(pFrame->size() - 4).write8(0x41);
+		_key.set(pKey);
+		_frame.set(pFrame);
+		_audioFrame.set(pAudio);
+		_audio.rate = 44100;
+		_audio.channels = 2;
+		segmenter.beginMedia("test", Parameters::Null());
+	}
+	~Source() { _segmenter.endMedia("test"); }
+
+	void video(UInt32 time, bool key) {
+		_video.time = time;
+		_video.frame = key ? Media::Video::FRAME_KEY : Media::Video::FRAME_INTER;
+		_segmenter.writeVideo(0, _video, key ? _key : _frame, true);
+		_segmenter.flush();
+	}
+	void audio(UInt32 time) {
+		_audio.time = time;
+		_segmenter.writeAudio(0, _audio, _audioFrame, true);
+		_segmenter.flush();
+	}
+	/*!
+	25fps video with a key frame every 'keyInterval' frames, from 'from' frame to 'to' frame excluded */
+	void videos(UInt32 from, UInt32 to, UInt32 keyInterval = 25) {
+		for (UInt32 i = from; i < to; ++i)
+			video(i * 40, (i % keyInterval) == 0);
+	}
+
+private:
+	HLSSegmenter&		_segmenter;
+	Media::Video::Tag	_video;
+	Media::Audio::Tag	_audio;
+	Packet				_key;
+	Packet				_frame;
+	Packet				_audioFrame;
+};
+
+static string Playlist(HLSSegmenter& segmenter) {
+	const Packet& playlist(segmenter.playlist());
+	return string(STR playlist.data(), playlist.size());
+}
+
+ADD_TEST(KeyFrameCut) {
+	HLSSegmenter segmenter("live", 6, 1000, 0);
+	Source source(segmenter);
+
+	// no segment before the first key frame
+	source.videos(1, 10);
+	CHECK(segmenter.segments().empty());
+	source.video(400, true);
+	CHECK(segmenter.segments().size() == 1 && !segmenter.segments().back().complete);
+
+	// key frames every 1s from 400ms, a cut by key frame
+	for (UInt32 i = 11; i < 70; ++i)
+		source.video(i * 40, ((i - 10) % 25) == 0);
+	CHECK(segmenter.segments().size() == 3);
+	UInt32 sequence(0);
+	for (const HLSSegmenter::Segment& segment : segmenter.segments()) {
+		CHECK(segment.sequence == sequence && segment.time == (400 + sequence * 1000) && !segment.discontinuity);
+		if (++sequence == 3)
+			break; // current segment, no part before the next cut
+		CHECK(segment.complete && segment.duration == 1000 && segment.size() == 1);
+		// every segment begins with a key frame and PAT+PMT
+		CHECK(segment.front().independent && segment.front().size() > (376 + 1000 + 24 * 300) && (segment.front().size() % 188) == 0);
+		CHECK(segment.front().data()[0] == 0x47 && (BinaryReader(segment.front().data() + 1, 2).read16() & 0x1FFF) == 0);
+	}
+	CHECK(!segmenter.segments().back().complete && segmenter.segments().back().empty());
+
+	// a key frame in the middle of a segment doesn't cut
+	source.video(70 * 40, true);
+	CHECK(segmenter.segments().size() == 3 && !segmenter.segments().back().complete);
+}
+
+ADD_TEST(AudioOnly) {
+	HLSSegmenter segmenter("live", 6, 1000, 0);
+	Source source(segmenter);
+	// AAC frames of 1024 samples at 44100Hz, cut on the first frame after the target duration
+	for (UInt32 i = 0; i < 140; ++i)
+		source.audio(i * 1024 * 1000 / 44100);
+	CHECK(segmenter.segments().size() == 4);
+	for (const HLSSegmenter::Segment& segment : segmenter.segments()) {
+		if (segment.complete)
+			CHECK(segment.front().independent && segment.duration >= 1000 && segment.duration < 1024);
+	}
+	CHECK(segmenter.segments()[1].time == 1021 && segmenter.targetDuration() == 2);
+}
+
+ADD_TEST(Bounded) {
+	HLSSegmenter segmenter("live", 3, 1000, 0);
+	Source source(segmenter);
+	source.videos(0, 10 * 25 + 1);
+	// 3 complete segments + the current one
+	CHECK(segmenter.segments().size() == 4);
+	CHECK(segmenter.segments().front().sequence == 7 && segmenter.segments().back().sequence == 10);
+	CHECK(!segmenter.segment(6) && segmenter.segment(7) && segmenter.segment(10) && !segmenter.segment(11));
+	CHECK(segmenter.available(6) < 0 && segmenter.available(7) > 0 && segmenter.available(10) == 0 && segmenter.available(12) == 0 && segmenter.available(13) < 0);
+}
+
+ADD_TEST(PlaylistText) {
+	HLSSegmenter segmenter("live", 2, 1000, 0);
+	Source source(segmenter);
+	CHECK(Playlist(segmenter) == "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:1\n#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES\n#EXT-X-MEDIA-SEQUENCE:0\n");
+	source.videos(0, 3 * 25 + 1);
+	CHECK(Playlist(segmenter) == "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:1\n#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES\n#EXT-X-MEDIA-SEQUENCE:1\n"
+		"#EXTINF:1.000,\nlive.1.ts\n#EXTINF:1.000,\nlive.2.ts\n");
+	// built one time by change
+	CHECK(segmenter.playlist().data() == segmenter.playlist().data());
+}
+
+ADD_TEST(PlaylistParts) {
+	HLSSegmenter segmenter("live", 6, 1000, 500);
+	Source source(segmenter);
+	source.videos(0, 25 + 13);
+	// parts cut a little before 500ms to never exceed it, and on segment cut
+	CHECK(segmenter.segments().size() == 2 && segmenter.segments()[0].size() == 3 && segmenter.segments()[1].size() == 1);
+	CHECK(segmenter.segments()[0][0].independent && !segmenter.segments()[0][1].independent && segmenter.segments()[1][0].independent);
+	CHECK(segmenter.available(1, 0) > 0 && segmenter.available(1, 1) == 0 && segmenter.available(1) == 0);
+	CHECK(Playlist(segmenter) == "#EXTM3U\n#EXT-X-VERSION:6\n#EXT-X-TARGETDURATION:1\n#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=1.500\n"
+		"#EXT-X-PART-INF:PART-TARGET=0.500\n#EXT-X-MEDIA-SEQUENCE:0\n"
+		"#EXT-X-PART:DURATION=0.480,URI=\"live.0.0.ts\",INDEPENDENT=YES\n#EXT-X-PART:DURATION=0.480,URI=\"live.0.1.ts\"\n"
+		"#EXT-X-PART:DURATION=0.040,URI=\"live.0.2.ts\"\n#EXTINF:1.000,\nlive.0.ts\n"
+		"#EXT-X-PART:DURATION=0.480,URI=\"live.1.0.ts\",INDEPENDENT=YES\n"
+		"#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"live.1.1.ts\"\n");
+}
+
+ADD_TEST(TargetDuration) {
+	HLSSegmenter segmenter("live", 6, 2000, 0);
+	CHECK(segmenter.targetDuration() == 2);
+	Source source(segmenter);
+	// key frame every 51 frames => segments of 2040ms
+	source.videos(0, 2 * 51 + 1, 51);
+	CHECK(segmenter.segments().front().duration == 2040 && segmenter.targetDuration() == 3);
+	CHECK(Playlist(segmenter).find("#EXT-X-TARGETDURATION:3\n") != string::npos);
+
+	HLSSegmenter small("live", 6, 500, 0);
+	CHECK(small.targetDuration() == 1);
+}
+
+ADD_TEST(Discontinuity) {
+	HLSSegmenter segmenter("live", 6, 1000, 0);
+	{
+		Source source(segmenter);
+		source.videos(0, 30);
+	}
+	// last segment closed by endMedia
+	CHECK(segmenter.segments().size() == 2 && segmenter.segments().back().complete && segmenter.segments().back().duration == 160);
+	Source source(segmenter);
+	source.videos(0, 1);
+	CHECK(segmenter.segments().size() == 3 && segmenter.segments().back().discontinuity && segmenter.segments().back().sequence == 2);
+	CHECK(Playlist(segmenter).find("#EXT-X-DISCONTINUITY\n") != string::npos);
+}
+
+ADD_TEST(Waiters) {
+	HLSSegmenter* pSegmenter(new HLSSegmenter("live", 6, 1000, 0));
+	Source* pSource(new Source(*pSegmenter));
+	pSource->videos(0, 1);
+
+	HLSSegmenter::Waiter waiter;
+	HLSSegmenter* pReady(NULL);
+	UInt32 readies(0);
+	waiter.onReady = [&](HLSSegmenter* pFrom) { pReady = pFrom; ++readies; };
+
+	// segment 0 completes => waiter released
+	waiter.sequence = 0;
+	pSegmenter->wait(waiter);
+	CHECK(waiter.pSegmenter == pSegmenter && !waiter.expired());
+	pSource->videos(1, 25);
+	CHECK(!readies);
+	pSource->videos(25, 26);
+	CHECK(readies == 1 && pReady == pSegmenter && !waiter.pSegmenter);
+
+	// waiting since 3 target durations => expired, still unavailable => 503
+	waiter.sequence = 1;
+	pSegmenter->wait(waiter);
+	waiter.time.update(Time::Now() - 3001);
+	CHECK(waiter.expired() && pSegmenter->available(waiter.sequence) == 0);
+	pSegmenter->unwait(waiter);
+	CHECK(!waiter.pSegmenter && !waiter.expired());
+
+	// segmenter deleted => released with a null segmenter
+	pSegmenter->wait(waiter);
+	delete pSource;
+	delete pSegmenter;
+	CHECK(readies == 2 && !pReady && !waiter.pSegmenter);
+}
+
+}
@@ -0,0 +1,155 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/HTTP/HTTPDecoder.h"
+#include "Mona/ServerAPI.h"
+#include "Mona/Protocols.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace HTTPDecoderTest {
+
+struct TestAPI : ServerAPI {
+	TestAPI(const Handler& handler, const Protocols& protocols, const Timer& timer) : ServerAPI(Path::Home(), Path::Home(), handler, protocols, timer, 1) {}
+	bool running() { return true; }
+};
+
+/*!
+	Decodes receptions as a HTTPSession would do, requests are dispatched to the main thread on every reception */
+struct Decoding : virtual Object {
+	Decoding() : _handler(_signal), _protocols(_parameters), _api(_handler, _protocols, _timer), _pSocket(new Socket(Socket::TYPE_STREAM)), _pDecoder(new HTTPDecoder(_api)) {
+		_pDecoder->onRequest = [this](HTTP::Request& request) {
+			if (request.ex)
+				errors.emplace_back(request.ex);
+			else if (request) {
+				headers.emplace_back(request);
+				bodies.emplace_back(STR request.data(), request.size());
+			}
+		};
+	}
+	~Decoding() { _pDecoder->onRequest = nullptr; }
+
+	Decoding& operator()(const string& data) {
+		shared<Buffer> pBuffer(new Buffer(data.size(), data.data()));
+		((Socket::Decoder&)*_pDecoder).decode(pBuffer, SocketAddress::Wildcard(), _pSocket);
+		_handler.flush();
+		return *this;
+	}
+
+	vector<shared<const HTTP::Header>>	headers;
+	vector<string>						bodies;
+	vector<Exception>					errors;
+private:
+	Signal					_signal;
+	Handler					_handler;
+	Parameters				_parameters;
+	Protocols				_protocols;
+	Timer					_timer;
+	TestAPI					_api;
+	shared<Socket>			_pSocket;
+	shared<HTTPDecoder>		_pDecoder;
+};
+
+ADD_TEST(RequestLine) {
+	Decoding decoding;
+	decoding("GET /app/sub/file.html?name=mona&n=1 HTTP/1.1\r\nHost: localhost:8080\r\n\r\n");
+	CHECK(decoding.headers.size() == 1 && decoding.errors.empty());
+	const HTTP::Header& header(*decoding.headers[0]);
+	CHECK(header.type == HTTP::TYPE_GET && header.path == "/app/sub" && header.query == "name=mona&n=1");
+	CHECK(header.version == 1.1f && String::ICompare(header.getString("version"), "1.1") == 0);
+	CHECK(header.mime == MIME::TYPE_TEXT);
+
+	decoding("POST  /rpc  HTTP/1.0\r\nContent-Length: 2\r\n\r\n{}");
+	CHECK(decoding.headers.size() == 2 && decoding.headers[1]->type == HTTP::TYPE_POST && decoding.headers[1]->path.empty() && decoding.headers[1]->version == 1.0f);
+	CHECK(decoding.bodies[1] == "{}");
+
+	decoding("BREW /pot HTTP/1.1\r\n\r\n");
+	CHECK(decoding.errors.size() == 1);
+}
+
+ADD_TEST(Fields) {
+	Decoding decoding;
+	decoding("GET /app HTTP/1.1\r\nHost: localhost:8080\r\nX-Spaces: \t value with spaces \t \r\nX-Empty:\r\nX-Blank:   \r\ninvalid line\r\n"
+		"Content-Type:application/json; charset=utf-8\r\nConnection: keep-alive, Upgrade\r\nCookie: user=mona; theme = dark\r\n\r\n");
+	CHECK(decoding.headers.size() == 1);
+	const HTTP::Header& header(*decoding.headers[0]);
+	CHECK(String::ICompare(header.getString("x-spaces"), "value with spaces") == 0);
+	CHECK(header.getString("X-Empty") && !*header.getString("X-Empty") && header.getString("X-Blank") && !*header.getString("X-Blank"));
+	CHECK(!header.hasKey("invalid line") && !header.hasKey("invalid"));
+	CHECK(header.mime == MIME::TYPE_APPLICATION && String::ICompare(header.subMime, EXPAND("json")) == 0);
+	CHECK((header.connection & HTTP::CONNECTION_KEEPALIVE) && (header.connection & HTTP::CONNECTION_UPGRADE));
+	CHECK(String::ICompare(header.getString("user"), "mona") == 0 && String::ICompare(header.getString("theme"), "dark") == 0);
+
+	// copy to properties: version + fields + cookies
+	Parameters properties;
+	header.copyTo(properties);
+	CHECK(String::ICompare(properties.getString("version"), "1.1") == 0);
+	CHECK(String::ICompare(properties.getString("host"), "localhost:8080") == 0);
+	CHECK(String::ICompare(properties.getString("x-spaces"), "value with spaces") == 0);
+	CHECK(properties.hasKey("x-empty") && properties.hasKey("x-blank") && !properties.hasKey("invalid line"));
+	CHECK(String::ICompare(properties.getString("content-type"), "application/json; charset=utf-8") == 0);
+	CHECK(String::ICompare(properties.getString("cookie"), "user=mona; theme = dark") == 0);
+	CHECK(String::ICompare(properties.getString("theme"), "dark") == 0);
+	CHECK(properties.count() == 10);
+}
+
+ADD_TEST(Pipelining) {
+	Decoding decoding;
+	decoding("GET /first/ HTTP/1.1\r\nHost: a\r\n\r\nPOST /second/ HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello\r\n"
+		"GET /third/ HTTP/1.1\r\n\r\n");
+	CHECK(decoding.headers.size() == 3 && decoding.errors.empty());
+	CHECK(decoding.headers[0]->path == "/first" && decoding.headers[1]->path == "/second" && decoding.headers[2]->path == "/third");
+	CHECK(decoding.bodies[0].empty() && decoding.bodies[1] == "hello" && decoding.bodies[2].empty());
+	CHECK(String::ICompare(decoding.headers[0]->getString("host"), "a") == 0 && !decoding.headers[2]->hasKey("host"));
+}
+
+ADD_TEST(Split) {
+	// every possible cut of a header, the end "\r\n\r\n" included
+	static const string Request("GET /app/ HTTP/1.1\r\nHost: localhost\r\nAccept: */*\r\n\r\n");
+	for (UInt32 i = 1; i < Request.size(); ++i) {
+		Decoding decoding;
+		decoding(Request.substr(0, i));
+		CHECK(decoding.headers.empty());
+		decoding(Request.substr(i));
+		CHECK(decoding.headers.size() == 1 && decoding.headers[0]->path == "/app" && String::ICompare(decoding.headers[0]->getString("accept"), "*/*") == 0);
+	}
+	// byte by byte, with the body
+	Decoding decoding;
+	string request("POST /app HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody");
+	for (char c : request)
+		decoding(string(1, c));
+	CHECK(decoding.headers.size() == 1 && decoding.bodies[0] == "body" && decoding.errors.empty());
+}
+
+ADD_TEST(TooLarge) {
+	// 8KB of header without its end => error
+	Decoding decoding;
+	string field("X-Big: ");
+	field.append(0x1000, 'x').append("\r\n");
+	decoding("GET /app HTTP/1.1\r\n")(field);
+	CHECK(decoding.headers.empty() && decoding.errors.empty()); // wait the end
+	decoding(field);
+	CHECK(decoding.headers.empty() && decoding.errors.size() == 1);
+
+	// a big header received in one time is accepted if complete
+	Decoding big;
+	big(String("GET /app HTTP/1.1\r\n", field, field, "\r\n"));
+	CHECK(big.headers.size() == 1 && big.errors.empty() && strlen(big.headers[0]->getString("X-Big")) == 0x1000);
+}
+
+}
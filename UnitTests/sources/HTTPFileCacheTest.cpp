@@ -0,0 +1,172 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+
+#include "Test.h"
+#include "Mona/HTTP/HTTPFileCache.h"
+#include "Mona/File.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace HTTPFileCacheTest {
+
+static void Write(const char* name, const string& content) {
+	Exception ex;
+	CHECK(File(name, File::MODE_WRITE).write(ex, content.data(), content.size()) && !ex);
+}
+
+static void Delete(const char* name) {
+	Exception ex;
+	FileSystem::Delete(ex, name);
+}
+
+static bool Body(const HTTPFileCache::Entry::Variant& variant, const string& content) {
+	return variant.body.size() == content.size() && memcmp(variant.body.data(), content.data(), content.size()) == 0;
+}
+
+ADD_TEST(ETag) {
+	string etag;
+	CHECK(HTTPFileCache::ETag(etag, 1500000000000, 12) == "\"1500000000000-12\"");
+	CHECK(HTTPFileCache::ETag(etag, 1500000000000, 12, HTTPFileCache::ENCODING_GZIP) == "\"1500000000000-12-gzip\"");
+	CHECK(HTTPFileCache::ETag(etag, 1500000000000, 12, HTTPFileCache::ENCODING_BR) == "\"1500000000000-12-br\"");
+}
+
+ADD_TEST(Match) {
+	string etag("\"1000-12\"");
+	CHECK(HTTPFileCache::Match("\"1000-12\"", etag));
+	CHECK(!HTTPFileCache::Match("\"1000-13\"", etag));
+	CHECK(!HTTPFileCache::Match("\"1000-1\"", etag));
+	CHECK(!HTTPFileCache::Match("", etag));
+	// lists
+	CHECK(HTTPFileCache::Match("\"a\", \"1000-12\"", etag));
+	CHECK(HTTPFileCache::Match("\"a\",\"b\" ,  \"1000-12\" ", etag));
+	CHECK(!HTTPFileCache::Match("\"a\", \"b\"", etag));
+	// weak comparison (RFC 7232 2.3.2)
+	CHECK(HTTPFileCache::Match("W/\"1000-12\"", etag));
+	CHECK(HTTPFileCache::Match("\"a\", W/\"1000-12\"", etag));
+	CHECK(!HTTPFileCache::Match("W/\"1000-13\"", etag));
+	// any
+	CHECK(HTTPFileCache::Match("*", etag));
+	CHECK(HTTPFileCache::Match("\"a\", *", etag));
+}
+
+ADD_TEST(Variants) {
+	static const string Html("<html><body>Mona</body></html>"), Gzip("gzip content"), Br("br");
+	Write("cache.html", Html);
+	Write("cache.html.gz", Gzip);
+	Write("cache.html.br", Br);
+
+	HTTPFileCache cache;
+	shared<const HTTPFileCache::Entry> pEntry(cache.get(Path("cache.html")));
+	CHECK(pEntry && cache.count() == 1 && cache.size() == pEntry->size);
+	CHECK(pEntry->mime == MIME::TYPE_TEXT && String::ICompare(pEntry->subMime, EXPAND("html")) == 0);
+	CHECK(Body(pEntry->variant(NULL), Html) && Body(pEntry->variant("identity"), Html) && Body(pEntry->variant("deflate"), Html));
+	CHECK(Body(pEntry->variant("gzip"), Gzip) && Body(pEntry->variant("deflate, gzip"), Gzip) && Body(pEntry->variant("br;q=0, gzip"), Gzip));
+	CHECK(Body(pEntry->variant("gzip, deflate, br"), Br) && Body(pEntry->variant("BR"), Br));
+	CHECK(Body(pEntry->variant("gzip;q=0, br;q=0"), Html));
+	// every variant has its own ETag, and a Vary field
+	const HTTPFileCache::Entry::Variant& identity(pEntry->variant(NULL)), &gzip(pEntry->variant("gzip")), &br(pEntry->variant("br"));
+	CHECK(identity.etag != gzip.etag && gzip.etag != br.etag && br.etag != identity.etag);
+	string header(STR identity.header.data(), identity.header.size());
+	CHECK(header.find(identity.etag) != string::npos && header.find("Vary: Accept-Encoding") != string::npos && header.find("Content-Encoding") == string::npos);
+	header.assign(STR gzip.header.data(), gzip.header.size());
+	CHECK(header.find(gzip.etag) != string::npos && header.find("Content-Encoding: gzip") != string::npos);
+
+	// removed precompressed variant
+	Delete("cache.html.br");
+	Write("cache.html", Html + " "); // other size => reloaded
+	Write("cache.html.gz", Gzip); // not older than the file
+	pEntry = cache.get(Path("cache.html"));
+	CHECK(pEntry && Body(pEntry->variant("br"), Html + " ") && Body(pEntry->variant("gzip"), Gzip));
+
+	Delete("cache.html");
+	Delete("cache.html.gz");
+	CHECK(!cache.get(Path("cache.html")) && !cache.count() && !cache.size());
+}
+
+ADD_TEST(NotModified) {
+	Write("cache.txt", "content");
+	HTTPFileCache cache;
+	shared<const HTTPFileCache::Entry> pEntry(cache.get(Path("cache.txt")));
+	CHECK(pEntry && pEntry->lastModified == Path("cache.txt").lastModified());
+	const HTTPFileCache::Entry::Variant& variant(pEntry->variant(NULL));
+	// If-None-Match
+	CHECK(pEntry->notModified(variant, variant.etag.c_str(), 0));
+	CHECK(pEntry->notModified(variant, String("\"x\", W/", variant.etag).c_str(), 0));
+	CHECK(pEntry->notModified(variant, "*", 0));
+	CHECK(!pEntry->notModified(variant, "\"x\"", 0));
+	// If-Modified-Since
+	CHECK(pEntry->notModified(variant, NULL, pEntry->lastModified) && pEntry->notModified(variant, NULL, pEntry->lastModified + 1000));
+	CHECK(!pEntry->notModified(variant, NULL, pEntry->lastModified - 1000) && !pEntry->notModified(variant, NULL, 0));
+	// If-None-Match has priority
+	CHECK(!pEntry->notModified(variant, "\"x\"", pEntry->lastModified));
+	Delete("cache.txt");
+}
+
+ADD_TEST(Reload) {
+	Write("cache.txt", "first");
+	HTTPFileCache cache;
+	shared<const HTTPFileCache::Entry> pEntry(cache.get(Path("cache.txt")));
+	CHECK(pEntry && Body(pEntry->variant(NULL), "first"));
+	CHECK(cache.get(Path("cache.txt")) == pEntry); // hit
+	Write("cache.txt", "second");
+	shared<const HTTPFileCache::Entry> pReloaded(cache.get(Path("cache.txt")));
+	CHECK(pReloaded && pReloaded != pEntry && Body(pReloaded->variant(NULL), "second") && pReloaded->variant(NULL).etag != pEntry->variant(NULL).etag);
+	CHECK(Body(pEntry->variant(NULL), "first")); // previous entry is immutable
+	CHECK(cache.count() == 1 && cache.size() == pReloaded->size);
+	Delete("cache.txt");
+	CHECK(!cache.get(Path("cache.txt")) && !cache.count());
+}
+
+ADD_TEST(Eviction) {
+	Write("cache1.txt", "1111");
+	Write("cache2.txt", "2222");
+	Write("cache3.txt", "3333");
+	HTTPFileCache cache;
+	shared<const HTTPFileCache::Entry> p1(cache.get(Path("cache1.txt")));
+	CHECK(p1);
+	// capacity for 2 files
+	cache.setCapacity(p1->size * 2);
+	shared<const HTTPFileCache::Entry> p2(cache.get(Path("cache2.txt")));
+	CHECK(p2 && cache.count() == 2 && cache.size() == p1->size * 2);
+	CHECK(cache.get(Path("cache1.txt")) == p1); // 1 becomes the most recently used
+	shared<const HTTPFileCache::Entry> p3(cache.get(Path("cache3.txt")));
+	CHECK(p3 && cache.count() == 2 && cache.size() == p1->size * 2);
+	// 2 has been evicted
+	CHECK(cache.get(Path("cache1.txt")) == p1 && cache.get(Path("cache3.txt")) == p3);
+	CHECK(cache.get(Path("cache2.txt")) != p2 && cache.count() == 2);
+	// lower capacity
+	cache.setCapacity(p1->size);
+	CHECK(cache.count() == 1 && cache.size() == p1->size);
+	// file bigger than capacity is not kept
+	cache.setCapacity(p1->size - 1);
+	CHECK(!cache.count() && !cache.size());
+	CHECK(cache.get(Path("cache1.txt")) && !cache.count());
+	// disabled cache, unfound file, folder and file too large
+	cache.setCapacity(0);
+	CHECK(!cache.get(Path("cache1.txt")));
+	cache.setCapacity(0x1000000);
+	CHECK(cache.get(Path("cache1.txt")) && !cache.get(Path("cache4.txt")) && !cache.get(Path(Path::CurrentDir())));
+	Write("cache4.txt", string(HTTPFileCache::MAX_FILE_SIZE + 1, 'x'));
+	CHECK(!cache.get(Path("cache4.txt")) && cache.count() == 1);
+	cache.clear();
+	CHECK(!cache.count() && !cache.size());
+	for (const char* name : { "cache1.txt", "cache2.txt", "cache3.txt", "cache4.txt" })
+		Delete(name);
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Test.h"
+#include "Mona/HashMap.h"
+#include "Mona/Util.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace HashMapTest {
+
+// bad hash to force long probe sequences and wrap around
+struct CollideHash { size_t operator()(UInt32 value) const { return value % 7; } };
+
+template<typename HashType>
+static void Check(UInt32 count) {
+	HashMap<UInt32, UInt32, HashType> hashMap;
+	map<UInt32, UInt32> reference;
+	for (UInt32 i = 0; i < count * 4; ++i) {
+		UInt32 key(Util::Random<UInt32>() % count);
+		if (Util::Random<UInt8>() % 3) {
+			bool inserted(hashMap.emplace(key, i).second);
+			CHECK(inserted == reference.emplace(key, i).second);
+		} else
+			CHECK(hashMap.erase(key) == reference.erase(key));
+		CHECK(hashMap.size() == reference.size());
+	}
+	for (const auto& it : reference) {
+		const auto& itFound = hashMap.find(it.first);
+		CHECK(itFound != hashMap.end() && itFound->second == it.second);
+	}
+	UInt32 size(0);
+	for (const auto& it : hashMap) {
+		CHECK(reference.count(it.first) == 1);
+		++size;
+	}
+	CHECK(size == reference.size());
+	hashMap.clear();
+	CHECK(hashMap.empty() && hashMap.begin() == hashMap.end() && hashMap.find(0) == hashMap.end());
+}
+
+ADD_TEST(Random) {
+	Check<std::hash<UInt32>>(10000);
+}
+
+ADD_TEST(Collisions) {
+	Check<CollideHash>(200);
+}
+
+ADD_TEST(EraseIterator) {
+	HashMap<string, unique<string>> hashMap;
+	CHECK(hashMap.emplace("one", new string("1")).second && hashMap.emplace("two", new string("2")).second);
+	CHECK(!hashMap.emplace("one", new string("bad")).second && *hashMap.find("one")->second == "1");
+	hashMap.erase(hashMap.find("one"));
+	CHECK(hashMap.size() == 1 && hashMap.find("one") == hashMap.end() && *hashMap.find("two")->second == "2");
+}
+
+}
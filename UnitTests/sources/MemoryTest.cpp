@@ -0,0 +1,123 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/Memory.h"
+#include "Mona/UDPSocket.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace MemoryTest {
+
+ADD_TEST(Buffers) {
+	UInt64 buffered(Memory::Buffered());
+	{
+		Buffer buffer(100);
+		CHECK(Memory::Buffered() == buffered + buffer.capacity());
+		buffer.resize(1000);
+		CHECK(Memory::Buffered() == buffered + buffer.capacity());
+		buffer.clip(10);
+		CHECK(Memory::Buffered() == buffered + buffer.capacity() + 10);
+		Buffer empty;
+		CHECK(Memory::Buffered() == buffered + buffer.capacity() + 10);
+	}
+	CHECK(Memory::Buffered() == buffered);
+}
+
+ADD_TEST(Watermarks) {
+	UInt64 buffered(Memory::Buffered());
+	CHECK(Memory::GetPressure() == Memory::PRESSURE_NONE);
+	Memory::SetWatermarks(buffered + 1000, buffered + 2000);
+	CHECK(Memory::GetPressure() == Memory::PRESSURE_NONE);
+	{
+		Buffer buffer(1000);
+		CHECK(Memory::GetPressure() == Memory::PRESSURE_LOW);
+		buffer.resize(2000);
+		CHECK(Memory::GetPressure() == Memory::PRESSURE_HIGH);
+	}
+	CHECK(Memory::GetPressure() == Memory::PRESSURE_NONE);
+	Memory::SetWatermarks(0, 0); // unlimited
+	Buffer buffer(0xFFFF);
+	CHECK(Memory::GetPressure() == Memory::PRESSURE_NONE);
+}
+
+ADD_TEST(Queueing) {
+	Exception ex;
+	Socket server(Socket::TYPE_STREAM);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && server.listen(ex) && !ex);
+	UInt64 queueing(Memory::Queueing());
+	shared<Memory::Account> pAccount(make_shared<Memory::Account>("Test"));
+	{
+		Socket client(Socket::TYPE_STREAM);
+		client.setAccount(pAccount);
+		CHECK(client.connect(ex, server.address()) && client.setNonBlockingMode(ex, true) && !ex);
+		// the server never reads, write until to fill system buffers
+		string data(0xFFFF, 'a');
+		while (!client.queueing())
+			CHECK(client.write(ex, Packet(data.data(), data.size())) >= 0 && !ex);
+		CHECK(pAccount->queueing() == client.queueing() && Memory::Queueing() == queueing + client.queueing());
+		// moving to an other account
+		shared<Memory::Account> pOther(make_shared<Memory::Account>("Other"));
+		client.setAccount(pOther);
+		CHECK(!pAccount->queueing() && pOther->queueing() == client.queueing());
+		client.setAccount(pAccount);
+	}
+	CHECK(!pAccount->queueing() && Memory::Queueing() == queueing);
+}
+
+ADD_TEST(PauseReception) {
+	Signal signal;
+	Handler handler(signal);
+	ThreadPool threadPool;
+	IOSocket io(handler, threadPool);
+	Exception ex;
+
+	UInt32 received(0);
+	UDPSocket receiver(io);
+	receiver.onError = [](const Exception& ex) { FATAL_ERROR("PauseReception, ", ex); };
+	receiver.onPacket = [&received](shared<Buffer>& pBuffer, const SocketAddress& address) { ++received; };
+	CHECK(receiver.bind(ex, IPAddress::Loopback()) && !ex);
+	SocketAddress target(IPAddress::Loopback(), receiver->address().port());
+	Socket sender(Socket::TYPE_DATAGRAM);
+
+	function<void(UInt32)> wait([&](UInt32 count) {
+		while (received < count) {
+			CHECK(signal.wait(14000));
+			handler.flush();
+		}
+	});
+	CHECK(sender.sendTo(ex, EXPAND("hi"), target) == 2 && !ex);
+	wait(1);
+	Thread::Sleep(20); // let finish the reception loop, pause is checked before each read
+
+	// paused, data wait in the system buffer
+	io.pause(receiver.socket());
+	for (UInt8 i = 0; i < 3; ++i)
+		CHECK(sender.sendTo(ex, EXPAND("hi"), target) == 2 && !ex);
+	Thread::Sleep(100);
+	handler.flush();
+	CHECK(received == 1);
+
+	io.resume(receiver.socket());
+	wait(4);
+
+	receiver.close();
+	threadPool.join();
+	handler.flush();
+}
+
+}
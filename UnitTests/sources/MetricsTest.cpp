@@ -0,0 +1,116 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/Metrics.h"
+#include <thread>
+
+using namespace Mona;
+using namespace std;
+
+namespace MetricsTest {
+
+ADD_TEST(Counter) {
+	Metrics::Counter counter("test_counter_total", "Test counter");
+	vector<thread> threads;
+	for (UInt8 i = 0; i < 8; ++i) {
+		threads.emplace_back([&counter]() {
+			for (UInt32 j = 0; j < 10000; ++j)
+				++counter;
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	counter += 5;
+	CHECK(counter.value() == 80005);
+
+	Metrics::Gauge gauge("test_gauge", "Test gauge");
+	gauge += 10;
+	--gauge;
+	CHECK(gauge.value() == 9);
+	UInt32 value(7);
+	Metrics::Gauge computed("test_computed", "Test computed gauge", "", [&value]() { return Int64(value); });
+	CHECK(computed.value() == 7);
+}
+
+ADD_TEST(Buckets) {
+	// power of 2 are upper bounds of buckets
+	for (UInt8 power = 0; power < 64; ++power) {
+		UInt64 value(UInt64(1) << power);
+		UInt16 index(Metrics::Histogram::Index(value));
+		CHECK(Metrics::Histogram::UpperBound(index) == value);
+		CHECK(Metrics::Histogram::Index(value + 1) == index + 1);
+	}
+	CHECK(Metrics::Histogram::Index(0) == 0);
+	CHECK(Metrics::Histogram::Index(0xFFFFFFFFFFFFFFFF) == Metrics::Histogram::BUCKETS - 1);
+	// buckets are contiguous and with a precision of 25%
+	for (UInt64 value = 1; value < 100000; ++value) {
+		UInt16 index(Metrics::Histogram::Index(value));
+		CHECK(Metrics::Histogram::UpperBound(index) >= value && Metrics::Histogram::UpperBound(index - 1) < value);
+		CHECK(Metrics::Histogram::UpperBound(index) <= value + value / 4 + 1);
+	}
+}
+
+ADD_TEST(Histogram) {
+	Metrics::Histogram histogram("test_histogram", "Test histogram");
+	vector<thread> threads;
+	for (UInt8 i = 0; i < 4; ++i) {
+		threads.emplace_back([&histogram]() {
+			for (UInt32 value = 1; value <= 1000; ++value)
+				histogram.record(value);
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	CHECK(histogram.count() == 4000);
+	CHECK(histogram.sum() == 4 * 500500);
+	UInt64 median(histogram.quantile(0.5));
+	CHECK(median >= 500 && median <= 625);
+	UInt64 max(histogram.quantile(1));
+	CHECK(max >= 1000 && max <= 1250);
+
+	Metrics::Histogram single("test_single", "Test histogram not sharded", "", false);
+	CHECK(single.quantile(0.99) == 0);
+	single.record(3);
+	CHECK(single.count() == 1 && single.quantile(0.99) == 3);
+}
+
+ADD_TEST(Exposition) {
+	Metrics::Counter first("test_exposition_total", "Test exposition", Metrics::Label("name", "a\"b"));
+	Metrics::Counter second("test_exposition_total", "Test exposition", Metrics::Label("name", "c"));
+	Metrics::Histogram histogram("test_exposition_microseconds", "Test exposition histogram");
+	first += 3;
+	histogram.record(3);
+	histogram.record(100);
+
+	string output;
+	Metrics::Write(output);
+	// HELP and TYPE written once by name
+	size_t help(output.find("# HELP test_exposition_total Test exposition\n# TYPE test_exposition_total counter\n"));
+	CHECK(help != string::npos && output.find("# HELP test_exposition_total", help + 1) == string::npos);
+	CHECK(output.find("\ntest_exposition_total{name=\"a\\\"b\"} 3\n") != string::npos);
+	CHECK(output.find("\ntest_exposition_total{name=\"c\"} 0\n") != string::npos);
+	// cumulative buckets
+	CHECK(output.find("# TYPE test_exposition_microseconds histogram\n") != string::npos);
+	CHECK(output.find("\ntest_exposition_microseconds_bucket{le=\"2\"} 0\n") != string::npos);
+	CHECK(output.find("\ntest_exposition_microseconds_bucket{le=\"4\"} 1\n") != string::npos);
+	CHECK(output.find("\ntest_exposition_microseconds_bucket{le=\"128\"} 2\n") != string::npos);
+	CHECK(output.find("\ntest_exposition_microseconds_bucket{le=\"+Inf\"} 2\n") != string::npos);
+	CHECK(output.find("\ntest_exposition_microseconds_sum 103\n") != string::npos);
+	CHECK(output.find("\ntest_exposition_microseconds_count 2\n") != string::npos);
+}
+
+}
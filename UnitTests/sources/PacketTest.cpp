@@ -19,6 +19,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Test.h"
 #include "Mona/Packet.h"
 #include "Mona/String.h"
+#include "Mona/Recycler.h"
 #include <deque>
 
 using namespace Mona;
@@ -107,4 +108,23 @@ ADD_TEST(Bufferize) {
 	CHECK(!packet.buffer());
 }
 
+ADD_TEST(BufferizeSizes) {
+	string data(2000, 'a');
+	for (UInt32 size : { 1, 64, 65, 256, 257, 896, 897, 2000 }) {
+		Packet unbuffered(data.data(), size);
+		Packet packet(move(unbuffered)); // bufferize
+		CHECK(packet.buffer() && packet.buffer()->size() == size && packet.data() != (const UInt8*)data.data());
+		CHECK(packet.buffer()->data() == packet.data() && memcmp(packet.data(), data.data(), size) == 0);
+		Packet copy(packet, packet.data() + 1, size - 1);
+		CHECK(&copy.buffer() == &packet.buffer());
+	}
+	// warm, small bufferizations recycle their block
+	UInt64 allocations(Recycling::Allocations());
+	for (UInt32 i = 0; i < 100; ++i) {
+		Packet unbuffered(data.data(), 100);
+		Packet packet(move(unbuffered));
+	}
+	CHECK(Recycling::Allocations() == allocations);
+}
+
 }
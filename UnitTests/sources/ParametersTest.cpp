@@ -18,6 +18,7 @@ details (or else see http://www.gnu.org/licenses/).
 
 #include "Test.h"
 #include "Mona/Parameters.h"
+#include <thread>
 
 using namespace std;
 using namespace Mona;
@@ -81,4 +82,95 @@ ADD_TEST(MapParameters) {
 	CHECK(params.count() == 0);
 }
 
+ADD_TEST(Keys) {
+	Parameters params;
+	// case insensitive, first key case kept
+	params.setString("Content-Type", "text/html");
+	params.setString("content-type", "text/plain");
+	params.setString("HOST", "localhost");
+	params.setString("Accept", "*/*");
+	params.setString("x-custom.a", "1");
+	params.setString("X-Custom.B", "2");
+	CHECK(params.count() == 5);
+	CHECK(strcmp(params.getString("CONTENT-TYPE"), "text/plain") == 0);
+	CHECK(params.begin()->first == "Accept");
+	const char* keys[] = { "Accept", "Content-Type", "HOST", "x-custom.a", "X-Custom.B" };
+	UInt8 i(0);
+	for (auto& it : params)
+		CHECK(it.first == keys[i++]);
+	i = 0;
+	for (auto& it : params.band("X-CUSTOM."))
+		CHECK(it.first == keys[3 + i++]);
+	CHECK(i == 2);
+	CHECK(params.from("host").begin()->first == "HOST");
+
+	// references to values stay valid after insertions
+	const string& host(params.setString("Host", "mona"));
+	for (UInt8 i = 0; i < 100; ++i)
+		params.setNumber(String("key", i), i);
+	CHECK(host == "mona" && params.count() == 105);
+	CHECK(params.erase("KEY50") && params.count() == 104 && !params.hasKey("key50"));
+}
+
+ADD_TEST(NumberCache) {
+	Parameters params;
+	UInt8 byte;
+	Int32 integer;
+	UInt32 unsignedInteger;
+	double number;
+	// same results than String::ToNumber for every type, from one parsing
+	params.setString(_Key, "300");
+	CHECK(!params.getNumber(_Key, byte));
+	CHECK(params.getNumber(_Key, integer) && integer == 300);
+	params.setString(_Key, "-1.5");
+	CHECK(!params.getNumber(_Key, unsignedInteger));
+	CHECK(params.getNumber(_Key, integer) && integer == -1);
+	CHECK(params.getNumber(_Key, number) && number == -1.5);
+	params.setString(_Key, "-0");
+	CHECK(!params.getNumber(_Key, unsignedInteger) && params.getNumber(_Key, integer) && integer == 0);
+	params.setString(_Key, "abc");
+	CHECK(!params.getNumber(_Key, number) && params.getBoolean<false>(_Key));
+	// cache invalidated on change
+	params.setString(_Key, "42");
+	CHECK(params.getNumber(_Key, byte) && byte == 42);
+	params.setBoolean(_Key, false);
+	CHECK(!params.getNumber(_Key, byte) && !params.getBoolean<true>(_Key));
+
+	// integers are exact beyond the double precision
+	UInt64 big;
+	Int64 signedBig;
+	params.setString(_Key, "18446744073709551615");
+	CHECK(params.getNumber(_Key, big) && big == 18446744073709551615ull);
+	CHECK(!params.getNumber(_Key, signedBig));
+	params.setString(_Key, "9007199254740993"); // 2^53 + 1
+	CHECK(params.getNumber(_Key, big) && big == 9007199254740993ull);
+	CHECK(params.getNumber(_Key, signedBig) && signedBig == 9007199254740993ll);
+	params.setString(_Key, "-9223372036854775807");
+	CHECK(params.getNumber(_Key, signedBig) && signedBig == -9223372036854775807ll && !params.getNumber(_Key, big));
+	params.setString(_Key, "18446744073709551616"); // UInt64 max + 1
+	CHECK(!params.getNumber(_Key, big) && params.getNumber(_Key, number) && number == 18446744073709551616.0);
+}
+
+ADD_TEST(NumberCacheThreads) {
+	// const readers from several threads parse and publish the same value
+	Parameters params;
+	for (UInt32 i = 0; i < 100; ++i)
+		params.setString(String(i), String(9007199254740993ull + i));
+	const Parameters& reader(params);
+	atomic<UInt32> errors(0);
+	vector<thread> threads;
+	for (UInt8 t = 0; t < 4; ++t) {
+		threads.emplace_back([&reader, &errors]() {
+			UInt64 value;
+			for (UInt32 i = 0; i < 100; ++i) {
+				if (!reader.getNumber(String(i), value) || value != 9007199254740993ull + i)
+					++errors;
+			}
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	CHECK(!errors);
+}
+
 }
@@ -19,6 +19,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Test.h"
 #include "Mona/PersistentData.h"
 #include "Mona/FileSystem.h"
+#include "Mona/Crypto.h"
 
 using namespace std;
 using namespace Mona;
@@ -27,7 +28,9 @@ namespace PersistentDataTest {
 
 static PersistentData	_Data;
 static string			_Path;
+static UInt32			_Count;
 static PersistentData::ForEach	_ForEach([](const string& path, const UInt8* value, UInt32 size) {
+	++_Count;
 	CHECK((strlen(path.c_str()) == 0 && size == 5 && memcmp("salut", value, size) == 0) ||
 		(path.compare("/Test") == 0 && size == 8 && memcmp("aur\0voir", value, size) == 0) ||
 		(path.compare("/Sub") == 0 && size == 3 && memcmp("val", value, size) == 0));
@@ -52,15 +55,15 @@ ADD_TEST(Add) {
 
 	_Data.flush();
 	CHECK(FileSystem::Exists(_Path));
-	CHECK(FileSystem::Exists(_Path+"Test/"));
-	CHECK(FileSystem::Exists(_Path+"Sub/"));
+	CHECK(!FileSystem::Exists(_Path+"Test/"));
 }
 
 ADD_TEST(Reload) {
 	// create base of test
 	Exception ex;
+	_Count = 0;
 	_Data.load(ex,_Path,_ForEach);
-	CHECK(!ex);
+	CHECK(!ex && _Count == 3);
 }
 
 ADD_TEST(Remove) {
@@ -80,4 +83,66 @@ ADD_TEST(Remove) {
 	CHECK(!FileSystem::Exists(_Path));;
 }
 
+ADD_TEST(Import) {
+	// old format, one file named by its MD5 by entry
+	Exception ex;
+	CHECK(FileSystem::CreateDirectory(ex, _Path + "Test/", FileSystem::MODE_HEAVY) && !ex);
+	CHECK(File(_Path + "Test/8b2b8e7e9e0e6d8d8c62b2e0d0b44fba", File::MODE_WRITE).write(ex, EXPAND("aur\0voir")) && !ex); // bad MD5, deleted
+	UInt8 md5[16];
+	Crypto::Hash::MD5(EXPAND("aur\0voir"), md5);
+	CHECK(File(String(_Path, "Test/", String::Hex(md5, sizeof(md5))), File::MODE_WRITE).write(ex, EXPAND("aur\0voir")) && !ex);
+	Crypto::Hash::MD5(EXPAND("salut"), md5);
+	CHECK(File(String(_Path, String::Hex(md5, sizeof(md5))), File::MODE_WRITE).write(ex, EXPAND("salut")) && !ex);
+	_Count = 0;
+	_Data.load(ex, _Path, _ForEach);
+	CHECK(!ex && _Count == 2 && !FileSystem::Exists(_Path + "Test/"));
+	_Count = 0;
+	_Data.load(ex, _Path, _ForEach);
+	CHECK(!ex && _Count == 2);
+
+	CHECK(_Data.remove(ex, "Test") && _Data.remove(ex, "") && !ex);
+	_Data.flush();
+	CHECK(!FileSystem::Exists(_Path));
+}
+
+static UInt64 SegmentsSize(string& last) {
+	UInt64 size(0);
+	Exception ex;
+	FileSystem::ListFiles(ex, _Path, [&](const string& file, UInt16 level) {
+		size += FileSystem::GetSize(ex, file);
+		if (last.size() < file.size() || (last.size() == file.size() && last < file))
+			last = file; // segments are numbered
+	});
+	return size;
+}
+
+ADD_TEST(Compaction) {
+	Exception ex;
+	_Data.load(ex, _Path, _ForEach);
+	CHECK(!ex);
+	// overwrite 4MB of values, obsolete records are compacted
+	string value(0x1000, 'v');
+	for (UInt32 i = 0; i < 0x400; ++i)
+		CHECK(_Data.add(ex, String("Value", i % 8), Packet(value.data(), value.size())) && !ex);
+	CHECK(_Data.add(ex, "Sub", Packet(EXPAND("val"))) && !ex);
+	_Data.flush();
+	string last;
+	CHECK(SegmentsSize(last) < (0x100000 + 9 * 0x1100));
+
+	// torn record at the end is ignored
+	CHECK(File(last, File::MODE_APPEND).write(ex, EXPAND("\0\0\0\0\0\0\1")) && !ex);
+	UInt32 count(0);
+	_Data.load(ex, _Path, [&count](const string& path, const UInt8* value, UInt32 size) {
+		++count;
+		CHECK(path == "/Sub" ? (size == 3 && memcmp(value, EXPAND("val")) == 0) : size == 0x1000);
+	});
+	CHECK(!ex && count == 9);
+
+	for (UInt32 i = 0; i < 8; ++i)
+		CHECK(_Data.remove(ex, String("Value", i)) && !ex);
+	CHECK(_Data.remove(ex, "Sub") && !ex);
+	_Data.flush();
+	CHECK(!FileSystem::Exists(_Path));
+}
+
 }
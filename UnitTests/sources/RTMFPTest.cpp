@@ -0,0 +1,146 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/RTMFP/RTMFPCongestion.h"
+#include "Mona/Thread.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace RTMFPTest {
+
+static Packet SACK(Buffer& buffer, const vector<UInt64>& values) {
+	BinaryWriter writer(buffer);
+	for (UInt64 value : values)
+		writer.write7BitLongValue(value);
+	return Packet(buffer.data(), buffer.size());
+}
+
+ADD_TEST(SACK) {
+	Buffer buffer;
+	// cumulative ack only
+	RTMFP::Ack ack(SACK(buffer, { 10 }), 123);
+	CHECK(ack.time == 123 && ack.stage == 10 && ack.stageMax == 10 && ack.holes.empty());
+
+	// 11-13 lost, 14-15 received, 16 lost, 17-20 received
+	buffer.clear();
+	RTMFP::Ack sack(SACK(buffer, { 10, 2, 1, 0, 3 }), 0);
+	CHECK(sack.stage == 10 && sack.stageMax == 20 && sack.holes.size() == 2);
+	CHECK(sack.holes[0].first == 11 && sack.holes[0].second == 13);
+	CHECK(sack.holes[1].first == 16 && sack.holes[1].second == 16);
+
+	// trailing lost range without received range after is not a hole
+	buffer.clear();
+	RTMFP::Ack trailing(SACK(buffer, { 10, 2, 1, 4 }), 0);
+	CHECK(trailing.stageMax == 15 && trailing.holes.size() == 1);
+	CHECK(trailing.holes[0].first == 11 && trailing.holes[0].second == 13);
+}
+
+ADD_TEST(RTO) {
+	double srtt(0), rttvar(0);
+	// first sample => srtt=rtt, rttvar=rtt/2
+	CHECK(RTMFP::RTO(srtt, rttvar, 200) == 600 && srtt == 200 && rttvar == 100);
+	// stable samples converge to srtt, bounded by RTO_MIN
+	for (UInt8 i = 0; i < 50; ++i)
+		RTMFP::RTO(srtt, rttvar, 20);
+	CHECK(RTMFP::RTO(srtt, rttvar, 20) == RTMFP::RTO_MIN);
+	// huge sample bounded by RTO_MAX
+	CHECK(RTMFP::RTO(srtt, rttvar, 60000) == Net::RTO_MAX);
+	// null or negative sample (clock adjustment) doesn't break estimator
+	srtt = rttvar = 0;
+	CHECK(RTMFP::RTO(srtt, rttvar, -5) == RTMFP::RTO_MIN && srtt == 1);
+}
+
+ADD_TEST(Backoff) {
+	UInt32 delay(RTMFP::RTO_MIN);
+	delay = RTMFP::Backoff(delay);
+	CHECK(delay == 353);
+	UInt8 timeouts(1);
+	while (delay < Net::RTO_MAX) {
+		delay = RTMFP::Backoff(delay);
+		++timeouts;
+	}
+	CHECK(delay == Net::RTO_MAX && timeouts == 11);
+	CHECK(RTMFP::Backoff(Net::RTO_MAX) == Net::RTO_MAX);
+}
+
+static void Round(RTMFPCongestion& congestion, UInt32 size) {
+	congestion.onSent(size);
+	congestion.onAcked(size, 50, 50);
+}
+
+ADD_TEST(Reno) {
+	unique_ptr<RTMFPCongestion> pReno(RTMFPCongestion::New("reno"));
+	RTMFPCongestion& reno(*pReno);
+	CHECK(reno.cwnd() == RTMFP::SENDABLE_MAX * RTMFP::SIZE_PACKET);
+	// slow start doubles window by round
+	Round(reno, reno.cwnd());
+	CHECK(reno.cwnd() == 2 * RTMFP::SENDABLE_MAX * RTMFP::SIZE_PACKET && !reno.inflight());
+	// application limited, window not validated
+	Round(reno, 100);
+	CHECK(reno.cwnd() == 2 * RTMFP::SENDABLE_MAX * RTMFP::SIZE_PACKET);
+
+	// timeout => ssthresh=cwnd/2, window collapses (2 packets minimum)
+	reno.onTimeout(1000);
+	CHECK(reno.cwnd() == 2 * RTMFP::SIZE_PACKET);
+	// an other writer timeout during the same RTO is ignored (else ssthresh would be 2 packets)
+	reno.onTimeout(1000);
+	Round(reno, reno.cwnd());
+	CHECK(reno.cwnd() == 4 * RTMFP::SIZE_PACKET); // slow start again
+	Round(reno, reno.cwnd());
+	CHECK(reno.cwnd() == 8 * RTMFP::SIZE_PACKET); // still under ssthresh of 6 packets before this round
+	// congestion avoidance, one packet by round
+	Round(reno, reno.cwnd());
+	CHECK(reno.cwnd() == 9 * RTMFP::SIZE_PACKET);
+
+	// loss halves window just once by RTT (and not in the RTT following the timeout)
+	reno.onLost(1000);
+	CHECK(reno.cwnd() == 9 * RTMFP::SIZE_PACKET);
+	Thread::Sleep(5);
+	reno.onLost(1);
+	UInt32 cwnd(reno.cwnd());
+	CHECK(cwnd == (9 * RTMFP::SIZE_PACKET) / 2);
+	reno.onLost(1000);
+	CHECK(reno.cwnd() == cwnd);
+
+	// timeout after the RTO collapses again
+	reno.onTimeout(1);
+	Thread::Sleep(5);
+	reno.onTimeout(1);
+	CHECK(reno.cwnd() == 2 * RTMFP::SIZE_PACKET);
+}
+
+ADD_TEST(Cubic) {
+	unique_ptr<RTMFPCongestion> pCubic(RTMFPCongestion::New("cubic"));
+	RTMFPCongestion& cubic(*pCubic);
+	// slow start as Reno
+	Round(cubic, cubic.cwnd());
+	UInt32 cwnd(cubic.cwnd());
+	CHECK(cwnd == 2 * RTMFP::SENDABLE_MAX * RTMFP::SIZE_PACKET);
+	// loss => multiplicative decrease of beta=0.7
+	cubic.onLost(1000);
+	CHECK(cubic.cwnd() == UInt32(cwnd * 0.7));
+	cwnd = cubic.cwnd();
+	// concave region, grows to wMax but slower than one packet by round
+	Round(cubic, cubic.cwnd());
+	CHECK(cubic.cwnd() > cwnd && cubic.cwnd() < (cwnd + RTMFP::SIZE_PACKET));
+	// timeout collapses window
+	cubic.onTimeout(1000);
+	CHECK(cubic.cwnd() == 2 * RTMFP::SIZE_PACKET);
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/Recycler.h"
+#include "Mona/Runner.h"
+#include <thread>
+
+using namespace Mona;
+using namespace std;
+
+namespace RecyclerTest {
+
+struct Job : Runner, virtual Object {
+	Job(UInt32& count) : Runner("Job"), _count(count) {}
+	~Job() { ++_count; }
+	bool run(Exception& ex) { return true; }
+private:
+	UInt32& _count;
+};
+
+ADD_TEST(SameThread) {
+	UInt32 destructions(0);
+	vector<shared<Runner>> runners;
+	for (UInt8 loop = 0; loop < 3; ++loop) {
+		UInt64 allocations(Recycling::Allocations());
+		for (UInt32 i = 0; i < 100; ++i)
+			runners.emplace_back(Runner::Make<Job>(destructions));
+		runners.clear();
+		CHECK(destructions == (loop + 1) * 100u);
+		if (loop) // warm
+			CHECK(Recycling::Allocations() == allocations);
+	}
+	// bigger than MAX_SIZE, not recycled
+	vector<char, Recycler<char>> bytes(Recycling::MAX_SIZE + 1, 'a');
+	CHECK(bytes.size() == (Recycling::MAX_SIZE + 1) && bytes.back() == 'a');
+}
+
+ADD_TEST(ProducerConsumer) {
+	// one thread allocates, the other releases: the surplus of the consumer must come back to the producer
+	UInt32 destructions(0);
+	UInt64 allocations(0);
+	for (UInt8 loop = 0; loop < 5; ++loop) {
+		vector<shared<Runner>> runners;
+		thread producer([&runners, &destructions]() {
+			for (UInt32 i = 0; i < 2000; ++i)
+				runners.emplace_back(Runner::Make<Job>(destructions));
+		});
+		producer.join();
+		if (loop > 2) // warm (the consumer keeps the first blocks released)
+			CHECK(Recycling::Allocations() == allocations);
+		allocations = Recycling::Allocations();
+		runners.clear();
+	}
+	CHECK(destructions == 10000);
+}
+
+ADD_TEST(ThreadEnd) {
+	// a thread_local destroyed after the recycler thread cache still allocates and releases
+	static UInt32 Destructions(0);
+	struct Late {
+		~Late() {
+			shared<Runner> pRunner(Runner::Make<Job>(Destructions));
+			vector<shared<Runner>> runners(10, pRunner);
+			runners.clear();
+			pRunner.reset();
+		}
+	};
+	for (UInt8 loop = 0; loop < 3; ++loop) {
+		thread ending([]() {
+			static thread_local Late Instance; // built before the recycler cache => destroyed after it
+			(void)Instance;
+			Runner::Make<Job>(Destructions);
+		});
+		ending.join();
+	}
+	CHECK(Destructions == 6);
+}
+
+}
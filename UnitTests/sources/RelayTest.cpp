@@ -0,0 +1,159 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/Relay/Relay.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace RelayTest {
+
+static BinaryWriter& Frame(BinaryWriter& writer, Relay::Type type, UInt32 id, const string& body) {
+	UInt32 size(1 + Binary::Get7BitValueSize(id) + body.size());
+	return writer.write32(size).write8(type).write7BitEncoded(id).write(body);
+}
+
+typedef vector<pair<Relay::Type, string>> Frames;
+
+static UInt32 Read(Exception& ex, const UInt8* data, UInt32 size, Frames& frames) {
+	return Relay::Read(ex, Packet(data, size), [&frames](Relay::Type type, UInt32 id, const Packet& body) {
+		frames.emplace_back(type, string(STR body.data(), body.size()));
+		return true;
+	});
+}
+
+ADD_TEST(Read) {
+	Buffer buffer;
+	BinaryWriter writer(buffer);
+	Frame(writer, Relay::TYPE_SUBSCRIBE, 1, "live");
+	Frame(writer, Relay::TYPE_ACK, 300, "");
+	UInt32 complete(buffer.size());
+	Frame(writer, Relay::TYPE_END, 1, "partial"); // read first without its last byte
+
+	Exception ex;
+	Frames frames;
+	CHECK(Read(ex, buffer.data(), buffer.size() - 1, frames) == (buffer.size() - complete - 1) && !ex);
+	CHECK(frames.size() == 2);
+	CHECK(frames[0].first == Relay::TYPE_SUBSCRIBE && frames[0].second == "live");
+	CHECK(frames[1].first == Relay::TYPE_ACK && frames[1].second.empty());
+
+	// partial frame, nothing read until complete
+	for (UInt32 size = 0; size < 4; ++size) {
+		frames.clear();
+		CHECK(Read(ex, buffer.data() + complete, size, frames) == size && !ex && frames.empty());
+	}
+	frames.clear();
+	CHECK(Read(ex, buffer.data() + complete, buffer.size() - complete - 1, frames) == (buffer.size() - complete - 1) && !ex && frames.empty());
+	CHECK(Read(ex, buffer.data() + complete, buffer.size() - complete, frames) == 0 && !ex);
+	CHECK(frames.size() == 1 && frames[0].first == Relay::TYPE_END && frames[0].second == "partial");
+}
+
+ADD_TEST(ReadInvalid) {
+	Buffer buffer;
+	BinaryWriter writer(buffer);
+	Frames frames;
+
+	// oversized frame, rejected without waiting its content
+	Frame(writer, Relay::TYPE_ACK, 1, "");
+	writer.write32(Relay::FRAME_MAX + 1).write8(Relay::TYPE_MEDIA);
+	Exception ex;
+	CHECK(Read(ex, buffer.data(), buffer.size(), frames) == 0 && ex);
+	CHECK(frames.size() == 1 && frames[0].first == Relay::TYPE_ACK);
+
+	// size overflowing available() + 4
+	buffer.clear();
+	writer.write32(0xFFFFFFFF).write8(Relay::TYPE_MEDIA);
+	ex = nullptr;
+	CHECK(Read(ex, buffer.data(), buffer.size(), frames) == 0 && ex);
+
+	// empty frame
+	buffer.clear();
+	writer.write32(0);
+	ex = nullptr;
+	CHECK(Read(ex, buffer.data(), buffer.size(), frames) == 0 && ex);
+}
+
+struct Source : Media::Source {
+	Source() : track(0), audios(0), videos(0), datas(0) {}
+	void writeAudio(UInt16 track, const Media::Audio::Tag& tag, const Packet& packet) { ++audios; this->track = track; audio.codec = tag.codec; audio.time = tag.time; audio.isConfig = tag.isConfig; audio.channels = tag.channels; audio.rate = tag.rate; payload.assign(STR packet.data(), packet.size()); }
+	void writeVideo(UInt16 track, const Media::Video::Tag& tag, const Packet& packet) { ++videos; this->track = track; video.codec = tag.codec; video.time = tag.time; video.frame = tag.frame; video.compositionOffset = tag.compositionOffset; payload.assign(STR packet.data(), packet.size()); }
+	void writeData(UInt16 track, Media::Data::Type type, const Packet& packet) { ++datas; this->track = track; data = type; payload.assign(STR packet.data(), packet.size()); }
+	void writeProperties(UInt16 track, DataReader& reader) {}
+	void reportLost(Media::Type type, UInt32 lost) {}
+	void reportLost(Media::Type type, UInt16 track, UInt32 lost) {}
+	void flush() {}
+	void reset() {}
+
+	UInt16				track;
+	Media::Audio::Tag	audio;
+	Media::Video::Tag	video;
+	Media::Data::Type	data;
+	string				payload;
+	UInt32				audios;
+	UInt32				videos;
+	UInt32				datas;
+};
+
+static Packet Body(Buffer& buffer, const string& payload) {
+	buffer.append(payload.data(), payload.size());
+	return Packet(buffer.data(), buffer.size());
+}
+
+ADD_TEST(Media) {
+	Source source;
+	Buffer buffer;
+	BinaryWriter writer(buffer);
+
+	Media::Audio::Tag audio(Media::Audio::CODEC_AAC);
+	audio.time = 1000;
+	audio.isConfig = true;
+	audio.channels = 2;
+	audio.rate = 44100;
+	Relay::WriteMedia(writer, 0, audio);
+	CHECK(Relay::ReadMedia(Body(buffer, "aac"), source) && source.audios == 1);
+	CHECK(source.track == 0 && source.audio.codec == Media::Audio::CODEC_AAC && source.audio.time == 1000 && source.audio.isConfig);
+	CHECK(source.audio.channels == 2 && source.audio.rate == 44100 && source.payload == "aac");
+
+	Media::Video::Tag video(Media::Video::CODEC_H264);
+	video.time = 2000;
+	video.frame = Media::Video::FRAME_INTER;
+	video.compositionOffset = 40;
+	buffer.clear();
+	Relay::WriteMedia(writer, 3, video);
+	CHECK(Relay::ReadMedia(Body(buffer, "h264"), source) && source.videos == 1);
+	CHECK(source.track == 3 && source.video.codec == Media::Video::CODEC_H264 && source.video.time == 2000);
+	CHECK(source.video.frame == Media::Video::FRAME_INTER && source.video.compositionOffset == 40 && source.payload == "h264");
+
+	video.compositionOffset = 0;
+	buffer.clear();
+	Relay::WriteMedia(writer, 0, video);
+	CHECK(Relay::ReadMedia(Body(buffer, ""), source) && source.videos == 2);
+	CHECK(source.track == 0 && source.video.compositionOffset == 0 && source.payload.empty());
+
+	buffer.clear();
+	Relay::WriteMedia(writer, 5, Media::Data::TYPE_JSON);
+	CHECK(Relay::ReadMedia(Body(buffer, "{}"), source) && source.datas == 1);
+	CHECK(source.track == 5 && source.data == Media::Data::TYPE_JSON && source.payload == "{}");
+
+	// truncated header
+	buffer.clear();
+	writer.write8(6).write8(0);
+	CHECK(!Relay::ReadMedia(Packet(buffer.data(), buffer.size()), source));
+	CHECK(!Relay::ReadMedia(Packet::Null(), source) && source.audios == 1 && source.videos == 2 && source.datas == 1);
+}
+
+}
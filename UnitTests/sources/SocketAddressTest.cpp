@@ -20,6 +20,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/SocketAddress.h"
 #include "Mona/Logs.h"
 #include "Mona/Util.h"
+#include <unordered_map>
 
 using namespace std;
 using namespace Mona;
@@ -213,4 +214,21 @@ ADD_TEST(Comparisons6) {
 	CHECK(sAddress1==sAddress2);
 }
 
+ADD_TEST(Hash) {
+	Exception ex;
+	SocketAddress::Hash hash;
+	SocketAddress sAddress1(IPAddress::Loopback(), 1234), sAddress2;
+	CHECK(sAddress2.set(ex, "127.0.0.1:1234") && !ex);
+	CHECK(hash(sAddress1) == hash(sAddress2));
+	sAddress2.setPort(1235);
+	CHECK(hash(sAddress1) != hash(sAddress2));
+	CHECK(sAddress2.set(ex, "[::1]:1234") && !ex);
+	CHECK(hash(sAddress1) != hash(sAddress2));
+
+	unordered_map<SocketAddress, UInt32, SocketAddress::Hash> addresses;
+	for (UInt16 port = 1; port <= 1000; ++port)
+		CHECK(addresses.emplace(SocketAddress(IPAddress::Loopback(), port), port).second);
+	CHECK(addresses.size() == 1000 && addresses[SocketAddress(IPAddress::Loopback(), 500)] == 500);
+}
+
 }
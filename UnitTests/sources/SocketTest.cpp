@@ -73,6 +73,11 @@ ADD_TEST(UDP_Blocking) {
 	CHECK(client.receive(ex, buffer, sizeof(buffer)) == 21 && !ex&& memcmp(buffer, EXPAND("hi mathieu and thomas")) == 0);
 	CHECK(UInt32(client.receive(ex, buffer, sizeof(buffer)))==_Short0Data.size() && !ex && memcmp(buffer,_Short0Data.data(),_Short0Data.size())==0)
 
+	// vectored writing => one datagram
+	Packet packets[3] = { Packet(EXPAND("hi ")), Packet(), Packet(EXPAND("mathieu and thomas")) };
+	CHECK(client.write(ex, packets, 3) == 21 && !ex);
+	CHECK(server.receiveFrom(ex, buffer, sizeof(buffer), from) == 21 && !ex && from == client.address() && memcmp(buffer, EXPAND("hi mathieu and thomas")) == 0);
+
 	CHECK(client.connect(ex, SocketAddress::Wildcard()) && !ex && !client.peerAddress() && client.address())
 }
 
@@ -162,6 +167,48 @@ void TestTCPBlocking(const shared<TLS>& pClientTLS = nullptr, const shared<TLS>&
 }
 
 
+struct BlockedSocket : Socket {
+	BlockedSocket() : Socket(TYPE_DATAGRAM), blocked(true) {}
+	bool blocked; // simulate a full sending buffer
+private:
+	int sendVector(Exception& ex, const Packet* packets, UInt32 count, int flags) {
+		if (!blocked)
+			return Socket::sendVector(ex, packets, count, flags);
+		SetException(ex, NET_EWOULDBLOCK);
+		return -1;
+	}
+	int sendTo(Exception& ex, const void* data, UInt32 size, const SocketAddress& address, int flags) {
+		if (!blocked)
+			return Socket::sendTo(ex, data, size, address, flags);
+		SetException(ex, NET_EWOULDBLOCK);
+		return -1;
+	}
+};
+
+ADD_TEST(UDP_Queueing) {
+	Socket server(Socket::TYPE_DATAGRAM);
+	SocketAddress address;
+	Exception ex;
+	CHECK(server.bind(ex, address) && !ex);
+
+	BlockedSocket client;
+	address.set(IPAddress::Loopback(), server.address().port());
+	CHECK(client.connect(ex, address) && !ex);
+
+	// vectored writing queued => still one datagram on flush
+	Packet packets[3] = { Packet(EXPAND("hi ")), Packet(), Packet(EXPAND("mathieu and thomas")) };
+	CHECK(client.write(ex, packets, 3) == 0 && !ex && client.queueing() == 21);
+	// queue not empty => queued after the first one
+	CHECK(client.write(ex, packets, 1) == 0 && !ex && client.queueing() == 24);
+	client.blocked = false;
+	CHECK(client.flush(ex) && !ex && !client.queueing());
+
+	UInt8 buffer[8192];
+	SocketAddress from;
+	CHECK(server.receiveFrom(ex, buffer, sizeof(buffer), from) == 21 && !ex && memcmp(buffer, EXPAND("hi mathieu and thomas")) == 0);
+	CHECK(server.receiveFrom(ex, buffer, sizeof(buffer), from) == 3 && !ex && memcmp(buffer, EXPAND("hi ")) == 0);
+}
+
 ADD_TEST(TCP_Blocking) {
 	TestTCPBlocking();
 }
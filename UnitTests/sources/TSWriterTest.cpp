@@ -0,0 +1,148 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/TSWriter.h"
+#include "Mona/Crypto.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace TSWriterTest {
+
+/*!
+	Fixed sequence: H264 config + key frame + inter frames of sizes around the TS cell payload boundaries (stuffing paths),
+	AAC config + frames, a composition offset, a MP3 to AAC codec change (PMT version), during 2.5s (PCR and PMT repetition) */
+static UInt32 Mux(TSWriter& writer, const MediaWriter::OnWrite& onWrite) {
+	UInt32 frames(0);
+	auto frame = [](UInt32 size, UInt8 nal, UInt8 seed) {
+		shared<Buffer> pBuffer(new Buffer(size));
+		for (UInt32 i = 0; i < size; ++i)
+			pBuffer->data()[i] = UInt8(seed + i * 7);
+		if (nal)
+			BinaryWriter(pBuffer->data(), 5).write32(size - 4).write8(nal);
+		return Packet(pBuffer);
+	};
+	writer.beginMedia(onWrite);
+
+	Media::Audio::Tag audio(Media::Audio::CODEC_MP3);
+	audio.rate = 44100;
+	audio.channels = 2;
+	audio.time = 0;
+	writer.writeAudio(1, audio, frame(417, 0, 1), onWrite);
+	++frames;
+
+	Media::Video::Tag video(Media::Video::CODEC_H264);
+	video.time = 0;
+	video.frame = Media::Video::FRAME_CONFIG;
+	{
+		// SPS + PPS in AVCC format
+		Buffer config;
+		BinaryWriter(config).write32(12).write8(0x67).write(EXPAND("\x42\xC0\x1E\xD9\x00\xA0\x47\xFE\xC8\x04")).write8(0).write32(4).write8(0x68).write(EXPAND("\xCB\x83\xCB"));
+		writer.writeVideo(0, video, Packet(config), onWrite);
+		++frames;
+	}
+	audio.codec = Media::Audio::CODEC_AAC;
+	audio.isConfig = true;
+	writer.writeAudio(1, audio, Packet(EXPAND("\x12\x10")), onWrite);
+	++frames;
+	audio.isConfig = false;
+
+	static const UInt32 Sizes[] = { 5000, 10, 170, 176, 177, 178, 183, 184, 185, 190, 367, 368, 369, 1000, 4000 };
+	UInt32 audioTime(0), videoTime(0);
+	while (videoTime < 63) {
+		if ((audioTime * 25) <= (videoTime * 43)) {
+			audio.time = audioTime * 1000 / 43;
+			writer.writeAudio(1, audio, frame(100 + (audioTime * 37) % 300, 0, UInt8(audioTime)), onWrite);
+			++audioTime;
+		} else {
+			video.time = videoTime * 40;
+			video.frame = (videoTime % 25) ? Media::Video::FRAME_INTER : Media::Video::FRAME_KEY;
+			video.compositionOffset = (videoTime % 3) ? 80 : 0;
+			writer.writeVideo(0, video, frame(Sizes[videoTime % (sizeof(Sizes) / sizeof(Sizes[0]))], video.frame == Media::Video::FRAME_KEY ? 0x65 : 0x41, UInt8(videoTime)), onWrite);
+			++videoTime;
+		}
+		++frames;
+	}
+	writer.endMedia(onWrite);
+	return frames;
+}
+
+ADD_TEST(Reference) {
+	// size and MD5 of the output of the previous muxer (one onWrite by TS part) for the same sequence
+	Buffer output;
+	UInt32 writes(0);
+	TSWriter writer;
+	UInt32 frames(Mux(writer, [&output, &writes](const Packet& packet) {
+		output.append(packet.data(), packet.size());
+		++writes;
+	}));
+	CHECK(writes == frames); // one contiguous buffer by frame
+	CHECK(output.size() == 109792);
+	UInt8 md5[Crypto::MD5_SIZE];
+	Crypto::Hash::MD5(output.data(), output.size(), md5);
+	String hex;
+	for (UInt8 value : md5)
+		String::Append(hex, String::Format<UInt8>("%02X", value));
+	CHECK(hex == "BE11F088797A2B833AA01F0CA0C7FE0E");
+}
+
+ADD_TEST(Structure) {
+	Buffer output;
+	TSWriter writer;
+	Mux(writer, [&output](const Packet& packet) {
+		CHECK((packet.size() % 188) == 0 && packet.data()[0] == 0x47); // every write is whole TS packets
+		output.append(packet.data(), packet.size());
+	});
+	CHECK((output.size() % 188) == 0);
+
+	map<UInt16, UInt8> counters;
+	UInt32 pats(0), pcrs(0);
+	UInt64 pcr(0);
+	UInt16 pidPCR(0);
+	for (BinaryReader reader(output.data(), output.size()); reader.available(); reader.next(188)) {
+		const UInt8* cell(reader.current());
+		CHECK(cell[0] == 0x47);
+		UInt16 pid(BinaryReader(cell + 1, 2).read16() & 0x1FFF);
+		if (reader.position() == 0)
+			CHECK(pid == 0); // begins with PAT
+		if (!pid) {
+			++pats;
+			CHECK(BinaryReader(cell + 189, 2).read16() == 0x6020); // followed by PMT
+		}
+		// continuity counter incremented by cell with payload, by PID
+		if (cell[3] & 0x10) {
+			auto it(counters.emplace(pid, cell[3] & 0x0F));
+			if (!it.second) {
+				CHECK((cell[3] & 0x0F) == ((it.first->second + 1) & 0x0F));
+				it.first->second = cell[3] & 0x0F;
+			}
+		}
+		// PCR in adaptation field, always on the same PID and increasing
+		if ((cell[3] & 0x20) && cell[4] && (cell[5] & 0x10)) {
+			if (pcrs++)
+				CHECK(pid == pidPCR);
+			pidPCR = pid;
+			UInt64 value((UInt64(BinaryReader(cell + 6, 4).read32()) << 1) | (cell[10] >> 7));
+			CHECK(value >= pcr);
+			pcr = value;
+		}
+	}
+	// PAT+PMT at beginning, on codec change and repeated, PCR regularly
+	CHECK(pats >= 3 && pcrs >= 25 && counters.size() == 4);
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/ThreadPool.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace ThreadPoolTest {
+
+struct Job : Runner, virtual Object {
+	Job(const function<void()>& function) : Runner("Job"), _function(function) {}
+private:
+	bool run(Exception& ex) { _function(); return true; }
+	function<void()> _function;
+};
+
+ADD_TEST(Tracks) {
+	ThreadPool threadPool(4);
+	threadPool.setStealing(true);
+	Exception ex;
+	// untracked runners stolen around must not break the order of tracked runners
+	vector<UInt32> values[4];
+	UInt16 tracks[4] = { 0, 0, 0, 0 };
+	atomic<UInt32> untracked(0);
+	for (UInt32 i = 0; i < 200; ++i) {
+		for (UInt8 t = 0; t < 4; ++t) {
+			vector<UInt32>& track(values[t]);
+			CHECK(threadPool.queue(ex, make_shared<Job>([&track, i]() { track.emplace_back(i); }), tracks[t]) && !ex);
+		}
+		CHECK(threadPool.queue(ex, make_shared<Job>([&untracked]() { ++untracked; })) && !ex);
+	}
+	threadPool.join();
+	CHECK(untracked == 200);
+	for (vector<UInt32>& track : values) {
+		CHECK(track.size() == 200);
+		for (UInt32 i = 0; i < track.size(); ++i)
+			CHECK(track[i] == i);
+	}
+	UInt64 runners(0);
+	for (UInt16 i = 0; i < threadPool.threads(); ++i) {
+		ThreadPool::Stats stats;
+		threadPool.stats(i, stats);
+		CHECK(!stats.depth && stats.maxDepth && stats.stolen <= stats.runners && stats.latency <= stats.maxLatency);
+		runners += stats.runners;
+	}
+	CHECK(runners == 1000);
+}
+
+ADD_TEST(Stealing) {
+	ThreadPool threadPool(2);
+	threadPool.setStealing(true);
+	Exception ex;
+	Signal blocked, released;
+	// block the first thread, the untracked runners queued behind are stolen by the second one
+	CHECK(threadPool.queue(ex, make_shared<Job>([&]() { blocked.set(); released.wait(); })) && !ex);
+	CHECK(blocked.wait(5000));
+	atomic<UInt32> count(0);
+	Signal done;
+	for (UInt8 i = 0; i < 10; ++i) {
+		CHECK(threadPool.queue(ex, make_shared<Job>([&]() {
+			if (++count == 10)
+				done.set();
+		})) && !ex);
+	}
+	CHECK(done.wait(5000) && count == 10);
+	released.set();
+	threadPool.join();
+	ThreadPool::Stats stats;
+	CHECK(threadPool.stats(0, stats).stolen == 5 && stats.runners == 6);
+}
+
+ADD_TEST(Affinity) {
+	ThreadPool threadPool(2);
+	Exception ex;
+	CHECK(!threadPool.setAffinity(ex, "1-0") && ex);
+	CHECK(!threadPool.setAffinity(ex = nullptr, "0,x") && ex);
+	CHECK(threadPool.setAffinity(ex = nullptr, " 0 ,0-0") && !ex);
+	atomic<UInt32> count(0);
+	for (UInt8 i = 0; i < 4; ++i)
+		CHECK(threadPool.queue(ex, make_shared<Job>([&count]() { ++count; })) && !ex);
+	threadPool.join();
+	CHECK(count == 4);
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Test.h"
+#include "Mona/Watchdog.h"
+#include "Mona/Metrics.h"
+#include "Mona/Timer.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace WatchdogTest {
+
+static UInt64 Stalls() {
+	static const string Name("\nmona_watchdog_stalls_total ");
+	string metrics;
+	Metrics::Write(metrics);
+	size_t found(metrics.find(Name));
+	if (found == string::npos)
+		return 0;
+	return stoull(metrics.substr(found + Name.size()));
+}
+
+ADD_TEST(Stall) {
+	Watchdog watchdog;
+	Exception ex;
+	CHECK(watchdog.start(ex, 20) && !ex);
+	UInt64 stalls(Stalls());
+	{
+		Watchdog::Task task("Fast");
+	}
+	{
+		Watchdog::Task task("Slow");
+		Thread::Sleep(100);
+		Watchdog::Task nested("Nested"); // attributed to Slow
+		Thread::Sleep(100);
+	}
+	CHECK(Stalls() == stalls + 1);
+
+	// timer callbacks are watched
+	Timer timer;
+	Timer::OnTimer onTimer([](UInt32) { Thread::Sleep(100); return 0; });
+	timer.set(onTimer, 1);
+	Thread::Sleep(5);
+	timer.raise();
+	CHECK(Stalls() == stalls + 2);
+
+	watchdog.stop();
+	{
+		Watchdog::Task task("Unwatched");
+		Thread::Sleep(100);
+	}
+	CHECK(Stalls() == stalls + 2);
+}
+
+ADD_TEST(Sampling) {
+	Watchdog watchdog;
+	Exception ex;
+	CHECK(watchdog.start(ex, 20, true) && !ex);
+	{
+		Watchdog::Task task("Sampled");
+		Thread::Sleep(100);
+	}
+	watchdog.stop();
+}
+
+}